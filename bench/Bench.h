@@ -0,0 +1,48 @@
+#pragma once
+
+#include <functional>
+#include <vector>
+#include <string>
+
+// Minimal benchmark registry, cases are timed by bench/main.cpp.
+// A case runs its body `iterations` times, each iteration processing itemsPerIteration items.
+
+struct BenchCase {
+    const char* group;
+    const char* name;
+    size_t itemsPerIteration;
+    std::function<void(size_t)> run;
+};
+
+inline std::vector<BenchCase>& getBenchCases ( ) {
+    static std::vector<BenchCase> cases{};
+    return cases;
+}
+
+struct BenchRegistrar {
+    BenchRegistrar ( const char* group, const char* name, size_t items, std::function<void(size_t)> run ) {
+        getBenchCases().push_back({ group, name, items, run });
+    }
+};
+
+#define BENCH(group, name, items)                                                   \
+    static void bench_##group##_##name ( size_t iterations );                      \
+    static BenchRegistrar registrar_##group##_##name(#group, #name, items, bench_##group##_##name); \
+    static void bench_##group##_##name ( size_t iterations )
+
+// Extra numbers a case wants shown, printed under its result and cleared after.
+inline std::string& getBenchNote ( ) {
+    static std::string note{};
+    return note;
+}
+
+// Keeps the compiler from discarding results that are never read.
+template<typename T>
+inline void doNotOptimize ( const T& val ) {
+#if defined(__GNUC__) || defined(__clang__)
+    asm volatile("" : : "r,m"(val) : "memory");
+#else
+    static volatile const T* sink;
+    sink = &val;
+#endif
+}
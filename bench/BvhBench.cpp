@@ -0,0 +1,122 @@
+#include <vector>
+#include <cmath>
+#include <stdlib.h>
+#include "util/spatial/TriangleBvh.h"
+#include "Bench.h"
+
+// Million triangle height field, built lazily so other filters don't pay for it.
+// Build cases count triangles as items, ray cases count rays.
+
+static constexpr int GRID_SIZE = 708; // 708 * 708 * 2 ~ 1M triangles
+static constexpr size_t MESH_TRIANGLES = static_cast<size_t>(GRID_SIZE) * GRID_SIZE * 2;
+static constexpr size_t BVH_RAY_COUNT = 4096;
+
+static float randomRange ( float min, float max ) {
+    return min + static_cast<float>(rand()) / RAND_MAX * (max - min);
+}
+
+static const std::vector<Triangle3d>& getMesh ( ) {
+    static std::vector<Triangle3d> mesh = []() -> std::vector<Triangle3d> {
+        std::vector<Triangle3d> tris;
+        tris.reserve(MESH_TRIANGLES);
+
+        auto vertex = []( int x, int z ) -> Vector3f {
+            return Vector3f(static_cast<float>(x), std::sin(x * 0.05F) * std::cos(z * 0.07F) * 20.0F, static_cast<float>(z));
+        };
+
+        for ( int z = 0; z < GRID_SIZE; ++z ) {
+            for ( int x = 0; x < GRID_SIZE; ++x ) {
+                Vector3f a = vertex(x, z), b = vertex(x + 1, z), c = vertex(x, z + 1), d = vertex(x + 1, z + 1);
+                tris.push_back(Triangle3d(a, b, c, Vector3f(0, 1, 0)));
+                tris.push_back(Triangle3d(b, d, c, Vector3f(0, 1, 0)));
+            }
+        }
+
+        return tris;
+    }();
+
+    return mesh;
+}
+
+static const std::vector<Ray3f>& getRays ( ) {
+    static std::vector<Ray3f> rays = []() -> std::vector<Ray3f> {
+        std::vector<Ray3f> out;
+
+        for ( size_t i = 0; i < BVH_RAY_COUNT; ++i ) {
+            Vector3f origin(randomRange(0, GRID_SIZE), 60, randomRange(0, GRID_SIZE));
+            out.push_back(Ray3f(origin, Vector3f(randomRange(-1, 1), -1, randomRange(-1, 1))));
+        }
+
+        return out;
+    }();
+
+    return rays;
+}
+
+template<int Width>
+static const TriangleBvh<Width>& getBvh ( ) {
+    static TriangleBvh<Width> bvh = []() -> TriangleBvh<Width> {
+        TriangleBvh<Width> out;
+        out.build(getMesh().data(), getMesh().size());
+        return out;
+    }();
+
+    return bvh;
+}
+
+template<int Width>
+static void benchBuild ( size_t iterations, unsigned int threads ) {
+    const std::vector<Triangle3d>& mesh = getMesh();
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        TriangleBvh<Width> bvh;
+        bvh.build(mesh.data(), mesh.size(), threads);
+        doNotOptimize(bvh.getBuildStats().nodeCount);
+    }
+}
+
+template<int Width>
+static void benchClosest ( size_t iterations ) {
+    const TriangleBvh<Width>& bvh = getBvh<Width>();
+    const std::vector<Ray3f>& rays = getRays();
+    RayHit hit;
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( const Ray3f& ray : rays ) {
+            bvh.intersect(ray, hit);
+        }
+        doNotOptimize(hit);
+    }
+}
+
+template<int Width>
+static void benchAny ( size_t iterations ) {
+    const TriangleBvh<Width>& bvh = getBvh<Width>();
+    const std::vector<Ray3f>& rays = getRays();
+    bool anyHit = false;
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( const Ray3f& ray : rays ) {
+            anyHit |= bvh.intersectAny(ray);
+        }
+        doNotOptimize(anyHit);
+    }
+}
+
+BENCH(Bvh, build4_1thread, MESH_TRIANGLES) { benchBuild<4>(iterations, 1); }
+BENCH(Bvh, build4_threads, MESH_TRIANGLES) { benchBuild<4>(iterations, 0); }
+BENCH(Bvh, build8_threads, MESH_TRIANGLES) { benchBuild<8>(iterations, 0); }
+
+BENCH(Bvh, refit4, MESH_TRIANGLES) {
+    static TriangleBvh4 bvh = getBvh<4>();
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        bvh.refit(getMesh().data());
+        doNotOptimize(bvh.getBounds());
+    }
+}
+
+BENCH(Bvh, closest4, BVH_RAY_COUNT) { benchClosest<4>(iterations); }
+BENCH(Bvh, closest8, BVH_RAY_COUNT) { benchClosest<8>(iterations); }
+BENCH(Bvh, any4, BVH_RAY_COUNT) { benchAny<4>(iterations); }
+BENCH(Bvh, any8, BVH_RAY_COUNT) { benchAny<8>(iterations); }
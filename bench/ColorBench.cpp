@@ -0,0 +1,109 @@
+#include <vector>
+#include <stdlib.h>
+#include "util/colors/ColorArrays.h"
+#include "util/colors/Color4f.h"
+#include "Bench.h"
+
+// Per pixel Color4f conversions against the bulk ColorArrays.h versions built for the compile
+// flags, the dispatched tables are covered in KernelBench.cpp.
+
+static constexpr size_t COLOR_COUNT = 1 << 16;
+
+static std::vector<uint32_t> makeColorPixels ( ) {
+    std::vector<uint32_t> pixels(COLOR_COUNT);
+    for ( auto& pixel : pixels ) { pixel = (static_cast<uint32_t>(rand()) << 16) ^ static_cast<uint32_t>(rand()); }
+    return pixels;
+}
+
+static std::vector<uint32_t> colorPixels = makeColorPixels();
+static std::vector<uint32_t> colorPixelsOut(COLOR_COUNT);
+static std::vector<Color4f> colorsIn = []() {
+    std::vector<Color4f> colors(COLOR_COUNT);
+    unpackARGBArray(colors.data(), colorPixels.data(), COLOR_COUNT);
+    return colors;
+}();
+static std::vector<Color4f> colorsOut(COLOR_COUNT);
+
+BENCH(Color4f, unpackARGB_scalar, COLOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < COLOR_COUNT; ++i ) { colorsOut[i] = Color4f(colorPixels[i]); }
+        doNotOptimize(colorsOut[0]);
+    }
+}
+
+BENCH(Color4f, unpackARGB_simd, COLOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        unpackARGBArray(colorsOut.data(), colorPixels.data(), COLOR_COUNT);
+        doNotOptimize(colorsOut[0]);
+    }
+}
+
+BENCH(Color4f, toARGB_scalar, COLOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < COLOR_COUNT; ++i ) { colorPixelsOut[i] = colorsIn[i].toARGB(); }
+        doNotOptimize(colorPixelsOut[0]);
+    }
+}
+
+BENCH(Color4f, toARGB_simd, COLOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        packARGBArray(colorPixelsOut.data(), colorsIn.data(), COLOR_COUNT);
+        doNotOptimize(colorPixelsOut[0]);
+    }
+}
+
+BENCH(Color4f, toRGBA_scalar, COLOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < COLOR_COUNT; ++i ) { colorPixelsOut[i] = colorsIn[i].toRGBA(); }
+        doNotOptimize(colorPixelsOut[0]);
+    }
+}
+
+BENCH(Color4f, toRGBA_simd, COLOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        packRGBAArray(colorPixelsOut.data(), colorsIn.data(), COLOR_COUNT);
+        doNotOptimize(colorPixelsOut[0]);
+    }
+}
+
+BENCH(Color4f, toLinear_scalar, COLOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < COLOR_COUNT; ++i ) { colorsOut[i] = colorsIn[i].toLinear(); }
+        doNotOptimize(colorsOut[0]);
+    }
+}
+
+BENCH(Color4f, toLinear_simd, COLOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        srgbToLinearArray(colorsOut.data(), colorsIn.data(), COLOR_COUNT);
+        doNotOptimize(colorsOut[0]);
+    }
+}
+
+BENCH(Color4f, toSrgb_scalar, COLOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < COLOR_COUNT; ++i ) { colorsOut[i] = colorsIn[i].toSrgb(); }
+        doNotOptimize(colorsOut[0]);
+    }
+}
+
+BENCH(Color4f, toSrgb_simd, COLOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        linearToSrgbArray(colorsOut.data(), colorsIn.data(), COLOR_COUNT);
+        doNotOptimize(colorsOut[0]);
+    }
+}
+
+BENCH(Color4f, premultiplied_scalar, COLOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < COLOR_COUNT; ++i ) { colorsOut[i] = colorsIn[i].premultiplied(); }
+        doNotOptimize(colorsOut[0]);
+    }
+}
+
+BENCH(Color4f, premultiplied_simd, COLOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        premultiplyAlphaArray(colorsOut.data(), colorsIn.data(), COLOR_COUNT);
+        doNotOptimize(colorsOut[0]);
+    }
+}
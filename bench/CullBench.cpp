@@ -0,0 +1,91 @@
+#include <vector>
+#include <stdlib.h>
+#include "renderer/FrustumCuller.h"
+#include "renderer/Camera.h"
+#include "Bench.h"
+
+// Items are bounding volumes tested. A quarter million objects scattered around the camera,
+// roughly a tenth of them end up visible.
+
+static constexpr size_t CULL_OBJECT_COUNT = 256 * 1024;
+
+static float randomRange ( float min, float max ) {
+    return min + static_cast<float>(rand()) / RAND_MAX * (max - min);
+}
+
+static Frustum makeFrustum ( ) {
+    Camera camera(Vector3f(0, 10, 0), Quaternion());
+    camera.lookAt(Vector3f(100, 0, -100));
+    camera.setPerspective(1.22173F, 0.1F, 500.0F);
+    return camera.getFrustum();
+}
+
+static const Frustum benchFrustum = makeFrustum();
+static std::vector<Aabb3f> benchBoxes{};
+static BoxBounds benchBoxBounds{};
+static SphereBounds benchSphereBounds{};
+static std::vector<uint32_t> benchVisible{};
+
+static void initCullScene ( ) {
+    if ( !benchBoxes.empty() ) {
+        return;
+    }
+
+    benchBoxBounds.resize(CULL_OBJECT_COUNT);
+    benchSphereBounds.resize(CULL_OBJECT_COUNT);
+
+    for ( size_t i = 0; i < CULL_OBJECT_COUNT; ++i ) {
+        Vector3f center(randomRange(-500, 500), randomRange(-50, 50), randomRange(-500, 500));
+        Vector3f extent(randomRange(0.5F, 4), randomRange(0.5F, 4), randomRange(0.5F, 4));
+
+        benchBoxes.push_back(Aabb3f(center - extent, center + extent));
+        benchBoxBounds.set(i, benchBoxes.back());
+        benchSphereBounds.set(i, center, extent.Magnitude());
+    }
+}
+
+BENCH(Cull, BoxesScalar, CULL_OBJECT_COUNT) {
+    initCullScene();
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        benchVisible.clear();
+
+        for ( size_t i = 0; i < CULL_OBJECT_COUNT; ++i ) {
+            if ( benchFrustum.IntersectsBox(benchBoxes[i]) ) {
+                benchVisible.push_back(static_cast<uint32_t>(i));
+            }
+        }
+
+        doNotOptimize(benchVisible.data());
+    }
+}
+
+BENCH(Cull, BoxesSimd, CULL_OBJECT_COUNT) {
+    initCullScene();
+    static FrustumCuller culler(1);
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        culler.cullBoxes(benchFrustum, benchBoxBounds, benchVisible);
+        doNotOptimize(benchVisible.data());
+    }
+}
+
+BENCH(Cull, BoxesThreaded, CULL_OBJECT_COUNT) {
+    initCullScene();
+    static FrustumCuller culler;
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        culler.cullBoxes(benchFrustum, benchBoxBounds, benchVisible);
+        doNotOptimize(benchVisible.data());
+    }
+}
+
+BENCH(Cull, SpheresSimd, CULL_OBJECT_COUNT) {
+    initCullScene();
+    static FrustumCuller culler(1);
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        culler.cullSpheres(benchFrustum, benchSphereBounds, benchVisible);
+        doNotOptimize(benchVisible.data());
+    }
+}
@@ -0,0 +1,132 @@
+#include <condition_variable>
+#include <iomanip>
+#include <sstream>
+#include <chrono>
+#include <thread>
+#include <deque>
+#include <mutex>
+#include "Bench.h"
+
+// AppWindow's frame pipelining at 1, 2 and 3 frames in flight, against a simulated GPU thread
+// that works through submitted frames in order. The CPU records for 2ms, the GPU takes 3ms per
+// frame, both sleep so the numbers hold on a single core. Like AppWindow, a frame first waits
+// on the fence of the frame that last used its slot, and latency runs from a frame's start
+// until its fence is seen signaled. Items are frames, the FPS and average latency are printed
+// under each case. A real driver adds its own queueing on top, these only show what the fences
+// allow.
+
+static constexpr size_t PACING_FRAMES = 60;
+static constexpr std::chrono::microseconds PACING_CPU_TIME ( 2000 );
+static constexpr std::chrono::microseconds PACING_GPU_TIME ( 3000 );
+
+using pacingClock = std::chrono::steady_clock;
+
+class SimulatedGpu {
+
+    private:
+        std::thread thread;
+        std::condition_variable cv{};
+        std::mutex mtx{};
+        std::deque<uint64_t> queue{};
+        uint64_t completed = 0; // frames done, they finish in order
+        bool isRunning = true;
+
+        void run ( ) {
+            std::unique_lock<std::mutex> lock(this->mtx);
+
+            while ( true ) {
+                this->cv.wait(lock, [&]() { return !this->isRunning || !this->queue.empty(); });
+
+                if ( this->queue.empty() ) {
+                    return;
+                }
+
+                uint64_t frame = this->queue.front();
+                this->queue.pop_front();
+
+                lock.unlock();
+                std::this_thread::sleep_for(PACING_GPU_TIME);
+                lock.lock();
+
+                this->completed = frame + 1;
+                this->cv.notify_all();
+            }
+        }
+
+    public:
+        SimulatedGpu ( ) : thread(&SimulatedGpu::run, this) { }
+
+        ~SimulatedGpu ( ) {
+            {
+                std::lock_guard<std::mutex> lock(this->mtx);
+                this->isRunning = false;
+            }
+
+            this->cv.notify_all();
+            this->thread.join();
+        }
+
+        void submit ( uint64_t frame ) {
+            std::lock_guard<std::mutex> lock(this->mtx);
+            this->queue.push_back(frame);
+            this->cv.notify_all();
+        }
+
+        // The fence wait.
+        void waitFor ( uint64_t frame ) {
+            std::unique_lock<std::mutex> lock(this->mtx);
+            this->cv.wait(lock, [&]() { return this->completed > frame; });
+        }
+
+};
+
+static void runFrames ( int framesInFlight, size_t iterations ) {
+    double seconds = 0, latencyMs = 0;
+    size_t latencySamples = 0;
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        SimulatedGpu gpu;
+        pacingClock::time_point frameStarts[3]{};
+        pacingClock::time_point start = pacingClock::now();
+
+        for ( uint64_t frame = 0; frame < PACING_FRAMES + framesInFlight; ++frame ) {
+            int slot = static_cast<int>(frame % framesInFlight);
+
+            // the frame that last used the slot, the tail only drains the pipeline.
+            if ( frame >= static_cast<uint64_t>(framesInFlight) ) {
+                gpu.waitFor(frame - framesInFlight);
+                latencyMs += std::chrono::duration<double, std::milli>(pacingClock::now() - frameStarts[slot]).count();
+                latencySamples++;
+            }
+
+            if ( frame >= PACING_FRAMES ) {
+                continue;
+            }
+
+            frameStarts[slot] = pacingClock::now();
+            std::this_thread::sleep_for(PACING_CPU_TIME);
+            gpu.submit(frame);
+        }
+
+        seconds += std::chrono::duration<double>(pacingClock::now() - start).count();
+    }
+
+    if ( iterations > 0 ) {
+        std::ostringstream note;
+        note << std::fixed << std::setprecision(1) << (PACING_FRAMES * iterations / seconds) << " FPS, "
+            << (latencyMs / latencySamples) << "ms latency";
+        getBenchNote() = note.str();
+    }
+}
+
+BENCH(FramePacing, frames_in_flight_1, PACING_FRAMES) {
+    runFrames(1, iterations);
+}
+
+BENCH(FramePacing, frames_in_flight_2, PACING_FRAMES) {
+    runFrames(2, iterations);
+}
+
+BENCH(FramePacing, frames_in_flight_3, PACING_FRAMES) {
+    runFrames(3, iterations);
+}
@@ -0,0 +1,134 @@
+#include <vector>
+#include <string>
+#include <stdlib.h>
+#include "renderer/GameRenderer.h"
+#include <GLFW/glfw3.h>
+#include "Bench.h"
+
+// GameRenderer submission of 10k props spread over 8 meshes, one draw per packet against
+// automatic instancing. GL runs against a null driver whose entry points only count calls,
+// so the difference is the renderer's own per-draw cost, the real driver's comes on top.
+// Each iteration records, sorts and submits. The draw calls and other GL calls (binds and
+// uploads) the null driver saw per frame are printed under each case, drawn individually that
+// is 10000 draws, instanced 41.
+
+static constexpr size_t PROP_COUNT = 10000;
+static constexpr GLuint PROP_MESHES = 8;
+
+static size_t nullDrawCalls = 0;
+static size_t nullGlCalls = 0;
+
+// GLFW entry points the renderer links against, no context means no buffer storage.
+extern "C" {
+    GLFWglproc glfwGetProcAddress ( const char* ) { return nullptr; }
+    int glfwExtensionSupported ( const char* ) { return GLFW_FALSE; }
+    void glfwSwapInterval ( int ) { }
+}
+
+static void APIENTRY nullUseProgram ( GLuint ) { nullGlCalls++; }
+static void APIENTRY nullBindVertexArray ( GLuint ) { nullGlCalls++; }
+static void APIENTRY nullActiveTexture ( GLenum ) { nullGlCalls++; }
+static void APIENTRY nullBindTexture ( GLenum, GLuint ) { nullGlCalls++; }
+static void APIENTRY nullBindBuffer ( GLenum, GLuint ) { nullGlCalls++; }
+static void APIENTRY nullBindBufferRange ( GLenum, GLuint, GLuint, GLintptr, GLsizeiptr ) { nullGlCalls++; }
+static void APIENTRY nullBufferData ( GLenum, GLsizeiptr, const void*, GLenum ) { nullGlCalls++; }
+static void APIENTRY nullBufferSubData ( GLenum, GLintptr, GLsizeiptr, const void* ) { nullGlCalls++; }
+static void APIENTRY nullGenBuffers ( GLsizei count, GLuint* buffers ) { for ( GLsizei i = 0; i < count; ++i ) { buffers[i] = 1; } }
+static void APIENTRY nullDeleteBuffers ( GLsizei, const GLuint* ) { }
+static GLenum APIENTRY nullGetError ( ) { return GL_NO_ERROR; }
+static void APIENTRY nullGetIntegerv ( GLenum, GLint* data ) { *data = 256; }
+static GLint APIENTRY nullGetUniformLocation ( GLuint, const GLchar* ) { return 0; }
+static GLuint APIENTRY nullGetUniformBlockIndex ( GLuint, const GLchar* ) { return 0; }
+static void APIENTRY nullUniformBlockBinding ( GLuint, GLuint, GLuint ) { }
+static void APIENTRY nullUniformMatrix4fv ( GLint, GLsizei, GLboolean, const GLfloat* ) { nullGlCalls++; }
+static void APIENTRY nullDrawArraysInstanced ( GLenum, GLint, GLsizei, GLsizei ) { nullDrawCalls++; }
+static void APIENTRY nullDrawElementsInstanced ( GLenum, GLsizei, GLenum, const void*, GLsizei ) { nullDrawCalls++; }
+
+static void loadNullDriver ( ) {
+    glad_glUseProgram = nullUseProgram;
+    glad_glBindVertexArray = nullBindVertexArray;
+    glad_glActiveTexture = nullActiveTexture;
+    glad_glBindTexture = nullBindTexture;
+    glad_glBindBuffer = nullBindBuffer;
+    glad_glBindBufferRange = nullBindBufferRange;
+    glad_glBufferData = nullBufferData;
+    glad_glBufferSubData = nullBufferSubData;
+    glad_glGenBuffers = nullGenBuffers;
+    glad_glDeleteBuffers = nullDeleteBuffers;
+    glad_glGetError = nullGetError;
+    glad_glGetIntegerv = nullGetIntegerv;
+    glad_glGetUniformLocation = nullGetUniformLocation;
+    glad_glGetUniformBlockIndex = nullGetUniformBlockIndex;
+    glad_glUniformBlockBinding = nullUniformBlockBinding;
+    glad_glUniformMatrix4fv = nullUniformMatrix4fv;
+    glad_glDrawArraysInstanced = nullDrawArraysInstanced;
+    glad_glDrawElementsInstanced = nullDrawElementsInstanced;
+}
+
+struct InstancingScene {
+    std::vector<uint64_t> keys;
+    std::vector<DrawPacket> packets;
+    GlStateCache state;
+    StreamBuffer stream;
+    Camera camera;
+};
+
+static InstancingScene& getScene ( ) {
+    static InstancingScene* scene = []() {
+        InstancingScene* out = new InstancingScene();
+        srand(1); // the same props whichever cases ran before
+
+        for ( size_t i = 0; i < PROP_COUNT; ++i ) {
+            DrawPacket packet{};
+            GLuint mesh = static_cast<GLuint>(rand() % PROP_MESHES);
+            packet.program = 1;
+            packet.vertexArray = mesh + 1;
+            packet.texture = mesh + 1;
+            packet.indexType = GL_UNSIGNED_SHORT;
+            packet.count = 36;
+            packet.model.M[12] = static_cast<float>(rand() % 1000);
+            out->keys.push_back(makeOpaqueSortKey(0, 1, mesh, rand() & SORT_KEY_DEPTH_MAX));
+            out->packets.push_back(packet);
+        }
+
+        out->stream.init(3);
+        return out;
+    }();
+
+    return *scene;
+}
+
+static void submitProps ( GameRenderer& renderer, size_t iterations ) {
+    // other benches point the shared entry points at their own driver.
+    loadNullDriver();
+    InstancingScene& scene = getScene();
+    size_t drawCalls = nullDrawCalls, glCalls = nullGlCalls;
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        scene.stream.beginFrame(static_cast<int>(it % 3));
+        CommandBuffer& buffer = renderer.getQueue().getCommandBuffer();
+
+        for ( size_t i = 0; i < PROP_COUNT; ++i ) {
+            buffer.draw(scene.keys[i], scene.packets[i]);
+        }
+
+        renderer.render(scene.camera, scene.state, scene.stream);
+        doNotOptimize(renderer.getStats().drawCalls);
+    }
+
+    if ( iterations > 0 ) {
+        getBenchNote() = std::to_string((nullDrawCalls - drawCalls) / iterations) + " draw calls, "
+            + std::to_string((nullGlCalls - glCalls) / iterations) + " other GL calls per frame";
+    }
+}
+
+BENCH(Instancing, submit_individual, PROP_COUNT) {
+    static GameRenderer renderer(1);
+    renderer.setAutoInstancing(false);
+    submitProps(renderer, iterations);
+}
+
+BENCH(Instancing, submit_instanced, PROP_COUNT) {
+    static GameRenderer renderer(1);
+    submitProps(renderer, iterations);
+}
@@ -0,0 +1,104 @@
+#include <vector>
+#include <stdlib.h>
+#include "util/Kernels.h"
+#include "Bench.h"
+
+// Runs each dispatched kernel through the baseline table and the AVX2 table, the AVX2 cases
+// fall back to baseline when the compiler or the CPU can't run them.
+
+static constexpr size_t KERNEL_COUNT = 1 << 16;
+
+static float randomUnit ( ) {
+    return static_cast<float>(rand()) / RAND_MAX * 2.0F - 1.0F;
+}
+
+static std::vector<Vector3f> makeVectors ( ) {
+    std::vector<Vector3f> vectors(KERNEL_COUNT);
+    for ( auto& vec : vectors ) { vec = Vector3f(randomUnit(), randomUnit(), randomUnit()) * 50.0F; }
+    return vectors;
+}
+
+static std::vector<uint32_t> makePixels ( ) {
+    std::vector<uint32_t> pixels(KERNEL_COUNT);
+    for ( auto& pixel : pixels ) { pixel = (static_cast<uint32_t>(rand()) << 16) ^ static_cast<uint32_t>(rand()); }
+    return pixels;
+}
+
+static std::vector<Vector3f> kernelVecIn = makeVectors();
+static std::vector<Vector3f> kernelVecOut = makeVectors();
+static std::vector<float> kernelDistances(KERNEL_COUNT);
+static std::vector<uint32_t> kernelPixels = makePixels();
+static std::vector<uint32_t> kernelPixelsOut(KERNEL_COUNT);
+static std::vector<Color4f> kernelColors(KERNEL_COUNT);
+static std::vector<Color4f> kernelColorsOut(KERNEL_COUNT);
+static std::vector<Snorm16x4> kernelSnormPositions(KERNEL_COUNT);
+static std::vector<Half4> kernelHalfPositions(KERNEL_COUNT);
+static std::vector<Snorm16x2> kernelOctNormals(KERNEL_COUNT);
+
+static const Kernels& getAVX2OrBaseline ( ) {
+    const Kernels* avx2 = getAVX2Kernels();
+    const CpuFeatures& features = getCpuFeatures();
+    return avx2 != nullptr && features.avx2 && features.fma ? *avx2 : getBaselineKernels();
+}
+
+#define KERNEL_BENCH(name, table, call)                                     \
+    BENCH(Kernels, name, KERNEL_COUNT) {                                    \
+        const Kernels& k = table;                                           \
+        for ( size_t it = 0; it < iterations; ++it ) {                      \
+            call;                                                           \
+            doNotOptimize(it);                                              \
+        }                                                                   \
+    }
+
+KERNEL_BENCH(normalize3f_baseline, getBaselineKernels(), k.normalizeArray3f(kernelVecOut.data(), kernelVecIn.data(), KERNEL_COUNT))
+KERNEL_BENCH(normalize3f_avx2, getAVX2OrBaseline(), k.normalizeArray3f(kernelVecOut.data(), kernelVecIn.data(), KERNEL_COUNT))
+
+KERNEL_BENCH(normalizeFast3f_baseline, getBaselineKernels(), k.normalizeArrayFast3f(kernelVecOut.data(), kernelVecIn.data(), KERNEL_COUNT))
+KERNEL_BENCH(normalizeFast3f_avx2, getAVX2OrBaseline(), k.normalizeArrayFast3f(kernelVecOut.data(), kernelVecIn.data(), KERNEL_COUNT))
+
+KERNEL_BENCH(distance3f_baseline, getBaselineKernels(),
+    k.distanceArrays3f(kernelDistances.data(), kernelVecIn.data(), kernelVecOut.data(), KERNEL_COUNT))
+KERNEL_BENCH(distanceFast3f_baseline, getBaselineKernels(),
+    k.distanceArraysFast3f(kernelDistances.data(), kernelVecIn.data(), kernelVecOut.data(), KERNEL_COUNT))
+KERNEL_BENCH(distanceFast3f_avx2, getAVX2OrBaseline(),
+    k.distanceArraysFast3f(kernelDistances.data(), kernelVecIn.data(), kernelVecOut.data(), KERNEL_COUNT))
+
+KERNEL_BENCH(transform3f_baseline, getBaselineKernels(),
+    k.transformArray3f(kernelVecOut.data(), kernelVecIn.data(), Vector3f(2, 3, 4), Vector3f(1, 0, -1), KERNEL_COUNT))
+KERNEL_BENCH(transform3f_avx2, getAVX2OrBaseline(),
+    k.transformArray3f(kernelVecOut.data(), kernelVecIn.data(), Vector3f(2, 3, 4), Vector3f(1, 0, -1), KERNEL_COUNT))
+
+KERNEL_BENCH(unpackARGB_baseline, getBaselineKernels(), k.unpackARGBArray(kernelColors.data(), kernelPixels.data(), KERNEL_COUNT))
+KERNEL_BENCH(unpackARGB_avx2, getAVX2OrBaseline(), k.unpackARGBArray(kernelColors.data(), kernelPixels.data(), KERNEL_COUNT))
+
+KERNEL_BENCH(packARGB_baseline, getBaselineKernels(), k.packARGBArray(kernelPixelsOut.data(), kernelColors.data(), KERNEL_COUNT))
+KERNEL_BENCH(packARGB_avx2, getAVX2OrBaseline(), k.packARGBArray(kernelPixelsOut.data(), kernelColors.data(), KERNEL_COUNT))
+
+KERNEL_BENCH(unpackSrgbARGB_baseline, getBaselineKernels(), k.unpackSrgbARGBArray(kernelColors.data(), kernelPixels.data(), KERNEL_COUNT))
+KERNEL_BENCH(unpackSrgbARGB_avx2, getAVX2OrBaseline(), k.unpackSrgbARGBArray(kernelColors.data(), kernelPixels.data(), KERNEL_COUNT))
+
+KERNEL_BENCH(packSrgbARGB_baseline, getBaselineKernels(), k.packSrgbARGBArray(kernelPixelsOut.data(), kernelColors.data(), KERNEL_COUNT))
+KERNEL_BENCH(packSrgbARGB_avx2, getAVX2OrBaseline(), k.packSrgbARGBArray(kernelPixelsOut.data(), kernelColors.data(), KERNEL_COUNT))
+
+KERNEL_BENCH(premultiply_baseline, getBaselineKernels(), k.premultiplyAlphaArray(kernelColorsOut.data(), kernelColors.data(), KERNEL_COUNT))
+KERNEL_BENCH(premultiply_avx2, getAVX2OrBaseline(), k.premultiplyAlphaArray(kernelColorsOut.data(), kernelColors.data(), KERNEL_COUNT))
+
+static const PositionQuantization kernelQuant = PositionQuantization::FromBounds(Aabb3f(Vector3f(-50, -50, -50), Vector3f(50, 50, 50)));
+
+KERNEL_BENCH(encodeHalfPositions_baseline, getBaselineKernels(),
+    k.encodeHalfPositions(kernelHalfPositions.data(), kernelVecIn.data(), KERNEL_COUNT, kernelQuant))
+KERNEL_BENCH(encodeHalfPositions_avx2, getAVX2OrBaseline(),
+    k.encodeHalfPositions(kernelHalfPositions.data(), kernelVecIn.data(), KERNEL_COUNT, kernelQuant))
+
+KERNEL_BENCH(encodeSnormPositions_baseline, getBaselineKernels(),
+    k.encodeSnormPositions(kernelSnormPositions.data(), kernelVecIn.data(), KERNEL_COUNT, kernelQuant))
+KERNEL_BENCH(encodeSnormPositions_avx2, getAVX2OrBaseline(),
+    k.encodeSnormPositions(kernelSnormPositions.data(), kernelVecIn.data(), KERNEL_COUNT, kernelQuant))
+
+KERNEL_BENCH(encodeOctNormals_baseline, getBaselineKernels(), k.encodeOctNormals(kernelOctNormals.data(), kernelVecIn.data(), KERNEL_COUNT))
+KERNEL_BENCH(encodeOctNormals_avx2, getAVX2OrBaseline(), k.encodeOctNormals(kernelOctNormals.data(), kernelVecIn.data(), KERNEL_COUNT))
+
+KERNEL_BENCH(decodeOctNormals_baseline, getBaselineKernels(), k.decodeOctNormals(kernelVecOut.data(), kernelOctNormals.data(), KERNEL_COUNT))
+KERNEL_BENCH(decodeOctNormals_avx2, getAVX2OrBaseline(), k.decodeOctNormals(kernelVecOut.data(), kernelOctNormals.data(), KERNEL_COUNT))
+
+#undef KERNEL_BENCH
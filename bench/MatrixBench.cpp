@@ -0,0 +1,85 @@
+#include <vector>
+#include "util/math/Matrix4f.h"
+#include "renderer/Camera.h"
+#include "Bench.h"
+
+static constexpr size_t MATRIX_COUNT = 1024;
+
+static std::vector<Matrix4f> makeMatrices ( ) {
+    std::vector<Matrix4f> matrices(MATRIX_COUNT);
+
+    for ( size_t i = 0; i < MATRIX_COUNT; ++i ) {
+        float f = static_cast<float>(i);
+        matrices[i] = Matrix4f::TRS(Vector3f(f, -f, f * 0.5F),
+            Quaternion::FromEuler(f * 0.01F, f * 0.02F, f * 0.03F), Vector3f(1.5F, 1.5F, 1.5F));
+    }
+
+    return matrices;
+}
+
+static std::vector<Matrix4f> matricesA = makeMatrices();
+static std::vector<Matrix4f> matricesOut(MATRIX_COUNT);
+
+// Reference for the SIMD operator*, the textbook triple loop.
+static Matrix4f multiplyScalar ( const Matrix4f& a, const Matrix4f& b ) {
+    Matrix4f mat;
+    for ( int column = 0; column < 4; ++column ) {
+        for ( int row = 0; row < 4; ++row ) {
+            float sum = 0;
+            for ( int k = 0; k < 4; ++k ) { sum += a.Get(row, k) * b.Get(k, column); }
+            mat.Set(row, column, sum);
+        }
+    }
+    return mat;
+}
+
+BENCH(Matrix4f, multiply_scalar, MATRIX_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < MATRIX_COUNT; ++i ) {
+            matricesOut[i] = multiplyScalar(matricesA[i], matricesA[MATRIX_COUNT - 1 - i]);
+        }
+        doNotOptimize(matricesOut[0]);
+    }
+}
+
+BENCH(Matrix4f, multiply_simd, MATRIX_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < MATRIX_COUNT; ++i ) {
+            matricesOut[i] = matricesA[i] * matricesA[MATRIX_COUNT - 1 - i];
+        }
+        doNotOptimize(matricesOut[0]);
+    }
+}
+
+BENCH(Matrix4f, inverse, MATRIX_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < MATRIX_COUNT; ++i ) { matricesOut[i] = matricesA[i].Inverse(); }
+        doNotOptimize(matricesOut[0]);
+    }
+}
+
+BENCH(Matrix4f, inverse_affine, MATRIX_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < MATRIX_COUNT; ++i ) { matricesOut[i] = matricesA[i].InverseAffine(); }
+        doNotOptimize(matricesOut[0]);
+    }
+}
+
+BENCH(Camera, view_projection_cached, 1) {
+    Camera camera(Vector3f(1, 2, 3), Quaternion::FromEuler(0.1F, 0.2F, 0));
+    camera.setViewport(1920, 1080);
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        doNotOptimize(camera.getViewProjection());
+    }
+}
+
+BENCH(Camera, view_projection_moving, 1) {
+    Camera camera(Vector3f(1, 2, 3), Quaternion::FromEuler(0.1F, 0.2F, 0));
+    camera.setViewport(1920, 1080);
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        camera.setPos(Vector3f(static_cast<float>(it & 1023), 2, 3));
+        doNotOptimize(camera.getViewProjection());
+    }
+}
@@ -0,0 +1,164 @@
+#include <vector>
+#include <stdlib.h>
+#include "util/spatial/MortonChunk.h"
+#include "util/Kernels.h"
+#include "Bench.h"
+
+// Morton encode / decode, then 3x3x3 neighborhood sums over a 256^3 byte grid (16 MB) stored
+// linearly (x + y * 256 + z * 256^2) against the same grid in Morton order.
+// Random cases visit scattered cells, sweep cases every interior cell of a 128^3 corner in
+// storage order. Items are codes or visited cells. A random 3x3x3 block touches 9.2 cache lines
+// on average stored linearly and 3.4 in Morton order, whether that pays for the index math
+// depends on how far out of cache the grid is.
+
+static constexpr size_t MORTON_COUNT = 1 << 16;
+static constexpr int GRID_LOG2 = 8;
+static constexpr int GRID_SIZE = 1 << GRID_LOG2;
+static constexpr int SWEEP_SIZE = 128;
+static constexpr size_t SWEEP_CELLS = static_cast<size_t>(SWEEP_SIZE - 2) * (SWEEP_SIZE - 2) * (SWEEP_SIZE - 2);
+
+typedef MortonChunk<uint8_t, GRID_LOG2> MortonGrid;
+
+static std::vector<Vector3i> makeCells ( int min, int max ) {
+    std::vector<Vector3i> cells(MORTON_COUNT);
+    for ( auto& cell : cells ) { cell = Vector3i(min + rand() % (max - min), min + rand() % (max - min), min + rand() % (max - min)); }
+    return cells;
+}
+
+static std::vector<Vector3i> mortonCells = makeCells(0, 1 << 21);
+static std::vector<Vector3i> mortonCellsOut(MORTON_COUNT);
+static std::vector<uint64_t> mortonCodes = []() {
+    std::vector<uint64_t> codes(MORTON_COUNT);
+    encodeMorton3Array(codes.data(), mortonCells.data(), MORTON_COUNT);
+    return codes;
+}();
+static std::vector<uint64_t> mortonCodesOut(MORTON_COUNT);
+
+struct NeighborGrids {
+    std::vector<uint8_t> linear;
+    MortonGrid morton;
+    std::vector<Vector3i> probes; // interior cells, all 26 neighbors exist
+};
+
+static const NeighborGrids& getGrids ( ) {
+    static NeighborGrids grids = []() -> NeighborGrids {
+        NeighborGrids out{ std::vector<uint8_t>(MortonGrid::VOLUME), MortonGrid(), makeCells(1, GRID_SIZE - 1) };
+
+        for ( int z = 0; z < GRID_SIZE; ++z ) {
+            for ( int y = 0; y < GRID_SIZE; ++y ) {
+                for ( int x = 0; x < GRID_SIZE; ++x ) {
+                    uint8_t val = static_cast<uint8_t>(x * 7 + y * 13 + z * 29);
+                    out.linear[x + y * GRID_SIZE + z * GRID_SIZE * GRID_SIZE] = val;
+                    out.morton.at(Vector3i(x, y, z)) = val;
+                }
+            }
+        }
+
+        return out;
+    }();
+
+    return grids;
+}
+
+static inline uint32_t sumLinear ( const uint8_t* grid, const Vector3i& cell ) {
+    uint32_t sum = 0;
+    for ( int dz = -1; dz <= 1; ++dz ) {
+        for ( int dy = -1; dy <= 1; ++dy ) {
+            const uint8_t* row = grid + (cell.X - 1) + (cell.Y + dy) * GRID_SIZE + (cell.Z + dz) * GRID_SIZE * GRID_SIZE;
+            sum += row[0] + row[1] + row[2];
+        }
+    }
+    return sum;
+}
+
+static inline uint32_t sumMorton ( const MortonGrid& grid, const Vector3i& cell ) {
+    uint64_t indices[27];
+    MortonGrid::getNeighborhood(cell, indices);
+    uint32_t sum = 0;
+    for ( int i = 0; i < 27; ++i ) { sum += grid[indices[i]]; }
+    return sum;
+}
+
+BENCH(Morton, encode_bittwiddle, MORTON_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < MORTON_COUNT; ++i ) {
+            const Vector3i& cell = mortonCells[i];
+            mortonCodesOut[i] = mortonSpread3(cell.X) | (mortonSpread3(cell.Y) << 1) | (mortonSpread3(cell.Z) << 2);
+        }
+        doNotOptimize(mortonCodesOut[0]);
+    }
+}
+
+BENCH(Morton, encode_baseline, MORTON_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        getBaselineKernels().encodeMorton3Array(mortonCodesOut.data(), mortonCells.data(), MORTON_COUNT);
+        doNotOptimize(mortonCodesOut[0]);
+    }
+}
+
+BENCH(Morton, encode_dispatched, MORTON_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        kernels.encodeMorton3Array(mortonCodesOut.data(), mortonCells.data(), MORTON_COUNT);
+        doNotOptimize(mortonCodesOut[0]);
+    }
+}
+
+BENCH(Morton, decode_baseline, MORTON_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        getBaselineKernels().decodeMorton3Array(mortonCellsOut.data(), mortonCodes.data(), MORTON_COUNT);
+        doNotOptimize(mortonCellsOut[0]);
+    }
+}
+
+BENCH(Morton, decode_dispatched, MORTON_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        kernels.decodeMorton3Array(mortonCellsOut.data(), mortonCodes.data(), MORTON_COUNT);
+        doNotOptimize(mortonCellsOut[0]);
+    }
+}
+
+BENCH(Neighborhood, random_linear, MORTON_COUNT) {
+    const NeighborGrids& grids = getGrids();
+    for ( size_t it = 0; it < iterations; ++it ) {
+        uint32_t total = 0;
+        for ( const Vector3i& cell : grids.probes ) { total += sumLinear(grids.linear.data(), cell); }
+        doNotOptimize(total);
+    }
+}
+
+BENCH(Neighborhood, random_morton, MORTON_COUNT) {
+    const NeighborGrids& grids = getGrids();
+    for ( size_t it = 0; it < iterations; ++it ) {
+        uint32_t total = 0;
+        for ( const Vector3i& cell : grids.probes ) { total += sumMorton(grids.morton, cell); }
+        doNotOptimize(total);
+    }
+}
+
+BENCH(Neighborhood, sweep_linear, SWEEP_CELLS) {
+    const NeighborGrids& grids = getGrids();
+    for ( size_t it = 0; it < iterations; ++it ) {
+        uint32_t total = 0;
+        for ( int z = 1; z < SWEEP_SIZE - 1; ++z ) {
+            for ( int y = 1; y < SWEEP_SIZE - 1; ++y ) {
+                for ( int x = 1; x < SWEEP_SIZE - 1; ++x ) { total += sumLinear(grids.linear.data(), Vector3i(x, y, z)); }
+            }
+        }
+        doNotOptimize(total);
+    }
+}
+
+// The 128^3 corner is a contiguous Morton range, walked in code order.
+BENCH(Neighborhood, sweep_morton, SWEEP_CELLS) {
+    const NeighborGrids& grids = getGrids();
+    for ( size_t it = 0; it < iterations; ++it ) {
+        uint32_t total = 0;
+        for ( uint64_t index = 0; index < static_cast<uint64_t>(SWEEP_SIZE) * SWEEP_SIZE * SWEEP_SIZE; ++index ) {
+            Vector3i cell = MortonGrid::getLocal(index);
+            if ( MortonGrid::isInside(cell - Vector3i(1, 1, 1)) && cell.X < SWEEP_SIZE - 1 && cell.Y < SWEEP_SIZE - 1 && cell.Z < SWEEP_SIZE - 1 ) {
+                total += sumMorton(grids.morton, cell);
+            }
+        }
+        doNotOptimize(total);
+    }
+}
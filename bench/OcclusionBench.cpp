@@ -0,0 +1,87 @@
+#include <vector>
+#include <stdlib.h>
+#include "renderer/OcclusionCuller.h"
+#include "renderer/Camera.h"
+#include "Bench.h"
+
+// A street of 32 building sized boxes drawn as occluders, then 64k small objects behind and
+// between them tested against the pyramid. Occluder items are occluders, cull items are boxes.
+
+static constexpr size_t OCCLUSION_OCCLUDER_COUNT = 32;
+static constexpr size_t OCCLUSION_OBJECT_COUNT = 64 * 1024;
+
+static float randomRange ( float min, float max ) {
+    return min + static_cast<float>(rand()) / RAND_MAX * (max - min);
+}
+
+static Matrix4f makeViewProjection ( ) {
+    Camera camera(Vector3f(0, 2, 20), Quaternion());
+    camera.lookAt(Vector3f(0, 2, 0));
+    camera.setPerspective(1.22173F, 0.1F, 500.0F);
+    return camera.getViewProjection();
+}
+
+static const Matrix4f benchViewProjection = makeViewProjection();
+static std::vector<Aabb3f> benchOccluders{};
+static BoxBounds benchObjectBounds{};
+static std::vector<uint32_t> benchCandidates{};
+
+static void initOcclusionScene ( ) {
+    if ( !benchOccluders.empty() ) {
+        return;
+    }
+
+    srand(49);
+
+    for ( size_t i = 0; i < OCCLUSION_OCCLUDER_COUNT; ++i ) {
+        float side = i % 2 ? 1.0F : -1.0F;
+        Vector3f center(side * randomRange(2, 12), randomRange(4, 10), -static_cast<float>(i / 2) * 12.0F);
+        Vector3f extent(randomRange(3, 6), center.Y, randomRange(3, 5));
+        benchOccluders.push_back(Aabb3f(center - extent, center + extent));
+    }
+
+    benchObjectBounds.resize(OCCLUSION_OBJECT_COUNT);
+
+    for ( size_t i = 0; i < OCCLUSION_OBJECT_COUNT; ++i ) {
+        Vector3f center(randomRange(-30, 30), randomRange(0, 8), randomRange(-200, 0));
+        Vector3f extent(randomRange(0.2F, 1.5F), randomRange(0.2F, 1.5F), randomRange(0.2F, 1.5F));
+        benchObjectBounds.set(i, Aabb3f(center - extent, center + extent));
+    }
+}
+
+BENCH(Occlusion, DrawOccluders, OCCLUSION_OCCLUDER_COUNT) {
+    initOcclusionScene();
+    static OcclusionCuller culler;
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        culler.beginFrame(benchViewProjection);
+
+        for ( const Aabb3f& occluder : benchOccluders ) {
+            culler.drawOccluder(occluder);
+        }
+
+        doNotOptimize(culler.getDepth(0, 0, 0));
+    }
+}
+
+BENCH(Occlusion, CullBoxes, OCCLUSION_OBJECT_COUNT) {
+    initOcclusionScene();
+    static OcclusionCuller culler;
+
+    culler.beginFrame(benchViewProjection);
+
+    for ( const Aabb3f& occluder : benchOccluders ) {
+        culler.drawOccluder(occluder);
+    }
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        benchCandidates.resize(OCCLUSION_OBJECT_COUNT);
+
+        for ( size_t i = 0; i < OCCLUSION_OBJECT_COUNT; ++i ) {
+            benchCandidates[i] = static_cast<uint32_t>(i);
+        }
+
+        culler.cullBoxes(benchObjectBounds, benchCandidates);
+        doNotOptimize(benchCandidates.data());
+    }
+}
@@ -0,0 +1,85 @@
+#include <vector>
+#include <stdlib.h>
+#include "util/math/TriangleStream.h"
+#include "Bench.h"
+
+// Items are ray/triangle tests.
+
+static constexpr size_t TRIANGLE_COUNT = 1024;
+static constexpr size_t RAY_COUNT = 64;
+
+static float randomSigned ( ) {
+    return static_cast<float>(rand()) / RAND_MAX * 2.0F - 1.0F;
+}
+
+static std::vector<Triangle3d> makeTriangles ( ) {
+    std::vector<Triangle3d> tris;
+
+    for ( size_t i = 0; i < TRIANGLE_COUNT; ++i ) {
+        Vector3f center(randomSigned() * 20, randomSigned() * 20, randomSigned() * 20 + 40);
+        tris.push_back(Triangle3d(center + Vector3f(randomSigned(), randomSigned(), randomSigned()),
+            center + Vector3f(randomSigned(), randomSigned(), randomSigned()),
+            center + Vector3f(randomSigned(), randomSigned(), randomSigned()), Vector3f()));
+    }
+
+    return tris;
+}
+
+static std::vector<Ray3f> makeRays ( ) {
+    std::vector<Ray3f> rays;
+
+    for ( size_t i = 0; i < RAY_COUNT; ++i ) {
+        rays.push_back(Ray3f(Vector3f(), Vector3f(randomSigned() * 0.5F, randomSigned() * 0.5F, 1)));
+    }
+
+    return rays;
+}
+
+static std::vector<Triangle3d> benchTriangles = makeTriangles();
+static std::vector<Ray3f> benchRays = makeRays();
+static std::vector<RayHit> benchHits(RAY_COUNT);
+static TriangleStream benchStream(benchTriangles.data(), TRIANGLE_COUNT);
+
+BENCH(Ray, nearest_scalar, TRIANGLE_COUNT * RAY_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t r = 0; r < RAY_COUNT; ++r ) {
+            RayHit hit;
+            float t, u, v;
+
+            for ( size_t i = 0; i < TRIANGLE_COUNT; ++i ) {
+                if ( benchTriangles[i].Intersect(benchRays[r], 0, hit.T, t, u, v) ) {
+                    hit.T = t; hit.U = u; hit.V = v; hit.Index = static_cast<int>(i);
+                }
+            }
+
+            benchHits[r] = hit;
+        }
+        doNotOptimize(benchHits[0]);
+    }
+}
+
+BENCH(Ray, nearest_ray_vs_packet, TRIANGLE_COUNT * RAY_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t r = 0; r < RAY_COUNT; ++r ) {
+            benchStream.intersect(benchRays[r], benchHits[r]);
+        }
+        doNotOptimize(benchHits[0]);
+    }
+}
+
+BENCH(Ray, nearest_packet_vs_triangle, TRIANGLE_COUNT * RAY_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        benchStream.intersect(benchRays.data(), benchHits.data(), RAY_COUNT);
+        doNotOptimize(benchHits[0]);
+    }
+}
+
+BENCH(Ray, any_ray_vs_packet, TRIANGLE_COUNT * RAY_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        bool anyHit = false;
+        for ( size_t r = 0; r < RAY_COUNT; ++r ) {
+            anyHit |= benchStream.intersectAny(benchRays[r]);
+        }
+        doNotOptimize(anyHit);
+    }
+}
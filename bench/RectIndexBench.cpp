@@ -0,0 +1,155 @@
+#include <vector>
+#include <cmath>
+#include <stdlib.h>
+#include "util/spatial/RectIndex.h"
+#include "Bench.h"
+
+// UI like layouts of 10K, 100K and 1M rects, 8 to 256 pixels wide, over an area that grows
+// with the count so the density stays the same. Sets are built lazily per size.
+// Build cases count rects as items, query cases count queries.
+
+static constexpr size_t RECT_QUERY_COUNT = 4096;
+static constexpr size_t RECT_CHURN_COUNT = 1024;
+
+template<size_t Count>
+static int getLayoutSize ( ) {
+    return static_cast<int>(std::sqrt(static_cast<double>(Count)) * 64);
+}
+
+template<size_t Count>
+static const std::vector<Rect2d>& getLayout ( ) {
+    static std::vector<Rect2d> rects = []() -> std::vector<Rect2d> {
+        std::vector<Rect2d> out(Count);
+        int size = getLayoutSize<Count>();
+        for ( auto& rect : out ) { rect = Rect2d(rand() % size, rand() % size, 8 + rand() % 248, 8 + rand() % 248); }
+        return out;
+    }();
+
+    return rects;
+}
+
+template<size_t Count>
+static const RectIndex& getIndex ( ) {
+    static RectIndex index = []() -> RectIndex {
+        RectIndex out;
+        out.build(getLayout<Count>().data(), Count);
+        return out;
+    }();
+
+    return index;
+}
+
+template<size_t Count>
+static const std::vector<Vector2i>& getQueryPoints ( ) {
+    static std::vector<Vector2i> points = []() -> std::vector<Vector2i> {
+        std::vector<Vector2i> out(RECT_QUERY_COUNT);
+        int size = getLayoutSize<Count>();
+        for ( auto& point : out ) { point = Vector2i(rand() % size, rand() % size); }
+        return out;
+    }();
+
+    return points;
+}
+
+// Window sized queries, roughly what a monitor or a drag selection covers.
+template<size_t Count>
+static const std::vector<Rect2d>& getQueryRects ( ) {
+    static std::vector<Rect2d> rects = []() -> std::vector<Rect2d> {
+        std::vector<Rect2d> out(RECT_QUERY_COUNT);
+        int size = getLayoutSize<Count>();
+        for ( auto& rect : out ) { rect = Rect2d(rand() % size, rand() % size, 64 + rand() % 448, 64 + rand() % 448); }
+        return out;
+    }();
+
+    return rects;
+}
+
+static std::vector<uint32_t> rectHits{}, rectOffsets{};
+static std::vector<uint32_t> rectBest(RECT_QUERY_COUNT);
+
+template<size_t Count>
+static void benchBuild ( size_t iterations ) {
+    RectIndex index;
+    for ( size_t it = 0; it < iterations; ++it ) {
+        index.build(getLayout<Count>().data(), Count);
+        doNotOptimize(index);
+    }
+}
+
+template<size_t Count>
+static void benchPoints ( size_t iterations ) {
+    const RectIndex& index = getIndex<Count>();
+    for ( size_t it = 0; it < iterations; ++it ) {
+        rectHits.clear();
+        index.queryPoints(getQueryPoints<Count>().data(), RECT_QUERY_COUNT, rectHits, rectOffsets);
+        doNotOptimize(rectHits.data());
+    }
+}
+
+template<size_t Count>
+static void benchOverlaps ( size_t iterations ) {
+    const RectIndex& index = getIndex<Count>();
+    for ( size_t it = 0; it < iterations; ++it ) {
+        rectHits.clear();
+        index.queryOverlaps(getQueryRects<Count>().data(), RECT_QUERY_COUNT, rectHits, rectOffsets);
+        doNotOptimize(rectHits.data());
+    }
+}
+
+template<size_t Count>
+static void benchLargest ( size_t iterations ) {
+    const RectIndex& index = getIndex<Count>();
+    for ( size_t it = 0; it < iterations; ++it ) {
+        index.findLargestIntersections(getQueryRects<Count>().data(), RECT_QUERY_COUNT, rectBest.data());
+        doNotOptimize(rectBest[0]);
+    }
+}
+
+// Moves RECT_CHURN_COUNT rects per iteration, items are the moves, rebuilds included.
+template<size_t Count>
+static void benchChurn ( size_t iterations ) {
+    static RectIndex index = []() -> RectIndex {
+        RectIndex out;
+        out.build(getLayout<Count>().data(), Count);
+        return out;
+    }();
+
+    const std::vector<Rect2d>& moves = getQueryRects<Count>();
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < RECT_CHURN_COUNT; ++i ) {
+            uint32_t id = static_cast<uint32_t>((it * RECT_CHURN_COUNT + i) * 7919 % Count);
+            index.update(id, moves[(it + i) % RECT_QUERY_COUNT]);
+        }
+        doNotOptimize(index);
+    }
+}
+
+BENCH(RectIndex, build_10k, 10000) { benchBuild<10000>(iterations); }
+BENCH(RectIndex, build_100k, 100000) { benchBuild<100000>(iterations); }
+BENCH(RectIndex, build_1m, 1000000) { benchBuild<1000000>(iterations); }
+
+BENCH(RectIndex, points_10k, RECT_QUERY_COUNT) { benchPoints<10000>(iterations); }
+BENCH(RectIndex, points_100k, RECT_QUERY_COUNT) { benchPoints<100000>(iterations); }
+BENCH(RectIndex, points_1m, RECT_QUERY_COUNT) { benchPoints<1000000>(iterations); }
+
+BENCH(RectIndex, overlaps_10k, RECT_QUERY_COUNT) { benchOverlaps<10000>(iterations); }
+BENCH(RectIndex, overlaps_100k, RECT_QUERY_COUNT) { benchOverlaps<100000>(iterations); }
+BENCH(RectIndex, overlaps_1m, RECT_QUERY_COUNT) { benchOverlaps<1000000>(iterations); }
+
+BENCH(RectIndex, largest_10k, RECT_QUERY_COUNT) { benchLargest<10000>(iterations); }
+BENCH(RectIndex, largest_100k, RECT_QUERY_COUNT) { benchLargest<100000>(iterations); }
+BENCH(RectIndex, largest_1m, RECT_QUERY_COUNT) { benchLargest<1000000>(iterations); }
+
+BENCH(RectIndex, churn_100k, RECT_CHURN_COUNT) { benchChurn<100000>(iterations); }
+
+// The linear scan AppWindow::getMonitor uses for a handful of monitors, at 10K for scale.
+BENCH(RectIndex, largest_linear_10k, RECT_QUERY_COUNT) {
+    const std::vector<Rect2d>& rects = getLayout<10000>();
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < RECT_QUERY_COUNT; ++i ) {
+            rectBest[i] = findLargestIntersection(rects.data(), rects.size(), getQueryRects<10000>()[i]);
+        }
+        doNotOptimize(rectBest[0]);
+    }
+}
@@ -0,0 +1,202 @@
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <stdlib.h>
+#include "renderer/RenderGraph.h"
+#include "Bench.h"
+
+// A deferred-style graph of 8 passes at 1280x720 against a null driver: lut, gbuffer, lighting,
+// a debug view nothing reads, bloom down and up, tonemap and fxaa to the backbuffer. Running
+// it compiled measures the per-frame walk, resizing every iteration the recompile. Items are
+// passes. The peak target memory without and with aliasing and the targets a resize recreated
+// are printed under each case, the fixed-size lut must survive a resize and the debug pass
+// must be culled or the bench exits.
+
+static constexpr size_t GRAPH_PASSES = 8;
+static constexpr size_t GRAPH_RESIZED_TARGETS = 6; // all but the lut, the debug target is culled
+
+static GLuint graphNextName = 1;
+static size_t graphTexturesCreated = 0;
+
+static void APIENTRY graphGenTextures ( GLsizei count, GLuint* names ) {
+    for ( GLsizei i = 0; i < count; ++i ) {
+        names[i] = graphNextName++;
+    }
+
+    graphTexturesCreated += count;
+}
+
+static void APIENTRY graphGenNames ( GLsizei count, GLuint* names ) { for ( GLsizei i = 0; i < count; ++i ) { names[i] = graphNextName++; } }
+static void APIENTRY graphDeleteNames ( GLsizei, const GLuint* ) { }
+static void APIENTRY graphBind ( GLenum, GLuint ) { }
+static void APIENTRY graphEnum ( GLenum ) { }
+static void APIENTRY graphTexImage2D ( GLenum, GLint, GLint, GLsizei, GLsizei, GLint, GLenum, GLenum, const void* ) { }
+static void APIENTRY graphTexParameteri ( GLenum, GLenum, GLint ) { }
+static void APIENTRY graphFramebufferTexture2D ( GLenum, GLenum, GLenum, GLuint, GLint ) { }
+static void APIENTRY graphDrawBuffers ( GLsizei, const GLenum* ) { }
+static GLenum APIENTRY graphCheckFramebufferStatus ( GLenum ) { return GL_FRAMEBUFFER_COMPLETE; }
+static GLenum APIENTRY graphGetError ( ) { return GL_NO_ERROR; }
+static void APIENTRY graphViewport ( GLint, GLint, GLsizei, GLsizei ) { }
+static void APIENTRY graphBufferData ( GLenum, GLsizeiptr, const void*, GLenum ) { }
+
+// Other benches point the shared entry points at their own driver, so every case loads it.
+static void loadGraphDriver ( ) {
+    glad_glGenTextures = graphGenTextures;
+    glad_glGenFramebuffers = graphGenNames;
+    glad_glGenBuffers = graphGenNames;
+    glad_glDeleteTextures = graphDeleteNames;
+    glad_glDeleteFramebuffers = graphDeleteNames;
+    glad_glDeleteBuffers = graphDeleteNames;
+    glad_glBindTexture = graphBind;
+    glad_glBindFramebuffer = graphBind;
+    glad_glBindBuffer = graphBind;
+    glad_glActiveTexture = graphEnum;
+    glad_glDrawBuffer = graphEnum;
+    glad_glReadBuffer = graphEnum;
+    glad_glTexImage2D = graphTexImage2D;
+    glad_glTexParameteri = graphTexParameteri;
+    glad_glFramebufferTexture2D = graphFramebufferTexture2D;
+    glad_glDrawBuffers = graphDrawBuffers;
+    glad_glCheckFramebufferStatus = graphCheckFramebufferStatus;
+    glad_glGetError = graphGetError;
+    glad_glViewport = graphViewport;
+    glad_glBufferData = graphBufferData;
+}
+
+struct GraphScene {
+    GlStateCache state;
+    RenderGraph graph;
+    RenderResource lut;
+    size_t debugPass;
+    size_t passesRun = 0;
+};
+
+static void buildGraph ( GraphScene& scene ) {
+    RenderGraph& graph = scene.graph;
+    RenderPassFunction count = [&scene]( RenderPassContext& ) { scene.passesRun++; };
+
+    RenderResource lut = graph.createRenderTarget("lut", { GL_RGBA8, 1.0F, 32, 32 });
+    RenderResource albedo = graph.createRenderTarget("albedo", { GL_RGBA8 });
+    RenderResource normal = graph.createRenderTarget("normal", { GL_RGBA16F });
+    RenderResource depth = graph.createRenderTarget("depth", { GL_DEPTH24_STENCIL8 });
+    RenderResource hdr = graph.createRenderTarget("hdr", { GL_RGBA16F });
+    RenderResource debug = graph.createRenderTarget("debug", { GL_RGBA8 });
+    RenderResource bloomDown = graph.createRenderTarget("bloomDown", { GL_RGBA16F, 0.5F });
+    RenderResource bloomUp = graph.createRenderTarget("bloomUp", { GL_RGBA16F, 0.5F });
+    RenderResource ldr = graph.createRenderTarget("ldr", { GL_RGBA8 });
+
+    size_t pass = graph.addPass("lut", count);
+    graph.write(pass, lut);
+
+    pass = graph.addPass("gbuffer", count);
+    graph.write(pass, albedo);
+    graph.write(pass, normal);
+    graph.write(pass, depth);
+
+    pass = graph.addPass("lighting", count);
+    graph.read(pass, albedo);
+    graph.read(pass, normal);
+    graph.read(pass, depth);
+    graph.write(pass, hdr);
+
+    scene.debugPass = graph.addPass("debug", count);
+    graph.read(scene.debugPass, depth);
+    graph.write(scene.debugPass, debug);
+
+    pass = graph.addPass("bloomDown", count);
+    graph.read(pass, hdr);
+    graph.write(pass, bloomDown);
+
+    pass = graph.addPass("bloomUp", count);
+    graph.read(pass, bloomDown);
+    graph.write(pass, bloomUp);
+
+    pass = graph.addPass("tonemap", count);
+    graph.read(pass, hdr);
+    graph.read(pass, bloomUp);
+    graph.read(pass, lut);
+    graph.write(pass, ldr);
+
+    pass = graph.addPass("fxaa", count);
+    graph.read(pass, ldr);
+    graph.write(pass, BACKBUFFER_RESOURCE);
+
+    scene.lut = lut;
+}
+
+static GraphScene& getGraphScene ( ) {
+    static GraphScene* scene = []() {
+        loadGraphDriver();
+        GraphScene* out = new GraphScene();
+        buildGraph(*out);
+        out->graph.setBackbufferSize(1280, 720);
+        out->graph.execute(out->state, 0.0F);
+
+        GLuint lut = out->graph.getTexture(out->lut);
+        out->graph.setBackbufferSize(1920, 1080);
+        out->graph.execute(out->state, 0.0F);
+
+        if ( !out->graph.isCulled(out->debugPass) || out->graph.getTexture(out->lut) != lut
+                || out->graph.getStats().reallocated != GRAPH_RESIZED_TARGETS ) {
+            std::cout << "RenderGraph: expected the debug pass culled and " << GRAPH_RESIZED_TARGETS
+                << " targets recreated on resize, got " << out->graph.getStats().reallocated << std::endl;
+            exit(1);
+        }
+
+        out->graph.setBackbufferSize(1280, 720);
+        out->graph.execute(out->state, 0.0F);
+        return out;
+    }();
+
+    return *scene;
+}
+
+static void setGraphNote ( const RenderGraphStats& stats, size_t textures ) {
+    std::ostringstream note;
+    note << std::fixed << std::setprecision(1)
+        << stats.bytesWithoutAliasing / 1048576.0 << " MB of targets without aliasing, "
+        << stats.bytesWithAliasing / 1048576.0 << " MB with, "
+        << stats.transientResources << " targets on " << stats.physicalResources << " textures, "
+        << textures << " created per frame";
+    getBenchNote() = note.str();
+}
+
+BENCH(RenderGraph, execute, GRAPH_PASSES) {
+    GraphScene& scene = getGraphScene();
+    loadGraphDriver();
+    size_t textures = graphTexturesCreated;
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        scene.graph.execute(scene.state, 0.016F);
+    }
+
+    doNotOptimize(scene.passesRun);
+
+    if ( iterations > 0 ) {
+        setGraphNote(scene.graph.getStats(), (graphTexturesCreated - textures) / iterations);
+    }
+}
+
+BENCH(RenderGraph, resize_and_execute, GRAPH_PASSES) {
+    GraphScene& scene = getGraphScene();
+    loadGraphDriver();
+    size_t textures = graphTexturesCreated;
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        if ( it & 1 ) {
+            scene.graph.setBackbufferSize(1280, 720);
+        } else {
+            scene.graph.setBackbufferSize(1920, 1080);
+        }
+
+        scene.graph.execute(scene.state, 0.016F);
+    }
+
+    scene.graph.setBackbufferSize(1280, 720);
+    scene.graph.execute(scene.state, 0.016F);
+    doNotOptimize(scene.passesRun);
+
+    if ( iterations > 0 ) {
+        setGraphNote(scene.graph.getStats(), (graphTexturesCreated - textures) / iterations);
+    }
+}
@@ -0,0 +1,70 @@
+#include <algorithm>
+#include <vector>
+#include <stdlib.h>
+#include "renderer/RenderQueue.h"
+#include "Bench.h"
+
+// Draw packet recording and sorting for 64k packets spread over 32 shaders and 1024 materials
+// with random depths. Recording cases fill the queue on one thread and on every hardware
+// thread, sort cases compare the radix sort against std::stable_sort on the same merged keys.
+
+static constexpr size_t PACKET_COUNT = 1 << 16;
+
+static std::vector<uint64_t> makeKeys ( ) {
+    std::vector<uint64_t> keys(PACKET_COUNT);
+    for ( uint64_t& key : keys ) {
+        key = makeOpaqueSortKey(rand() % 2, rand() % 32, rand() % 1024, rand() & SORT_KEY_DEPTH_MAX);
+    }
+    return keys;
+}
+
+static std::vector<uint64_t> packetKeys = makeKeys();
+
+static void recordPackets ( CommandBuffer& buffer, size_t begin, size_t end ) {
+    DrawPacket packet{};
+    for ( size_t i = begin; i < end; ++i ) {
+        uint64_t key = packetKeys[i];
+        packet.program = static_cast<GLuint>((key >> 44) & 0xFFF) + 1;
+        packet.texture = static_cast<GLuint>((key >> 24) & 0xFFFFF) + 1;
+        packet.vertexArray = static_cast<GLuint>(i & 63) + 1;
+        packet.count = 36;
+        packet.model.M[12] = static_cast<float>(i);
+        buffer.draw(key, packet);
+    }
+}
+
+BENCH(RenderQueue, record_1_thread, PACKET_COUNT) {
+    static RenderQueue queue(1);
+    for ( size_t it = 0; it < iterations; ++it ) {
+        queue.clear();
+        queue.record(PACKET_COUNT, recordPackets);
+        doNotOptimize(queue.getPacketCount());
+    }
+}
+
+BENCH(RenderQueue, record_all_threads, PACKET_COUNT) {
+    static RenderQueue queue(0);
+    for ( size_t it = 0; it < iterations; ++it ) {
+        queue.clear();
+        queue.record(PACKET_COUNT, recordPackets);
+        doNotOptimize(queue.getPacketCount());
+    }
+}
+
+BENCH(RenderQueue, sort_radix, PACKET_COUNT) {
+    static RenderQueue queue(1);
+    queue.clear();
+    queue.record(PACKET_COUNT, recordPackets);
+    for ( size_t it = 0; it < iterations; ++it ) {
+        doNotOptimize(queue.sort());
+    }
+}
+
+BENCH(RenderQueue, sort_std, PACKET_COUNT) {
+    static std::vector<RadixSortItem> items(PACKET_COUNT);
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < PACKET_COUNT; ++i ) { items[i] = { packetKeys[i], static_cast<uint32_t>(i) }; }
+        std::stable_sort(items.begin(), items.end(), []( const RadixSortItem& a, const RadixSortItem& b ) { return a.key < b.key; });
+        doNotOptimize(items[0]);
+    }
+}
@@ -0,0 +1,124 @@
+#include <vector>
+#include <stdlib.h>
+#include "util/math/TriangleStream.h"
+#include "util/math/Triangle3d.h"
+#include "util/math/Rect2d.h"
+#include "util/Vectors.h"
+#include "Bench.h"
+
+// Integer vectors, rectangles and triangle areas. Rect2d has no SIMD form, Triangle3d::GetArea
+// is compared against TrianglePacket::GetArea over a TriangleStream.
+
+static constexpr size_t SHAPE_COUNT = 1 << 14;
+
+static int randomInt ( int min, int max ) {
+    return min + rand() % (max - min + 1);
+}
+
+static std::vector<Vector2i> makeVectors2i ( ) {
+    std::vector<Vector2i> vectors(SHAPE_COUNT);
+    for ( auto& vec : vectors ) { vec = Vector2i(randomInt(-1000, 1000), randomInt(-1000, 1000)); }
+    return vectors;
+}
+
+static std::vector<Rect2d> makeRects ( ) {
+    std::vector<Rect2d> rects(SHAPE_COUNT);
+    for ( auto& rect : rects ) { rect = Rect2d(randomInt(-2000, 2000), randomInt(-2000, 2000), randomInt(1, 2000), randomInt(1, 2000)); }
+    return rects;
+}
+
+static std::vector<Triangle3d> makeTriangles ( ) {
+    std::vector<Triangle3d> tris;
+    tris.reserve(SHAPE_COUNT);
+    auto vertex = []() { return Vector3f(randomInt(-100, 100) * 0.5F, randomInt(-100, 100) * 0.5F, randomInt(-100, 100) * 0.5F); };
+    for ( size_t i = 0; i < SHAPE_COUNT; ++i ) { tris.emplace_back(vertex(), vertex(), vertex(), Vector3f()); }
+    return tris;
+}
+
+static std::vector<Vector2i> vec2iA = makeVectors2i();
+static std::vector<Vector2i> vec2iB = makeVectors2i();
+static std::vector<Vector2i> vec2iOut(SHAPE_COUNT);
+static std::vector<Vector2f> vec2fOut(SHAPE_COUNT);
+static std::vector<float> shapeFloatOut(SHAPE_COUNT + STREAM_PADDING);
+static std::vector<Rect2d> rectA = makeRects();
+static std::vector<Rect2d> rectB = makeRects();
+static std::vector<Rect2d> rectOut(SHAPE_COUNT);
+static std::vector<Triangle3d> shapeTriangles = makeTriangles();
+
+// Vector2i
+
+BENCH(Vector2i, normalize_scalar, SHAPE_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < SHAPE_COUNT; ++i ) { vec2fOut[i] = vec2iA[i].Normalized(); }
+        doNotOptimize(vec2fOut[0]);
+    }
+}
+
+BENCH(Vector2i, normalizeFast_scalar, SHAPE_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < SHAPE_COUNT; ++i ) { vec2fOut[i] = vec2iA[i].NormalizedFast(); }
+        doNotOptimize(vec2fOut[0]);
+    }
+}
+
+BENCH(Vector2i, distance_scalar, SHAPE_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < SHAPE_COUNT; ++i ) { shapeFloatOut[i] = vec2iA[i].Distance(vec2iB[i]); }
+        doNotOptimize(shapeFloatOut[0]);
+    }
+}
+
+BENCH(Vector2i, distanceFast_scalar, SHAPE_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < SHAPE_COUNT; ++i ) { shapeFloatOut[i] = vec2iA[i].DistanceFast(vec2iB[i]); }
+        doNotOptimize(shapeFloatOut[0]);
+    }
+}
+
+BENCH(Vector2i, lerp_scalar, SHAPE_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < SHAPE_COUNT; ++i ) { vec2iOut[i] = vec2iA[i].Lerp(vec2iB[i], 0.25F); }
+        doNotOptimize(vec2iOut[0]);
+    }
+}
+
+// Rect2d
+
+BENCH(Rect2d, getIntersection_scalar, SHAPE_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < SHAPE_COUNT; ++i ) { rectOut[i] = rectA[i].getIntersection(rectB[i]); }
+        doNotOptimize(rectOut[0]);
+    }
+}
+
+BENCH(Rect2d, getIntersectionArea_scalar, SHAPE_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        int total = 0;
+        for ( size_t i = 0; i < SHAPE_COUNT; ++i ) { total += rectA[i].getIntersectionArea(rectB[i]); }
+        doNotOptimize(total);
+    }
+}
+
+// Triangle3d
+
+BENCH(Triangle3d, getArea_scalar, SHAPE_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < SHAPE_COUNT; ++i ) { shapeFloatOut[i] = shapeTriangles[i].GetArea(); }
+        doNotOptimize(shapeFloatOut[0]);
+    }
+}
+
+BENCH(Triangle3d, getArea_simd, SHAPE_COUNT) {
+    static TriangleStream stream = []() {
+        TriangleStream out;
+        out.load(shapeTriangles.data(), SHAPE_COUNT);
+        return out;
+    }();
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < SHAPE_COUNT; i += SIMD_LANES ) {
+            simd_store(&shapeFloatOut[i], stream.loadPacket<simdf>(i).GetArea());
+        }
+        doNotOptimize(shapeFloatOut[0]);
+    }
+}
@@ -0,0 +1,56 @@
+#include <vector>
+#include "renderer/SoftwareRasterizer.h"
+#include "Bench.h"
+
+// One 640x480 frame of 1000 vertex colored cubes in perspective, cleared, binned and
+// rasterized, on one thread and on every hardware thread. Items are pixels.
+
+static constexpr int RASTER_WIDTH = 640;
+static constexpr int RASTER_HEIGHT = 480;
+static constexpr int CUBE_GRID = 10;
+
+static SoftwareMesh makeCube ( ) {
+    SoftwareMesh cube;
+
+    for ( int i = 0; i < 8; ++i ) {
+        cube.positions.push_back(Vector3f(i & 1 ? 0.4F : -0.4F, i & 2 ? 0.4F : -0.4F, i & 4 ? 0.4F : -0.4F));
+        cube.colors.push_back(Color4f(i & 1 ? 1.0F : 0.2F, i & 2 ? 1.0F : 0.2F, i & 4 ? 1.0F : 0.2F, 1.0F));
+    }
+
+    cube.indices = { 0, 2, 1, 1, 2, 3,  4, 5, 6, 5, 7, 6,  0, 1, 4, 1, 5, 4,  2, 6, 3, 3, 6, 7,  0, 4, 2, 2, 4, 6,  1, 3, 5, 3, 7, 5 };
+    return cube;
+}
+
+static void renderCubes ( SoftwareRasterizer& rasterizer, size_t iterations ) {
+    static SoftwareMesh cube = makeCube();
+    Matrix4f viewProjection = Matrix4f::Perspective(1.2F, static_cast<float>(RASTER_WIDTH) / RASTER_HEIGHT, 0.1F, 100.0F)
+        * Matrix4f::LookAt(Vector3f(0, 4, 12), Vector3f(0, 0, 0), Vector3f(0, 1, 0));
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        rasterizer.clear(Color4f(0.07F, 0.13F, 0.17F, 1.0F));
+
+        for ( int z = 0; z < CUBE_GRID; ++z ) {
+            for ( int y = 0; y < CUBE_GRID; ++y ) {
+                for ( int x = 0; x < CUBE_GRID; ++x ) {
+                    Vector3f pos(x - CUBE_GRID / 2.0F, y - CUBE_GRID / 2.0F, -z * 1.5F);
+                    rasterizer.drawTriangles(cube, 0, cube.indices.size(), viewProjection * Matrix4f::Translation(pos));
+                }
+            }
+        }
+
+        rasterizer.flush();
+        doNotOptimize(rasterizer.getPixel(RASTER_WIDTH / 2, RASTER_HEIGHT / 2));
+    }
+}
+
+BENCH(SoftwareRaster, cubes_1_thread, RASTER_WIDTH * RASTER_HEIGHT) {
+    static SoftwareRasterizer rasterizer(1);
+    rasterizer.resize(RASTER_WIDTH, RASTER_HEIGHT);
+    renderCubes(rasterizer, iterations);
+}
+
+BENCH(SoftwareRaster, cubes_all_threads, RASTER_WIDTH * RASTER_HEIGHT) {
+    static SoftwareRasterizer rasterizer(0);
+    rasterizer.resize(RASTER_WIDTH, RASTER_HEIGHT);
+    renderCubes(rasterizer, iterations);
+}
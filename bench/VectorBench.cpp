@@ -0,0 +1,282 @@
+#include <vector>
+#include <iostream>
+#include <stdlib.h>
+#include "util/math/Vector3fStream.h"
+#include "util/math/VectorArrays.h"
+#include "util/Vectors.h"
+#include "Bench.h"
+
+static constexpr size_t VECTOR_COUNT = 1 << 16;
+
+static float randomFloat ( ) {
+    return static_cast<float>(rand()) / RAND_MAX * 200.0F - 100.0F;
+}
+
+template<typename T>
+static std::vector<T> randomVectors ( size_t count );
+
+template<>
+std::vector<Vector3f> randomVectors<Vector3f> ( size_t count ) {
+    std::vector<Vector3f> vectors(count);
+    for ( auto& vec : vectors ) { vec = Vector3f(randomFloat(), randomFloat(), randomFloat()); }
+    return vectors;
+}
+
+template<>
+std::vector<Vector2f> randomVectors<Vector2f> ( size_t count ) {
+    std::vector<Vector2f> vectors(count);
+    for ( auto& vec : vectors ) { vec = Vector2f(randomFloat(), randomFloat()); }
+    return vectors;
+}
+
+static std::vector<Vector3f> vec3A = randomVectors<Vector3f>(VECTOR_COUNT);
+static std::vector<Vector3f> vec3B = randomVectors<Vector3f>(VECTOR_COUNT);
+static std::vector<Vector3f> vec3Out(VECTOR_COUNT);
+
+static std::vector<Vector2f> vec2A = randomVectors<Vector2f>(VECTOR_COUNT);
+static std::vector<Vector2f> vec2B = randomVectors<Vector2f>(VECTOR_COUNT);
+static std::vector<Vector2f> vec2Out(VECTOR_COUNT);
+
+static std::vector<float> floatOut(VECTOR_COUNT);
+
+static Vector3fStream streamA(vec3A.data(), VECTOR_COUNT);
+static Vector3fStream streamB(vec3B.data(), VECTOR_COUNT);
+static Vector3fStream streamOut(VECTOR_COUNT);
+
+// Bulk results must match the per-element methods exactly, checked once before a case is timed.
+// One short of VECTOR_COUNT so the scalar tail runs too.
+template<typename T>
+static void checkArrays ( const char* name, const std::vector<T>& out, const std::vector<T>& a,
+    const std::vector<T>& b, bool isAdd ) {
+
+    for ( size_t i = 0; i + 1 < VECTOR_COUNT; ++i ) {
+        T actual = out[i], expected = isAdd ? a[i] + b[i] : a[i] - b[i];
+
+        if ( !(actual == expected) ) {
+            std::cout << name << " differs from the scalar result at " << i << std::endl;
+            exit(1);
+        }
+    }
+
+}
+
+// Vector3f
+
+BENCH(Vector3f, add_simd, VECTOR_COUNT) {
+    addArrays(vec3Out.data(), vec3A.data(), vec3B.data(), VECTOR_COUNT - 1);
+    checkArrays("Vector3f addArrays", vec3Out, vec3A, vec3B, true);
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        addArrays(vec3Out.data(), vec3A.data(), vec3B.data(), VECTOR_COUNT);
+        doNotOptimize(vec3Out[0]);
+    }
+}
+
+BENCH(Vector3f, sub_simd, VECTOR_COUNT) {
+    subArrays(vec3Out.data(), vec3A.data(), vec3B.data(), VECTOR_COUNT - 1);
+    checkArrays("Vector3f subArrays", vec3Out, vec3A, vec3B, false);
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        subArrays(vec3Out.data(), vec3A.data(), vec3B.data(), VECTOR_COUNT);
+        doNotOptimize(vec3Out[0]);
+    }
+}
+
+BENCH(Vector3f, transform_scalar, VECTOR_COUNT) {
+    const Vector3f scale(1.5F, 2.0F, 0.5F), offset(10, -4, 3);
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < VECTOR_COUNT; ++i ) {
+            const Vector3f& v = vec3A[i];
+            vec3Out[i] = Vector3f(v.X * scale.X, v.Y * scale.Y, v.Z * scale.Z) + offset;
+        }
+        doNotOptimize(vec3Out[0]);
+    }
+}
+
+BENCH(Vector3f, transform_simd, VECTOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        transformArray(vec3Out.data(), vec3A.data(), Vector3f(1.5F, 2.0F, 0.5F), Vector3f(10, -4, 3), VECTOR_COUNT);
+        doNotOptimize(vec3Out[0]);
+    }
+}
+
+BENCH(Vector3f, lerp_scalar, VECTOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < VECTOR_COUNT; ++i ) { vec3Out[i] = vec3A[i].Lerp(vec3B[i], 0.25F); }
+        doNotOptimize(vec3Out[0]);
+    }
+}
+
+BENCH(Vector3f, lerp_simd, VECTOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        lerpArrays(vec3Out.data(), vec3A.data(), vec3B.data(), 0.25F, VECTOR_COUNT);
+        doNotOptimize(vec3Out[0]);
+    }
+}
+
+BENCH(Vector3f, dot_scalar, VECTOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < VECTOR_COUNT; ++i ) { floatOut[i] = vec3A[i].Dot(vec3B[i]); }
+        doNotOptimize(floatOut[0]);
+    }
+}
+
+BENCH(Vector3f, dot_simd, VECTOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        dotArrays(floatOut.data(), vec3A.data(), vec3B.data(), VECTOR_COUNT);
+        doNotOptimize(floatOut[0]);
+    }
+}
+
+BENCH(Vector3f, cross_scalar, VECTOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < VECTOR_COUNT; ++i ) { vec3Out[i] = vec3A[i].Cross(vec3B[i]); }
+        doNotOptimize(vec3Out[0]);
+    }
+}
+
+BENCH(Vector3f, cross_simd, VECTOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        crossArrays(vec3Out.data(), vec3A.data(), vec3B.data(), VECTOR_COUNT);
+        doNotOptimize(vec3Out[0]);
+    }
+}
+
+BENCH(Vector3f, normalize_scalar, VECTOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < VECTOR_COUNT; ++i ) { vec3Out[i] = vec3A[i].Normalized(); }
+        doNotOptimize(vec3Out[0]);
+    }
+}
+
+BENCH(Vector3f, normalize_simd, VECTOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        normalizeArray(vec3Out.data(), vec3A.data(), VECTOR_COUNT);
+        doNotOptimize(vec3Out[0]);
+    }
+}
+
+BENCH(Vector3f, distance_scalar, VECTOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < VECTOR_COUNT; ++i ) { floatOut[i] = vec3A[i].Distance(vec3B[i]); }
+        doNotOptimize(floatOut[0]);
+    }
+}
+
+BENCH(Vector3f, distance_simd, VECTOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        distanceArrays(floatOut.data(), vec3A.data(), vec3B.data(), VECTOR_COUNT);
+        doNotOptimize(floatOut[0]);
+    }
+}
+
+// Vector2f
+
+BENCH(Vector2f, add_simd, VECTOR_COUNT) {
+    addArrays(vec2Out.data(), vec2A.data(), vec2B.data(), VECTOR_COUNT - 1);
+    checkArrays("Vector2f addArrays", vec2Out, vec2A, vec2B, true);
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        addArrays(vec2Out.data(), vec2A.data(), vec2B.data(), VECTOR_COUNT);
+        doNotOptimize(vec2Out[0]);
+    }
+}
+
+BENCH(Vector2f, sub_simd, VECTOR_COUNT) {
+    subArrays(vec2Out.data(), vec2A.data(), vec2B.data(), VECTOR_COUNT - 1);
+    checkArrays("Vector2f subArrays", vec2Out, vec2A, vec2B, false);
+
+    for ( size_t it = 0; it < iterations; ++it ) {
+        subArrays(vec2Out.data(), vec2A.data(), vec2B.data(), VECTOR_COUNT);
+        doNotOptimize(vec2Out[0]);
+    }
+}
+
+BENCH(Vector2f, transform_scalar, VECTOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < VECTOR_COUNT; ++i ) {
+            vec2Out[i] = Vector2f(vec2A[i].X * 1.5F, vec2A[i].Y * 2.0F) + Vector2f(10, -4);
+        }
+        doNotOptimize(vec2Out[0]);
+    }
+}
+
+BENCH(Vector2f, transform_simd, VECTOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        transformArray(vec2Out.data(), vec2A.data(), Vector2f(1.5F, 2.0F), Vector2f(10, -4), VECTOR_COUNT);
+        doNotOptimize(vec2Out[0]);
+    }
+}
+
+BENCH(Vector2f, normalize_scalar, VECTOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < VECTOR_COUNT; ++i ) { vec2Out[i] = vec2A[i].Normalized(); }
+        doNotOptimize(vec2Out[0]);
+    }
+}
+
+BENCH(Vector2f, normalize_simd, VECTOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        normalizeArray(vec2Out.data(), vec2A.data(), VECTOR_COUNT);
+        doNotOptimize(vec2Out[0]);
+    }
+}
+
+BENCH(Vector2f, distance_scalar, VECTOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        for ( size_t i = 0; i < VECTOR_COUNT; ++i ) { floatOut[i] = vec2A[i].Distance(vec2B[i]); }
+        doNotOptimize(floatOut[0]);
+    }
+}
+
+BENCH(Vector2f, distance_simd, VECTOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        distanceArrays(floatOut.data(), vec2A.data(), vec2B.data(), VECTOR_COUNT);
+        doNotOptimize(floatOut[0]);
+    }
+}
+
+// Vector3fStream (SoA), compare with the Vector3f AoS cases above.
+
+BENCH(Vector3fStream, dot, VECTOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        dotArrays(floatOut.data(), streamA, streamB);
+        doNotOptimize(floatOut[0]);
+    }
+}
+
+BENCH(Vector3fStream, cross, VECTOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        crossArrays(streamOut, streamA, streamB);
+        doNotOptimize(streamOut.X[0]);
+    }
+}
+
+BENCH(Vector3fStream, normalize, VECTOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        normalizeArray(streamOut, streamA);
+        doNotOptimize(streamOut.X[0]);
+    }
+}
+
+BENCH(Vector3fStream, lerp, VECTOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        lerpArrays(streamOut, streamA, streamB, 0.25F);
+        doNotOptimize(streamOut.X[0]);
+    }
+}
+
+BENCH(Vector3fStream, from_aos, VECTOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        streamOut.loadAoS(vec3A.data(), VECTOR_COUNT);
+        doNotOptimize(streamOut.X[0]);
+    }
+}
+
+BENCH(Vector3fStream, to_aos, VECTOR_COUNT) {
+    for ( size_t it = 0; it < iterations; ++it ) {
+        streamA.storeAoS(vec3Out.data());
+        doNotOptimize(vec3Out[0]);
+    }
+}
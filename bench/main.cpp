@@ -0,0 +1,232 @@
+// Standalone microbenchmarks, only depends on util code and the renderer, GL runs against the
+// null drivers in InstancingBench.cpp and RenderGraphBench.cpp.
+// g++ -std=c++20 -O2 -Isrc -Ilibs/include bench/*.cpp src/renderer/Camera.cpp src/renderer/FrustumCuller.cpp
+//     src/renderer/RenderQueue.cpp src/renderer/GameRenderer.cpp src/renderer/GlStateCache.cpp
+//     src/renderer/StreamBuffer.cpp src/renderer/SoftwareRasterizer.cpp src/renderer/OcclusionCuller.cpp
+//     src/renderer/RenderGraph.cpp src/renderer/FrameProfiler.cpp
+//     src/util/Kernels.cpp src/util/JobPool.cpp src/util/KernelsAVX2.cpp src/util/detect/detect_cpu.cpp src/util/spatial/TriangleBvh.cpp
+//     src/util/spatial/RectIndex.cpp libs/libs/glad/glad.c -pthread -o vrge_bench
+// Add -march=native to measure the compile-time backends at full width, leave it out to compare
+// the runtime dispatched Kernels tables against the baseline.
+// Usage: vrge_bench [filter] [--json out.json] [--compare baseline.json] [--threshold percent]
+//   filter       runs every case whose "group/name" contains it
+//   --json       writes the results, a baseline is just an earlier --json file
+//   --compare    flags cases slower than the baseline by more than threshold (default 10) percent
+//                and exits with 1 if any are
+
+#include <algorithm>
+#include <stdlib.h>
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <chrono>
+#include <string>
+#include <vector>
+#include <map>
+#include "util/simd.h"
+#include "util/Kernels.h"
+#include "Bench.h"
+
+using highResClock = std::chrono::high_resolution_clock;
+
+static constexpr double MIN_BATCH_SECONDS = 0.05;
+static constexpr int REPETITIONS = 5;
+static constexpr double DEFAULT_THRESHOLD = 10;
+
+struct BenchResult {
+    std::string name;
+    double nsPerItem;
+};
+
+static const char* getSimdBackend ( ) {
+#if SIMD_AVX
+    return "AVX";
+#elif SIMD_SSE2
+    return "SSE2";
+#elif SIMD_NEON
+    return "NEON";
+#else
+    return "scalar";
+#endif
+}
+
+static double timeBatch ( BenchCase& bench, size_t iterations ) {
+    highResClock::time_point start = highResClock::now();
+    bench.run(iterations);
+    return std::chrono::duration<double>(highResClock::now() - start).count();
+}
+
+// Returns the best nanoseconds per item out of REPETITIONS batches.
+static double runCase ( BenchCase& bench ) {
+
+    size_t iterations = 1;
+
+    while ( timeBatch(bench, iterations) < MIN_BATCH_SECONDS && iterations < (1ULL << 40) ) {
+        iterations *= 2;
+    }
+
+    double best = timeBatch(bench, iterations);
+
+    for ( int i = 1; i < REPETITIONS; ++i ) {
+        best = std::min(best, timeBatch(bench, iterations));
+    }
+
+    return best * 1e9 / (static_cast<double>(iterations) * bench.itemsPerIteration);
+}
+
+static bool writeJson ( const std::string& path, const std::vector<BenchResult>& results ) {
+
+    std::ofstream file(path);
+
+    if ( !file.is_open() ) {
+        std::cout << "Failed to open " << path << std::endl;
+        return false;
+    }
+
+    file << "{\n  \"backend\": \"" << getSimdBackend() << "\",\n  \"lanes\": " << SIMD_LANES
+        << ",\n  \"kernels\": \"" << initKernels() << "\",\n  \"results\": [\n";
+
+    for ( size_t i = 0; i < results.size(); ++i ) {
+        file << "    { \"name\": \"" << results[i].name << "\", \"ns_per_item\": " << std::setprecision(9) << results[i].nsPerItem
+            << ", \"items_per_second\": " << (1e9 / results[i].nsPerItem) << " }" << (i + 1 < results.size() ? ",\n" : "\n");
+    }
+
+    file << "  ]\n}\n";
+    return true;
+
+}
+
+// Only reads back what writeJson writes, every "name" is followed by its "ns_per_item".
+static bool readBaseline ( const std::string& path, std::map<std::string, double>& baseline ) {
+
+    std::ifstream file(path);
+
+    if ( !file.is_open() ) {
+        std::cout << "Failed to open " << path << std::endl;
+        return false;
+    }
+
+    std::stringstream buffer;
+    buffer << file.rdbuf();
+    std::string json = buffer.str();
+
+    const std::string nameKey = "\"name\": \"", nsKey = "\"ns_per_item\": ";
+
+    for ( size_t pos = json.find(nameKey); pos != std::string::npos; pos = json.find(nameKey, pos) ) {
+        size_t nameStart = pos + nameKey.size();
+        size_t nameEnd = json.find('"', nameStart);
+        size_t nsPos = json.find(nsKey, nameEnd);
+
+        if ( nameEnd == std::string::npos || nsPos == std::string::npos ) {
+            break;
+        }
+
+        baseline[json.substr(nameStart, nameEnd - nameStart)] = std::strtod(json.c_str() + nsPos + nsKey.size(), nullptr);
+        pos = nsPos;
+    }
+
+    if ( baseline.empty() ) {
+        std::cout << "No results in " << path << std::endl;
+        return false;
+    }
+
+    return true;
+
+}
+
+// Returns how many cases regressed, cases missing from either side are listed but don't count.
+static int compareResults ( const std::vector<BenchResult>& results, const std::map<std::string, double>& baseline, double threshold ) {
+
+    int regressions = 0;
+
+    std::cout << std::endl << "Compared to baseline (threshold " << threshold << "%):" << std::endl;
+
+    for ( const BenchResult& result : results ) {
+
+        auto it = baseline.find(result.name);
+
+        if ( it == baseline.end() ) {
+            std::cout << std::left << std::setw(40) << result.name << "       new" << std::endl;
+            continue;
+        }
+
+        double change = (result.nsPerItem / it->second - 1) * 100;
+        bool isRegression = result.nsPerItem > it->second * (1 + threshold / 100);
+        regressions += isRegression;
+
+        std::cout << std::left << std::setw(40) << result.name << std::right << std::fixed << std::setprecision(1)
+            << std::setw(9) << std::showpos << change << std::noshowpos << "%" << (isRegression ? "  REGRESSION" : "") << std::endl;
+    }
+
+    std::cout << regressions << " regression(s)" << std::endl;
+    return regressions;
+
+}
+
+int main ( int argc, char** args ) {
+
+    std::string filter, jsonPath, baselinePath;
+    double threshold = DEFAULT_THRESHOLD;
+
+    for ( int i = 1; i < argc; ++i ) {
+        std::string arg = args[i];
+
+        if ( (arg == "--json" || arg == "--compare" || arg == "--threshold") && i + 1 >= argc ) {
+            std::cout << arg << " needs a value" << std::endl;
+            return 2;
+        }
+
+        if ( arg == "--json" ) {
+            jsonPath = args[++i];
+        } else if ( arg == "--compare" ) {
+            baselinePath = args[++i];
+        } else if ( arg == "--threshold" ) {
+            threshold = std::atof(args[++i]);
+        } else {
+            filter = arg;
+        }
+    }
+
+    std::map<std::string, double> baseline;
+
+    if ( !baselinePath.empty() && !readBaseline(baselinePath, baseline) ) {
+        return 2;
+    }
+
+    std::vector<BenchResult> results;
+    std::cout << "SIMD backend: " << getSimdBackend() << " (" << SIMD_LANES << " lanes)" << std::endl;
+    std::cout << "CPU features: " << describeCpuFeatures(getCpuFeatures()) << std::endl;
+    std::cout << "Kernels: " << initKernels() << std::endl;
+
+    for ( BenchCase& bench : getBenchCases() ) {
+
+        std::string fullName = std::string(bench.group) + "/" + bench.name;
+
+        if ( fullName.find(filter) == std::string::npos ) {
+            continue;
+        }
+
+        double nsPerItem = runCase(bench);
+        results.push_back({ fullName, nsPerItem });
+
+        std::cout << std::left << std::setw(40) << fullName << std::right << std::fixed 
+            << std::setprecision(3) << std::setw(10) << nsPerItem << " ns/item" 
+            << std::setw(12) << std::setprecision(1) << (1e3 / nsPerItem) << " M items/s" << std::endl;
+
+        if ( !getBenchNote().empty() ) {
+            std::cout << "    " << getBenchNote() << std::endl;
+            getBenchNote().clear();
+        }
+    }
+
+    if ( !jsonPath.empty() && !writeJson(jsonPath, results) ) {
+        return 2;
+    }
+
+    if ( !baselinePath.empty() && compareResults(results, baseline, threshold) > 0 ) {
+        return 1;
+    }
+
+    return 0;
+}
@@ -1,31 +1,39 @@
 
-#include <unordered_map>
 #include "util/GlfwContextLock.h"
 #include "input/InputHandler.h" // key_callback
+#include "RenderThreadPool.h"
 #include "MainThreadRunner.h"
+#include "ResourceLoader.h"
+#include "StartupTimer.h"
 #include "util/TimeUtil.h"
 #include "util/detect.h"
+#include "util/spatial/RectIndex.h"
 #include "AppWindow.h"
+#include <algorithm>
 #include <stdlib.h>
 
 using highResClock = std::chrono::high_resolution_clock;
 
-static std::unordered_map<GLFWwindow*, AppWindow*> windowMap{};
-static std::mutex global_win_mtx;
+// Only touched from the main thread, so window creation and destruction need no global lock.
+static GLFWwindow* sharedContext = nullptr;
 static bool isGlfwActive = false;
 static int windowCount = 0;
 
-constexpr uint8_t POSITION_CHANGED_FLAG   = 0b1;
-constexpr uint8_t SIZE_CHANGED_FLAG       = 0b10;
-constexpr uint8_t FULLSCREEN_CHANGED_FLAG = 0b100;
-constexpr uint8_t FRAMERATE_CHANGED_FLAG  = 0b1000;
-constexpr uint8_t VSYNC_CHANGED_FLAG      = 0b10000;
-constexpr uint8_t TITLE_CHANGED_FLAG      = 0b100000;
-constexpr uint8_t ICON_CHANGED_FLAG       = 0b1000000;
-constexpr uint8_t VISIBILITY_CHANGED_FLAG = 0b10000000;
+constexpr uint16_t POSITION_CHANGED_FLAG   = 0b1;
+constexpr uint16_t SIZE_CHANGED_FLAG       = 0b10;
+constexpr uint16_t FULLSCREEN_CHANGED_FLAG = 0b100;
+constexpr uint16_t FRAMERATE_CHANGED_FLAG  = 0b1000;
+constexpr uint16_t VSYNC_CHANGED_FLAG      = 0b10000;
+constexpr uint16_t TITLE_CHANGED_FLAG      = 0b100000;
+constexpr uint16_t ICON_CHANGED_FLAG       = 0b1000000;
+constexpr uint16_t VISIBILITY_CHANGED_FLAG = 0b10000000;
+constexpr uint16_t IN_FLIGHT_CHANGED_FLAG  = 0b100000000;
+
+constexpr std::chrono::seconds FRAME_STATS_INTERVAL ( 1 );
+constexpr GLuint64 FENCE_WAIT_TIMEOUT_NS = 100000000; // 100ms, retried until signaled
 
 AppWindow* getAppWindow ( GLFWwindow* window ) {
-    return windowMap[window];
+    return static_cast<AppWindow*>(glfwGetWindowUserPointer(window));
 }
 
 void framebuffer_size_callback(GLFWwindow* window, int width, int height) {
@@ -82,11 +90,36 @@ bool initGlfw ( ) {
 // Must only be called from the main thread.
 void stopGlfw ( ) {
     if ( isGlfwActive ) { 
+
+        if ( sharedContext ) {
+            glfwDestroyWindow ( sharedContext );
+            sharedContext = nullptr;
+        }
+
         glfwTerminate ();
         isGlfwActive = false;
     }
 }
 
+// Must only be called from the main thread.
+GLFWwindow* getSharedContext ( ) {
+
+    if ( sharedContext || (!isGlfwActive && !initGlfw()) ) {
+        return sharedContext;
+    }
+
+    glfwWindowHint(GLFW_VISIBLE, GLFW_FALSE);
+    sharedContext = glfwCreateWindow(1, 1, "", NULL, NULL);
+    glfwWindowHint(GLFW_VISIBLE, GLFW_TRUE);
+
+    if ( !sharedContext ) {
+        std::cout << "Failed to create the shared GL context" << std::endl;
+    }
+
+    return sharedContext;
+
+}
+
 bool isValidMonitorAddress ( GLFWmonitor* monitor ) {
     #if ((OPERATING_SYSTEM == OS_WINDOWS) || (OPERATING_SYSTEM == OS_CYGWIN))
         constexpr uintptr_t INVALID_MONITOR_HANDLE = 0xFEEEFEEEFEEEFEEEULL;
@@ -110,7 +143,7 @@ inline Rect2d getMonitorWorkRect ( GLFWmonitor* monitor ) {
 
 // Must only be called from the main thread.
 GLFWwindow* createGlfwWindow ( const char* winTitle, bool &isFullScreen, 
-    GLFWmonitor* monitor, Rect2d& rect ) {
+    GLFWmonitor* monitor, Rect2d& rect, GLFWwindow* share ) {
 
     const GLFWvidmode* mode;
     GLFWwindow* window;
@@ -139,7 +172,7 @@ GLFWwindow* createGlfwWindow ( const char* winTitle, bool &isFullScreen,
         
     }
     
-    window = glfwCreateWindow(rect.width, rect.height, winTitle, isFullScreen ? monitor : NULL, NULL);
+    window = glfwCreateWindow(rect.width, rect.height, winTitle, isFullScreen ? monitor : NULL, share);
 
     if ( window ) {
         toggle_callbacks ( window, true );
@@ -169,11 +202,8 @@ GLFWmonitor* AppWindow::getMonitor ( ) {
         int monitorCount = 0;
         GLFWmonitor** monitors = glfwGetMonitors(&monitorCount); 
 
-        GLFWmonitor* bestMonitor = NULL;
-        int bestArea = -1;
-
-        Rect2d monitorRect;
-        int area;
+        std::vector<GLFWmonitor*> validMonitors;
+        std::vector<Rect2d> monitorRects;
 
         for ( int i = 0; i < monitorCount; ++i ) {
 
@@ -183,17 +213,18 @@ GLFWmonitor* AppWindow::getMonitor ( ) {
                 continue;
             }
 
-            monitorRect = getMonitorWorkRect(monitor);
-            area = this->dimensions.getIntersectionArea(monitorRect);
+            validMonitors.push_back(monitor);
+            monitorRects.push_back(getMonitorWorkRect(monitor));
 
-            if ( bestArea < area ) {
-                bestMonitor = monitor;
-                bestArea = area;
-            }
+        }
 
+        if ( validMonitors.empty() ) {
+            return NULL;
         }
 
-        return bestMonitor; 
+        // a window off every monitor goes to the first one.
+        uint32_t best = findLargestIntersection(monitorRects.data(), monitorRects.size(), this->dimensions);
+        return validMonitors[best == INVALID_RECT_ID ? 0 : best]; 
 
     });
 
@@ -233,6 +264,7 @@ bool AppWindow::initWindow ( ) {
 
     GLFWmonitor* monitor;
     GlfwContextLock lock ( this->window );
+    StartupPhase phase("initWindow");
 
     if (!gladLoadGLLoader((GLADloadproc)glfwGetProcAddress)) {
         std::cout << "Failed to initialize GLAD" << std::endl;
@@ -240,6 +272,11 @@ bool AppWindow::initWindow ( ) {
         return false;
     }
 
+    // one region per possible slot, so changing the frames in flight never resizes it.
+    this->streamBuffer.init(MAX_FRAMES_IN_FLIGHT);
+    this->profiler.init();
+    this->initRenderGraph();
+
     if ( this->initializeCentered && (monitor = this->getMonitor()) ) { 
         Rect2d monitorRect = getMonitorWorkRect(monitor);
 
@@ -259,21 +296,23 @@ bool AppWindow::initWindow ( ) {
         glfwHideWindow ( this->window );
     }
 
-    if ( this->fullscreenEnabled ) {
-        glfwGetFramebufferSize ( this->window, &this->bufferSize.X, &this->bufferSize.Y );
-        glViewport ( 0, 0, this->bufferSize.X, this->bufferSize.Y );
-    } 
-    
-    else {
+    if ( !this->fullscreenEnabled ) {
         glfwSetWindowSize(this->window, this->dimensions.width, this->dimensions.height);
         glfwSetWindowPos(this->window, this->dimensions.xPos, this->dimensions.yPos);
     }
 
+    // the size callback only fires on changes, a window created at its size never gets one.
+    // init holds localMtx while this runs.
+    glfwGetFramebufferSize ( this->window, &this->bufferSize.X, &this->bufferSize.Y );
+
     // framerate
-    glfwSwapInterval( this->vSyncEnabled ? 1 : 0 );
-    this->frameTime = highResClock::duration ( 
-        static_cast<highResClock::rep>(highResClock::period::den / this->maxFrameRate) 
-    );
+    const GLFWvidmode* mode = glfwGetVideoMode(glfwGetPrimaryMonitor());
+
+    if ( mode && mode->refreshRate > 0 ) {
+        this->refreshRate = static_cast<float>(mode->refreshRate);
+    }
+
+    this->updateFramePacing();
 
     this->changedFlags = 0;
     return true;
@@ -282,8 +321,7 @@ bool AppWindow::initWindow ( ) {
 
 bool AppWindow::init ( ) { 
 
-    std::lock_guard<std::mutex> lockA(this->localMtx);
-    std::lock_guard<std::mutex> lockB(global_win_mtx);
+    std::lock_guard<std::mutex> lock(this->localMtx);
 
     if ( this->isDestroyed ) {
         std::cout << "Attempted to initialized a destroyed window" << std::endl;
@@ -305,7 +343,17 @@ bool AppWindow::init ( ) {
         }
 
         this->oldDimensions = this->dimensions;
-        this->window = createGlfwWindow(this->winTitle, this->fullscreenEnabled, NULL, this->dimensions);
+
+        {
+            StartupPhase phase("sharedContext");
+            getSharedContext();
+        }
+
+        {
+            StartupPhase phase("createGlfwWindow");
+            this->window = createGlfwWindow(this->winTitle, this->fullscreenEnabled, NULL, 
+                this->dimensions, getSharedContext());
+        }
         
         if (!this->window) {
             std::cout << "Failed to open GLFW window" << std::endl;
@@ -313,7 +361,7 @@ bool AppWindow::init ( ) {
         } 
         
         else {
-            windowMap[this->window] = this; 
+            glfwSetWindowUserPointer(this->window, this); 
             windowCount++;
         }
 
@@ -321,8 +369,26 @@ bool AppWindow::init ( ) {
             std::cout << "Failed to initialize window" << std::endl;
             return false;
         }
+
+        // GL is loaded by now, the loader thread needs it.
+        if ( resourceLoader ) {
+            resourceLoader->start(getSharedContext());
+        }
+
+        // set before a worker can tick it, the first tick then repaces it as a pooled window.
+        if ( renderThreadPool ) {
+            this->ownsThread = false;
+            this->setFlag(VSYNC_CHANGED_FLAG, true);
+
+            if ( (this->thread = renderThreadPool->addWindow(this)) ) {
+                return true;
+            }
+
+            this->ownsThread = true;
+            this->setFlag(VSYNC_CHANGED_FLAG, false);
+        }
         
-        this->thread = new std::thread(AppWindow::run, this);
+        this->thread = new std::thread(&AppWindow::run, this);
         mainThreadRunner->addChild(this->thread);
         
         return true;
@@ -336,8 +402,7 @@ void AppWindow::destroy ( bool force ) {
         return;
     }
 
-    std::lock_guard<std::mutex> lockA(this->localMtx);
-    std::lock_guard<std::mutex> lockB(global_win_mtx);
+    std::lock_guard<std::mutex> lock(this->localMtx);
 
     if ( (!force) && ((!this->thread) || (this->thread->get_id() != std::this_thread::get_id()))) {
         this->shouldDestroy = true;
@@ -348,7 +413,6 @@ void AppWindow::destroy ( bool force ) {
 
         if ( this->window ) {
             glfwDestroyWindow(this->window); 
-            windowMap.erase(this->window);
 
             this->window = nullptr;
             windowCount--;
@@ -358,10 +422,19 @@ void AppWindow::destroy ( bool force ) {
 
         // Application shutdown.
         if ( !windowCount && isGlfwActive ) {  
+
+            if ( renderThreadPool ) {
+                renderThreadPool->stop();
+            }
+
+            if ( resourceLoader ) {
+                resourceLoader->stop();
+            }
+
             mainThreadRunner->stop();
         } 
         
-        else {
+        else if ( this->ownsThread ) {
             mainThreadRunner->removeChild(this->thread);
             delete this->thread;
         }
@@ -404,8 +477,7 @@ void AppWindow::iSetFullScreen ( ) {
 
         }
 
-        glfwGetFramebufferSize ( this->window, &this->bufferSize.X, &this->bufferSize.Y );
-        glViewport ( 0, 0, this->bufferSize.X, this->bufferSize.Y );
+        glfwGetFramebufferSize ( this->window, &this->bufferSize.X, &this->bufferSize.Y ); // applyChanges holds localMtx
 
         toggle_callbacks ( this->window, true );
 
@@ -413,22 +485,41 @@ void AppWindow::iSetFullScreen ( ) {
 
 }
 
+// Pooled windows share their thread, so one blocking in a vsync swap would hold up the others.
+// They swap without vsync and the pool paces them to the refresh rate instead.
+void AppWindow::updateFramePacing ( ) {
+
+    bool isPooled = !this->ownsThread;
+    float frameRate = this->maxFrameRate;
+
+    if ( isPooled && this->vSyncEnabled ) {
+        frameRate = std::min(frameRate, this->refreshRate);
+    }
+
+    this->glState.setSwapInterval( (this->vSyncEnabled && !isPooled) ? 1 : 0 );
+    this->frameTime = highResClock::duration(
+        static_cast<highResClock::rep>(highResClock::period::den / frameRate)
+    );
+
+}
+
 void AppWindow::applyChanges ( ) {
 
     this->localMtx.lock();
         
-    if ( this->isFlagEnabled(FRAMERATE_CHANGED_FLAG)) {
+    if ( this->isFlagEnabled(FRAMERATE_CHANGED_FLAG) || this->isFlagEnabled(VSYNC_CHANGED_FLAG) ) {
         this->setFlag(FRAMERATE_CHANGED_FLAG, false);
+        this->setFlag(VSYNC_CHANGED_FLAG, false);
 
-        this->frameTime = highResClock::duration(
-            static_cast<highResClock::rep>(highResClock::period::den / this->maxFrameRate)
-        );
+        this->updateFramePacing();
     }
 
-    if ( this->isFlagEnabled(VSYNC_CHANGED_FLAG)) {
-        this->setFlag(VSYNC_CHANGED_FLAG, false);
+    if ( this->isFlagEnabled(IN_FLIGHT_CHANGED_FLAG)) {
+        this->setFlag(IN_FLIGHT_CHANGED_FLAG, false);
 
-        glfwSwapInterval( this->vSyncEnabled ? 1 : 0 );
+        this->releaseFrameFences(); // drains the GPU so slots can be renumbered
+        this->framesInFlight = this->requestedFramesInFlight;
+        this->frameIndex = 0;
     }
 
     if ( this->isFlagEnabled(TITLE_CHANGED_FLAG)) {
@@ -479,48 +570,197 @@ void AppWindow::applyChanges ( ) {
 }
 
 void AppWindow::render ( float deltaTime ) {
-    // constexpr auto wBgColor = windowBackgroundColor;
-    // glClearColor(wBgColor.red, wBgColor.green, wBgColor.blue, wBgColor.alpha);
-    // glClear(GL_COLOR_BUFFER_BIT);
+    this->renderGraph.execute(this->glState, deltaTime, &this->profiler);
+}
+
+// The default frame is a single pass drawing the renderer's queue to the backbuffer, passes
+// added through getRenderGraph run after it in the order they were added.
+void AppWindow::initRenderGraph ( ) {
+
+    size_t scene = this->renderGraph.addPass("scene", [this]( RenderPassContext& context ) -> void {
+        constexpr Color4f bgColor = AppWindowBackgroundColor;
+
+        {
+            ProfileScope scope(this->profiler, "clear");
+            glClearColor(bgColor.red, bgColor.green, bgColor.blue, bgColor.alpha);
+            glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+        }
+
+        this->renderer.render(this->camera, context.state, this->streamBuffer);
+    });
+
+    this->renderGraph.write(scene, BACKBUFFER_RESOURCE);
 
-    std::cout << ( 1 / deltaTime ) << " FPS" << std::endl;
 }
 
-void AppWindow::run ( ) {
+// Blocks until the GPU is done with the frame that last used this slot.
+void AppWindow::waitForFrameSlot ( int slot ) {
 
-    glfwMakeContextCurrent(this->window);    
+    GLsync fence = this->frameFences[slot];
 
-    highResClock::time_point frameStart, frameEnd;
-    highResClock::duration timeElapsed;
-    float deltaTime = 0;
+    if ( !fence ) {
+        return;
+    }
 
-    while(!this->shouldDestroy && !glfwWindowShouldClose(this->window)) {
+    GLenum result = glClientWaitSync(fence, GL_SYNC_FLUSH_COMMANDS_BIT, FENCE_WAIT_TIMEOUT_NS);
 
-        if ( this->changedFlags ) {
-            this->applyChanges();
-        }
+    while ( result == GL_TIMEOUT_EXPIRED ) {
+        result = glClientWaitSync(fence, 0, FENCE_WAIT_TIMEOUT_NS);
+    }
 
-        if ( !this->visible ) { 
-            continue; // no point in redering something that can not be seen.
-        }
-        
-        frameStart = highResClock::now();
+    if ( result == GL_WAIT_FAILED ) {
+        std::cout << "Failed to wait for frame fence" << std::endl;
+    }
 
-        this->render(deltaTime);
-        glfwSwapBuffers(this->window);
+    glDeleteSync(fence);
+    this->frameFences[slot] = nullptr;
 
-        frameEnd = highResClock::now();
-        timeElapsed = frameEnd - frameStart;
+    this->statsAccum.latencyMs += std::chrono::duration<double, std::milli>(
+        highResClock::now() - this->frameStarts[slot]).count();
+    this->statsAccum.latencySamples++;
 
-        if ( frameTime > timeElapsed ) {
-            sleepFor ( frameTime - timeElapsed );
+}
 
-            frameEnd = highResClock::now();
-            timeElapsed = frameEnd - frameStart;
-        } 
-                    
-        deltaTime = std::chrono::duration<float>(timeElapsed).count();
+// The context must be current on the calling thread.
+void AppWindow::releaseFrameFences ( ) {
+    for ( int slot = 0; slot < MAX_FRAMES_IN_FLIGHT; ++slot ) {
+        this->waitForFrameSlot(slot);
+    }
+}
+
+// Renders a single frame, the context must already be current on the calling thread.
+// Returns false once the window should be destroyed.
+bool AppWindow::tick ( ) {
+
+    if ( this->shouldDestroy || glfwWindowShouldClose(this->window) ) {
+        this->releaseFrameFences();
+        this->streamBuffer.destroy();
+        this->renderer.destroy(this->glState);
+        this->profiler.destroy();
+        this->renderGraph.destroy(this->glState);
+        return false;
+    }
+
+    if ( this->changedFlags ) {
+        this->applyChanges();
+    }
+
+    if ( !this->visible ) { 
+        return true; // no point in redering something that can not be seen.
+    }
+
+    int slot = this->getFrameSlot();
+    highResClock::time_point waitStart = highResClock::now();
+
+    // reads back an older frame's timings, which the slot's fence already covered.
+    this->profiler.beginFrame();
+
+    {
+        ProfileScope scope(this->profiler, "frameWait");
+        this->waitForFrameSlot(slot);
+    }
+
+    this->streamBuffer.beginFrame(slot);
+
+    highResClock::time_point frameStart = highResClock::now();
+
+    if ( this->lastFrameStart != highResClock::time_point{} ) {
+        this->deltaTime = std::chrono::duration<float>(frameStart - this->lastFrameStart).count();
+    }
+
+    // these only do work if the buffer size changed, the graph then recreates the targets
+    // sized after it on its next execute.
+    Vector2i size = this->getBufferSize();
+    this->glState.beginFrame();
+    this->glState.setViewport(0, 0, size.X, size.Y);
+    this->camera.setViewport(size);
+
+    // minimized windows have no framebuffer, the graph would size every target down to 1x1.
+    if ( size.X > 0 && size.Y > 0 ) {
+        this->renderGraph.setBackbufferSize(size.X, size.Y);
+        this->render(this->deltaTime);
+    }
+
+    this->profiler.endFrame();
+
+    // fenced before the swap so it only covers this frame's own commands.
+    this->frameFences[slot] = glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+    this->frameStarts[slot] = frameStart;
+    this->frameIndex++;
+
+    glfwSwapBuffers(this->window);
+
+    highResClock::time_point frameEnd = highResClock::now();
 
+    if ( this->frameIndex == 1 ) {
+        recordStartupPhase("firstFrame", frameStart, frameEnd);
+        reportFirstFrame();
+    }
+
+    this->lastFrameStart = frameStart;
+    this->nextFrame = frameStart + this->frameTime;
+
+    // stats
+    auto& acc = this->statsAccum;
+
+    if ( acc.start == highResClock::time_point{} ) {
+        acc.start = waitStart;
+    }
+
+    acc.fenceWaitMs += std::chrono::duration<double, std::milli>(frameStart - waitStart).count();
+    acc.cpuMs += std::chrono::duration<double, std::milli>(frameEnd - frameStart).count();
+    acc.stateCallsIssued += this->glState.getFrameStats().issued;
+    acc.stateCallsSkipped += this->glState.getFrameStats().skipped;
+    acc.frames++;
+
+    // the profiler reads frames back late, each one is counted once.
+    const ProfileFrame& profiled = this->profiler.getLastFrame();
+
+    if ( profiled.gpuMs >= 0 && profiled.frameIndex != this->lastProfiledFrame ) {
+        this->lastProfiledFrame = profiled.frameIndex;
+        acc.gpuMs += profiled.gpuMs;
+        acc.gpuSamples++;
+    }
+
+    if ( frameEnd - acc.start >= FRAME_STATS_INTERVAL ) {
+        double seconds = std::chrono::duration<double>(frameEnd - acc.start).count();
+        std::lock_guard<std::mutex> lock(this->localMtx);
+
+        this->frameStats.frameCount      = acc.frames;
+        this->frameStats.framesInFlight  = this->framesInFlight;
+        this->frameStats.framesPerSecond = static_cast<float>(acc.frames / seconds);
+        this->frameStats.avgCpuFrameMs   = static_cast<float>(acc.cpuMs / acc.frames);
+        this->frameStats.avgFenceWaitMs  = static_cast<float>(acc.fenceWaitMs / acc.frames);
+        this->frameStats.avgLatencyMs    = acc.latencySamples ? 
+            static_cast<float>(acc.latencyMs / acc.latencySamples) : 0.0F;
+        this->frameStats.avgGpuFrameMs   = acc.gpuSamples ? 
+            static_cast<float>(acc.gpuMs / acc.gpuSamples) : 0.0F;
+        this->frameStats.avgStateCallsIssued  = static_cast<float>(acc.stateCallsIssued) / acc.frames;
+        this->frameStats.avgStateCallsSkipped = static_cast<float>(acc.stateCallsSkipped) / acc.frames;
+        this->frameStats.renderTargetBytes = this->renderGraph.getStats().bytesWithAliasing;
+        this->frameStats.renderTargetBytesUnaliased = this->renderGraph.getStats().bytesWithoutAliasing;
+
+        std::cout << this->winTitle << ": " << this->frameStats.framesPerSecond << " FPS, " 
+            << this->frameStats.avgCpuFrameMs << "ms CPU, " << this->frameStats.avgGpuFrameMs << "ms GPU, "
+            << this->frameStats.avgLatencyMs << "ms latency (" << this->framesInFlight 
+            << " frames in flight)" << std::endl;
+
+        acc = {};
+        acc.start = frameEnd;
+    }
+
+    return true;
+
+}
+
+void AppWindow::run ( ) {
+
+    glfwMakeContextCurrent(this->window);    
+
+    while ( this->tick() ) {
+        if ( highResClock::now() < this->nextFrame ) {
+            sleepUntil ( this->nextFrame );
+        }
     }
 
     this->isActive = false;
@@ -528,11 +768,11 @@ void AppWindow::run ( ) {
 
 }
 
-void AppWindow::flipFlag ( uint8_t flag ) {
+void AppWindow::flipFlag ( uint16_t flag ) {
     this->changedFlags ^= flag;
 }
 
-void AppWindow::setFlag ( uint8_t flag, bool enabled ) {
+void AppWindow::setFlag ( uint16_t flag, bool enabled ) {
     
     if ( enabled ) {
         this->changedFlags |= flag;
@@ -542,7 +782,7 @@ void AppWindow::setFlag ( uint8_t flag, bool enabled ) {
 
 }
 
-bool AppWindow::isFlagEnabled ( uint8_t flag ) {
+bool AppWindow::isFlagEnabled ( uint16_t flag ) {
     return this->changedFlags & flag;
 };
 
@@ -633,6 +873,18 @@ void AppWindow::setVSyncEnabled ( bool enabled ) {
     }
 }
 
+void AppWindow::setFramesInFlight ( int count ) {
+
+    count = std::clamp(count, 1, MAX_FRAMES_IN_FLIGHT);
+
+    std::lock_guard<std::mutex> lock(this->localMtx);
+
+    if ( this->requestedFramesInFlight != count ) {
+        this->setFlag(IN_FLIGHT_CHANGED_FLAG, true);
+        this->requestedFramesInFlight = count;
+    }
+}
+
 void AppWindow::setTitle ( const char* newTitle ) {
 
     if ( this->winTitle != newTitle ) {
@@ -655,11 +907,9 @@ void AppWindow::setFullScreen ( bool enabled ) {
 
 void AppWindow::setBufferSize ( int width, int height ) {
 
-    if ( this->bufferSize.X != width && this->bufferSize.Y != height ) {
-        std::lock_guard<std::mutex> lockA (this->localMtx);
-        GlfwContextLock lockB ( this->window );
-
-        glViewport(0, 0, width, height);
+    // the viewport and render graph follow on the next frame, from the render thread.
+    if ( this->bufferSize.X != width || this->bufferSize.Y != height ) {
+        std::lock_guard<std::mutex> lock (this->localMtx);
 
         this->bufferSize.X = width;
         this->bufferSize.Y = height;
@@ -668,9 +918,34 @@ void AppWindow::setBufferSize ( int width, int height ) {
 }
 
 Vector2i AppWindow::getBufferSize () {
+    std::lock_guard<std::mutex> lock (this->localMtx);
     return this->bufferSize;
 }
 
+Camera& AppWindow::getCamera () {
+    return this->camera;
+}
+
+GameRenderer& AppWindow::getRenderer () {
+    return this->renderer;
+}
+
+GlStateCache& AppWindow::getGlState () {
+    return this->glState;
+}
+
+StreamBuffer& AppWindow::getStreamBuffer () {
+    return this->streamBuffer;
+}
+
+FrameProfiler& AppWindow::getProfiler () {
+    return this->profiler;
+}
+
+RenderGraph& AppWindow::getRenderGraph () {
+    return this->renderGraph;
+}
+
 Rect2d AppWindow::getDimensions () {
     return this->dimensions;
 }
@@ -699,6 +974,20 @@ float AppWindow::getMaxFrameRate ( ) {
     return this->maxFrameRate;
 }
 
+int AppWindow::getFramesInFlight ( ) {
+    std::lock_guard<std::mutex> lock(this->localMtx);
+    return this->requestedFramesInFlight;
+}
+
+int AppWindow::getFrameSlot ( ) {
+    return static_cast<int>(this->frameIndex % this->framesInFlight);
+}
+
+FrameStats AppWindow::getFrameStats ( ) {
+    std::lock_guard<std::mutex> lock(this->localMtx);
+    return this->frameStats;
+}
+
 std::thread* AppWindow::getThread () {
     return this->thread;
 }
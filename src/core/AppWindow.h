@@ -12,15 +12,31 @@
 #include "util/Vectors.h"
 #include "util/TimeUtil.h"
 #include "util/math/Rect2d.h"
+#include "renderer/Camera.h"
+#include "renderer/GameRenderer.h"
+#include "renderer/GlStateCache.h"
+#include "renderer/StreamBuffer.h"
+#include "renderer/FrameProfiler.h"
+#include "renderer/RenderGraph.h"
 
 static constexpr Rect2d defaultAppWindowDimensions( 0, 0, 854, 480 );
 static constexpr Color4f AppWindowBackgroundColor(0.07F, 0.13F, 0.17F, 1.0F);
+static constexpr int MAX_FRAMES_IN_FLIGHT = 3;
+
+// the frame fence covers the profiler's queries, so they are done by the time they are read.
+static_assert(PROFILER_FRAME_LATENCY > MAX_FRAMES_IN_FLIGHT);
 
 // GLFW && Glad
 // Must only be called from the main thread.
 bool initGlfw ();
 void stopGlfw ();
 
+// Hidden context that every window shares its buffers, textures and shaders with.
+// Container objects (VAOs, FBOs) are never shared by GL and must be created per window.
+// The ResourceLoader's thread keeps it current, nothing else may make it current.
+// Must only be called from the main thread.
+GLFWwindow* getSharedContext ();
+
 class AppWindow; // foward
 AppWindow* getAppWindow ( GLFWwindow* window );
 
@@ -43,19 +59,63 @@ struct MonitorData {
     }
 };
 
+// Averages over the last report interval of a window's render loop.
+struct FrameStats {
+    uint32_t frameCount = 0;
+    int framesInFlight = 0;
+
+    float framesPerSecond = 0;
+    float avgCpuFrameMs = 0;  // recording and submission on the render thread
+    float avgFenceWaitMs = 0; // time blocked until a frame slot was free again
+    float avgLatencyMs = 0;   // frame start until its fence was seen signaled, an upper bound
+    float avgGpuFrameMs = 0;  // GPU time of the frame's commands, 0 without timer queries
+
+    float avgStateCallsIssued = 0;  // GL state changes that reached the driver
+    float avgStateCallsSkipped = 0; // redundant ones the state cache dropped
+
+    size_t renderTargetBytes = 0;          // transient targets and buffers of the render graph
+    size_t renderTargetBytesUnaliased = 0; // what they would take without sharing memory
+};
+
 class AppWindow {
     
     private:
-        std::atomic<uint8_t> changedFlags = 0;
+        std::atomic<uint16_t> changedFlags = 0;
         std::thread* thread = nullptr;
         GLFWwindow* window = nullptr;
         std::mutex localMtx{};
         Vector2i bufferSize{};
-
+        Camera camera{};
+        GameRenderer renderer{};
+        GlStateCache glState{};
+        StreamBuffer streamBuffer{};
+        FrameProfiler profiler{};
+        RenderGraph renderGraph{};
+
+        std::chrono::high_resolution_clock::time_point lastFrameStart{};
+        std::chrono::high_resolution_clock::time_point nextFrame{};
         std::chrono::high_resolution_clock::duration frameTime{};
+
+        // frames in flight, slot i is reused once frameFences[i] has been signaled.
+        std::chrono::high_resolution_clock::time_point frameStarts[MAX_FRAMES_IN_FLIGHT]{};
+        GLsync frameFences[MAX_FRAMES_IN_FLIGHT]{};
+        uint64_t frameIndex = 0;
+        int framesInFlight = 2;          // render thread only, applyChanges copies the requested one
+        int requestedFramesInFlight = 2; // guarded by localMtx
+
+        struct {
+            std::chrono::high_resolution_clock::time_point start{};
+            double cpuMs = 0, fenceWaitMs = 0, latencyMs = 0, gpuMs = 0;
+            uint32_t frames = 0, latencySamples = 0, gpuSamples = 0;
+            size_t stateCallsIssued = 0, stateCallsSkipped = 0;
+        } statsAccum;
+
+        FrameStats frameStats{};
+        uint64_t lastProfiledFrame = UINT64_MAX;
         Rect2d oldDimensions = defaultAppWindowDimensions; // pre full-screen size
         Rect2d dimensions = defaultAppWindowDimensions;
         float maxFrameRate = INFINITY;
+        float refreshRate = 60; // of the primary monitor, paces pooled windows with vsync
         bool fullscreenEnabled = false;
         bool shouldDestroy = false;
         bool vSyncEnabled = true;
@@ -63,19 +123,29 @@ class AppWindow {
 
         bool isDestroyed = false;
         bool isActive = false;
+        bool ownsThread = true;
         bool visible = true;
+        float deltaTime = 0;
 
         void run();
+        bool tick();
         void render( float deltaTime );
+        void initRenderGraph ( );
 
         void iSetFullScreen ( );
 
-        void flipFlag ( uint8_t flag );
-        void setFlag ( uint8_t flag, bool enabled );
-        bool isFlagEnabled ( uint8_t flag );
+        void waitForFrameSlot ( int slot );
+        void releaseFrameFences ( );
+
+        void flipFlag ( uint16_t flag );
+        void setFlag ( uint16_t flag, bool enabled );
+        bool isFlagEnabled ( uint16_t flag );
+        void updateFramePacing ( );
         void applyChanges ( );
         bool initWindow ( );
 
+        friend class RenderThreadPool;
+
     public:
         bool initializeCentered = true;
 
@@ -115,6 +185,14 @@ class AppWindow {
         void setVSyncEnabled ( bool enabled );
         bool isVSyncEnabled ();
 
+        // How many frames the CPU may record ahead of the GPU, clamped to [1, MAX_FRAMES_IN_FLIGHT].
+        void setFramesInFlight ( int count );
+        int getFramesInFlight ();
+
+        // Index of the per-frame resources the frame being recorded may write to.
+        int getFrameSlot ();
+        FrameStats getFrameStats ();
+
         void setTitle ( const char* newTitle );
         const char* getTitle ( );
 
@@ -124,5 +202,30 @@ class AppWindow {
         void setBufferSize ( int width, int height ); // callback
         Vector2i getBufferSize ();
 
+        // Only safe to use from the window's render thread.
+        Camera& getCamera ();
+
+        // Packets recorded into its queue are drawn with the next frame.
+        // Only safe to use from the window's render thread.
+        GameRenderer& getRenderer ();
+
+        // State and binding changes on this window's context should go through it.
+        // Only safe to use from the window's render thread.
+        GlStateCache& getGlState ();
+
+        // Per-frame vertex, index and uniform data, regions follow getFrameSlot.
+        // Only safe to use from the window's render thread.
+        StreamBuffer& getStreamBuffer ();
+
+        // CPU and GPU time per scope of the frame, open scopes around passes to break it down.
+        // Only safe to use from the window's render thread.
+        FrameProfiler& getProfiler ();
+
+        // The passes a frame is drawn with, the window's own pass comes first and writes the
+        // backbuffer, passes added here run after it.
+        // Targets sized after the backbuffer follow the window's buffer size.
+        // Only safe to use from the window's render thread.
+        RenderGraph& getRenderGraph ();
+
         
 };
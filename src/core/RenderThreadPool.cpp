@@ -0,0 +1,169 @@
+#include <algorithm>
+#include "MainThreadRunner.h"
+#include "RenderThreadPool.h"
+#include "util/TimeUtil.h"
+#include "AppWindow.h"
+
+using highResClock = std::chrono::high_resolution_clock;
+
+RenderThreadPool::RenderThreadPool ( unsigned int threadCount ) {
+
+    if ( threadCount == 0 ) {
+        threadCount = std::max(1U, std::thread::hardware_concurrency() / 2);
+    }
+
+    for ( unsigned int i = 0; i < threadCount; ++i ) {
+        this->workers.push_back(new Worker());
+    }
+
+}
+
+RenderThreadPool::~RenderThreadPool ( ) {
+    this->stop();
+
+    for ( Worker* worker : this->workers ) {
+        delete worker;
+    }
+}
+
+void RenderThreadPool::start ( ) {
+    std::lock_guard<std::mutex> lock(this->mtx);
+
+    if ( this->isRunning ) {
+        return;
+    }
+
+    this->isRunning = true;
+
+    for ( Worker* worker : this->workers ) {
+        worker->thread = new std::thread(&RenderThreadPool::runWorker, this, worker);
+        mainThreadRunner->addChild(worker->thread);
+    }
+
+}
+
+void RenderThreadPool::stop ( ) {
+    this->isRunning = false;
+
+    for ( Worker* worker : this->workers ) {
+        worker->cv.notify_all();
+    }
+}
+
+std::thread* RenderThreadPool::addWindow ( AppWindow* window ) {
+    std::lock_guard<std::mutex> lock(this->mtx);
+
+    if ( !this->isRunning ) {
+        return nullptr;
+    }
+
+    // least loaded worker, the window count is only an estimate of the render cost.
+    Worker* best = nullptr;
+    size_t bestCount = SIZE_MAX;
+
+    for ( Worker* worker : this->workers ) {
+        std::lock_guard<std::mutex> workerLock(worker->mtx);
+
+        if ( worker->windowCount < bestCount ) {
+            best = worker;
+            bestCount = worker->windowCount;
+        }
+    }
+
+    std::lock_guard<std::mutex> workerLock(best->mtx);
+    best->added.push_back(window);
+    best->windowCount++;
+    best->cv.notify_one();
+
+    return best->thread;
+}
+
+void RenderThreadPool::removeWindow ( AppWindow* window ) {
+    std::lock_guard<std::mutex> lock(this->mtx);
+
+    for ( Worker* worker : this->workers ) {
+        std::lock_guard<std::mutex> workerLock(worker->mtx);
+        worker->removed.push_back(window);
+    }
+}
+
+size_t RenderThreadPool::getThreadCount ( ) {
+    return this->workers.size();
+}
+
+void RenderThreadPool::applyPending ( Worker* worker ) {
+
+    auto& windows = worker->windows;
+
+    // a window is only ever added once, so a removal always comes after its add.
+    windows.insert(windows.end(), worker->added.begin(), worker->added.end());
+
+    for ( AppWindow* window : worker->removed ) {
+        windows.erase(std::remove(windows.begin(), windows.end(), window), windows.end());
+    }
+
+    worker->added.clear();
+    worker->removed.clear();
+    worker->windowCount = windows.size();
+
+}
+
+void RenderThreadPool::runWorker ( Worker* worker ) {
+
+    std::unique_lock<std::mutex> lock(worker->mtx, std::defer_lock);
+    highResClock::time_point wakeUp;
+
+    while ( this->isRunning ) {
+
+        lock.lock();
+        this->applyPending(worker);
+
+        if ( worker->windows.empty() ) {
+            worker->cv.wait_for(lock, this->idleSleepTime);
+            lock.unlock();
+            continue;
+        }
+
+        lock.unlock();
+
+        wakeUp = highResClock::now() + std::chrono::duration_cast<highResClock::duration>(this->idleSleepTime);
+
+        for ( size_t i = 0; i < worker->windows.size(); ) {
+
+            AppWindow* window = worker->windows[i];
+
+            if ( highResClock::now() < window->nextFrame ) {
+                wakeUp = std::min(wakeUp, window->nextFrame);
+                ++i;
+                continue;
+            }
+
+            glfwMakeContextCurrent(window->window);
+
+            if ( window->tick() ) {
+                wakeUp = std::min(wakeUp, window->nextFrame);
+                ++i;
+                continue;
+            }
+
+            worker->windows.erase(worker->windows.begin() + i);
+            glfwMakeContextCurrent(NULL);
+
+            window->isActive = false;
+            window->destroy();
+
+            lock.lock();
+            worker->windowCount--;
+            lock.unlock();
+
+        }
+
+        if ( highResClock::now() < wakeUp ) {
+            sleepUntil(wakeUp);
+        }
+
+    }
+
+    glfwMakeContextCurrent(NULL);
+
+}
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <condition_variable>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+
+class AppWindow; // foward
+
+// Renders several windows from a fixed set of threads instead of one thread per window.
+// Each window is pinned to a single worker, as a GL context can only be current on one thread.
+// Workers tick without holding their lock, a tick may wait on the main thread which adds and
+// removes windows, so those are queued and picked up before the worker's next pass.
+// Pooled windows swap without vsync, see AppWindow::updateFramePacing.
+class RenderThreadPool {
+
+    private:
+        struct Worker {
+            std::vector<AppWindow*> windows{}; // only touched by the worker thread
+            std::vector<AppWindow*> added{};
+            std::vector<AppWindow*> removed{};
+            size_t windowCount = 0;            // windows and added, for picking a worker
+            std::condition_variable cv{};
+            std::thread* thread = nullptr;
+            std::mutex mtx{};
+        };
+
+        std::chrono::duration<double> idleSleepTime { 1.0 / 120.0 };
+        std::vector<Worker*> workers{};
+        std::atomic<bool> isRunning = false;
+        std::mutex mtx{};
+
+        // Applies added and removed, worker->mtx must be held.
+        void applyPending ( Worker* worker );
+        void runWorker ( Worker* worker );
+
+    public:
+        RenderThreadPool ( unsigned int threadCount );
+        ~RenderThreadPool ( );
+
+        // Spawns the worker threads, they are joined by the MainThreadRunner on shutdown.
+        void start ();
+        void stop ();
+
+        // Returns the thread the window will be rendered on, or nullptr if the pool is not running.
+        std::thread* addWindow ( AppWindow* window );
+
+        // The window may still finish a tick that already started when this returns.
+        void removeWindow ( AppWindow* window );
+
+        size_t getThreadCount ();
+
+};
+
+extern RenderThreadPool* renderThreadPool; // nullptr means one thread per window.
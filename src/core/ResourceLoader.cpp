@@ -0,0 +1,210 @@
+#include <iostream>
+#include "util/GlfwContextLock.h"
+#include "MainThreadRunner.h"
+#include "ResourceLoader.h"
+
+ResourceLoader::~ResourceLoader ( ) {
+    this->stop();
+}
+
+void ResourceLoader::start ( GLFWwindow* context ) {
+    std::lock_guard<std::mutex> lock(this->mtx);
+
+    if ( this->thread || !context ) {
+        return;
+    }
+
+    this->isRunning = true;
+    this->thread = new std::thread(&ResourceLoader::run, this, context);
+    mainThreadRunner->addChild(this->thread);
+}
+
+void ResourceLoader::stop ( ) {
+    {
+        std::lock_guard<std::mutex> lock(this->mtx);
+        this->isRunning = false;
+    }
+
+    this->cv.notify_all();
+}
+
+UploadTicket ResourceLoader::submit ( UploadJob job ) {
+    return this->enqueue(std::move(job));
+}
+
+UploadTicket ResourceLoader::uploadTexture ( int width, int height, std::vector<uint8_t> pixels, bool mipmaps ) {
+
+    if ( width <= 0 || height <= 0 || pixels.size() < size_t(width) * size_t(height) * 4 ) {
+        std::cout << "Texture upload of " << width << "x" << height << " got " << pixels.size() << " bytes" << std::endl;
+        return UploadTicket();
+    }
+
+    return this->enqueue([width, height, pixels = std::move(pixels), mipmaps]() -> GLuint {
+        GLuint texture = 0;
+        glGenTextures(1, &texture);
+        glBindTexture(GL_TEXTURE_2D, texture);
+
+        glPixelStorei(GL_UNPACK_ALIGNMENT, 4);
+        glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA8, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, pixels.data());
+
+        if ( mipmaps ) {
+            glGenerateMipmap(GL_TEXTURE_2D);
+        }
+
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, mipmaps ? GL_LINEAR_MIPMAP_LINEAR : GL_LINEAR);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        glBindTexture(GL_TEXTURE_2D, 0);
+
+        if ( glGetError() != GL_NO_ERROR ) {
+            std::cout << "Failed to upload a " << width << "x" << height << " texture" << std::endl;
+            glDeleteTextures(1, &texture);
+            return 0;
+        }
+
+        return texture;
+    });
+
+}
+
+UploadTicket ResourceLoader::uploadBuffer ( std::vector<uint8_t> data ) {
+
+    if ( data.empty() ) {
+        return UploadTicket();
+    }
+
+    return this->enqueue([data = std::move(data)]() -> GLuint {
+        GLuint buffer = 0;
+        glGenBuffers(1, &buffer);
+
+        // the copy target leaves the element binding of no vertex array behind.
+        glBindBuffer(GL_COPY_WRITE_BUFFER, buffer);
+        glBufferData(GL_COPY_WRITE_BUFFER, GLsizeiptr(data.size()), data.data(), GL_STATIC_DRAW);
+        glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+        if ( glGetError() != GL_NO_ERROR ) {
+            std::cout << "Failed to upload a buffer of " << data.size() << " bytes" << std::endl;
+            glDeleteBuffers(1, &buffer);
+            return 0;
+        }
+
+        return buffer;
+    });
+
+}
+
+size_t ResourceLoader::getPendingCount ( ) const {
+    return this->pendingCount.load(std::memory_order_relaxed);
+}
+
+UploadTicket ResourceLoader::enqueue ( UploadJob job ) {
+
+    UploadTicket ticket;
+    ticket.state = std::make_shared<UploadTicket::State>();
+
+    {
+        std::lock_guard<std::mutex> lock(this->mtx);
+
+        // a stopped loader never picks the job up.
+        if ( this->thread && !this->isRunning ) {
+            ticket.state->status.store(UPLOAD_FAILED, std::memory_order_release);
+            return ticket;
+        }
+
+        this->jobs.push_back({ std::move(job), ticket.state });
+        this->pendingCount++;
+    }
+
+    this->cv.notify_one();
+    return ticket;
+
+}
+
+void ResourceLoader::pollFences ( ) {
+
+    for ( size_t i = 0; i < this->inFlight.size(); ) {
+
+        InFlightJob& job = this->inFlight[i];
+        GLenum result = glClientWaitSync(job.fence, 0, 0);
+
+        if ( result == GL_TIMEOUT_EXPIRED ) {
+            ++i;
+            continue;
+        }
+
+        glDeleteSync(job.fence);
+
+        if ( result == GL_WAIT_FAILED ) {
+            job.state->status.store(UPLOAD_FAILED, std::memory_order_release);
+        } else {
+            job.state->handle = job.handle;
+            job.state->status.store(UPLOAD_READY, std::memory_order_release);
+        }
+
+        this->pendingCount--;
+        this->inFlight[i] = std::move(this->inFlight.back());
+        this->inFlight.pop_back();
+
+    }
+
+}
+
+void ResourceLoader::run ( GLFWwindow* context ) {
+
+    GlfwContextLock contextLock ( context );
+    std::unique_lock<std::mutex> lock(this->mtx);
+    std::vector<PendingJob> batch{};
+
+    auto hasWork = [this]() -> bool { return !this->jobs.empty() || !this->isRunning; };
+
+    while ( this->isRunning ) {
+
+        // fences are polled, GL has no way to wait on several at once.
+        if ( this->inFlight.empty() ) {
+            this->cv.wait(lock, hasWork);
+        } else {
+            this->cv.wait_for(lock, this->fencePollTime, hasWork);
+        }
+
+        batch.swap(this->jobs);
+        lock.unlock();
+
+        for ( PendingJob& pending : batch ) {
+            GLuint handle = pending.job();
+
+            if ( !handle ) {
+                pending.state->status.store(UPLOAD_FAILED, std::memory_order_release);
+                this->pendingCount--;
+                continue;
+            }
+
+            this->inFlight.push_back({ glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0), handle, pending.state });
+        }
+
+        // fences of an unflushed context may never signal.
+        if ( !batch.empty() ) {
+            glFlush();
+            batch.clear();
+        }
+
+        this->pollFences();
+        lock.lock();
+
+    }
+
+    for ( PendingJob& pending : this->jobs ) {
+        pending.state->status.store(UPLOAD_FAILED, std::memory_order_release);
+    }
+
+    this->jobs.clear();
+    lock.unlock();
+
+    // the shared context goes away with GLFW, the objects it made with it.
+    for ( InFlightJob& job : this->inFlight ) {
+        glDeleteSync(job.fence);
+        job.state->status.store(UPLOAD_FAILED, std::memory_order_release);
+    }
+
+    this->inFlight.clear();
+    this->pendingCount = 0;
+
+}
@@ -0,0 +1,118 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <stdint.h>
+#include <memory>
+#include <vector>
+#include <thread>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <glad/glad.h>
+#include <glfw/glfw3.h>
+
+enum UploadStatus : int {
+    UPLOAD_PENDING,
+    UPLOAD_READY,
+    UPLOAD_FAILED
+};
+
+// Handed back by the ResourceLoader for every upload. Polling it never blocks, so render
+// threads can check it once per frame and keep drawing a placeholder until it is ready.
+class UploadTicket {
+
+    friend class ResourceLoader;
+
+    private:
+        struct State {
+            std::atomic<int> status { UPLOAD_PENDING };
+            GLuint handle = 0; // written before status turns ready
+        };
+
+        std::shared_ptr<State> state{};
+
+    public:
+        UploadTicket ( ) { }
+
+        inline UploadStatus getStatus ( ) const {
+            return this->state ? static_cast<UploadStatus>(this->state->status.load(std::memory_order_acquire)) : UPLOAD_FAILED;
+        }
+
+        inline bool isReady ( ) const {
+            return this->getStatus() == UPLOAD_READY;
+        }
+
+        // The texture or buffer name once ready, 0 before.
+        inline GLuint getHandle ( ) const {
+            return this->isReady() ? this->state->handle : 0;
+        }
+
+};
+
+// Creates a GL object on the loader thread and returns its name, 0 if it failed.
+using UploadJob = std::function<GLuint()>;
+
+// Uploads textures and buffers on a thread of its own so large uploads never stall a frame.
+// The thread owns the hidden shared context, every window shares its objects with it.
+// Each job is followed by a fence and its ticket only turns ready once the GPU passed it,
+// so the object is complete when a render thread first sees it. Render threads must bind the
+// object after that, a binding made before the upload finished may still see the old contents.
+// Vertex arrays are never shared by GL, meshes are uploaded as buffers and each window builds
+// its own vertex array around them.
+class ResourceLoader {
+
+    private:
+        struct PendingJob {
+            UploadJob job;
+            std::shared_ptr<UploadTicket::State> state;
+        };
+
+        struct InFlightJob {
+            GLsync fence;
+            GLuint handle;
+            std::shared_ptr<UploadTicket::State> state;
+        };
+
+        std::chrono::duration<double> fencePollTime { 1.0 / 1000.0 };
+        std::vector<PendingJob> jobs{};
+        std::vector<InFlightJob> inFlight{};
+        std::atomic<size_t> pendingCount = 0;
+        std::atomic<bool> isRunning = false;
+        std::thread* thread = nullptr;
+        std::condition_variable cv{};
+        std::mutex mtx{};
+
+        void run ( GLFWwindow* context );
+        void pollFences ( );
+        UploadTicket enqueue ( UploadJob job );
+
+    public:
+        ResourceLoader ( ) { }
+        ~ResourceLoader ( );
+
+        ResourceLoader ( const ResourceLoader& ) = delete;
+        ResourceLoader& operator= ( const ResourceLoader& ) = delete;
+
+        // Spawns the loader thread on context, it is joined by the MainThreadRunner on shutdown.
+        // GL must already be loaded. Must only be called from the main thread.
+        void start ( GLFWwindow* context );
+
+        // Jobs that did not run yet fail.
+        void stop ( );
+
+        // Runs job with the loader's context current and fences it. May be called from any thread.
+        UploadTicket submit ( UploadJob job );
+
+        // RGBA8 texture, mipmapped and trilinear when mipmaps is set.
+        UploadTicket uploadTexture ( int width, int height, std::vector<uint8_t> pixels, bool mipmaps = true );
+
+        // Static buffer for vertices, indices or uniforms, the target is picked when binding it.
+        UploadTicket uploadBuffer ( std::vector<uint8_t> data );
+
+        // Jobs submitted whose tickets are still pending.
+        size_t getPendingCount ( ) const;
+
+};
+
+extern ResourceLoader* resourceLoader; // nullptr means there is no loader thread.
@@ -0,0 +1,62 @@
+#include "StartupTimer.h"
+#include <iostream>
+#include <iomanip>
+#include <atomic>
+#include <vector>
+#include <thread>
+#include <mutex>
+
+using highResClock = std::chrono::high_resolution_clock;
+
+struct PhaseRecord {
+    const char* name;
+    highResClock::time_point start;
+    highResClock::time_point end;
+    std::thread::id threadId;
+};
+
+// initialized during static init, as close to process start as we can get.
+static const highResClock::time_point processStart = highResClock::now();
+static const std::thread::id mainThreadId = std::this_thread::get_id();
+
+static std::vector<PhaseRecord> phases{};
+static std::atomic<bool> hasReported = false;
+static std::mutex phaseMtx;
+
+static double msSinceStart ( highResClock::time_point timepoint ) {
+    return std::chrono::duration<double, std::milli>(timepoint - processStart).count();
+}
+
+void recordStartupPhase ( const char* name, highResClock::time_point start, highResClock::time_point end ) {
+
+    if ( hasReported ) {
+        return;
+    }
+
+    std::lock_guard<std::mutex> lock(phaseMtx);
+    phases.push_back({ name, start, end, std::this_thread::get_id() });
+}
+
+void reportFirstFrame ( ) {
+
+    if ( hasReported.exchange(true) ) {
+        return;
+    }
+
+    highResClock::time_point firstFrame = highResClock::now();
+    std::lock_guard<std::mutex> lock(phaseMtx);
+
+    std::cout << "Time to first frame: " << std::fixed << std::setprecision(2)
+        << msSinceStart(firstFrame) << "ms" << std::endl;
+
+    for ( auto& phase : phases ) {
+        std::cout << "    " << std::setw(24) << std::left << phase.name << std::right
+            << " start " << std::setw(8) << msSinceStart(phase.start) << "ms"
+            << "  took " << std::setw(8) << std::chrono::duration<double, std::milli>(phase.end - phase.start).count() << "ms"
+            << ( phase.threadId == mainThreadId ? "" : "  (parallel)" ) << std::endl;
+    }
+
+    std::cout << std::defaultfloat;
+    phases.clear();
+
+}
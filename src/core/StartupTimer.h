@@ -0,0 +1,28 @@
+#pragma once
+
+#include <chrono>
+
+// Time-to-first-frame breakdown, printed once the first frame of any window has been presented.
+// Phases may be recorded from any thread, overlapping phases ran in parallel.
+
+void recordStartupPhase ( const char* name,
+    std::chrono::high_resolution_clock::time_point start,
+    std::chrono::high_resolution_clock::time_point end );
+
+void reportFirstFrame ( );
+
+// similar to std::lock_guard, records the phase when it goes out of scope.
+struct StartupPhase {
+
+    private:
+        std::chrono::high_resolution_clock::time_point start;
+        const char* name;
+
+    public:
+        StartupPhase ( const char* phaseName ) : start(std::chrono::high_resolution_clock::now()), name(phaseName) { }
+
+        ~StartupPhase ( ) {
+            recordStartupPhase ( this->name, this->start, std::chrono::high_resolution_clock::now() );
+        }
+
+};
@@ -1,18 +1,36 @@
 #include <iostream>
+#include <future>
 #include <glad/glad.h>
 #include <glfw/glfw3.h>
 #include "core/MainThreadRunner.h"
+#include "core/RenderThreadPool.h"
+#include "core/ResourceLoader.h"
+#include "core/StartupTimer.h"
 #include "input/Keybindings.h"
 #include "core/AppWindow.h"
+#include "util/Kernels.h"
 
 MainThreadRunner* mainThreadRunner = nullptr;
+RenderThreadPool* renderThreadPool = nullptr; // assign and start() before any window init to pool render threads.
+ResourceLoader* resourceLoader = nullptr; // started on the shared context by the first window.
 
 int main(int argc, char** args) 
 {
+    std::cout << "Kernels: " << initKernels() << " (" << describeCpuFeatures(getCpuFeatures()) << ")" << std::endl;
     mainThreadRunner = new MainThreadRunner();
-    initGlfw();
+    resourceLoader = new ResourceLoader();
+
+    // Work that needs neither GLFW nor a GL context runs alongside window creation.
+    std::future<void> keyBinds = std::async(std::launch::async, []() -> void {
+        StartupPhase phase("registerKeyBinds");
+        registerKeyBinds();
+    });
+
+    {
+        StartupPhase phase("initGlfw");
+        initGlfw();
+    }
 
-    registerKeyBinds();
     mainThreadRunner->addRepeating ([]() -> void { glfwPollEvents(); });
 
     AppWindow window("Test Window");
@@ -23,6 +41,8 @@ int main(int argc, char** args)
         return 1;
     }
 
+    keyBinds.wait(); // key events are only polled once the runner starts.
+
     mainThreadRunner->start();
     
     stopGlfw();
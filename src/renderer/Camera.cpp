@@ -0,0 +1,145 @@
+#include "Camera.h"
+
+constexpr uint8_t VIEW_DIRTY_FLAG       = 0b1;
+constexpr uint8_t PROJECTION_DIRTY_FLAG = 0b10;
+
+void Camera::updateMatrices ( ) const {
+
+    if ( this->dirtyFlags & VIEW_DIRTY_FLAG ) {
+        // the camera transform is rigid, so its inverse is the affine one.
+        this->view = (Matrix4f::Translation(this->pos) * Matrix4f::Rotation(this->rotation)).InverseAffine();
+    }
+
+    if ( this->dirtyFlags & PROJECTION_DIRTY_FLAG ) {
+        this->projection = Matrix4f::Perspective(this->fovY, this->aspect, this->zNear, this->zFar);
+    }
+
+    this->viewProjection = this->projection * this->view;
+    this->frustum = Frustum::FromMatrix(this->viewProjection);
+    this->dirtyFlags = 0;
+
+}
+
+void Camera::setPos ( Vector3f newPos ) {
+    if ( this->pos.X != newPos.X || this->pos.Y != newPos.Y || this->pos.Z != newPos.Z ) {
+        this->pos = newPos;
+        this->dirtyFlags |= VIEW_DIRTY_FLAG;
+    }
+}
+
+Vector3f Camera::getPos ( ) const {
+    return this->pos;
+}
+
+void Camera::setRotation ( Quaternion newRotation ) {
+    if ( this->rotation != newRotation ) {
+        this->rotation = newRotation;
+        this->dirtyFlags |= VIEW_DIRTY_FLAG;
+    }
+}
+
+Quaternion Camera::getRotation ( ) const {
+    return this->rotation;
+}
+
+void Camera::lookAt ( Vector3f target, Vector3f up ) {
+
+    // the rotation part of a LookAt matrix is the transposed camera basis.
+    Matrix4f basis = Matrix4f::LookAt(this->pos, target, up).Transposed();
+    float m00 = basis.Get(0, 0), m11 = basis.Get(1, 1), m22 = basis.Get(2, 2);
+    float trace = m00 + m11 + m22;
+    Quaternion rot;
+
+    if ( trace > 0 ) {
+        float s = sqrtf(trace + 1) * 2;
+        rot = Quaternion((basis.Get(2, 1) - basis.Get(1, 2)) / s, (basis.Get(0, 2) - basis.Get(2, 0)) / s,
+            (basis.Get(1, 0) - basis.Get(0, 1)) / s, 0.25F * s);
+    } else if ( m00 > m11 && m00 > m22 ) {
+        float s = sqrtf(1 + m00 - m11 - m22) * 2;
+        rot = Quaternion(0.25F * s, (basis.Get(0, 1) + basis.Get(1, 0)) / s,
+            (basis.Get(0, 2) + basis.Get(2, 0)) / s, (basis.Get(2, 1) - basis.Get(1, 2)) / s);
+    } else if ( m11 > m22 ) {
+        float s = sqrtf(1 + m11 - m00 - m22) * 2;
+        rot = Quaternion((basis.Get(0, 1) + basis.Get(1, 0)) / s, 0.25F * s,
+            (basis.Get(1, 2) + basis.Get(2, 1)) / s, (basis.Get(0, 2) - basis.Get(2, 0)) / s);
+    } else {
+        float s = sqrtf(1 + m22 - m00 - m11) * 2;
+        rot = Quaternion((basis.Get(0, 2) + basis.Get(2, 0)) / s, (basis.Get(1, 2) + basis.Get(2, 1)) / s,
+            0.25F * s, (basis.Get(1, 0) - basis.Get(0, 1)) / s);
+    }
+
+    this->setRotation(rot.Normalized());
+
+}
+
+Vector3f Camera::getForward ( ) const {
+    return this->rotation.Rotate(Vector3f(0, 0, -1));
+}
+
+Vector3f Camera::getRight ( ) const {
+    return this->rotation.Rotate(Vector3f(1, 0, 0));
+}
+
+Vector3f Camera::getUp ( ) const {
+    return this->rotation.Rotate(Vector3f(0, 1, 0));
+}
+
+void Camera::setPerspective ( float newFovY, float newNear, float newFar ) {
+    if ( this->fovY != newFovY || this->zNear != newNear || this->zFar != newFar ) {
+        this->fovY = newFovY;
+        this->zNear = newNear;
+        this->zFar = newFar;
+        this->dirtyFlags |= PROJECTION_DIRTY_FLAG;
+    }
+}
+
+void Camera::setViewport ( int width, int height ) {
+
+    if ( width <= 0 || height <= 0 ) {
+        return; // minimized windows report a 0x0 framebuffer.
+    }
+
+    float newAspect = static_cast<float>(width) / height;
+
+    if ( this->aspect != newAspect ) {
+        this->aspect = newAspect;
+        this->dirtyFlags |= PROJECTION_DIRTY_FLAG;
+    }
+
+}
+
+float Camera::getFieldOfView ( ) const {
+    return this->fovY;
+}
+
+float Camera::getAspectRatio ( ) const {
+    return this->aspect;
+}
+
+float Camera::getNearPlane ( ) const {
+    return this->zNear;
+}
+
+float Camera::getFarPlane ( ) const {
+    return this->zFar;
+}
+
+const Matrix4f& Camera::getView ( ) const {
+    if ( this->dirtyFlags ) { this->updateMatrices(); }
+    return this->view;
+}
+
+const Matrix4f& Camera::getProjection ( ) const {
+    if ( this->dirtyFlags ) { this->updateMatrices(); }
+    return this->projection;
+}
+
+const Matrix4f& Camera::getViewProjection ( ) const {
+    if ( this->dirtyFlags ) { this->updateMatrices(); }
+    return this->viewProjection;
+}
+
+const Frustum& Camera::getFrustum ( ) const {
+    if ( this->dirtyFlags ) { this->updateMatrices(); }
+    return this->frustum;
+}
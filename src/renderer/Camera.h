@@ -1,10 +1,65 @@
-
 #pragma once
 
+#include <stdint.h>
 #include "util/Vectors.h"
+#include "util/math/Frustum.h"
+#include "util/math/Matrix4f.h"
+#include "util/math/Quaternion.h"
+
+// Caches its view, projection and view-projection matrices and the frustum, they are only rebuilt
+// when the pose or viewport changed since the last get.
+class Camera {
+
+    private:
+        Vector3f pos{};
+        Quaternion rotation{};
+
+        float fovY = 1.22173F; // 70 degrees
+        float aspect = 16.0F / 9.0F;
+        float zNear = 0.1F;
+        float zFar = 1000.0F;
+
+        mutable uint8_t dirtyFlags = 0b11;
+        mutable Matrix4f view{};
+        mutable Matrix4f projection{};
+        mutable Matrix4f viewProjection{};
+        mutable Frustum frustum{};
+
+        void updateMatrices ( ) const;
+
+    public:
+        Camera ( ) { }
+        Camera ( Vector3f pos, Quaternion rotation ) : pos(pos), rotation(rotation) { }
+
+        void setPos ( Vector3f newPos );
+        Vector3f getPos ( ) const;
+
+        // rotation must be normalized.
+        void setRotation ( Quaternion newRotation );
+        Quaternion getRotation ( ) const;
+
+        void lookAt ( Vector3f target, Vector3f up );
+        inline void lookAt ( Vector3f target ) { this->lookAt(target, Vector3f(0, 1, 0)); }
+
+        Vector3f getForward ( ) const;
+        Vector3f getRight ( ) const;
+        Vector3f getUp ( ) const;
+
+        // fovY is in radians.
+        void setPerspective ( float fovY, float zNear, float zFar );
+        void setViewport ( int width, int height );
+        inline void setViewport ( Vector2i size ) { this->setViewport(size.X, size.Y); }
+
+        float getFieldOfView ( ) const;
+        float getAspectRatio ( ) const;
+        float getNearPlane ( ) const;
+        float getFarPlane ( ) const;
+
+        const Matrix4f& getView ( ) const;
+        const Matrix4f& getProjection ( ) const;
+        const Matrix4f& getViewProjection ( ) const;
 
-struct Camera {
-    Vector3f pos;
-    
+        // World space planes of the view-projection.
+        const Frustum& getFrustum ( ) const;
 
-};
\ No newline at end of file
+};
@@ -0,0 +1,94 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <glad/glad.h>
+#include "util/math/Matrix4f.h"
+#include "util/RadixSort.h"
+
+// 64 bit draw sort keys, compared as plain integers so the most significant field wins.
+//   opaque       | layer 8 | shader 12 | material 20 | depth 24 |  front to back inside a material
+//   translucent  | layer 8 | ~depth 24 | shader 12 | material 20 |  back to front, state second
+// Shader and material are ids, not GL names, they only need to be equal for equal state.
+static constexpr int SORT_KEY_LAYER_BITS = 8;
+static constexpr int SORT_KEY_SHADER_BITS = 12;
+static constexpr int SORT_KEY_MATERIAL_BITS = 20;
+static constexpr int SORT_KEY_DEPTH_BITS = 24;
+
+static constexpr uint32_t SORT_KEY_DEPTH_MAX = (1U << SORT_KEY_DEPTH_BITS) - 1;
+
+// Linear view depth mapped to [0, SORT_KEY_DEPTH_MAX], clamped to the near and far plane.
+inline uint32_t quantizeSortDepth ( float viewDepth, float zNear, float zFar ) noexcept {
+    float normalized = (viewDepth - zNear) / (zFar - zNear);
+    normalized = normalized < 0 ? 0 : (normalized > 1 ? 1 : normalized);
+    return static_cast<uint32_t>(normalized * SORT_KEY_DEPTH_MAX);
+}
+
+constexpr inline uint64_t makeOpaqueSortKey ( uint32_t layer, uint32_t shader, uint32_t material, uint32_t depth ) noexcept {
+    return (static_cast<uint64_t>(layer & 0xFF) << 56) | (static_cast<uint64_t>(shader & 0xFFF) << 44)
+        | (static_cast<uint64_t>(material & 0xFFFFF) << 24) | (depth & SORT_KEY_DEPTH_MAX);
+}
+
+constexpr inline uint64_t makeTranslucentSortKey ( uint32_t layer, uint32_t shader, uint32_t material, uint32_t depth ) noexcept {
+    return (static_cast<uint64_t>(layer & 0xFF) << 56) | (static_cast<uint64_t>(SORT_KEY_DEPTH_MAX - (depth & SORT_KEY_DEPTH_MAX)) << 32)
+        | (static_cast<uint64_t>(shader & 0xFFF) << 20) | (material & 0xFFFFF);
+}
+
+constexpr inline uint32_t getSortKeyLayer ( uint64_t key ) noexcept {
+    return static_cast<uint32_t>(key >> 56);
+}
+
+// Everything a draw needs, the renderer binds what differs from the previous packet.
+// indexType 0 draws arrays from first, otherwise elements starting at index first.
+struct DrawPacket {
+    Matrix4f model{};
+    GLuint program = 0;
+    GLuint vertexArray = 0;
+    GLuint texture = 0;
+    GLenum mode = GL_TRIANGLES;
+    GLenum indexType = 0;
+    GLint first = 0;
+    GLsizei count = 0;
+    GLsizei instanceCount = 1;
+};
+
+// Draw packets recorded by one thread. Only the 16 byte keys get sorted, packets stay where
+// they were recorded and are looked up by the key's value.
+class CommandBuffer {
+
+    private:
+        std::vector<DrawPacket> packets{};
+        std::vector<RadixSortItem> keys{};
+
+    public:
+        CommandBuffer ( ) { }
+
+        inline void draw ( uint64_t key, const DrawPacket& packet ) {
+            this->keys.push_back({ key, static_cast<uint32_t>(this->packets.size()) });
+            this->packets.push_back(packet);
+        }
+
+        // Keeps the capacity, a buffer reaches its steady size after a few frames.
+        inline void clear ( ) {
+            this->packets.clear();
+            this->keys.clear();
+        }
+
+        inline void reserve ( size_t count ) {
+            this->packets.reserve(count);
+            this->keys.reserve(count);
+        }
+
+        inline size_t size ( ) const {
+            return this->packets.size();
+        }
+
+        inline const DrawPacket& getPacket ( size_t index ) const {
+            return this->packets[index];
+        }
+
+        inline const std::vector<RadixSortItem>& getKeys ( ) const {
+            return this->keys;
+        }
+
+};
@@ -0,0 +1,188 @@
+#include <iostream>
+#include "FrameProfiler.h"
+
+static inline double toMs ( std::chrono::high_resolution_clock::duration duration ) {
+    return std::chrono::duration<double, std::milli>(duration).count();
+}
+
+bool FrameProfiler::init ( bool gpuTimers ) {
+
+    this->destroy();
+
+    if ( gpuTimers ) {
+        GLint bits = 0;
+        glGetQueryiv(GL_TIMESTAMP, GL_QUERY_COUNTER_BITS, &bits);
+
+        if ( bits == 0 ) {
+            std::cout << "GL has no timestamp queries, only profiling the CPU" << std::endl;
+            gpuTimers = false;
+        }
+    }
+
+    if ( gpuTimers ) {
+        for ( FrameRecord& frame : this->frames ) {
+            glGenQueries(MAX_PROFILER_SCOPES * 2, frame.queries);
+        }
+    }
+
+    for ( FrameRecord& frame : this->frames ) {
+        frame.scopes.reserve(MAX_PROFILER_SCOPES);
+    }
+
+    this->gpuTimers = gpuTimers;
+    return gpuTimers;
+
+}
+
+void FrameProfiler::destroy ( ) {
+
+    if ( this->gpuTimers ) {
+        for ( FrameRecord& frame : this->frames ) {
+            glDeleteQueries(MAX_PROFILER_SCOPES * 2, frame.queries);
+        }
+    }
+
+    for ( FrameRecord& frame : this->frames ) {
+        frame = FrameRecord{};
+    }
+
+    this->current = nullptr;
+    this->openScopes.clear();
+    this->lastFrame = {};
+    this->gpuTimers = false;
+
+}
+
+void FrameProfiler::beginFrame ( ) {
+
+    if ( !this->enabled ) {
+        return;
+    }
+
+    FrameRecord& frame = this->frames[this->frameIndex % PROFILER_FRAME_LATENCY];
+
+    if ( frame.isPending ) {
+        this->resolve(frame);
+    }
+
+    frame.frameIndex = this->frameIndex++;
+    frame.scopes.clear();
+    frame.isPending = false;
+
+    this->current = &frame;
+    this->openScopes.clear();
+    this->beginScope("frame");
+
+}
+
+void FrameProfiler::endFrame ( ) {
+
+    if ( !this->current ) {
+        return;
+    }
+
+    while ( !this->openScopes.empty() ) {
+        this->endScope();
+    }
+
+    this->current->isPending = true;
+    this->current = nullptr;
+
+}
+
+void FrameProfiler::beginScope ( const char* name ) {
+
+    if ( !this->current ) {
+        return;
+    }
+
+    FrameRecord& frame = *this->current;
+
+    // dropped scopes still nest, so the matching endScope closes nothing.
+    if ( frame.scopes.size() >= MAX_PROFILER_SCOPES ) {
+        this->openScopes.push_back(-1);
+        return;
+    }
+
+    int index = static_cast<int>(frame.scopes.size());
+    frame.scopes.push_back({ name, static_cast<int>(this->openScopes.size()), Clock::now(), {} });
+    this->openScopes.push_back(index);
+
+    if ( this->gpuTimers ) {
+        glQueryCounter(frame.queries[index * 2], GL_TIMESTAMP);
+    }
+
+}
+
+void FrameProfiler::endScope ( ) {
+
+    if ( !this->current || this->openScopes.empty() ) {
+        return;
+    }
+
+    int index = this->openScopes.back();
+    this->openScopes.pop_back();
+
+    if ( index < 0 ) {
+        return;
+    }
+
+    this->current->scopes[index].cpuEnd = Clock::now();
+
+    if ( this->gpuTimers ) {
+        glQueryCounter(this->current->queries[index * 2 + 1], GL_TIMESTAMP);
+    }
+
+}
+
+void FrameProfiler::setEnabled ( bool enabled ) {
+
+    if ( !enabled ) {
+        this->endFrame();
+    }
+
+    this->enabled = enabled;
+
+}
+
+bool FrameProfiler::isEnabled ( ) const {
+    return this->enabled;
+}
+
+void FrameProfiler::resolve ( FrameRecord& frame ) {
+
+    ProfileFrame& out = this->lastFrame;
+    out.frameIndex = frame.frameIndex;
+    out.scopes.resize(frame.scopes.size());
+
+    // asking for a result that is not available yet would block until it is.
+    bool gpuAvailable = this->gpuTimers;
+
+    for ( size_t i = 0; gpuAvailable && i < frame.scopes.size() * 2; ++i ) {
+        GLint available = 0;
+        glGetQueryObjectiv(frame.queries[i], GL_QUERY_RESULT_AVAILABLE, &available);
+        gpuAvailable = available != 0;
+    }
+
+    for ( size_t i = 0; i < frame.scopes.size(); ++i ) {
+        const ScopeRecord& scope = frame.scopes[i];
+        ProfileScopeTiming& timing = out.scopes[i];
+
+        timing.name = scope.name;
+        timing.depth = scope.depth;
+        timing.cpuMs = toMs(scope.cpuEnd - scope.cpuBegin);
+        timing.gpuMs = -1;
+
+        if ( gpuAvailable ) {
+            GLuint64 begin = 0, end = 0;
+            glGetQueryObjectui64v(frame.queries[i * 2], GL_QUERY_RESULT, &begin);
+            glGetQueryObjectui64v(frame.queries[i * 2 + 1], GL_QUERY_RESULT, &end);
+            timing.gpuMs = end >= begin ? double(end - begin) / 1e6 : 0.0;
+        }
+    }
+
+    out.cpuMs = out.scopes.empty() ? 0 : out.scopes[0].cpuMs;
+    out.gpuMs = out.scopes.empty() ? -1 : out.scopes[0].gpuMs;
+    frame.isPending = false;
+
+}
@@ -0,0 +1,111 @@
+#pragma once
+
+#include <stdint.h>
+#include <chrono>
+#include <vector>
+#include <glad/glad.h>
+
+static constexpr int MAX_PROFILER_SCOPES = 64;    // per frame, the frame itself included
+static constexpr int PROFILER_FRAME_LATENCY = 4;  // frames until a frame's timings are read back
+
+struct ProfileScopeTiming {
+    const char* name = nullptr;
+    int depth = 0;       // 0 is the frame, nested scopes count up
+    double cpuMs = 0;
+    double gpuMs = -1;   // GPU time between the scope's begin and end, negative when unknown
+};
+
+// Where the time of one frame went, scopes in the order they began.
+struct ProfileFrame {
+    uint64_t frameIndex = 0;
+    double cpuMs = 0;
+    double gpuMs = -1;
+    std::vector<ProfileScopeTiming> scopes{};
+};
+
+// Times nested scopes of a frame on the CPU and with GL_TIMESTAMP queries on the GPU.
+// Timestamps are used over GL_TIME_ELAPSED as elapsed queries can not nest. Query results are
+// read PROFILER_FRAME_LATENCY frames late, once the GPU is done with them, so reading never
+// stalls. A frame whose queries are still not available then only reports CPU times.
+// Without a context or when the implementation has no timestamp bits, as some software
+// implementations do, it runs CPU only.
+// Only use it from the thread the context is current on.
+class FrameProfiler {
+
+    private:
+        using Clock = std::chrono::high_resolution_clock;
+
+        struct ScopeRecord {
+            const char* name;
+            int depth;
+            Clock::time_point cpuBegin, cpuEnd;
+        };
+
+        struct FrameRecord {
+            uint64_t frameIndex = 0;
+            std::vector<ScopeRecord> scopes{};
+            GLuint queries[MAX_PROFILER_SCOPES * 2]{}; // begin and end of each scope
+            bool isPending = false;
+        };
+
+        FrameRecord frames[PROFILER_FRAME_LATENCY]{};
+        FrameRecord* current = nullptr;
+        std::vector<int> openScopes{};
+        ProfileFrame lastFrame{};
+        uint64_t frameIndex = 0;
+        bool gpuTimers = false;
+        bool enabled = true;
+
+        void resolve ( FrameRecord& frame );
+
+    public:
+        FrameProfiler ( ) { }
+
+        FrameProfiler ( const FrameProfiler& ) = delete;
+        FrameProfiler& operator= ( const FrameProfiler& ) = delete;
+
+        // Creates the queries, the context must be current. gpuTimers false or a context
+        // without timestamp bits only times the CPU. Returns whether GPU times are measured.
+        bool init ( bool gpuTimers = true );
+        void destroy ( );
+
+        // Reads back the frame that last used this frame's queries, then opens the frame scope.
+        void beginFrame ( );
+        void endFrame ( );
+
+        // Scopes must nest and close before endFrame, ones past MAX_PROFILER_SCOPES are dropped.
+        // name must outlive the frame's read back, string literals do.
+        void beginScope ( const char* name );
+        void endScope ( );
+
+        // Disabled, frames and scopes are no-ops.
+        void setEnabled ( bool enabled );
+        bool isEnabled ( ) const;
+
+        inline bool hasGpuTimers ( ) const {
+            return this->gpuTimers;
+        }
+
+        // The most recent frame that was read back, PROFILER_FRAME_LATENCY frames old.
+        inline const ProfileFrame& getLastFrame ( ) const {
+            return this->lastFrame;
+        }
+
+};
+
+// similar to std::lock_guard, ends the scope when it goes out of scope.
+struct ProfileScope {
+
+    private:
+        FrameProfiler& profiler;
+
+    public:
+        ProfileScope ( FrameProfiler& frameProfiler, const char* name ) : profiler(frameProfiler) {
+            this->profiler.beginScope(name);
+        }
+
+        ~ProfileScope ( ) {
+            this->profiler.endScope();
+        }
+
+};
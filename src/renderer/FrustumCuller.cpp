@@ -0,0 +1,195 @@
+#include <algorithm>
+#include <string.h>
+#include <chrono>
+#include "util/JobPool.h"
+#include "FrustumCuller.h"
+
+using highResClock = std::chrono::high_resolution_clock;
+
+static constexpr size_t CULL_LANES = 8;
+
+// Frustum planes broadcast once per range, abs normals give the box projection radius.
+struct FrustumPacket {
+    simd8f nx[FRUSTUM_PLANES], ny[FRUSTUM_PLANES], nz[FRUSTUM_PLANES], offset[FRUSTUM_PLANES];
+    simd8f ax[FRUSTUM_PLANES], ay[FRUSTUM_PLANES], az[FRUSTUM_PLANES];
+
+    inline FrustumPacket ( const Frustum& frustum ) noexcept {
+        for ( int i = 0; i < FRUSTUM_PLANES; ++i ) {
+            const Vector3f& n = frustum.Normals[i];
+            this->nx[i] = simd8f_set1(n.X); this->ny[i] = simd8f_set1(n.Y); this->nz[i] = simd8f_set1(n.Z);
+            this->ax[i] = simd8f_set1(std::fabs(n.X)); this->ay[i] = simd8f_set1(std::fabs(n.Y)); this->az[i] = simd8f_set1(std::fabs(n.Z));
+            this->offset[i] = simd8f_set1(frustum.Offsets[i]);
+        }
+    }
+
+    inline simd8f getDistance ( int i, const Vector3fx8& point ) const noexcept {
+        return simd_madd(this->nz[i], point.Z, simd_madd(this->ny[i], point.Y, simd_madd(this->nx[i], point.X, this->offset[i])));
+    }
+};
+
+// Appends the indices of the set lanes without branching on them, every lane is written and
+// the cursor only advances past the visible ones. Needs 8 free slots at out + n.
+static inline size_t appendVisible ( uint32_t* out, size_t n, uint32_t base, int mask ) noexcept {
+    for ( uint32_t lane = 0; lane < CULL_LANES; ++lane ) {
+        out[n] = base + lane;
+        n += (mask >> lane) & 1;
+    }
+
+    return n;
+}
+
+// Drops the lanes past count in the last packet, they hold the stream padding.
+static inline int maskTail ( int mask, size_t base, size_t count ) noexcept {
+    return base + CULL_LANES > count ? mask & ((1 << (count - base)) - 1) : mask;
+}
+
+static size_t cullBoxRange ( const FrustumPacket& frustum, const BoxBounds& bounds, size_t begin, size_t end, uint32_t* out ) {
+    simd8f zero = simd8f_set1(0);
+    size_t n = 0, count = bounds.size();
+
+    for ( size_t i = begin; i < end; i += CULL_LANES ) {
+        Vector3fx8 center = bounds.Center.loadPacket<simd8f>(i);
+        Vector3fx8 extent = bounds.Extent.loadPacket<simd8f>(i);
+        simd8f inside = simd_cmpge(zero, zero);
+
+        for ( int p = 0; p < FRUSTUM_PLANES; ++p ) {
+            simd8f radius = simd_madd(frustum.az[p], extent.Z, simd_madd(frustum.ay[p], extent.Y, simd_mul(frustum.ax[p], extent.X)));
+            inside = simd_and(inside, simd_cmpge(simd_add(frustum.getDistance(p, center), radius), zero));
+        }
+
+        n = appendVisible(out, n, static_cast<uint32_t>(i), maskTail(simd_mask(inside), i, count));
+    }
+
+    return n;
+}
+
+static size_t cullSphereRange ( const FrustumPacket& frustum, const SphereBounds& bounds, size_t begin, size_t end, uint32_t* out ) {
+    simd8f zero = simd8f_set1(0);
+    size_t n = 0, count = bounds.size();
+
+    for ( size_t i = begin; i < end; i += CULL_LANES ) {
+        Vector3fx8 center = bounds.Center.loadPacket<simd8f>(i);
+        simd8f radius = simd8f_load(&bounds.Radius[i]);
+        simd8f inside = simd_cmpge(zero, zero);
+
+        for ( int p = 0; p < FRUSTUM_PLANES; ++p ) {
+            inside = simd_and(inside, simd_cmpge(simd_add(frustum.getDistance(p, center), radius), zero));
+        }
+
+        n = appendVisible(out, n, static_cast<uint32_t>(i), maskTail(simd_mask(inside), i, count));
+    }
+
+    return n;
+}
+
+FrustumCuller::FrustumCuller ( unsigned int threadCount ) {
+    this->threadCount = threadCount ? threadCount : getJobPool().getThreadCount();
+}
+
+template<typename Body>
+void FrustumCuller::runRanges ( size_t count, std::vector<size_t>& rangeStarts, std::vector<size_t>& rangeVisible, Body body ) {
+
+    size_t packets = (count + CULL_LANES - 1) / CULL_LANES;
+    size_t ranges = count < this->parallelThreshold ? 1 : std::min(this->threadCount, packets);
+    size_t packetsPerRange = ranges ? (packets + ranges - 1) / ranges : 0;
+
+    rangeStarts.assign(this->threadCount + 1, packets * CULL_LANES);
+    rangeVisible.assign(this->threadCount, 0);
+
+    for ( size_t i = 0; i < ranges; ++i ) {
+        rangeStarts[i] = std::min(packets, i * packetsPerRange) * CULL_LANES;
+    }
+
+    auto runRange = [&]( size_t range ) {
+        if ( rangeStarts[range] < rangeStarts[range + 1] ) {
+            rangeVisible[range] = body(rangeStarts[range], rangeStarts[range + 1]);
+        }
+    };
+
+    getJobPool().run(ranges, runRange);
+
+}
+
+size_t FrustumCuller::compact ( uint32_t* out, const std::vector<size_t>& rangeStarts, const std::vector<size_t>& rangeVisible ) {
+
+    size_t total = rangeVisible[0];
+
+    for ( size_t i = 1; i < rangeVisible.size(); ++i ) {
+        memmove(out + total, out + rangeStarts[i], rangeVisible[i] * sizeof(uint32_t));
+        total += rangeVisible[i];
+    }
+
+    return total;
+
+}
+
+void FrustumCuller::addStats ( size_t tested, size_t visible, double milliseconds ) {
+    this->lastStats.tested = tested;
+    this->lastStats.visible = visible;
+    this->lastStats.milliseconds = milliseconds;
+
+    this->frameStats.tested += tested;
+    this->frameStats.visible += visible;
+    this->frameStats.milliseconds += milliseconds;
+}
+
+size_t FrustumCuller::cullBoxes ( const Frustum& frustum, const BoxBounds& bounds, std::vector<uint32_t>& visible ) {
+
+    highResClock::time_point start = highResClock::now();
+    FrustumPacket packet(frustum);
+    std::vector<size_t> rangeStarts, rangeVisible;
+
+    // each range writes from its own start, which leaves room for the full padded set.
+    visible.resize(bounds.Center.paddedSize());
+    uint32_t* out = visible.data();
+
+    this->runRanges(bounds.size(), rangeStarts, rangeVisible, [&]( size_t begin, size_t end ) {
+        return cullBoxRange(packet, bounds, begin, end, out + begin);
+    });
+
+    visible.resize(this->compact(out, rangeStarts, rangeVisible));
+    this->addStats(bounds.size(), visible.size(), std::chrono::duration<double, std::milli>(highResClock::now() - start).count());
+
+    return visible.size();
+
+}
+
+size_t FrustumCuller::cullSpheres ( const Frustum& frustum, const SphereBounds& bounds, std::vector<uint32_t>& visible ) {
+
+    highResClock::time_point start = highResClock::now();
+    FrustumPacket packet(frustum);
+    std::vector<size_t> rangeStarts, rangeVisible;
+
+    visible.resize(bounds.Center.paddedSize());
+    uint32_t* out = visible.data();
+
+    this->runRanges(bounds.size(), rangeStarts, rangeVisible, [&]( size_t begin, size_t end ) {
+        return cullSphereRange(packet, bounds, begin, end, out + begin);
+    });
+
+    visible.resize(this->compact(out, rangeStarts, rangeVisible));
+    this->addStats(bounds.size(), visible.size(), std::chrono::duration<double, std::milli>(highResClock::now() - start).count());
+
+    return visible.size();
+
+}
+
+void FrustumCuller::setParallelThreshold ( size_t count ) {
+    this->parallelThreshold = count;
+}
+
+void FrustumCuller::beginFrame ( ) {
+    this->frameStats = CullStats();
+}
+
+const CullStats& FrustumCuller::getFrameStats ( ) const {
+    return this->frameStats;
+}
+
+const CullStats& FrustumCuller::getLastStats ( ) const {
+    return this->lastStats;
+}
+
+size_t FrustumCuller::getThreadCount ( ) const {
+    return this->threadCount;
+}
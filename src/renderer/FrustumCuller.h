@@ -0,0 +1,98 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "util/math/Aabb3f.h"
+#include "util/math/Frustum.h"
+#include "util/math/Vector3fStream.h"
+
+// SoA bounding boxes in center / half extent form, the form the plane test wants.
+struct BoxBounds {
+    Vector3fStream Center{}, Extent{};
+
+    inline size_t size ( ) const noexcept {
+        return this->Center.size();
+    }
+
+    inline void resize ( size_t count ) {
+        this->Center.resize(count);
+        this->Extent.resize(count);
+    }
+
+    inline void set ( size_t index, const Aabb3f& box ) noexcept {
+        this->Center.set(index, box.GetCenter());
+        this->Extent.set(index, box.GetSize() * 0.5F);
+    }
+};
+
+// SoA bounding spheres, Radius is padded like the stream.
+struct SphereBounds {
+    Vector3fStream Center{};
+    std::vector<float> Radius{};
+
+    inline size_t size ( ) const noexcept {
+        return this->Center.size();
+    }
+
+    inline void resize ( size_t count ) {
+        this->Center.resize(count);
+        this->Radius.resize(this->Center.paddedSize());
+    }
+
+    inline void set ( size_t index, const Vector3f& center, float radius ) noexcept {
+        this->Center.set(index, center);
+        this->Radius[index] = radius;
+    }
+};
+
+struct CullStats {
+    size_t tested = 0;
+    size_t visible = 0;
+    double milliseconds = 0;
+
+    inline size_t getCulled ( ) const noexcept {
+        return this->tested - this->visible;
+    }
+};
+
+// Tests bounding volumes against a frustum 8 at a time and writes the indices of the visible
+// ones, in ascending order, to a compact list. Sets above the parallel threshold are split in
+// equal ranges run on the shared JobPool.
+class FrustumCuller {
+
+    private:
+        size_t threadCount = 1;
+        size_t parallelThreshold = 32768;
+        CullStats frameStats{};
+        CullStats lastStats{};
+
+        // Runs body(begin, end) over [0, count) split in ranges that are multiples of 8
+        // and fills in where each range starts and how many it found visible.
+        template<typename Body>
+        void runRanges ( size_t count, std::vector<size_t>& rangeStarts, std::vector<size_t>& rangeVisible, Body body );
+
+        size_t compact ( uint32_t* out, const std::vector<size_t>& rangeStarts, const std::vector<size_t>& rangeVisible );
+        void addStats ( size_t tested, size_t visible, double milliseconds );
+
+    public:
+        // threadCount 0 uses every thread of the job pool, 1 never leaves the calling thread.
+        FrustumCuller ( unsigned int threadCount = 0 );
+
+        FrustumCuller ( const FrustumCuller& ) = delete;
+        FrustumCuller& operator= ( const FrustumCuller& ) = delete;
+
+        // visible is resized to the visible count, its capacity is kept between frames.
+        size_t cullBoxes ( const Frustum& frustum, const BoxBounds& bounds, std::vector<uint32_t>& visible );
+        size_t cullSpheres ( const Frustum& frustum, const SphereBounds& bounds, std::vector<uint32_t>& visible );
+
+        // Sets smaller than this stay on the calling thread.
+        void setParallelThreshold ( size_t count );
+
+        // Resets the frame stats, which sum every cull call since.
+        void beginFrame ( );
+        const CullStats& getFrameStats ( ) const;
+        const CullStats& getLastStats ( ) const;
+
+        size_t getThreadCount ( ) const;
+
+};
@@ -0,0 +1,229 @@
+#include <algorithm>
+#include <chrono>
+#include "GameRenderer.h"
+
+using highResClock = std::chrono::high_resolution_clock;
+
+static constexpr GLintptr NOT_INSTANCED = -1;
+static constexpr GLintptr FALLBACK_INSTANCE = -2; // the matrix goes through fallbackInstances
+static constexpr GLsizeiptr INSTANCE_BLOCK_SIZE = MAX_INSTANCES_PER_DRAW * sizeof(Matrix4f);
+
+// Same draw apart from the model matrix.
+static inline bool canInstance ( const DrawPacket& a, const DrawPacket& b ) {
+    return a.program == b.program && a.vertexArray == b.vertexArray && a.texture == b.texture && a.mode == b.mode
+        && a.indexType == b.indexType && a.first == b.first && a.count == b.count && b.instanceCount == 1;
+}
+
+GameRenderer::ProgramUniforms& GameRenderer::getUniforms ( GLuint program ) {
+
+    auto found = this->programs.find(program);
+
+    if ( found != this->programs.end() ) {
+        return found->second;
+    }
+
+    ProgramUniforms& uniforms = this->programs[program];
+    uniforms.model = glGetUniformLocation(program, MODEL_UNIFORM);
+    uniforms.viewProjection = glGetUniformLocation(program, VIEW_PROJECTION_UNIFORM);
+    uniforms.instanceBlock = glGetUniformBlockIndex(program, INSTANCE_BLOCK_NAME);
+
+    if ( uniforms.instanceBlock != GL_INVALID_INDEX ) {
+        glUniformBlockBinding(program, uniforms.instanceBlock, INSTANCE_BLOCK_BINDING);
+    }
+
+    return uniforms;
+
+}
+
+// Splits the sorted packets into draws and streams the matrices of the instance block ones.
+void GameRenderer::buildBatches ( StreamBuffer& stream ) {
+
+    size_t count = this->queue.getSortedCount();
+    this->batches.clear();
+
+    for ( size_t i = 0; i < count; ) {
+        const DrawPacket& packet = this->queue.getSortedPacket(i);
+
+        if ( this->getUniforms(packet.program).instanceBlock == GL_INVALID_INDEX ) {
+            this->batches.push_back({ i, 1, NOT_INSTANCED });
+            i++;
+            continue;
+        }
+
+        size_t end = i + 1;
+
+        if ( this->autoInstancing && packet.instanceCount == 1 ) {
+            size_t limit = std::min(count, i + MAX_INSTANCES_PER_DRAW);
+
+            while ( end < limit && canInstance(packet, this->queue.getSortedPacket(end)) ) {
+                end++;
+            }
+        }
+
+        StreamAllocation instances = stream.allocateUniforms(static_cast<GLsizeiptr>((end - i) * sizeof(Matrix4f)));
+
+        if ( instances.data ) {
+            Matrix4f* models = static_cast<Matrix4f*>(instances.data);
+
+            for ( size_t k = i; k < end; ++k ) {
+                models[k - i] = this->queue.getSortedPacket(k).model;
+            }
+
+            this->batches.push_back({ i, end - i, instances.offset });
+        } else {
+            // slower, every draw waits on an upload of its own, but nothing is lost.
+            for ( size_t k = i; k < end; ++k ) {
+                this->batches.push_back({ k, 1, FALLBACK_INSTANCE });
+            }
+
+            this->stats.fallbackDraws += end - i;
+        }
+
+        i = end;
+    }
+
+}
+
+void GameRenderer::bindFallbackInstance ( GlStateCache& state, const Matrix4f& model ) {
+
+    if ( !this->fallbackInstances ) {
+        glGenBuffers(1, &this->fallbackInstances);
+        state.bindBuffer(GL_UNIFORM_BUFFER, this->fallbackInstances);
+        glBufferData(GL_UNIFORM_BUFFER, INSTANCE_BLOCK_SIZE, nullptr, GL_DYNAMIC_DRAW);
+    }
+
+    state.bindBuffer(GL_UNIFORM_BUFFER, this->fallbackInstances);
+    glBufferSubData(GL_UNIFORM_BUFFER, 0, sizeof(Matrix4f), model.M);
+    state.bindBufferRange(GL_UNIFORM_BUFFER, INSTANCE_BLOCK_BINDING, this->fallbackInstances, 0, INSTANCE_BLOCK_SIZE);
+
+}
+
+void GameRenderer::render ( const Camera& camera, GlStateCache& state, StreamBuffer& stream ) {
+
+    highResClock::time_point start = highResClock::now();
+    size_t count = this->queue.sort();
+    highResClock::time_point sorted = highResClock::now();
+
+    this->frameIndex++;
+    this->stats = RenderStats();
+    this->stats.packets = count;
+
+    this->buildBatches(stream);
+    stream.flush();
+
+    const Matrix4f& viewProjection = camera.getViewProjection();
+    ProgramUniforms* uniforms = nullptr;
+    GLuint program = 0;
+
+    for ( const DrawBatch& batch : this->batches ) {
+        const DrawPacket& packet = this->queue.getSortedPacket(batch.first);
+
+        if ( packet.program != program || !uniforms ) {
+            program = packet.program;
+            uniforms = &this->getUniforms(program);
+            this->stats.programBinds += state.useProgram(program);
+
+            if ( uniforms->uploadedFrame != this->frameIndex ) {
+                uniforms->uploadedFrame = this->frameIndex;
+                glUniformMatrix4fv(uniforms->viewProjection, 1, GL_FALSE, viewProjection.M);
+            }
+        }
+
+        this->stats.vertexArrayBinds += state.bindVertexArray(packet.vertexArray);
+        this->stats.textureBinds += state.bindTexture(0, GL_TEXTURE_2D, packet.texture);
+
+        GLsizei instanceCount = batch.count > 1 ? static_cast<GLsizei>(batch.count) : packet.instanceCount;
+        this->stats.instancedDraws += batch.count > 1;
+
+        if ( batch.instanceOffset == NOT_INSTANCED ) {
+            glUniformMatrix4fv(uniforms->model, 1, GL_FALSE, packet.model.M);
+        } else if ( batch.instanceOffset == FALLBACK_INSTANCE ) {
+            this->bindFallbackInstance(state, packet.model);
+        } else {
+            state.bindBufferRange(GL_UNIFORM_BUFFER, INSTANCE_BLOCK_BINDING, stream.getBuffer(), batch.instanceOffset,
+                static_cast<GLsizeiptr>(batch.count * sizeof(Matrix4f)));
+        }
+
+        if ( packet.indexType ) {
+            GLsizeiptr indexSize = packet.indexType == GL_UNSIGNED_INT ? 4 : (packet.indexType == GL_UNSIGNED_SHORT ? 2 : 1);
+            const void* offset = reinterpret_cast<const void*>(static_cast<GLsizeiptr>(packet.first) * indexSize);
+            glDrawElementsInstanced(packet.mode, packet.count, packet.indexType, offset, instanceCount);
+        } else {
+            glDrawArraysInstanced(packet.mode, packet.first, packet.count, instanceCount);
+        }
+
+        this->stats.drawCalls++;
+    }
+
+    this->queue.clear();
+
+    highResClock::time_point end = highResClock::now();
+    this->stats.sortMs = std::chrono::duration<double, std::milli>(sorted - start).count();
+    this->stats.submitMs = std::chrono::duration<double, std::milli>(end - sorted).count();
+
+}
+
+void GameRenderer::renderSoftware ( const Camera& camera, SoftwareRasterizer& rasterizer ) {
+
+    highResClock::time_point start = highResClock::now();
+    size_t count = this->queue.sort();
+    highResClock::time_point sorted = highResClock::now();
+
+    this->frameIndex++;
+    this->stats = RenderStats();
+    this->stats.packets = count;
+
+    const Matrix4f& viewProjection = camera.getViewProjection();
+
+    // instances without per-instance data land on the same pixels, one copy draws them all.
+    for ( size_t i = 0; i < count; ++i ) {
+        const DrawPacket& packet = this->queue.getSortedPacket(i);
+        const SoftwareMesh* mesh = rasterizer.getMesh(packet.vertexArray);
+
+        if ( !mesh || packet.mode != GL_TRIANGLES ) {
+            this->stats.droppedPackets++;
+            continue;
+        }
+
+        rasterizer.drawTriangles(*mesh, static_cast<size_t>(packet.first), static_cast<size_t>(packet.count), viewProjection * packet.model);
+        this->stats.drawCalls++;
+    }
+
+    rasterizer.flush();
+    this->queue.clear();
+
+    highResClock::time_point end = highResClock::now();
+    this->stats.sortMs = std::chrono::duration<double, std::milli>(sorted - start).count();
+    this->stats.submitMs = std::chrono::duration<double, std::milli>(end - sorted).count();
+
+}
+
+void GameRenderer::destroy ( GlStateCache& state ) {
+
+    if ( this->fallbackInstances ) {
+        state.forgetBuffer(this->fallbackInstances);
+        glDeleteBuffers(1, &this->fallbackInstances);
+        this->fallbackInstances = 0;
+    }
+
+}
+
+void GameRenderer::forgetProgram ( GLuint program ) {
+    this->programs.erase(program);
+}
+
+void GameRenderer::setAutoInstancing ( bool enabled ) {
+    this->autoInstancing = enabled;
+}
+
+bool GameRenderer::isAutoInstancing ( ) const {
+    return this->autoInstancing;
+}
+
+RenderQueue& GameRenderer::getQueue ( ) {
+    return this->queue;
+}
+
+const RenderStats& GameRenderer::getStats ( ) const {
+    return this->stats;
+}
@@ -1,2 +1,105 @@
-
 #pragma once
+
+#include <unordered_map>
+#include <vector>
+#include <glad/glad.h>
+#include "GlStateCache.h"
+#include "StreamBuffer.h"
+#include "SoftwareRasterizer.h"
+#include "RenderQueue.h"
+#include "Camera.h"
+
+// Shaders drawn by the renderer take the packet's model matrix as "uModel" and the camera's
+// view projection as "uViewProjection", either may be left out.
+static constexpr const char* MODEL_UNIFORM = "uModel";
+static constexpr const char* VIEW_PROJECTION_UNIFORM = "uViewProjection";
+
+// Shaders that declare this uniform block are instanced automatically, they read the model
+// matrix as uInstanceModels[gl_InstanceID] instead of uModel:
+//   layout(std140) uniform InstanceBlock { mat4 uInstanceModels[MAX_INSTANCES_PER_DRAW]; };
+// Their packets should have an instanceCount of 1, larger counts all get the packet's matrix
+// at index 0 and nothing past it.
+static constexpr const char* INSTANCE_BLOCK_NAME = "InstanceBlock";
+static constexpr GLuint INSTANCE_BLOCK_BINDING = 0;
+static constexpr size_t MAX_INSTANCES_PER_DRAW = 256; // 16 KB, the smallest block size GL allows
+
+struct RenderStats {
+    size_t packets = 0;
+    size_t drawCalls = 0;
+    size_t instancedDraws = 0;  // draws that merged more than one packet
+    size_t droppedPackets = 0;  // packets the software path could not draw
+    size_t fallbackDraws = 0;   // instance block draws that did not fit into the stream buffer
+    size_t programBinds = 0;
+    size_t vertexArrayBinds = 0;
+    size_t textureBinds = 0;
+    double sortMs = 0;
+    double submitMs = 0;
+};
+
+// Draws everything recorded into its queue since the last frame in sort key order, binds go
+// through the context's state cache so only state that differs from the previous packet is set.
+// Sorted runs of packets that share program, mesh and texture collapse into instanced draws
+// when the program declares the instance block, their matrices are streamed per frame. Once
+// the stream buffer is full, the rest are drawn one by one through a block of the renderer's own.
+// Recording may use worker threads, sorting and submission must stay on the render thread.
+class GameRenderer {
+
+    private:
+        struct ProgramUniforms {
+            GLint model = -1;
+            GLint viewProjection = -1;
+            GLuint instanceBlock = GL_INVALID_INDEX;
+            uint64_t uploadedFrame = 0; // view projection is set once per program and frame
+        };
+
+        // count sorted packets from first, drawn as instances when instanceOffset is set.
+        struct DrawBatch {
+            size_t first;
+            size_t count;
+            GLintptr instanceOffset;
+        };
+
+        RenderQueue queue;
+        std::unordered_map<GLuint, ProgramUniforms> programs{};
+        GLuint fallbackInstances = 0; // one block, rewritten per draw once the stream buffer is full
+        std::vector<DrawBatch> batches{};
+        RenderStats stats{};
+        uint64_t frameIndex = 0;
+        bool autoInstancing = true;
+
+        ProgramUniforms& getUniforms ( GLuint program );
+        void buildBatches ( StreamBuffer& stream );
+        void bindFallbackInstance ( GlStateCache& state, const Matrix4f& model );
+
+    public:
+        // threadCount 0 uses every thread of the job pool, 1 records on the calling thread only.
+        GameRenderer ( unsigned int threadCount = 0 ): queue(threadCount) { }
+
+        GameRenderer ( const GameRenderer& ) = delete;
+        GameRenderer& operator= ( const GameRenderer& ) = delete;
+
+        // Sorts and submits every recorded packet, then clears the queue for the next frame.
+        // Instance matrices go to stream, which is flushed before the first draw.
+        // The context state belongs to must be current on the calling thread.
+        void render ( const Camera& camera, GlStateCache& state, StreamBuffer& stream );
+
+        // Same as render without a GL context. Packets are drawn with the mesh the rasterizer
+        // has for their vertex array, programs and textures are ignored, only triangles are
+        // drawn and the rest is counted as dropped. Flushes the rasterizer before returning.
+        void renderSoftware ( const Camera& camera, SoftwareRasterizer& rasterizer );
+
+        // Deletes the renderer's own GL objects, the context must be current.
+        void destroy ( GlStateCache& state );
+
+        // Cached uniform locations are dropped with the program, call before deleting it.
+        void forgetProgram ( GLuint program );
+
+        // Off draws every packet on its own, programs with the instance block still read
+        // their matrix from it.
+        void setAutoInstancing ( bool enabled );
+        bool isAutoInstancing ( ) const;
+
+        RenderQueue& getQueue ( );
+        const RenderStats& getStats ( ) const;
+
+};
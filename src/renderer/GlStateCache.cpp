@@ -0,0 +1,259 @@
+#include "GlStateCache.h"
+#include <GLFW/glfw3.h>
+
+// Index of a cached texture target, -1 for the rest.
+static inline int getTextureTargetIndex ( GLenum target ) {
+    switch ( target ) {
+        case GL_TEXTURE_2D:       return 0;
+        case GL_TEXTURE_2D_ARRAY: return 1;
+        case GL_TEXTURE_3D:       return 2;
+        case GL_TEXTURE_CUBE_MAP: return 3;
+        default:                  return -1;
+    }
+}
+
+GlStateCache::GlStateCache ( ) {
+    this->invalidate();
+}
+
+void GlStateCache::invalidate ( ) {
+
+    this->program = UNKNOWN;
+    this->vertexArray = UNKNOWN;
+    this->arrayBuffer = UNKNOWN;
+    this->elementBuffer = UNKNOWN;
+    this->uniformBuffer = UNKNOWN;
+    this->activeTexture = UNKNOWN;
+
+    for ( auto& unit : this->textures ) {
+        for ( GLuint& texture : unit ) {
+            texture = UNKNOWN;
+        }
+    }
+
+    this->blendEnabled = -1;
+    this->blendSrc = this->blendDst = UNKNOWN;
+    this->depthTestEnabled = -1;
+    this->depthWriteEnabled = -1;
+    this->depthFunc = UNKNOWN;
+    this->viewport[0] = this->viewport[1] = this->viewport[2] = this->viewport[3] = -1;
+    this->swapInterval = -1;
+
+}
+
+bool GlStateCache::setEnabled ( GLenum cap, int8_t& current, bool enabled ) {
+
+    if ( !this->count(current != static_cast<int8_t>(enabled)) ) {
+        return false;
+    }
+
+    current = enabled;
+    enabled ? glEnable(cap) : glDisable(cap);
+    return true;
+
+}
+
+GLuint* GlStateCache::getBufferSlot ( GLenum target ) {
+    switch ( target ) {
+        case GL_ARRAY_BUFFER:         return &this->arrayBuffer;
+        case GL_ELEMENT_ARRAY_BUFFER: return &this->elementBuffer;
+        case GL_UNIFORM_BUFFER:       return &this->uniformBuffer;
+        default:                      return nullptr;
+    }
+}
+
+bool GlStateCache::useProgram ( GLuint program ) {
+
+    if ( !this->count(this->program != program) ) {
+        return false;
+    }
+
+    this->program = program;
+    glUseProgram(program);
+    return true;
+
+}
+
+bool GlStateCache::bindVertexArray ( GLuint vertexArray ) {
+
+    if ( !this->count(this->vertexArray != vertexArray) ) {
+        return false;
+    }
+
+    this->vertexArray = vertexArray;
+    this->elementBuffer = UNKNOWN; // whatever the new vertex array has bound
+    glBindVertexArray(vertexArray);
+    return true;
+
+}
+
+bool GlStateCache::bindBuffer ( GLenum target, GLuint buffer ) {
+
+    GLuint* slot = this->getBufferSlot(target);
+
+    if ( !this->count(!slot || *slot != buffer) ) {
+        return false;
+    }
+
+    if ( slot ) {
+        *slot = buffer;
+    }
+
+    glBindBuffer(target, buffer);
+    return true;
+
+}
+
+void GlStateCache::bindBufferRange ( GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size ) {
+
+    GLuint* slot = this->getBufferSlot(target);
+
+    if ( slot ) {
+        *slot = buffer;
+    }
+
+    this->count(true);
+    glBindBufferRange(target, index, buffer, offset, size);
+
+}
+
+bool GlStateCache::bindTexture ( GLuint unit, GLenum target, GLuint texture ) {
+
+    int targetIndex = getTextureTargetIndex(target);
+    bool cached = unit < MAX_CACHED_TEXTURE_UNITS && targetIndex >= 0;
+
+    if ( !this->count(!cached || this->textures[unit][targetIndex] != texture) ) {
+        return false;
+    }
+
+    if ( this->activeTexture != GL_TEXTURE0 + unit ) {
+        this->activeTexture = GL_TEXTURE0 + unit;
+        glActiveTexture(this->activeTexture);
+        this->frameStats.issued++;
+    }
+
+    if ( cached ) {
+        this->textures[unit][targetIndex] = texture;
+    }
+
+    glBindTexture(target, texture);
+    return true;
+
+}
+
+bool GlStateCache::setBlendEnabled ( bool enabled ) {
+    return this->setEnabled(GL_BLEND, this->blendEnabled, enabled);
+}
+
+bool GlStateCache::setBlendFunc ( GLenum src, GLenum dst ) {
+
+    if ( !this->count(this->blendSrc != src || this->blendDst != dst) ) {
+        return false;
+    }
+
+    this->blendSrc = src;
+    this->blendDst = dst;
+    glBlendFunc(src, dst);
+    return true;
+
+}
+
+bool GlStateCache::setDepthTestEnabled ( bool enabled ) {
+    return this->setEnabled(GL_DEPTH_TEST, this->depthTestEnabled, enabled);
+}
+
+bool GlStateCache::setDepthWriteEnabled ( bool enabled ) {
+
+    if ( !this->count(this->depthWriteEnabled != static_cast<int8_t>(enabled)) ) {
+        return false;
+    }
+
+    this->depthWriteEnabled = enabled;
+    glDepthMask(enabled ? GL_TRUE : GL_FALSE);
+    return true;
+
+}
+
+bool GlStateCache::setDepthFunc ( GLenum func ) {
+
+    if ( !this->count(this->depthFunc != func) ) {
+        return false;
+    }
+
+    this->depthFunc = func;
+    glDepthFunc(func);
+    return true;
+
+}
+
+bool GlStateCache::setViewport ( GLint x, GLint y, GLsizei width, GLsizei height ) {
+
+    GLint* current = this->viewport;
+
+    if ( !this->count(current[0] != x || current[1] != y || current[2] != width || current[3] != height) ) {
+        return false;
+    }
+
+    current[0] = x; current[1] = y; current[2] = width; current[3] = height;
+    glViewport(x, y, width, height);
+    return true;
+
+}
+
+bool GlStateCache::setSwapInterval ( int interval ) {
+
+    if ( !this->count(this->swapInterval != interval) ) {
+        return false;
+    }
+
+    this->swapInterval = interval;
+    glfwSwapInterval(interval);
+    return true;
+
+}
+
+void GlStateCache::forgetProgram ( GLuint program ) {
+    if ( this->program == program ) {
+        this->program = UNKNOWN;
+    }
+}
+
+void GlStateCache::forgetVertexArray ( GLuint vertexArray ) {
+    if ( this->vertexArray == vertexArray ) {
+        this->vertexArray = UNKNOWN;
+        this->elementBuffer = UNKNOWN;
+    }
+}
+
+void GlStateCache::forgetBuffer ( GLuint buffer ) {
+    GLuint* slots[] = { &this->arrayBuffer, &this->elementBuffer, &this->uniformBuffer };
+
+    for ( GLuint* slot : slots ) {
+        if ( *slot == buffer ) {
+            *slot = UNKNOWN;
+        }
+    }
+}
+
+void GlStateCache::forgetTexture ( GLuint texture ) {
+    for ( auto& unit : this->textures ) {
+        for ( GLuint& slot : unit ) {
+            if ( slot == texture ) {
+                slot = UNKNOWN;
+            }
+        }
+    }
+}
+
+void GlStateCache::beginFrame ( ) {
+    this->lastStats = this->frameStats;
+    this->frameStats = GlStateStats();
+}
+
+const GlStateStats& GlStateCache::getFrameStats ( ) const {
+    return this->frameStats;
+}
+
+const GlStateStats& GlStateCache::getLastStats ( ) const {
+    return this->lastStats;
+}
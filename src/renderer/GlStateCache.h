@@ -0,0 +1,95 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <glad/glad.h>
+
+static constexpr int MAX_CACHED_TEXTURE_UNITS = 16;
+
+struct GlStateStats {
+    size_t issued = 0;
+    size_t skipped = 0;
+};
+
+// Shadow copy of the binding and fixed function state of one GL context. Every setter skips
+// the GL call when the value is already current and returns whether it issued one.
+// State starts unknown, so the first call of each kind always goes through, and must only be
+// changed through the cache afterwards or be forgotten with invalidate.
+// Only use it from the thread the context is current on.
+class GlStateCache {
+
+    private:
+        static constexpr GLuint UNKNOWN = ~0U;
+
+        GLuint program = UNKNOWN;
+        GLuint vertexArray = UNKNOWN;
+        GLuint arrayBuffer = UNKNOWN;
+        GLuint elementBuffer = UNKNOWN; // part of the bound vertex array
+        GLuint uniformBuffer = UNKNOWN;
+        GLenum activeTexture = UNKNOWN;
+        GLuint textures[MAX_CACHED_TEXTURE_UNITS][4];
+
+        int8_t blendEnabled = -1;
+        GLenum blendSrc = UNKNOWN, blendDst = UNKNOWN;
+        int8_t depthTestEnabled = -1;
+        int8_t depthWriteEnabled = -1;
+        GLenum depthFunc = UNKNOWN;
+        GLint viewport[4] = { -1, -1, -1, -1 };
+        int swapInterval = -1;
+
+        GlStateStats frameStats{};
+        GlStateStats lastStats{};
+
+        inline bool count ( bool changed ) {
+            changed ? this->frameStats.issued++ : this->frameStats.skipped++;
+            return changed;
+        }
+
+        bool setEnabled ( GLenum cap, int8_t& current, bool enabled );
+        GLuint* getBufferSlot ( GLenum target );
+
+    public:
+        GlStateCache ( );
+
+        GlStateCache ( const GlStateCache& ) = delete;
+        GlStateCache& operator= ( const GlStateCache& ) = delete;
+
+        // Forgets everything, for after code that changed state behind the cache's back.
+        void invalidate ( );
+
+        bool useProgram ( GLuint program );
+        bool bindVertexArray ( GLuint vertexArray );
+
+        // Array, element and uniform buffer bindings are cached, other targets always go through.
+        bool bindBuffer ( GLenum target, GLuint buffer );
+
+        // Indexed ranges are not cached, they always go through and update the target's binding.
+        void bindBufferRange ( GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size );
+
+        // 2D, 2D array, 3D and cube map bindings of the first MAX_CACHED_TEXTURE_UNITS units
+        // are cached, others always go through. Switches the active unit only when needed.
+        bool bindTexture ( GLuint unit, GLenum target, GLuint texture );
+
+        bool setBlendEnabled ( bool enabled );
+        bool setBlendFunc ( GLenum src, GLenum dst );
+        bool setDepthTestEnabled ( bool enabled );
+        bool setDepthWriteEnabled ( bool enabled );
+        bool setDepthFunc ( GLenum func );
+        bool setViewport ( GLint x, GLint y, GLsizei width, GLsizei height );
+
+        // Not GL state but per context as well, the context must be current.
+        bool setSwapInterval ( int interval );
+
+        // Call after deleting an object, GL may recycle its name and a bind of the new object
+        // must not be mistaken for the old binding. Its slots become unknown.
+        void forgetProgram ( GLuint program );
+        void forgetVertexArray ( GLuint vertexArray );
+        void forgetBuffer ( GLuint buffer );
+        void forgetTexture ( GLuint texture );
+
+        // Moves the frame's counters to the last frame's and resets them.
+        void beginFrame ( );
+        const GlStateStats& getFrameStats ( ) const;
+        const GlStateStats& getLastStats ( ) const;
+
+};
@@ -0,0 +1,424 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include "util/simd.h"
+#include "OcclusionCuller.h"
+
+using highResClock = std::chrono::high_resolution_clock;
+
+static constexpr size_t OCCLUSION_LANES = 8;
+static constexpr float MIN_OCCLUSION_W = 1e-5F;
+
+// Two triangles per face, corner i has x from bit 0, y from bit 1 and z from bit 2.
+static constexpr uint32_t BOX_INDICES[36] = {
+    0, 2, 3,  0, 3, 1,   4, 5, 7,  4, 7, 6,   0, 1, 5,  0, 5, 4,
+    2, 6, 7,  2, 7, 3,   0, 4, 6,  0, 6, 2,   1, 3, 7,  1, 7, 5
+};
+
+static inline bool isPowerOfTwo ( int val ) {
+    return val > 0 && (val & (val - 1)) == 0;
+}
+
+static inline double getMs ( highResClock::time_point start ) {
+    return std::chrono::duration<double, std::milli>(highResClock::now() - start).count();
+}
+
+OcclusionCuller::OcclusionCuller ( int width, int height ) {
+    if ( !this->resize(width, height) ) {
+        this->resize(DEFAULT_OCCLUSION_WIDTH, DEFAULT_OCCLUSION_HEIGHT);
+    }
+}
+
+bool OcclusionCuller::resize ( int width, int height ) {
+
+    if ( !isPowerOfTwo(width) || !isPowerOfTwo(height) || std::min(width, height) < 8 || std::max(width, height) > MAX_OCCLUSION_SIZE ) {
+        return false;
+    }
+
+    this->width = width;
+    this->height = height;
+    this->levelOffsets.clear();
+
+    size_t total = 0;
+
+    for ( int level = 0; ; ++level ) {
+        int levelWidth = std::max(1, width >> level), levelHeight = std::max(1, height >> level);
+        this->levelOffsets.push_back(total);
+        total += size_t(levelWidth) * size_t(levelHeight);
+
+        if ( levelWidth == 1 && levelHeight == 1 ) {
+            break;
+        }
+    }
+
+    this->depth.assign(total, 1.0F);
+    this->isPyramidDirty = false;
+    return true;
+
+}
+
+void OcclusionCuller::beginFrame ( const Matrix4f& viewProjection ) {
+    this->viewProjection = viewProjection;
+    std::fill(this->depth.begin(), this->depth.end(), 1.0F);
+    this->isPyramidDirty = false;
+
+    this->lastStats = this->frameStats;
+    this->frameStats = {};
+}
+
+void OcclusionCuller::drawOccluder ( const SoftwareMesh& mesh, const Matrix4f& model ) {
+
+    highResClock::time_point start = highResClock::now();
+    Matrix4f modelViewProjection = this->viewProjection * model;
+
+    this->clipPositions.resize(mesh.positions.size() * 4);
+
+    for ( size_t i = 0; i < mesh.positions.size(); ++i ) {
+        const Vector3f& pos = mesh.positions[i];
+        simd_store(&this->clipPositions[i * 4], modelViewProjection.Transform(simd4f_set(pos.X, pos.Y, pos.Z, 1.0F)));
+    }
+
+    const float* clip = this->clipPositions.data();
+    bool indexed = !mesh.indices.empty();
+    size_t corners = indexed ? mesh.indices.size() : mesh.positions.size();
+
+    for ( size_t i = 0; i + 3 <= corners; i += 3 ) {
+        if ( indexed ) {
+            this->drawTriangle(clip + mesh.indices[i] * 4, clip + mesh.indices[i + 1] * 4, clip + mesh.indices[i + 2] * 4);
+        } else {
+            this->drawTriangle(clip + i * 4, clip + (i + 1) * 4, clip + (i + 2) * 4);
+        }
+    }
+
+    this->frameStats.occluders++;
+    this->frameStats.rasterMs += getMs(start);
+    this->isPyramidDirty = true;
+
+}
+
+void OcclusionCuller::drawOccluder ( const Aabb3f& box ) {
+
+    highResClock::time_point start = highResClock::now();
+    alignas(16) float clip[8 * 4];
+
+    for ( int i = 0; i < 8; ++i ) {
+        simd4f corner = simd4f_set(i & 1 ? box.Max.X : box.Min.X, i & 2 ? box.Max.Y : box.Min.Y, i & 4 ? box.Max.Z : box.Min.Z, 1.0F);
+        simd_store(clip + i * 4, this->viewProjection.Transform(corner));
+    }
+
+    for ( int i = 0; i < 36; i += 3 ) {
+        this->drawTriangle(clip + BOX_INDICES[i] * 4, clip + BOX_INDICES[i + 1] * 4, clip + BOX_INDICES[i + 2] * 4);
+    }
+
+    this->frameStats.occluders++;
+    this->frameStats.rasterMs += getMs(start);
+    this->isPyramidDirty = true;
+
+}
+
+// The GPU clips away what is in front of the near plane, so that part hides nothing. Such
+// triangles are rare for good occluders and skipped instead of clipped. Past the far plane
+// depth ends up above 1, which hides nothing either.
+void OcclusionCuller::drawTriangle ( const float* a, const float* b, const float* c ) {
+
+    const float* clip[3] = { a, b, c };
+    float screen[3][3];
+
+    for ( int i = 0; i < 3; ++i ) {
+        float w = clip[i][3];
+
+        if ( w < MIN_OCCLUSION_W || clip[i][2] < -w ) {
+            return;
+        }
+
+        float invW = 1.0F / w;
+        screen[i][0] = (clip[i][0] * invW * 0.5F + 0.5F) * this->width;
+        screen[i][1] = (clip[i][1] * invW * 0.5F + 0.5F) * this->height;
+        screen[i][2] = clip[i][2] * invW * 0.5F + 0.5F;
+    }
+
+    this->rasterize(screen[0], screen[1], screen[2]);
+
+}
+
+// Screen space x, y and window depth per vertex.
+void OcclusionCuller::rasterize ( const float* v0, const float* v1, const float* v2 ) {
+
+    float area = (v1[0] - v0[0]) * (v2[1] - v0[1]) - (v2[0] - v0[0]) * (v1[1] - v0[1]);
+
+    // both windings hide what is behind them, counter clockwise keeps the edges positive inside.
+    if ( area < 0 ) {
+        std::swap(v1, v2);
+        area = -area;
+    }
+
+    if ( !(area > 1e-6F) ) {
+        return;
+    }
+
+    // clamped before the conversion, guard band coordinates may not fit an int.
+    float right = static_cast<float>(this->width), top = static_cast<float>(this->height);
+    int minX = static_cast<int>(std::floor(std::clamp(std::min({ v0[0], v1[0], v2[0] }), 0.0F, right)));
+    int minY = static_cast<int>(std::floor(std::clamp(std::min({ v0[1], v1[1], v2[1] }), 0.0F, top)));
+    int maxX = static_cast<int>(std::ceil(std::clamp(std::max({ v0[0], v1[0], v2[0] }), 0.0F, right))) - 1;
+    int maxY = static_cast<int>(std::ceil(std::clamp(std::max({ v0[1], v1[1], v2[1] }), 0.0F, top))) - 1;
+
+    if ( minX > maxX || minY > maxY ) {
+        return;
+    }
+
+    this->frameStats.occluderTriangles++;
+
+    // edge k runs from vertex k + 1 to k + 2 and is measured from its start, which keeps the
+    // values small far out in the guard band.
+    const float* v[3] = { v0, v1, v2 };
+    float A[3], B[3], originX[3], originY[3];
+
+    for ( int k = 0; k < 3; ++k ) {
+        const float* from = v[(k + 1) % 3];
+        const float* to = v[(k + 2) % 3];
+
+        A[k] = from[1] - to[1];
+        B[k] = to[0] - from[0];
+        originX[k] = from[0];
+        originY[k] = from[1];
+    }
+
+    // the depth plane's farthest point in a pixel is half a pixel out along its gradient, but
+    // never past the farthest vertex.
+    float invArea = 1.0F / area;
+    float dz1 = v1[2] - v0[2], dz2 = v2[2] - v0[2];
+    float dzdx = (dz1 * A[1] + dz2 * A[2]) * invArea;
+    float dzdy = (dz1 * B[1] + dz2 * B[2]) * invArea;
+    float pixelSpread = 0.5F * (std::fabs(dzdx) + std::fabs(dzdy));
+    float farthest = std::max({ v0[2], v1[2], v2[2] });
+
+    simd4f laneOffsets = simd4f_set(0.5F, 1.5F, 2.5F, 3.5F);
+    simd4f simdInvArea = simd4f_set1(invArea);
+    simd4f simdDz1 = simd4f_set1(dz1), simdDz2 = simd4f_set1(dz2);
+    simd4f simdZ0 = simd4f_set1(v0[2] + pixelSpread), simdFarthest = simd4f_set1(farthest);
+    simd4f zero = simd4f_set1(0.0F);
+    simd4f stepX[3];
+
+    for ( int k = 0; k < 3; ++k ) {
+        stepX[k] = simd4f_set1(A[k] * 4.0F);
+    }
+
+    int startX = minX & ~3; // rows are a multiple of 4 wide
+
+    for ( int y = minY; y <= maxY; ++y ) {
+
+        float* row = &this->depth[size_t(y) * this->width];
+        float centerY = y + 0.5F;
+        simd4f e[3];
+
+        for ( int k = 0; k < 3; ++k ) {
+            simd4f px = simd_add(simd4f_set1(startX - originX[k]), laneOffsets);
+            e[k] = simd_madd(simd4f_set1(A[k]), px, simd4f_set1(B[k] * (centerY - originY[k])));
+        }
+
+        for ( int x = startX; x <= maxX; x += 4 ) {
+            // centers on an edge go to both sides, so triangles sharing it leave no cracks.
+            simd4f inside = simd_and(simd_and(simd_cmpge(e[0], zero), simd_cmpge(e[1], zero)), simd_cmpge(e[2], zero));
+
+            if ( simd_mask(inside) ) {
+                simd4f l1 = simd_mul(e[1], simdInvArea), l2 = simd_mul(e[2], simdInvArea);
+                simd4f z = simd_min(simd_madd(l2, simdDz2, simd_madd(l1, simdDz1, simdZ0)), simdFarthest);
+                simd4f old = simd4f_load(row + x);
+                simd_store(row + x, simd_select(simd_and(inside, simd_cmplt(z, old)), z, old));
+            }
+
+            e[0] = simd_add(e[0], stepX[0]);
+            e[1] = simd_add(e[1], stepX[1]);
+            e[2] = simd_add(e[2], stepX[2]);
+        }
+
+    }
+
+}
+
+void OcclusionCuller::buildPyramid ( ) {
+
+    highResClock::time_point start = highResClock::now();
+
+    for ( size_t level = 1; level < this->levelOffsets.size(); ++level ) {
+        int srcWidth = std::max(1, this->width >> (level - 1)), srcHeight = std::max(1, this->height >> (level - 1));
+        int dstWidth = std::max(1, this->width >> level), dstHeight = std::max(1, this->height >> level);
+        const float* src = &this->depth[this->levelOffsets[level - 1]];
+        float* dst = &this->depth[this->levelOffsets[level]];
+
+        // a side that already reached 1 texel stays 1 wide.
+        for ( int y = 0; y < dstHeight; ++y ) {
+            const float* row0 = src + size_t(std::min(y * 2, srcHeight - 1)) * srcWidth;
+            const float* row1 = src + size_t(std::min(y * 2 + 1, srcHeight - 1)) * srcWidth;
+
+            for ( int x = 0; x < dstWidth; ++x ) {
+                int x0 = std::min(x * 2, srcWidth - 1), x1 = std::min(x * 2 + 1, srcWidth - 1);
+                dst[size_t(y) * dstWidth + x] = std::max(std::max(row0[x0], row0[x1]), std::max(row1[x0], row1[x1]));
+            }
+        }
+    }
+
+    this->isPyramidDirty = false;
+    this->frameStats.rasterMs += getMs(start);
+
+}
+
+float OcclusionCuller::getFarthestDepth ( int minX, int minY, int maxX, int maxY ) const {
+
+    // the first level the rectangle spans at most 2x2 texels of, the last level is 1x1.
+    int level = 0;
+
+    while ( (maxX >> level) - (minX >> level) > 1 || (maxY >> level) - (minY >> level) > 1 ) {
+        ++level;
+    }
+
+    int levelWidth = std::max(1, this->width >> level);
+    const float* texels = &this->depth[this->levelOffsets[level]];
+    float farthest = 0;
+
+    for ( int y = minY >> level; y <= (maxY >> level); ++y ) {
+        for ( int x = minX >> level; x <= (maxX >> level); ++x ) {
+            farthest = std::max(farthest, texels[size_t(y) * levelWidth + x]);
+        }
+    }
+
+    return farthest;
+
+}
+
+size_t OcclusionCuller::cullBoxes ( const BoxBounds& bounds, std::vector<uint32_t>& visible ) {
+
+    size_t count = visible.size();
+    this->frameStats.tested += count;
+
+    // nothing was drawn, nothing is hidden.
+    if ( this->frameStats.occluders == 0 ) {
+        return count;
+    }
+
+    if ( this->isPyramidDirty ) {
+        this->buildPyramid();
+    }
+
+    highResClock::time_point start = highResClock::now();
+    const Matrix4f& m = this->viewProjection;
+
+    simd8f row[4][4];
+
+    for ( int r = 0; r < 4; ++r ) {
+        for ( int c = 0; c < 4; ++c ) {
+            row[r][c] = simd8f_set1(m.Get(r, c));
+        }
+    }
+
+    simd8f half = simd8f_set1(0.5F), minW = simd8f_set1(MIN_OCCLUSION_W);
+    simd8f screenWidth = simd8f_set1(static_cast<float>(this->width)), screenHeight = simd8f_set1(static_cast<float>(this->height));
+    size_t kept = 0;
+
+    for ( size_t base = 0; base < count; base += OCCLUSION_LANES ) {
+
+        size_t lanes = std::min(OCCLUSION_LANES, count - base);
+        alignas(32) float center[3][OCCLUSION_LANES], extent[3][OCCLUSION_LANES];
+
+        // short batches repeat their last box.
+        for ( size_t lane = 0; lane < OCCLUSION_LANES; ++lane ) {
+            uint32_t index = visible[base + std::min(lane, lanes - 1)];
+            center[0][lane] = bounds.Center.X[index]; extent[0][lane] = bounds.Extent.X[index];
+            center[1][lane] = bounds.Center.Y[index]; extent[1][lane] = bounds.Extent.Y[index];
+            center[2][lane] = bounds.Center.Z[index]; extent[2][lane] = bounds.Extent.Z[index];
+        }
+
+        simd8f cx = simd8f_load(center[0]), cy = simd8f_load(center[1]), cz = simd8f_load(center[2]);
+        simd8f ex = simd8f_load(extent[0]), ey = simd8f_load(extent[1]), ez = simd8f_load(extent[2]);
+        simd8f minX = simd8f_set1(INFINITY), minY = minX, minZ = minX;
+        simd8f maxX = simd8f_set1(-INFINITY), maxY = maxX;
+        simd8f crossesNear = simd_cmplt(minX, minX); // all clear
+
+        for ( int corner = 0; corner < 8; ++corner ) {
+            simd8f px = corner & 1 ? simd_add(cx, ex) : simd_sub(cx, ex);
+            simd8f py = corner & 2 ? simd_add(cy, ey) : simd_sub(cy, ey);
+            simd8f pz = corner & 4 ? simd_add(cz, ez) : simd_sub(cz, ez);
+            simd8f clip[4];
+
+            for ( int r = 0; r < 4; ++r ) {
+                clip[r] = simd_madd(row[r][2], pz, simd_madd(row[r][1], py, simd_madd(row[r][0], px, row[r][3])));
+            }
+
+            crossesNear = simd_or(crossesNear, simd_or(simd_cmplt(clip[3], minW), simd_cmplt(simd_add(clip[2], clip[3]), simd8f_set1(0))));
+
+            simd8f invW = simd_div(simd8f_set1(1.0F), clip[3]);
+            simd8f sx = simd_mul(simd_madd(simd_mul(clip[0], invW), half, half), screenWidth);
+            simd8f sy = simd_mul(simd_madd(simd_mul(clip[1], invW), half, half), screenHeight);
+            simd8f sz = simd_madd(simd_mul(clip[2], invW), half, half);
+
+            minX = simd_min(minX, sx); maxX = simd_max(maxX, sx);
+            minY = simd_min(minY, sy); maxY = simd_max(maxY, sy);
+            minZ = simd_min(minZ, sz);
+        }
+
+        alignas(32) float rect[5][OCCLUSION_LANES];
+        simd_store(rect[0], minX); simd_store(rect[1], minY);
+        simd_store(rect[2], maxX); simd_store(rect[3], maxY);
+        simd_store(rect[4], minZ);
+        int nearMask = simd_mask(crossesNear);
+
+        for ( size_t lane = 0; lane < lanes; ++lane ) {
+            uint32_t index = visible[base + lane];
+            bool isHidden = false;
+
+            // off screen boxes are the frustum's business, they are left visible. The rectangle
+            // grows by a pixel, which takes in pixels past the silhouettes of occluders that
+            // only cover them in part.
+            if ( !((nearMask >> lane) & 1) && rect[0][lane] < this->width && rect[1][lane] < this->height && rect[2][lane] >= 0 && rect[3][lane] >= 0 ) {
+                int x0 = static_cast<int>(std::max(rect[0][lane] - 1.0F, 0.0F)), y0 = static_cast<int>(std::max(rect[1][lane] - 1.0F, 0.0F));
+                int x1 = static_cast<int>(std::min(rect[2][lane] + 1.0F, this->width - 1.0F)), y1 = static_cast<int>(std::min(rect[3][lane] + 1.0F, this->height - 1.0F));
+                isHidden = rect[4][lane] > this->getFarthestDepth(x0, y0, x1, y1);
+            }
+
+            visible[kept] = index;
+            kept += !isHidden;
+        }
+
+    }
+
+    visible.resize(kept);
+    this->frameStats.rejected += count - kept;
+    this->frameStats.testMs += getMs(start);
+    return kept;
+
+}
+
+bool OcclusionCuller::isVisible ( const Aabb3f& box ) {
+    BoxBounds bounds{};
+    bounds.resize(1);
+    bounds.set(0, box);
+
+    std::vector<uint32_t> indices{ 0 };
+
+    return this->cullBoxes(bounds, indices) == 1;
+}
+
+int OcclusionCuller::getWidth ( ) const {
+    return this->width;
+}
+
+int OcclusionCuller::getHeight ( ) const {
+    return this->height;
+}
+
+int OcclusionCuller::getLevelCount ( ) const {
+    return static_cast<int>(this->levelOffsets.size());
+}
+
+float OcclusionCuller::getDepth ( int level, int x, int y ) const {
+    return this->depth[this->levelOffsets[level] + size_t(y) * std::max(1, this->width >> level) + x];
+}
+
+const OcclusionStats& OcclusionCuller::getFrameStats ( ) const {
+    return this->frameStats;
+}
+
+const OcclusionStats& OcclusionCuller::getLastStats ( ) const {
+    return this->lastStats;
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include "util/math/Matrix4f.h"
+#include "util/math/Aabb3f.h"
+#include "FrustumCuller.h"
+#include "SoftwareRasterizer.h"
+
+static constexpr int DEFAULT_OCCLUSION_WIDTH = 256;
+static constexpr int DEFAULT_OCCLUSION_HEIGHT = 128;
+static constexpr int MAX_OCCLUSION_SIZE = 1024;
+
+struct OcclusionStats {
+    size_t occluders = 0;         // meshes and boxes drawn
+    size_t occluderTriangles = 0; // triangles that reached the depth buffer
+    size_t tested = 0;
+    size_t rejected = 0;
+    double rasterMs = 0;          // occluders and the pyramid
+    double testMs = 0;
+};
+
+// Rejects bounding boxes hidden behind a few large occluders before their draws are recorded.
+// Occluders are rasterized 4 pixels at a time into a small depth buffer that spans the whole
+// view, a hierarchical Z pyramid of the farthest depth per texel is built over it, and boxes
+// are projected 8 at a time and compared against the 2x2 texels of the first level their
+// screen rectangle fits in.
+// Every step errs towards visible: occluders write the farthest depth they have in a pixel,
+// triangles in front of the near plane are skipped, boxes that cross it are always visible
+// and box rectangles grow by a pixel to take in pixels that occluder edges only cut through.
+// Depth is window depth in [0, 1] and row 0 the bottom row, like GL.
+class OcclusionCuller {
+
+    private:
+        int width = 0, height = 0;
+        std::vector<float> depth{};          // every level, level 0 first
+        std::vector<size_t> levelOffsets{};
+        std::vector<float> clipPositions{};  // occluder vertices, 4 floats each
+        Matrix4f viewProjection{};
+        bool isPyramidDirty = false;
+
+        OcclusionStats frameStats{};
+        OcclusionStats lastStats{};
+
+        // Clip space corners, 4 floats each.
+        void drawTriangle ( const float* a, const float* b, const float* c );
+        void rasterize ( const float* v0, const float* v1, const float* v2 );
+        void buildPyramid ( );
+
+        // Farthest depth of the pyramid over the pixel rectangle, inclusive.
+        float getFarthestDepth ( int minX, int minY, int maxX, int maxY ) const;
+
+    public:
+        OcclusionCuller ( int width = DEFAULT_OCCLUSION_WIDTH, int height = DEFAULT_OCCLUSION_HEIGHT );
+
+        OcclusionCuller ( const OcclusionCuller& ) = delete;
+        OcclusionCuller& operator= ( const OcclusionCuller& ) = delete;
+
+        // false unless both sides are powers of two in [8, MAX_OCCLUSION_SIZE].
+        bool resize ( int width, int height );
+
+        // Clears the depth buffer for the frame's camera and moves the frame stats to the last.
+        void beginFrame ( const Matrix4f& viewProjection );
+
+        // Only positions and indices are used. Good occluders are large, closed and simple,
+        // a few hundred triangles per frame in total keep this well under a millisecond.
+        void drawOccluder ( const SoftwareMesh& mesh, const Matrix4f& model );
+        void drawOccluder ( const Aabb3f& box );
+
+        // Keeps the indices in visible whose box is not hidden, in order. Meant to run on the
+        // output of FrustumCuller, the pyramid is rebuilt first if occluders were drawn since.
+        size_t cullBoxes ( const BoxBounds& bounds, std::vector<uint32_t>& visible );
+        bool isVisible ( const Aabb3f& box );
+
+        int getWidth ( ) const;
+        int getHeight ( ) const;
+        int getLevelCount ( ) const;
+
+        // Level 0 is the depth buffer, every level after it halves both sides down to 1.
+        float getDepth ( int level, int x, int y ) const;
+
+        const OcclusionStats& getFrameStats ( ) const;
+        const OcclusionStats& getLastStats ( ) const;
+
+};
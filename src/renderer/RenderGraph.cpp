@@ -0,0 +1,620 @@
+#include <algorithm>
+#include <iostream>
+#include <cmath>
+#include "RenderGraph.h"
+
+static constexpr size_t NO_PHYSICAL = ~size_t(0);
+static constexpr size_t MAX_COLOR_ATTACHMENTS = 8; // the least GL 3.3 allows
+
+static bool isDepthFormat ( GLenum format ) {
+    switch ( format ) {
+        case GL_DEPTH_COMPONENT16:
+        case GL_DEPTH_COMPONENT24:
+        case GL_DEPTH_COMPONENT32:
+        case GL_DEPTH_COMPONENT32F:
+        case GL_DEPTH24_STENCIL8:
+        case GL_DEPTH32F_STENCIL8:
+            return true;
+        default:
+            return false;
+    }
+}
+
+static bool hasStencil ( GLenum format ) {
+    return format == GL_DEPTH24_STENCIL8 || format == GL_DEPTH32F_STENCIL8;
+}
+
+// Size estimate, drivers may pad.
+static size_t getBytesPerPixel ( GLenum format ) {
+    switch ( format ) {
+        case GL_R8:
+            return 1;
+        case GL_RG8: case GL_R16F: case GL_DEPTH_COMPONENT16:
+            return 2;
+        case GL_RGBA16F: case GL_RG32F: case GL_DEPTH32F_STENCIL8:
+            return 8;
+        case GL_RGBA32F:
+            return 16;
+        default:
+            return 4;
+    }
+}
+
+RenderGraph::RenderGraph ( ) {
+    this->reset();
+}
+
+RenderResource RenderGraph::createRenderTarget ( const char* name, const RenderTargetDesc& desc ) {
+    Resource resource{ name };
+    resource.desc = desc;
+
+    this->resources.push_back(resource);
+    this->isDirty = true;
+    return static_cast<RenderResource>(this->resources.size() - 1);
+}
+
+RenderResource RenderGraph::createBuffer ( const char* name, GLsizeiptr size ) {
+    Resource resource{ name };
+    resource.bufferSize = std::max<GLsizeiptr>(size, 1);
+
+    this->resources.push_back(resource);
+    this->isDirty = true;
+    return static_cast<RenderResource>(this->resources.size() - 1);
+}
+
+void RenderGraph::setOutput ( RenderResource resource, bool isOutput ) {
+    if ( resource < this->resources.size() && resource != BACKBUFFER_RESOURCE ) {
+        this->resources[resource].isOutput = isOutput;
+        this->isDirty = true;
+    }
+}
+
+size_t RenderGraph::addPass ( const char* name, RenderPassFunction execute ) {
+    this->passes.push_back({ name, std::move(execute) });
+    this->isDirty = true;
+    return this->passes.size() - 1;
+}
+
+void RenderGraph::read ( size_t pass, RenderResource resource ) {
+    this->passes[pass].reads.push_back(resource);
+    this->isDirty = true;
+}
+
+void RenderGraph::write ( size_t pass, RenderResource resource ) {
+    this->passes[pass].writes.push_back(resource);
+    this->isDirty = true;
+}
+
+void RenderGraph::reset ( ) {
+
+    for ( Pass& pass : this->passes ) {
+        if ( pass.framebuffer ) {
+            this->staleFramebuffers.push_back(pass.framebuffer);
+        }
+    }
+
+    this->passes.clear();
+    this->resources.clear();
+    this->barriers.clear();
+
+    Resource backbuffer{ "backbuffer" };
+    backbuffer.isOutput = true;
+    this->resources.push_back(backbuffer);
+
+    this->isDirty = true;
+
+}
+
+void RenderGraph::dropFramebuffers ( ) {
+
+    for ( Pass& pass : this->passes ) {
+        if ( pass.framebuffer ) {
+            this->staleFramebuffers.push_back(pass.framebuffer);
+        }
+
+        pass.framebuffer = 0;
+        pass.attachments.clear();
+    }
+
+    if ( !this->staleFramebuffers.empty() ) {
+        glDeleteFramebuffers(static_cast<GLsizei>(this->staleFramebuffers.size()), this->staleFramebuffers.data());
+        this->staleFramebuffers.clear();
+    }
+
+}
+
+void RenderGraph::destroy ( GlStateCache& state ) {
+
+    this->dropFramebuffers();
+
+    for ( Physical& physical : this->physicals ) {
+        if ( physical.isBuffer ) {
+            state.forgetBuffer(physical.name);
+            glDeleteBuffers(1, &physical.name);
+        } else {
+            state.forgetTexture(physical.name);
+            glDeleteTextures(1, &physical.name);
+        }
+    }
+
+    this->physicals.clear();
+
+    for ( Resource& resource : this->resources ) {
+        resource.physical = NO_PHYSICAL;
+    }
+
+    this->isDirty = true;
+    this->isValid = false;
+
+}
+
+void RenderGraph::setBackbufferSize ( int width, int height ) {
+    if ( this->backbufferSize.X != width || this->backbufferSize.Y != height ) {
+        this->backbufferSize = Vector2i(width, height);
+        this->isDirty = true;
+    }
+}
+
+Vector2i RenderGraph::getBackbufferSize ( ) const {
+    return this->backbufferSize;
+}
+
+Vector2i RenderGraph::getTargetSize ( const Resource& resource ) const {
+    if ( resource.desc.width > 0 && resource.desc.height > 0 ) {
+        return Vector2i(resource.desc.width, resource.desc.height);
+    }
+
+    return Vector2i(
+        std::max(1, static_cast<int>(std::lround(this->backbufferSize.X * resource.desc.scale))),
+        std::max(1, static_cast<int>(std::lround(this->backbufferSize.Y * resource.desc.scale))));
+}
+
+bool RenderGraph::validate ( ) {
+
+    for ( const Pass& pass : this->passes ) {
+
+        size_t colorCount = 0, depthCount = 0;
+        bool writesBackbuffer = false;
+
+        for ( RenderResource resource : pass.reads ) {
+            if ( resource >= this->resources.size() || resource == BACKBUFFER_RESOURCE ) {
+                std::cout << "Render pass " << pass.name << " reads an unknown resource or the backbuffer" << std::endl;
+                return false;
+            }
+
+            if ( std::find(pass.writes.begin(), pass.writes.end(), resource) != pass.writes.end() ) {
+                std::cout << "Render pass " << pass.name << " reads and writes " << this->resources[resource].name << std::endl;
+                return false;
+            }
+        }
+
+        for ( RenderResource resource : pass.writes ) {
+            if ( resource >= this->resources.size() ) {
+                std::cout << "Render pass " << pass.name << " writes an unknown resource" << std::endl;
+                return false;
+            }
+
+            const Resource& res = this->resources[resource];
+
+            if ( resource == BACKBUFFER_RESOURCE ) {
+                writesBackbuffer = true;
+            } else if ( !res.bufferSize ) {
+                isDepthFormat(res.desc.format) ? ++depthCount : ++colorCount;
+            }
+        }
+
+        if ( (writesBackbuffer && colorCount + depthCount > 0) || colorCount > MAX_COLOR_ATTACHMENTS || depthCount > 1 ) {
+            std::cout << "Render pass " << pass.name << " writes attachments no framebuffer can hold" << std::endl;
+            return false;
+        }
+    }
+
+    return true;
+
+}
+
+// Walks the passes backwards from the outputs. Earlier writers of a needed resource stay
+// needed, a later pass may only draw over part of it.
+void RenderGraph::cullPasses ( ) {
+
+    std::vector<bool> isNeeded(this->resources.size(), false);
+
+    for ( size_t i = 0; i < this->resources.size(); ++i ) {
+        isNeeded[i] = this->resources[i].isOutput;
+    }
+
+    for ( size_t i = this->passes.size(); i-- > 0; ) {
+        Pass& pass = this->passes[i];
+        pass.isCulled = true;
+
+        for ( RenderResource resource : pass.writes ) {
+            if ( isNeeded[resource] ) {
+                pass.isCulled = false;
+            }
+        }
+
+        if ( !pass.isCulled ) {
+            for ( RenderResource resource : pass.reads ) {
+                isNeeded[resource] = true;
+            }
+        }
+    }
+
+    // lifetimes and barriers of what is left.
+    enum Access { NONE, READ, WRITTEN };
+    std::vector<Access> lastAccess(this->resources.size(), NONE);
+
+    for ( Resource& resource : this->resources ) {
+        resource.isUsed = false;
+    }
+
+    this->barriers.clear();
+
+    for ( size_t i = 0; i < this->passes.size(); ++i ) {
+        const Pass& pass = this->passes[i];
+
+        if ( pass.isCulled ) {
+            continue;
+        }
+
+        auto touch = [&]( RenderResource id, Access access ) {
+            Resource& resource = this->resources[id];
+
+            if ( !resource.isUsed ) {
+                resource.firstPass = i;
+                resource.isUsed = true;
+            }
+
+            resource.lastPass = i;
+
+            if ( lastAccess[id] != NONE && lastAccess[id] != access ) {
+                this->barriers.push_back({ i, id, access == READ });
+            }
+
+            lastAccess[id] = access;
+        };
+
+        for ( RenderResource resource : pass.reads ) {
+            touch(resource, READ);
+        }
+
+        for ( RenderResource resource : pass.writes ) {
+            touch(resource, WRITTEN);
+        }
+    }
+
+}
+
+// Greedy in order of first use: a resource takes the first GL object of its kind that is free
+// again, so lifetimes that do not overlap share. GL objects of the last compile are reused for
+// equal kinds, only the rest is created.
+bool RenderGraph::assignPhysicals ( GlStateCache& state ) {
+
+    std::vector<Physical> previous;
+    previous.swap(this->physicals);
+
+    std::vector<RenderResource> order;
+
+    for ( RenderResource i = 1; i < this->resources.size(); ++i ) {
+        this->resources[i].physical = NO_PHYSICAL;
+
+        if ( this->resources[i].isUsed ) {
+            order.push_back(i);
+        }
+    }
+
+    std::stable_sort(order.begin(), order.end(), [this]( RenderResource a, RenderResource b ) {
+        return this->resources[a].firstPass < this->resources[b].firstPass;
+    });
+
+    auto isSameKind = []( const Physical& a, const Physical& b ) {
+        return a.isBuffer == b.isBuffer && a.format == b.format && a.size.X == b.size.X && a.size.Y == b.size.Y
+            && a.bufferSize == b.bufferSize;
+    };
+
+    auto getBytes = []( const Physical& physical ) {
+        return physical.isBuffer ? static_cast<size_t>(physical.bufferSize)
+            : size_t(physical.size.X) * size_t(physical.size.Y) * getBytesPerPixel(physical.format);
+    };
+
+    this->stats.bytesWithoutAliasing = 0;
+
+    for ( RenderResource id : order ) {
+        Resource& resource = this->resources[id];
+        Physical wanted{};
+
+        if ( resource.bufferSize ) {
+            wanted.isBuffer = true;
+            wanted.bufferSize = resource.bufferSize;
+        } else {
+            wanted.format = resource.desc.format;
+            wanted.size = this->getTargetSize(resource);
+        }
+
+        this->stats.bytesWithoutAliasing += getBytes(wanted);
+
+        // outputs are read after the frame, nothing may take them over.
+        for ( size_t p = 0; p < this->physicals.size() && !resource.isOutput; ++p ) {
+            Physical& physical = this->physicals[p];
+
+            if ( physical.lastPass < resource.firstPass && isSameKind(physical, wanted) ) {
+                resource.physical = p;
+                break;
+            }
+        }
+
+        if ( resource.physical == NO_PHYSICAL ) {
+            resource.physical = this->physicals.size();
+            this->physicals.push_back(wanted);
+        }
+
+        // outputs keep theirs to the end.
+        this->physicals[resource.physical].lastPass = resource.isOutput ? ~size_t(0) : resource.lastPass;
+    }
+
+    this->stats.reallocated = 0;
+    this->stats.bytesWithAliasing = 0;
+
+    while ( glGetError() != GL_NO_ERROR ) { } // only report errors of our own calls
+
+    for ( Physical& physical : this->physicals ) {
+        this->stats.bytesWithAliasing += getBytes(physical);
+
+        auto reuse = std::find_if(previous.begin(), previous.end(), [&]( const Physical& old ) {
+            return old.name && isSameKind(old, physical);
+        });
+
+        if ( reuse != previous.end() ) {
+            physical.name = reuse->name;
+            reuse->name = 0;
+            continue;
+        }
+
+        this->stats.reallocated++;
+
+        if ( physical.isBuffer ) {
+            glGenBuffers(1, &physical.name);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, physical.name);
+            glBufferData(GL_COPY_WRITE_BUFFER, physical.bufferSize, nullptr, GL_DYNAMIC_DRAW);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+            continue;
+        }
+
+        // the upload format only has to fit the internal one, there is no data.
+        GLenum format = GL_RGBA, type = GL_UNSIGNED_BYTE;
+
+        if ( isDepthFormat(physical.format) ) {
+            format = hasStencil(physical.format) ? GL_DEPTH_STENCIL : GL_DEPTH_COMPONENT;
+            type = physical.format == GL_DEPTH24_STENCIL8 ? GL_UNSIGNED_INT_24_8
+                : physical.format == GL_DEPTH32F_STENCIL8 ? GL_FLOAT_32_UNSIGNED_INT_24_8_REV : GL_FLOAT;
+        }
+
+        GLint filter = isDepthFormat(physical.format) ? GL_NEAREST : GL_LINEAR;
+
+        glGenTextures(1, &physical.name);
+        state.bindTexture(0, GL_TEXTURE_2D, physical.name);
+        glTexImage2D(GL_TEXTURE_2D, 0, physical.format, physical.size.X, physical.size.Y, 0, format, type, nullptr);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, filter);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    }
+
+    for ( Physical& old : previous ) {
+        if ( !old.name ) {
+            continue;
+        }
+
+        if ( old.isBuffer ) {
+            state.forgetBuffer(old.name);
+            glDeleteBuffers(1, &old.name);
+        } else {
+            state.forgetTexture(old.name);
+            glDeleteTextures(1, &old.name);
+        }
+    }
+
+    this->stats.transientResources = order.size();
+    this->stats.physicalResources = this->physicals.size();
+
+    if ( glGetError() != GL_NO_ERROR ) {
+        std::cout << "Failed to create the render graph's targets" << std::endl;
+        return false;
+    }
+
+    return true;
+
+}
+
+// A framebuffer is only built again when the textures behind its attachments changed.
+bool RenderGraph::buildFramebuffers ( ) {
+
+    if ( !this->staleFramebuffers.empty() ) {
+        glDeleteFramebuffers(static_cast<GLsizei>(this->staleFramebuffers.size()), this->staleFramebuffers.data());
+        this->staleFramebuffers.clear();
+    }
+
+    bool isComplete = true;
+
+    for ( Pass& pass : this->passes ) {
+
+        std::vector<GLuint> attachments;
+
+        for ( RenderResource resource : pass.writes ) {
+            const Resource& res = this->resources[resource];
+
+            if ( resource != BACKBUFFER_RESOURCE && !res.bufferSize && !pass.isCulled ) {
+                attachments.push_back(this->physicals[res.physical].name);
+            }
+        }
+
+        // names are only reused for textures of the same size, so the size is still right.
+        if ( attachments.empty() ) {
+            pass.size = this->backbufferSize;
+        }
+
+        if ( attachments == pass.attachments && (pass.framebuffer || attachments.empty()) ) {
+            continue;
+        }
+
+        if ( pass.framebuffer ) {
+            glDeleteFramebuffers(1, &pass.framebuffer);
+            pass.framebuffer = 0;
+        }
+
+        pass.attachments = attachments;
+
+        if ( attachments.empty() ) {
+            continue;
+        }
+
+        // GL draws into the intersection of differently sized attachments.
+        std::vector<GLenum> drawBuffers;
+        pass.size = Vector2i(INT32_MAX, INT32_MAX);
+
+        glGenFramebuffers(1, &pass.framebuffer);
+        glBindFramebuffer(GL_FRAMEBUFFER, pass.framebuffer);
+
+        for ( RenderResource resource : pass.writes ) {
+            const Resource& res = this->resources[resource];
+
+            if ( res.bufferSize ) {
+                continue;
+            }
+
+            const Physical& physical = this->physicals[res.physical];
+            GLenum attachment = GL_COLOR_ATTACHMENT0 + static_cast<GLenum>(drawBuffers.size());
+
+            if ( isDepthFormat(physical.format) ) {
+                attachment = hasStencil(physical.format) ? GL_DEPTH_STENCIL_ATTACHMENT : GL_DEPTH_ATTACHMENT;
+            } else {
+                drawBuffers.push_back(attachment);
+            }
+
+            glFramebufferTexture2D(GL_FRAMEBUFFER, attachment, GL_TEXTURE_2D, physical.name, 0);
+            pass.size = Vector2i(std::min(pass.size.X, physical.size.X), std::min(pass.size.Y, physical.size.Y));
+        }
+
+        // GL 3.3 also counts a read buffer without an attachment as incomplete.
+        if ( drawBuffers.empty() ) {
+            glDrawBuffer(GL_NONE);
+            glReadBuffer(GL_NONE);
+        } else {
+            glDrawBuffers(static_cast<GLsizei>(drawBuffers.size()), drawBuffers.data());
+        }
+
+        if ( glCheckFramebufferStatus(GL_FRAMEBUFFER) != GL_FRAMEBUFFER_COMPLETE ) {
+            std::cout << "Framebuffer of render pass " << pass.name << " is incomplete" << std::endl;
+            isComplete = false;
+        }
+
+    }
+
+    glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    return isComplete;
+
+}
+
+bool RenderGraph::compile ( GlStateCache& state ) {
+
+    this->isDirty = false;
+    this->isValid = false;
+
+    if ( !this->validate() ) {
+        return false;
+    }
+
+    this->cullPasses();
+
+    // attachments may name textures that were deleted, and GL hands out freed names again.
+    if ( !this->assignPhysicals(state) || !this->buildFramebuffers() ) {
+        this->dropFramebuffers();
+        return false;
+    }
+
+    this->stats.passes = this->passes.size();
+    this->stats.culledPasses = static_cast<size_t>(std::count_if(this->passes.begin(), this->passes.end(),
+        []( const Pass& pass ) { return pass.isCulled; }));
+    this->stats.barriers = this->barriers.size();
+
+    this->isValid = true;
+    return true;
+
+}
+
+void RenderGraph::execute ( GlStateCache& state, float deltaTime, FrameProfiler* profiler ) {
+
+    if ( this->isDirty ) {
+        this->compile(state);
+    }
+
+    if ( !this->isValid ) {
+        return;
+    }
+
+    GLuint framebuffer = 0;
+
+    for ( Pass& pass : this->passes ) {
+
+        if ( pass.isCulled ) {
+            continue;
+        }
+
+        if ( pass.framebuffer != framebuffer ) {
+            framebuffer = pass.framebuffer;
+            glBindFramebuffer(GL_FRAMEBUFFER, framebuffer);
+        }
+
+        if ( profiler ) {
+            profiler->beginScope(pass.name);
+        }
+
+        state.setViewport(0, 0, pass.size.X, pass.size.Y);
+        RenderPassContext context{ *this, state, pass.size, deltaTime };
+        pass.execute(context);
+
+        if ( profiler ) {
+            profiler->endScope();
+        }
+
+    }
+
+    if ( framebuffer ) {
+        glBindFramebuffer(GL_FRAMEBUFFER, 0);
+    }
+
+}
+
+GLuint RenderGraph::getTexture ( RenderResource resource ) const {
+
+    if ( resource >= this->resources.size() || resource == BACKBUFFER_RESOURCE ) {
+        return 0;
+    }
+
+    const Resource& res = this->resources[resource];
+    return (!res.bufferSize && res.physical != NO_PHYSICAL) ? this->physicals[res.physical].name : 0;
+
+}
+
+GLuint RenderGraph::getBuffer ( RenderResource resource ) const {
+
+    if ( resource >= this->resources.size() || resource == BACKBUFFER_RESOURCE ) {
+        return 0;
+    }
+
+    const Resource& res = this->resources[resource];
+    return (res.bufferSize && res.physical != NO_PHYSICAL) ? this->physicals[res.physical].name : 0;
+
+}
+
+const std::vector<RenderBarrier>& RenderGraph::getBarriers ( ) const {
+    return this->barriers;
+}
+
+bool RenderGraph::isCulled ( size_t pass ) const {
+    return this->passes[pass].isCulled;
+}
+
+const RenderGraphStats& RenderGraph::getStats ( ) const {
+    return this->stats;
+}
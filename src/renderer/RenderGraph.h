@@ -0,0 +1,165 @@
+#pragma once
+
+#include <functional>
+#include <stdint.h>
+#include <vector>
+#include <glad/glad.h>
+#include "util/math/Vector2i.h"
+#include "GlStateCache.h"
+#include "FrameProfiler.h"
+
+using RenderResource = uint32_t;
+static constexpr RenderResource INVALID_RENDER_RESOURCE = ~0U;
+static constexpr RenderResource BACKBUFFER_RESOURCE = 0; // the window's default framebuffer
+
+// A transient texture, sized relative to the backbuffer unless width and height are set.
+// Color formats must be normalized or float, depth formats attach as depth (and stencil).
+struct RenderTargetDesc {
+    GLenum format = GL_RGBA8;
+    float scale = 1.0F;
+    GLsizei width = 0;
+    GLsizei height = 0;
+};
+
+// A resource changing from being written to being read or back between two passes.
+struct RenderBarrier {
+    size_t pass;           // the pass it happens before
+    RenderResource resource;
+    bool toRead;           // written before and read now, otherwise the other way around
+};
+
+struct RenderGraphStats {
+    size_t passes = 0;
+    size_t culledPasses = 0;
+    size_t barriers = 0;
+    size_t transientResources = 0; // render targets and buffers used by passes that run
+    size_t physicalResources = 0;  // GL objects backing them
+    size_t reallocated = 0;        // GL objects created by the last compile
+    size_t bytesWithoutAliasing = 0;
+    size_t bytesWithAliasing = 0;
+};
+
+class RenderGraph; // foward
+
+// What a pass gets to work with, its framebuffer is already bound and the viewport set.
+struct RenderPassContext {
+    RenderGraph& graph;
+    GlStateCache& state;
+    Vector2i size; // of the framebuffer
+    float deltaTime; // seconds since the previous frame
+};
+
+using RenderPassFunction = std::function<void(RenderPassContext&)>;
+
+// Describes a frame as passes that declare which render targets and buffers they read and
+// write, in the order they run. A read sees the last write declared before it.
+// Compiling culls passes nothing reaches the backbuffer or an output from, lists the barriers
+// between passes and aliases transient resources: ones with equal descriptions whose
+// lifetimes do not overlap share one GL object. GL has no memory aliasing of different
+// formats, so this is pooling and a resource must not expect the contents of its previous
+// owner, clear or overwrite it. GL orders the barriers itself, they are listed for inspection.
+// Compiling again after a resize only recreates GL objects whose size changed.
+// Only use it from the thread the context is current on.
+class RenderGraph {
+
+    private:
+        struct Resource {
+            const char* name;
+            RenderTargetDesc desc{};
+            GLsizeiptr bufferSize = 0; // buffers have no desc
+            bool isOutput = false;
+
+            // filled by compile
+            size_t firstPass = 0, lastPass = 0;
+            bool isUsed = false;
+            size_t physical = ~size_t(0); // none
+        };
+
+        struct Pass {
+            const char* name;
+            RenderPassFunction execute;
+            std::vector<RenderResource> reads{};
+            std::vector<RenderResource> writes{};
+
+            // filled by compile
+            bool isCulled = false;
+            GLuint framebuffer = 0;
+            std::vector<GLuint> attachments{}; // what framebuffer was built with
+            Vector2i size{};
+        };
+
+        // A GL texture or buffer, with what it was created as.
+        struct Physical {
+            GLuint name = 0;
+            bool isBuffer = false;
+            GLenum format = 0;
+            Vector2i size{};
+            GLsizeiptr bufferSize = 0;
+            size_t lastPass = 0;
+        };
+
+        std::vector<Resource> resources{};
+        std::vector<Pass> passes{};
+        std::vector<Physical> physicals{};
+        std::vector<RenderBarrier> barriers{};
+        std::vector<GLuint> staleFramebuffers{};  // of passes dropped by reset
+        Vector2i backbufferSize{};
+        RenderGraphStats stats{};
+        bool isDirty = true;
+        bool isValid = false;
+
+        Vector2i getTargetSize ( const Resource& resource ) const;
+        bool validate ( );
+        void cullPasses ( );
+        bool assignPhysicals ( GlStateCache& state );
+        bool buildFramebuffers ( );
+
+        // Deletes every pass's framebuffer, the next compile builds them all again.
+        void dropFramebuffers ( );
+
+    public:
+        RenderGraph ( );
+
+        RenderGraph ( const RenderGraph& ) = delete;
+        RenderGraph& operator= ( const RenderGraph& ) = delete;
+
+        RenderResource createRenderTarget ( const char* name, const RenderTargetDesc& desc );
+        RenderResource createBuffer ( const char* name, GLsizeiptr size );
+
+        // Kept with the passes writing it even if no pass reads it, like the backbuffer.
+        void setOutput ( RenderResource resource, bool isOutput = true );
+
+        // Returns the pass index that read and write take.
+        size_t addPass ( const char* name, RenderPassFunction execute );
+
+        // Render targets a pass writes are its attachments, in the order declared.
+        void read ( size_t pass, RenderResource resource );
+        void write ( size_t pass, RenderResource resource );
+
+        // Drops every pass and resource, their GL objects are reused or deleted by the next
+        // compile. Needs no context.
+        void reset ( );
+
+        // Deletes every GL object, the context must be current.
+        void destroy ( GlStateCache& state );
+
+        // Only marks the graph for compiling when the size changed.
+        void setBackbufferSize ( int width, int height );
+        Vector2i getBackbufferSize ( ) const;
+
+        // Runs on its own from execute when something changed. False if a pass reads and
+        // writes the same resource, writes the backbuffer with other targets or GL failed.
+        bool compile ( GlStateCache& state );
+
+        // Runs the passes that were not culled, each in a profiler scope of its name if given.
+        void execute ( GlStateCache& state, float deltaTime, FrameProfiler* profiler = nullptr );
+
+        // The GL object behind a resource, 0 before compiling or when its pass was culled.
+        GLuint getTexture ( RenderResource resource ) const;
+        GLuint getBuffer ( RenderResource resource ) const;
+
+        const std::vector<RenderBarrier>& getBarriers ( ) const;
+        bool isCulled ( size_t pass ) const;
+        const RenderGraphStats& getStats ( ) const;
+
+};
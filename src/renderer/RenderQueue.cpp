@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <iostream>
+#include "util/JobPool.h"
+#include "RenderQueue.h"
+
+static constexpr int PACKET_INDEX_BITS = 26;
+
+RenderQueue::RenderQueue ( unsigned int threadCount ) {
+
+    if ( threadCount == 0 ) {
+        threadCount = static_cast<unsigned int>(getJobPool().getThreadCount());
+    }
+
+    threadCount = std::min<unsigned int>(threadCount, MAX_COMMAND_BUFFERS);
+    this->buffers.resize(threadCount);
+
+}
+
+void RenderQueue::clear ( ) {
+
+    for ( CommandBuffer& buffer : this->buffers ) {
+        buffer.clear();
+    }
+
+    this->sorted = nullptr;
+    this->sortedCount = 0;
+
+}
+
+void RenderQueue::record ( size_t count, const std::function<void(CommandBuffer&, size_t, size_t)>& body ) {
+
+    this->sorted = nullptr;
+    this->sortedCount = 0;
+
+    size_t ranges = count < this->parallelThreshold ? 1 : std::min(this->buffers.size(), count);
+    size_t perRange = ranges ? (count + ranges - 1) / ranges : 0;
+
+    auto runRange = [&]( size_t range ) {
+        size_t begin = std::min(count, range * perRange);
+        size_t end = std::min(count, begin + perRange);
+
+        if ( begin < end ) {
+            body(this->buffers[range], begin, end);
+        }
+    };
+
+    getJobPool().run(ranges, runRange);
+
+}
+
+CommandBuffer& RenderQueue::getCommandBuffer ( size_t index ) {
+    return this->buffers[index];
+}
+
+size_t RenderQueue::sort ( ) {
+
+    size_t total = this->getPacketCount();
+    this->items.resize(total);
+    this->scratch.resize(total);
+
+    RadixSortItem* out = this->items.data();
+
+    for ( size_t b = 0; b < this->buffers.size(); ++b ) {
+        const std::vector<RadixSortItem>& keys = this->buffers[b].getKeys();
+
+        if ( keys.size() > MAX_COMMAND_BUFFER_PACKETS ) {
+            std::cout << "Command buffer " << b << " holds more than " << MAX_COMMAND_BUFFER_PACKETS << " packets, the rest are dropped" << std::endl;
+        }
+
+        size_t count = std::min(keys.size(), MAX_COMMAND_BUFFER_PACKETS);
+        uint32_t tag = static_cast<uint32_t>(b) << PACKET_INDEX_BITS;
+
+        for ( size_t i = 0; i < count; ++i ) {
+            out[i] = { keys[i].key, keys[i].value | tag };
+        }
+
+        out += count;
+    }
+
+    this->sortedCount = static_cast<size_t>(out - this->items.data());
+    this->sorted = radixSort(this->items.data(), this->scratch.data(), this->sortedCount);
+
+    return this->sortedCount;
+
+}
+
+size_t RenderQueue::getSortedCount ( ) const {
+    return this->sortedCount;
+}
+
+uint64_t RenderQueue::getSortedKey ( size_t index ) const {
+    return this->sorted[index].key;
+}
+
+const DrawPacket& RenderQueue::getSortedPacket ( size_t index ) const {
+    uint32_t value = this->sorted[index].value;
+    return this->buffers[value >> PACKET_INDEX_BITS].getPacket(value & (MAX_COMMAND_BUFFER_PACKETS - 1));
+}
+
+size_t RenderQueue::getPacketCount ( ) const {
+
+    size_t total = 0;
+
+    for ( const CommandBuffer& buffer : this->buffers ) {
+        total += buffer.size();
+    }
+
+    return total;
+
+}
+
+void RenderQueue::setParallelThreshold ( size_t count ) {
+    this->parallelThreshold = count;
+}
+
+size_t RenderQueue::getThreadCount ( ) const {
+    return this->buffers.size();
+}
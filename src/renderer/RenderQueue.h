@@ -0,0 +1,57 @@
+#pragma once
+
+#include <functional>
+#include <stdint.h>
+#include <vector>
+#include "CommandBuffer.h"
+
+// Packet indices are stored in 26 bits of the sort value, the command buffer in the 6 above.
+static constexpr size_t MAX_COMMAND_BUFFERS = 64;
+static constexpr size_t MAX_COMMAND_BUFFER_PACKETS = 1 << 26;
+
+// One command buffer per recording thread, merged and radix sorted into a single submission
+// order. Recording over many items is split in equal ranges run on the shared JobPool, one
+// buffer per range, so no two threads ever share a buffer.
+class RenderQueue {
+
+    private:
+        std::vector<CommandBuffer> buffers{};
+        std::vector<RadixSortItem> items{};
+        std::vector<RadixSortItem> scratch{};
+        const RadixSortItem* sorted = nullptr;
+        size_t sortedCount = 0;
+
+        size_t parallelThreshold = 4096;
+
+    public:
+        // threadCount 0 uses every thread of the job pool, 1 never leaves the calling thread.
+        RenderQueue ( unsigned int threadCount = 0 );
+
+        RenderQueue ( const RenderQueue& ) = delete;
+        RenderQueue& operator= ( const RenderQueue& ) = delete;
+
+        // Drops every recorded packet, buffers keep their capacity.
+        void clear ( );
+
+        // Runs body(buffer, begin, end) over [0, count). Counts below the parallel threshold
+        // stay on the calling thread and record into buffer 0.
+        void record ( size_t count, const std::function<void(CommandBuffer&, size_t, size_t)>& body );
+
+        // Buffer 0 belongs to the calling thread outside of record.
+        CommandBuffer& getCommandBuffer ( size_t index = 0 );
+
+        // Merges every buffer's keys and sorts them, equal keys keep their recording order
+        // within a buffer and buffers are merged in index order. Returns the packet count.
+        size_t sort ( );
+
+        // Valid after sort until the next record or clear.
+        size_t getSortedCount ( ) const;
+        uint64_t getSortedKey ( size_t index ) const;
+        const DrawPacket& getSortedPacket ( size_t index ) const;
+
+        size_t getPacketCount ( ) const;
+
+        void setParallelThreshold ( size_t count );
+        size_t getThreadCount ( ) const;
+
+};
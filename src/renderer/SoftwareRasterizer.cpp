@@ -0,0 +1,457 @@
+#include <algorithm>
+#include <iostream>
+#include <fstream>
+#include <chrono>
+#include <cmath>
+#include "util/colors/ColorArrays.h"
+#include "util/JobPool.h"
+#include "util/simd.h"
+#include "SoftwareRasterizer.h"
+
+using highResClock = std::chrono::high_resolution_clock;
+
+static constexpr int SUBPIXEL = 1 << SOFTWARE_SUBPIXEL_BITS;
+static constexpr int HALF_SUBPIXEL = SUBPIXEL / 2;
+static constexpr int CLIP_PLANES = 6;
+static constexpr int MAX_CLIPPED_VERTICES = 3 + CLIP_PLANES;
+
+// Round to nearest like GL's normalized fixed point conversion, PixelABGR is RGBA8 in memory.
+static inline uint32_t packPixel ( float r, float g, float b, float a ) {
+    auto toByte = []( float c ) { return static_cast<uint32_t>(std::min(std::max(c * 255.0F + 0.5F, 0.0F), 255.0F)); };
+    return (toByte(r) << PixelABGR::R) | (toByte(g) << PixelABGR::G) | (toByte(b) << PixelABGR::B) | (toByte(a) << PixelABGR::A);
+}
+
+// Signed distance to clip plane i: left, right, bottom, top, near, far. Inside at >= 0.
+static inline float getPlaneDistance ( const float* v, int plane ) {
+    float axis = v[plane >> 1];
+    return (plane & 1) ? v[3] - axis : v[3] + axis;
+}
+
+SoftwareRasterizer::SoftwareRasterizer ( unsigned int threadCount ) {
+    this->threadCount = threadCount;
+}
+
+bool SoftwareRasterizer::resize ( int width, int height ) {
+
+    if ( width < 1 || height < 1 || width > MAX_SOFTWARE_TARGET_SIZE || height > MAX_SOFTWARE_TARGET_SIZE ) {
+        std::cout << "Software render target of " << width << "x" << height << " is not supported" << std::endl;
+        return false;
+    }
+
+    this->width = width;
+    this->height = height;
+    this->tilesX = (width + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+    this->tilesY = (height + SOFTWARE_TILE_SIZE - 1) / SOFTWARE_TILE_SIZE;
+
+    // padded to whole tiles so 4 pixel blocks never leave a row.
+    this->stride = static_cast<size_t>(this->tilesX) * SOFTWARE_TILE_SIZE;
+    this->colorBuffer.assign(this->stride * this->tilesY * SOFTWARE_TILE_SIZE, 0);
+    this->depthBuffer.assign(this->stride * this->tilesY * SOFTWARE_TILE_SIZE, 1.0F);
+
+    this->triangles.clear();
+    this->bins.assign(static_cast<size_t>(this->tilesX) * this->tilesY, std::vector<uint32_t>());
+
+    return true;
+
+}
+
+void SoftwareRasterizer::clear ( const Color4f& color, float depth ) {
+
+    std::fill(this->colorBuffer.begin(), this->colorBuffer.end(), packPixel(color.red, color.green, color.blue, color.alpha));
+    std::fill(this->depthBuffer.begin(), this->depthBuffer.end(), depth);
+    this->stats = SoftwareRasterStats();
+
+}
+
+void SoftwareRasterizer::drawTriangles ( const SoftwareMesh& mesh, size_t first, size_t count, const Matrix4f& modelViewProjection ) {
+
+    highResClock::time_point start = highResClock::now();
+    bool indexed = !mesh.indices.empty();
+    size_t end = std::min(first + count, indexed ? mesh.indices.size() : mesh.positions.size());
+
+    auto getVertex = [&]( size_t corner ) {
+        uint32_t index = indexed ? mesh.indices[corner] : static_cast<uint32_t>(corner);
+        const Vector3f& pos = mesh.positions[index];
+        Color4f color = index < mesh.colors.size() ? mesh.colors[index] : Color4f(1, 1, 1, 1);
+
+        alignas(16) float clip[4];
+        simd_store(clip, modelViewProjection.Transform(simd4f_set(pos.X, pos.Y, pos.Z, 1.0F)));
+        return ClipVertex{ clip[0], clip[1], clip[2], clip[3], color.red, color.green, color.blue, color.alpha };
+    };
+
+    for ( size_t i = first; i + 3 <= end; i += 3 ) {
+        this->stats.triangles++;
+        this->clipTriangle(getVertex(i), getVertex(i + 1), getVertex(i + 2));
+    }
+
+    this->stats.setupMs += std::chrono::duration<double, std::milli>(highResClock::now() - start).count();
+
+}
+
+// Sutherland-Hodgman against the planes a vertex is outside of, then a fan over the polygon.
+// Attributes are interpolated in clip space, which is what keeps them perspective correct.
+void SoftwareRasterizer::clipTriangle ( const ClipVertex& a, const ClipVertex& b, const ClipVertex& c ) {
+
+    int outA = 0, outB = 0, outC = 0;
+
+    for ( int plane = 0; plane < CLIP_PLANES; ++plane ) {
+        outA |= (getPlaneDistance(&a.x, plane) < 0) << plane;
+        outB |= (getPlaneDistance(&b.x, plane) < 0) << plane;
+        outC |= (getPlaneDistance(&c.x, plane) < 0) << plane;
+    }
+
+    if ( outA & outB & outC ) {
+        return;
+    }
+
+    if ( !(outA | outB | outC) ) {
+        this->setupTriangle(a, b, c);
+        return;
+    }
+
+    this->stats.clipped++;
+
+    ClipVertex buffers[2][MAX_CLIPPED_VERTICES];
+    ClipVertex* in = buffers[0];
+    ClipVertex* out = buffers[1];
+    int count = 3;
+    int crossed = outA | outB | outC;
+    in[0] = a; in[1] = b; in[2] = c;
+
+    for ( int plane = 0; plane < CLIP_PLANES && count >= 3; ++plane ) {
+        if ( !(crossed & (1 << plane)) ) {
+            continue;
+        }
+
+        int outCount = 0;
+
+        for ( int i = 0; i < count; ++i ) {
+            const ClipVertex& cur = in[i];
+            const ClipVertex& next = in[(i + 1) % count];
+            float dCur = getPlaneDistance(&cur.x, plane);
+            float dNext = getPlaneDistance(&next.x, plane);
+
+            if ( dCur >= 0 ) {
+                out[outCount++] = cur;
+            }
+
+            // always lerped from the inside end, so both triangles of a shared edge get the
+            // same vertex and no crack opens between them.
+            if ( (dCur >= 0) != (dNext >= 0) ) {
+                bool curInside = dCur >= 0;
+                float t = curInside ? dCur / (dCur - dNext) : dNext / (dNext - dCur);
+                const float* from = curInside ? &cur.x : &next.x;
+                const float* to = curInside ? &next.x : &cur.x;
+                float* lerped = &out[outCount++].x;
+
+                for ( int k = 0; k < 8; ++k ) {
+                    lerped[k] = from[k] + (to[k] - from[k]) * t;
+                }
+            }
+        }
+
+        std::swap(in, out);
+        count = outCount;
+    }
+
+    for ( int i = 2; i < count; ++i ) {
+        this->setupTriangle(in[0], in[i - 1], in[i]);
+    }
+
+}
+
+void SoftwareRasterizer::setupTriangle ( const ClipVertex& a, const ClipVertex& b, const ClipVertex& c ) {
+
+    const ClipVertex* v[3] = { &a, &b, &c };
+    int32_t sx[3], sy[3];
+    float invW[3];
+
+    for ( int i = 0; i < 3; ++i ) {
+        if ( v[i]->w <= 0 ) {
+            return; // only a clipped away corner can get here, the triangle has no area.
+        }
+
+        invW[i] = 1.0F / v[i]->w;
+        sx[i] = static_cast<int32_t>(std::lrint((v[i]->x * invW[i] + 1.0F) * 0.5F * this->width * SUBPIXEL));
+        sy[i] = static_cast<int32_t>(std::lrint((v[i]->y * invW[i] + 1.0F) * 0.5F * this->height * SUBPIXEL));
+    }
+
+    int64_t area = static_cast<int64_t>(sx[1] - sx[0]) * (sy[2] - sy[0]) - static_cast<int64_t>(sy[1] - sy[0]) * (sx[2] - sx[0]);
+
+    if ( area == 0 ) {
+        return;
+    }
+
+    // no face culling, clockwise triangles are flipped to counter clockwise.
+    int order[3] = { 0, 1, 2 };
+
+    if ( area < 0 ) {
+        order[1] = 2; order[2] = 1;
+        area = -area;
+    }
+
+    RasterTriangle tri;
+    int32_t px[3], py[3];
+    float z[3];
+
+    for ( int i = 0; i < 3; ++i ) {
+        int k = order[i];
+        px[i] = sx[k]; py[i] = sy[k];
+        tri.invW[i] = invW[k];
+        tri.colorW[i][0] = v[k]->r * invW[k]; tri.colorW[i][1] = v[k]->g * invW[k];
+        tri.colorW[i][2] = v[k]->b * invW[k]; tri.colorW[i][3] = v[k]->a * invW[k];
+        z[i] = v[k]->z * invW[k] * 0.5F + 0.5F;
+    }
+
+    // pixel x covers center x * 16 + 8.
+    tri.minX = std::max(0, (std::min({ px[0], px[1], px[2] }) + HALF_SUBPIXEL - 1) >> SOFTWARE_SUBPIXEL_BITS);
+    tri.minY = std::max(0, (std::min({ py[0], py[1], py[2] }) + HALF_SUBPIXEL - 1) >> SOFTWARE_SUBPIXEL_BITS);
+    tri.maxX = std::min(this->width - 1, (std::max({ px[0], px[1], px[2] }) - HALF_SUBPIXEL) >> SOFTWARE_SUBPIXEL_BITS);
+    tri.maxY = std::min(this->height - 1, (std::max({ py[0], py[1], py[2] }) - HALF_SUBPIXEL) >> SOFTWARE_SUBPIXEL_BITS);
+
+    if ( tri.minX > tri.maxX || tri.minY > tri.maxY ) {
+        return;
+    }
+
+    for ( int k = 0; k < 3; ++k ) {
+        int i = (k + 1) % 3, j = (k + 2) % 3;
+        int32_t dx = px[j] - px[i], dy = py[j] - py[i];
+        bool topLeft = dy < 0 || (dy == 0 && dx < 0);
+
+        tri.A[k] = -dy;
+        tri.B[k] = dx;
+        tri.C[k] = -(static_cast<int64_t>(tri.A[k]) * px[i] + static_cast<int64_t>(tri.B[k]) * py[i]);
+        tri.threshold[k] = topLeft ? -1 : 0;
+    }
+
+    tri.invArea = 1.0F / static_cast<float>(area);
+    tri.z0 = z[0];
+    tri.dz1 = z[1] - z[0];
+    tri.dz2 = z[2] - z[0];
+
+    uint32_t index = static_cast<uint32_t>(this->triangles.size());
+    this->triangles.push_back(tri);
+    this->stats.setUp++;
+
+    int tileX0 = tri.minX / SOFTWARE_TILE_SIZE, tileX1 = tri.maxX / SOFTWARE_TILE_SIZE;
+    int tileY0 = tri.minY / SOFTWARE_TILE_SIZE, tileY1 = tri.maxY / SOFTWARE_TILE_SIZE;
+
+    for ( int ty = tileY0; ty <= tileY1; ++ty ) {
+        for ( int tx = tileX0; tx <= tileX1; ++tx ) {
+            this->bins[static_cast<size_t>(ty) * this->tilesX + tx].push_back(index);
+        }
+    }
+
+    this->stats.binned += static_cast<size_t>(tileX1 - tileX0 + 1) * (tileY1 - tileY0 + 1);
+
+}
+
+void SoftwareRasterizer::rasterizeTile ( size_t tile ) {
+
+    int tileX = static_cast<int>(tile % this->tilesX) * SOFTWARE_TILE_SIZE;
+    int tileY = static_cast<int>(tile / this->tilesX) * SOFTWARE_TILE_SIZE;
+
+    simd4f one = simd4f_set1(1.0F), zero = simd4f_set1(0.0F);
+    simd4f byteMax = simd4f_set1(255.0F), half = simd4f_set1(0.5F);
+
+    for ( uint32_t index : this->bins[tile] ) {
+        const RasterTriangle& tri = this->triangles[index];
+
+        // 4 aligned pixels at a time, the buffers are padded to whole tiles.
+        int x0 = std::max(tileX, tri.minX) & ~3;
+        int x1 = std::min(tileX + SOFTWARE_TILE_SIZE - 1, tri.maxX);
+        int y0 = std::max(tileY, tri.minY);
+        int y1 = std::min(tileY + SOFTWARE_TILE_SIZE - 1, tri.maxY);
+
+        if ( x0 > x1 || y0 > y1 ) {
+            continue;
+        }
+
+        // edge values at the rectangle's corners, linear so the extremes are among them.
+        int64_t cornerX[2] = { static_cast<int64_t>(x0) * SUBPIXEL + HALF_SUBPIXEL, static_cast<int64_t>(x1) * SUBPIXEL + HALF_SUBPIXEL };
+        int64_t cornerY[2] = { static_cast<int64_t>(y0) * SUBPIXEL + HALF_SUBPIXEL, static_cast<int64_t>(y1) * SUBPIXEL + HALF_SUBPIXEL };
+        bool isOutside = false;
+
+        for ( int k = 0; k < 3 && !isOutside; ++k ) {
+            int64_t maxE = INT64_MIN;
+
+            for ( int c = 0; c < 4; ++c ) {
+                maxE = std::max(maxE, tri.A[k] * cornerX[c & 1] + tri.B[k] * cornerY[c >> 1] + tri.C[k]);
+            }
+
+            isOutside = maxE <= tri.threshold[k];
+        }
+
+        if ( isOutside ) {
+            continue;
+        }
+
+        simd4i stepX[3], threshold[3];
+        int32_t stepY[3];
+        int64_t rowStart[3];
+
+        for ( int k = 0; k < 3; ++k ) {
+            stepX[k] = simd4i_set1(tri.A[k] * SUBPIXEL * 4);
+            stepY[k] = tri.B[k] * SUBPIXEL;
+            threshold[k] = simd4i_set1(tri.threshold[k]);
+            rowStart[k] = tri.A[k] * cornerX[0] + tri.B[k] * cornerY[0] + tri.C[k];
+        }
+
+        simd4f invArea = simd4f_set1(tri.invArea);
+        simd4f z0 = simd4f_set1(tri.z0), dz1 = simd4f_set1(tri.dz1), dz2 = simd4f_set1(tri.dz2);
+        simd4f invW0 = simd4f_set1(tri.invW[0]), invW1 = simd4f_set1(tri.invW[1]), invW2 = simd4f_set1(tri.invW[2]);
+
+        for ( int y = y0; y <= y1; ++y ) {
+            simd4i e[3];
+
+            // within the clipped viewport every edge value fits in 32 bits.
+            for ( int k = 0; k < 3; ++k ) {
+                int32_t start = static_cast<int32_t>(rowStart[k]);
+                int32_t a = tri.A[k] * SUBPIXEL;
+                e[k] = simd4i_set(start, start + a, start + 2 * a, start + 3 * a);
+                rowStart[k] += stepY[k];
+            }
+
+            uint32_t* colorRow = this->colorBuffer.data() + static_cast<size_t>(y) * this->stride;
+            float* depthRow = this->depthBuffer.data() + static_cast<size_t>(y) * this->stride;
+
+            for ( int x = x0; x <= x1; x += 4 ) {
+                simd4i inside = simd_and(simd_and(simd_cmpgt(e[0], threshold[0]), simd_cmpgt(e[1], threshold[1])), simd_cmpgt(e[2], threshold[2]));
+
+                if ( simd_mask(simd_asFloat(inside)) ) {
+                    simd4f l1 = simd_mul(simd_toFloat(e[1]), invArea);
+                    simd4f l2 = simd_mul(simd_toFloat(e[2]), invArea);
+                    simd4f z = simd_madd(l2, dz2, simd_madd(l1, dz1, z0));
+                    simd4f oldDepth = simd4f_load(depthRow + x);
+                    simd4f pass = simd_and(simd_asFloat(inside), simd_cmplt(z, oldDepth));
+
+                    if ( simd_mask(pass) ) {
+                        simd4f l0 = simd_sub(simd_sub(one, l1), l2);
+                        simd4f w = simd_div(one, simd_madd(l2, invW2, simd_madd(l1, invW1, simd_mul(l0, invW0))));
+                        simd4i channels[4];
+
+                        for ( int ch = 0; ch < 4; ++ch ) {
+                            simd4f c = simd_madd(l2, simd4f_set1(tri.colorW[2][ch]),
+                                simd_madd(l1, simd4f_set1(tri.colorW[1][ch]), simd_mul(l0, simd4f_set1(tri.colorW[0][ch]))));
+                            c = simd_madd(simd_mul(c, w), byteMax, half);
+                            channels[ch] = simd_toInt(simd_min(simd_max(c, zero), byteMax));
+                        }
+
+                        simd4i color = simd_or(simd_or(simd_shl<PixelABGR::R>(channels[0]), simd_shl<PixelABGR::G>(channels[1])),
+                            simd_or(simd_shl<PixelABGR::B>(channels[2]), simd_shl<PixelABGR::A>(channels[3])));
+                        int32_t* colorPtr = reinterpret_cast<int32_t*>(colorRow + x);
+
+                        simd_store(colorPtr, simd_select(simd_asInt(pass), color, simd4i_load(colorPtr)));
+                        simd_store(depthRow + x, simd_select(pass, z, oldDepth));
+                    }
+                }
+
+                e[0] = simd_add(e[0], stepX[0]);
+                e[1] = simd_add(e[1], stepX[1]);
+                e[2] = simd_add(e[2], stepX[2]);
+            }
+        }
+    }
+
+}
+
+void SoftwareRasterizer::flush ( ) {
+
+    if ( this->triangles.empty() ) {
+        return;
+    }
+
+    highResClock::time_point start = highResClock::now();
+    size_t tileCount = this->bins.size();
+    this->nextTile = 0;
+
+    auto runTiles = [&]( ) {
+        for ( size_t tile = this->nextTile++; tile < tileCount; tile = this->nextTile++ ) {
+            this->rasterizeTile(tile);
+        }
+    };
+
+    // tiles differ a lot in cost, so each thread pulls them one at a time.
+    getJobPool().run(std::min(this->getThreadCount(), tileCount), [&]( size_t ) { runTiles(); });
+
+    for ( std::vector<uint32_t>& bin : this->bins ) {
+        bin.clear();
+    }
+
+    this->triangles.clear();
+    this->stats.rasterMs += std::chrono::duration<double, std::milli>(highResClock::now() - start).count();
+
+}
+
+void SoftwareRasterizer::setMesh ( GLuint vertexArray, const SoftwareMesh* mesh ) {
+
+    if ( mesh ) {
+        this->meshes[vertexArray] = mesh;
+    } else {
+        this->meshes.erase(vertexArray);
+    }
+
+}
+
+const SoftwareMesh* SoftwareRasterizer::getMesh ( GLuint vertexArray ) const {
+    auto found = this->meshes.find(vertexArray);
+    return found != this->meshes.end() ? found->second : nullptr;
+}
+
+int SoftwareRasterizer::getWidth ( ) const {
+    return this->width;
+}
+
+int SoftwareRasterizer::getHeight ( ) const {
+    return this->height;
+}
+
+uint32_t SoftwareRasterizer::getPixel ( int x, int y ) const {
+    return this->colorBuffer[static_cast<size_t>(y) * this->stride + x];
+}
+
+float SoftwareRasterizer::getDepth ( int x, int y ) const {
+    return this->depthBuffer[static_cast<size_t>(y) * this->stride + x];
+}
+
+void SoftwareRasterizer::readPixels ( uint32_t* out ) const {
+    for ( int y = 0; y < this->height; ++y ) {
+        std::copy_n(this->colorBuffer.data() + static_cast<size_t>(y) * this->stride, this->width, out + static_cast<size_t>(y) * this->width);
+    }
+}
+
+bool SoftwareRasterizer::savePpm ( const char* path ) const {
+
+    std::ofstream file(path, std::ios::binary);
+
+    if ( !file ) {
+        std::cout << "Failed to open " << path << std::endl;
+        return false;
+    }
+
+    file << "P6\n" << this->width << " " << this->height << "\n255\n";
+    std::vector<uint8_t> row(static_cast<size_t>(this->width) * 3);
+
+    for ( int y = this->height - 1; y >= 0; --y ) {
+        for ( int x = 0; x < this->width; ++x ) {
+            uint32_t pixel = this->getPixel(x, y);
+            row[x * 3 + 0] = static_cast<uint8_t>(pixel >> PixelABGR::R);
+            row[x * 3 + 1] = static_cast<uint8_t>(pixel >> PixelABGR::G);
+            row[x * 3 + 2] = static_cast<uint8_t>(pixel >> PixelABGR::B);
+        }
+
+        file.write(reinterpret_cast<const char*>(row.data()), static_cast<std::streamsize>(row.size()));
+    }
+
+    return static_cast<bool>(file);
+
+}
+
+const SoftwareRasterStats& SoftwareRasterizer::getStats ( ) const {
+    return this->stats;
+}
+
+size_t SoftwareRasterizer::getThreadCount ( ) const {
+    size_t poolThreads = getJobPool().getThreadCount();
+    return this->threadCount ? std::min<size_t>(this->threadCount, poolThreads) : poolThreads;
+}
@@ -0,0 +1,135 @@
+#pragma once
+
+#include <unordered_map>
+#include <stdint.h>
+#include <atomic>
+#include <vector>
+#include <glad/glad.h>
+#include "util/math/Matrix4f.h"
+#include "util/math/Vector3f.h"
+#include "util/colors/Color4f.h"
+
+static constexpr int SOFTWARE_TILE_SIZE = 32;
+static constexpr int SOFTWARE_SUBPIXEL_BITS = 4;     // what GL requires at the least
+static constexpr int MAX_SOFTWARE_TARGET_SIZE = 2048; // keeps edge functions in 32 bits
+
+// CPU side copy of a mesh, the software path can not read vertex arrays back.
+struct SoftwareMesh {
+    std::vector<Vector3f> positions{};
+    std::vector<Color4f> colors{};   // one per position, white when empty
+    std::vector<uint32_t> indices{}; // indexed packets draw indices [first, first + count)
+};
+
+// The GL program the software path matches, attribute 0 is the position and 1 the color.
+// Draw with depth test GL_LESS, no blending and no face culling.
+static constexpr const char* SOFTWARE_REFERENCE_VERTEX_SHADER = R"(#version 330 core
+layout(location = 0) in vec3 aPosition;
+layout(location = 1) in vec4 aColor;
+uniform mat4 uModel;
+uniform mat4 uViewProjection;
+out vec4 vColor;
+void main ( ) {
+    vColor = aColor;
+    gl_Position = uViewProjection * uModel * vec4(aPosition, 1.0);
+}
+)";
+
+static constexpr const char* SOFTWARE_REFERENCE_FRAGMENT_SHADER = R"(#version 330 core
+in vec4 vColor;
+out vec4 fragColor;
+void main ( ) {
+    fragColor = vColor;
+}
+)";
+
+struct SoftwareRasterStats {
+    size_t triangles = 0; // submitted
+    size_t clipped = 0;   // crossed a clip plane
+    size_t setUp = 0;     // reached binning, the rest was outside or covered no pixel center
+    size_t binned = 0;    // triangle and tile pairs
+    double setupMs = 0;
+    double rasterMs = 0;
+};
+
+// Tiled CPU rasterizer for headless renders. Triangles are clipped against the six clip
+// planes, snapped to 1/16 pixel and binned into 32x32 tiles in submission order. flush then
+// rasterizes the tiles on the shared JobPool, the calling thread takes tiles too.
+// Each tile tests 4 pixels at a time with integer edge functions and the top-left fill rule,
+// depth tests GL_LESS and interpolates vertex colors perspective correct like GL varyings.
+// Buffers use GL's conventions: row 0 is the bottom row, pixels are RGBA8 bytes, depth is
+// window depth in [0, 1].
+class SoftwareRasterizer {
+
+    private:
+        struct ClipVertex {
+            float x, y, z, w;
+            float r, g, b, a;
+        };
+
+        struct RasterTriangle {
+            int32_t minX, minY, maxX, maxY; // pixels whose centers may be covered, inclusive
+            int32_t A[3], B[3];             // edge k is opposite vertex k, per subpixel
+            int64_t C[3];
+            int32_t threshold[3];           // inside where E > threshold, -1 on top and left edges
+            float invArea;
+            float z0, dz1, dz2;
+            float invW[3];
+            float colorW[3][4];             // vertex color over w
+        };
+
+        int width = 0, height = 0;
+        int tilesX = 0, tilesY = 0;
+        size_t stride = 0;
+        std::vector<uint32_t> colorBuffer{};
+        std::vector<float> depthBuffer{};
+
+        std::vector<RasterTriangle> triangles{};
+        std::vector<std::vector<uint32_t>> bins{};
+        std::unordered_map<GLuint, const SoftwareMesh*> meshes{};
+        SoftwareRasterStats stats{};
+
+        unsigned int threadCount = 0;
+        std::atomic<size_t> nextTile{0};
+
+        void rasterizeTile ( size_t tile );
+        void clipTriangle ( const ClipVertex& a, const ClipVertex& b, const ClipVertex& c );
+        void setupTriangle ( const ClipVertex& a, const ClipVertex& b, const ClipVertex& c );
+
+    public:
+        // threadCount 0 uses every thread of the job pool, 1 never leaves the calling thread.
+        SoftwareRasterizer ( unsigned int threadCount = 0 );
+
+        SoftwareRasterizer ( const SoftwareRasterizer& ) = delete;
+        SoftwareRasterizer& operator= ( const SoftwareRasterizer& ) = delete;
+
+        // Drops pending triangles, false if a side is not in [1, MAX_SOFTWARE_TARGET_SIZE].
+        bool resize ( int width, int height );
+
+        // Also resets the stats.
+        void clear ( const Color4f& color, float depth = 1.0F );
+
+        // Sets up and bins count triangles' worth of vertices from first, by index if the
+        // mesh has indices. Nothing is drawn before flush.
+        void drawTriangles ( const SoftwareMesh& mesh, size_t first, size_t count, const Matrix4f& modelViewProjection );
+        void flush ( );
+
+        // Stands in for the vertex array when GameRenderer draws in software, null removes it.
+        // The mesh must outlive its registration.
+        void setMesh ( GLuint vertexArray, const SoftwareMesh* mesh );
+        const SoftwareMesh* getMesh ( GLuint vertexArray ) const;
+
+        int getWidth ( ) const;
+        int getHeight ( ) const;
+        uint32_t getPixel ( int x, int y ) const;
+        float getDepth ( int x, int y ) const;
+
+        // width * height RGBA8 pixels bottom row first, what glReadPixels returns.
+        void readPixels ( uint32_t* out ) const;
+
+        // Binary PPM, top row first, alpha dropped.
+        bool savePpm ( const char* path ) const;
+
+        const SoftwareRasterStats& getStats ( ) const;
+        size_t getThreadCount ( ) const;
+
+};
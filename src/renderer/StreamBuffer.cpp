@@ -0,0 +1,165 @@
+#include <iostream>
+#include <string.h>
+#include "StreamBuffer.h"
+#include <GLFW/glfw3.h>
+
+// The glad loader only covers GL 3.3, buffer storage is loaded here when the context has it.
+#ifndef GL_MAP_PERSISTENT_BIT
+    #define GL_MAP_PERSISTENT_BIT 0x0040
+    #define GL_MAP_COHERENT_BIT   0x0080
+#endif
+
+typedef void (APIENTRYP PFNBUFFERSTORAGEPROC)( GLenum target, GLsizeiptr size, const void* data, GLbitfield flags );
+
+static PFNBUFFERSTORAGEPROC loadBufferStorage ( ) {
+
+    GLint major = 0, minor = 0;
+    glGetIntegerv(GL_MAJOR_VERSION, &major);
+    glGetIntegerv(GL_MINOR_VERSION, &minor);
+
+    if ( major > 4 || (major == 4 && minor >= 4) || glfwExtensionSupported("GL_ARB_buffer_storage") ) {
+        return reinterpret_cast<PFNBUFFERSTORAGEPROC>(glfwGetProcAddress("glBufferStorage"));
+    }
+
+    return nullptr;
+
+}
+
+static inline GLsizeiptr alignUp ( GLsizeiptr val, GLsizeiptr alignment ) {
+    return (val + alignment - 1) / alignment * alignment;
+}
+
+bool StreamBuffer::init ( int regionCount, GLsizeiptr regionSize ) {
+
+    this->destroy();
+
+    while ( glGetError() != GL_NO_ERROR ) { } // only report errors of our own calls
+
+    GLint alignment = 0;
+    glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+
+    if ( alignment > 0 ) {
+        this->uniformAlignment = alignment;
+    }
+
+    // regions start aligned, so region relative alignment is buffer alignment.
+    this->regionSize = alignUp(regionSize, this->uniformAlignment);
+    this->regionCount = regionCount;
+    GLsizeiptr totalSize = this->regionSize * regionCount;
+
+    // bound to the copy target so vertex and uniform bindings are left alone.
+    glGenBuffers(1, &this->buffer);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, this->buffer);
+
+    PFNBUFFERSTORAGEPROC bufferStorage = loadBufferStorage();
+
+    if ( bufferStorage ) {
+        GLbitfield flags = GL_MAP_WRITE_BIT | GL_MAP_PERSISTENT_BIT | GL_MAP_COHERENT_BIT;
+        bufferStorage(GL_COPY_WRITE_BUFFER, totalSize, nullptr, flags);
+        this->mapped = static_cast<uint8_t*>(glMapBufferRange(GL_COPY_WRITE_BUFFER, 0, totalSize, flags));
+
+        if ( !this->mapped ) {
+            std::cout << "Failed to map the stream buffer, falling back to glBufferSubData" << std::endl;
+
+            // storage is immutable, the fallback needs a new buffer.
+            glDeleteBuffers(1, &this->buffer);
+            glGenBuffers(1, &this->buffer);
+            glBindBuffer(GL_COPY_WRITE_BUFFER, this->buffer);
+        }
+    }
+
+    if ( !this->mapped ) {
+        glBufferData(GL_COPY_WRITE_BUFFER, totalSize, nullptr, GL_STREAM_DRAW);
+        this->staging.resize(this->regionSize);
+    }
+
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    if ( glGetError() != GL_NO_ERROR ) {
+        std::cout << "Failed to create the stream buffer" << std::endl;
+        this->destroy();
+        return false;
+    }
+
+    this->beginFrame(0);
+    return true;
+
+}
+
+void StreamBuffer::destroy ( ) {
+
+    if ( !this->buffer ) {
+        return;
+    }
+
+    // deleting the buffer unmaps it.
+    glDeleteBuffers(1, &this->buffer);
+
+    this->buffer = 0;
+    this->mapped = nullptr;
+    this->staging = std::vector<uint8_t>();
+    this->regionSize = 0;
+    this->regionCount = 0;
+    this->head = this->flushed = 0;
+
+}
+
+void StreamBuffer::beginFrame ( int slot ) {
+
+    this->slot = this->regionCount ? slot % this->regionCount : 0;
+    this->head = 0;
+    this->flushed = 0;
+    this->hasOverflowed = false;
+
+}
+
+StreamAllocation StreamBuffer::allocate ( GLsizeiptr size, GLsizeiptr alignment ) {
+
+    GLsizeiptr offset = alignUp(this->head, alignment);
+
+    if ( offset + size > this->regionSize ) {
+        if ( !this->hasOverflowed ) {
+            std::cout << "Stream buffer region of " << this->regionSize << " bytes is full" << std::endl;
+            this->hasOverflowed = true;
+        }
+
+        return StreamAllocation();
+    }
+
+    this->head = offset + size;
+    this->peakUsage = this->head > this->peakUsage ? this->head : this->peakUsage;
+
+    GLintptr bufferOffset = this->slot * this->regionSize + offset;
+    uint8_t* data = this->mapped ? this->mapped + bufferOffset : this->staging.data() + offset;
+
+    return StreamAllocation{ data, this->buffer, bufferOffset, size };
+
+}
+
+StreamAllocation StreamBuffer::upload ( const void* data, GLsizeiptr size, GLsizeiptr alignment ) {
+
+    StreamAllocation allocation = this->allocate(size, alignment);
+
+    if ( allocation.data ) {
+        memcpy(allocation.data, data, size);
+    }
+
+    return allocation;
+
+}
+
+void StreamBuffer::flush ( ) {
+
+    if ( this->mapped || this->head == this->flushed ) {
+        return;
+    }
+
+    // the region's last frame is fenced, the upload never waits on the GPU.
+    glBindBuffer(GL_COPY_WRITE_BUFFER, this->buffer);
+    glBufferSubData(GL_COPY_WRITE_BUFFER, this->slot * this->regionSize + this->flushed,
+        this->head - this->flushed, this->staging.data() + this->flushed);
+    glBindBuffer(GL_COPY_WRITE_BUFFER, 0);
+
+    this->flushed = this->head;
+
+}
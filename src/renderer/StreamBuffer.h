@@ -0,0 +1,90 @@
+#pragma once
+
+#include <stdint.h>
+#include <vector>
+#include <glad/glad.h>
+
+static constexpr GLsizeiptr DEFAULT_STREAM_REGION_SIZE = 4 << 20;
+
+// Where an allocation landed, data is only valid until the next beginFrame.
+// data is null if the frame's region is full.
+struct StreamAllocation {
+    void* data = nullptr;
+    GLuint buffer = 0;
+    GLintptr offset = 0;
+    GLsizeiptr size = 0;
+};
+
+// Linear allocator for per-frame vertex, index and uniform data, one region of a single GL
+// buffer per frame slot. A region is only written again once the window waited for its
+// slot's frame fence, so writes never race the GPU and never make the driver sync.
+// With GL 4.4 or ARB_buffer_storage the buffer is persistently and coherently mapped and
+// allocations are written in place. Otherwise they go to a staging copy that flush uploads
+// with glBufferSubData.
+// Only use it from the thread the context is current on.
+class StreamBuffer {
+
+    private:
+        GLuint buffer = 0;
+        GLsizeiptr regionSize = 0;
+        int regionCount = 0;
+        GLint uniformAlignment = 256;
+        uint8_t* mapped = nullptr;
+        std::vector<uint8_t> staging{};
+
+        int slot = 0;
+        GLsizeiptr head = 0;
+        GLsizeiptr flushed = 0;
+        GLsizeiptr peakUsage = 0;
+        bool hasOverflowed = false;
+
+    public:
+        StreamBuffer ( ) { }
+
+        StreamBuffer ( const StreamBuffer& ) = delete;
+        StreamBuffer& operator= ( const StreamBuffer& ) = delete;
+
+        // One region per frame slot. The context must be current, false if the buffer could
+        // not be created.
+        bool init ( int regionCount, GLsizeiptr regionSize = DEFAULT_STREAM_REGION_SIZE );
+        void destroy ( );
+
+        // Starts writing the slot's region, the slot's frame fence must have been waited for.
+        void beginFrame ( int slot );
+
+        StreamAllocation allocate ( GLsizeiptr size, GLsizeiptr alignment = 16 );
+
+        // Aligned for glBindBufferRange on GL_UNIFORM_BUFFER.
+        inline StreamAllocation allocateUniforms ( GLsizeiptr size ) {
+            return this->allocate(size, this->uniformAlignment);
+        }
+
+        // Copies data into a new allocation.
+        StreamAllocation upload ( const void* data, GLsizeiptr size, GLsizeiptr alignment = 16 );
+
+        // Makes everything allocated since the last flush visible to draws issued after it.
+        // Free with a coherent mapping, one glBufferSubData otherwise.
+        void flush ( );
+
+        inline bool isPersistent ( ) const {
+            return this->mapped != nullptr;
+        }
+
+        inline GLuint getBuffer ( ) const {
+            return this->buffer;
+        }
+
+        inline GLsizeiptr getRegionSize ( ) const {
+            return this->regionSize;
+        }
+
+        // Bytes allocated this frame and the most any frame used since init.
+        inline GLsizeiptr getUsage ( ) const {
+            return this->head;
+        }
+
+        inline GLsizeiptr getPeakUsage ( ) const {
+            return this->peakUsage;
+        }
+
+};
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include "JobPool.h"
+
+JobPool::JobPool ( unsigned int threadCount ) {
+
+    if ( threadCount == 0 ) {
+        threadCount = std::max(1U, std::thread::hardware_concurrency());
+    }
+
+    // the calling thread works too.
+    for ( unsigned int i = 1; i < threadCount; ++i ) {
+        this->workers.emplace_back(&JobPool::runWorker, this);
+    }
+
+}
+
+JobPool::~JobPool ( ) {
+
+    {
+        std::lock_guard<std::mutex> lock(this->mtx);
+        this->isRunning = false;
+    }
+
+    this->cv.notify_all();
+
+    for ( std::thread& worker : this->workers ) {
+        worker.join();
+    }
+
+}
+
+void JobPool::work ( std::unique_lock<std::mutex>& lock, Batch* batch ) {
+
+    batch->users++;
+    lock.unlock();
+
+    for ( size_t i = batch->next++; i < batch->count; i = batch->next++ ) {
+        (*batch->job)(i);
+        batch->done++;
+    }
+
+    lock.lock();
+
+    // every index is taken, the batch only waits for the ones still running.
+    auto it = std::find(this->batches.begin(), this->batches.end(), batch);
+
+    if ( it != this->batches.end() ) {
+        this->batches.erase(it);
+    }
+
+    // the thread that ran the batch may only return once no one touches it anymore.
+    if ( --batch->users == 0 && batch->done == batch->count ) {
+        this->cv.notify_all();
+    }
+
+}
+
+void JobPool::runWorker ( ) {
+
+    std::unique_lock<std::mutex> lock(this->mtx);
+
+    while ( true ) {
+
+        this->cv.wait(lock, [&]() { return !this->isRunning || !this->batches.empty(); });
+
+        if ( !this->isRunning ) {
+            return;
+        }
+
+        this->work(lock, this->batches.front());
+
+    }
+
+}
+
+void JobPool::run ( size_t count, const std::function<void(size_t)>& job ) {
+
+    if ( count <= 1 || this->workers.empty() ) {
+        for ( size_t i = 0; i < count; ++i ) {
+            job(i);
+        }
+
+        return;
+    }
+
+    Batch batch;
+    batch.job = &job;
+    batch.count = count;
+
+    std::unique_lock<std::mutex> lock(this->mtx);
+    this->batches.push_back(&batch);
+    this->cv.notify_all();
+
+    this->work(lock, &batch);
+
+    while ( batch.done != batch.count || batch.users != 0 ) {
+
+        if ( !this->batches.empty() ) {
+            this->work(lock, this->batches.front());
+        } else {
+            this->cv.wait(lock);
+        }
+
+    }
+
+}
+
+size_t JobPool::getThreadCount ( ) const {
+    return this->workers.size() + 1;
+}
+
+JobPool& getJobPool ( ) {
+    static JobPool pool;
+    return pool;
+}
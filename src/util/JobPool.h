@@ -0,0 +1,55 @@
+#pragma once
+
+#include <condition_variable>
+#include <functional>
+#include <atomic>
+#include <vector>
+#include <deque>
+#include <thread>
+#include <mutex>
+
+// Runs batches of indexed jobs on one set of threads shared by every parallel system, so the
+// culler, the render queue, the rasterizers and the BVH build don't each keep a thread per core.
+// The thread running a batch works on it too, and while it waits for the rest it helps with
+// whatever other batch is queued, so a job may run a batch of its own without deadlocking.
+// Batches from several threads are worked on in the order they were started.
+class JobPool {
+
+    private:
+        struct Batch {
+            const std::function<void(size_t)>* job;
+            size_t count;
+            std::atomic<size_t> next{0};
+            std::atomic<size_t> done{0};
+            size_t users = 0; // threads inside work, guarded by mtx
+        };
+
+        std::vector<std::thread> workers{};
+        std::deque<Batch*> batches{}; // ones with indices left to take
+        std::condition_variable cv{};
+        std::mutex mtx{};
+        bool isRunning = true;
+
+        // Takes indices of batch until none are left, lock is released meanwhile.
+        void work ( std::unique_lock<std::mutex>& lock, Batch* batch );
+        void runWorker ( );
+
+    public:
+        // threadCount 0 uses every hardware thread, the thread calling run counts as one.
+        JobPool ( unsigned int threadCount = 0 );
+        ~JobPool ( );
+
+        JobPool ( const JobPool& ) = delete;
+        JobPool& operator= ( const JobPool& ) = delete;
+
+        // Runs job(i) for every i in [0, count) and returns once all of them did. Indices run
+        // in no particular order and on any thread, give each a range of work, not an item.
+        void run ( size_t count, const std::function<void(size_t)>& job );
+
+        // Workers and the calling thread.
+        size_t getThreadCount ( ) const;
+
+};
+
+// The pool every system shares, started on first use.
+JobPool& getJobPool ( );
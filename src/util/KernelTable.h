@@ -0,0 +1,104 @@
+// Not a standalone header, each Kernels*.cpp includes it once after VectorArrays.h,
+// ColorArrays.h, VertexArrays.h and Morton.h, inside the namespace of the instruction set it builds for.
+
+static constexpr Kernels makeKernelTable ( const char* name ) noexcept {
+
+    Kernels table{};
+    table.name = name;
+
+    table.transformArray3f = [] ( Vector3f* out, const Vector3f* in, const Vector3f& scale, const Vector3f& offset, size_t count ) noexcept {
+        transformArray(out, in, scale, offset, count);
+    };
+    table.lerpArrays3f = [] ( Vector3f* out, const Vector3f* a, const Vector3f* b, float delta, size_t count ) noexcept {
+        lerpArrays(out, a, b, delta, count);
+    };
+    table.dotArrays3f = [] ( float* out, const Vector3f* a, const Vector3f* b, size_t count ) noexcept {
+        dotArrays(out, a, b, count);
+    };
+    table.normalizeArray3f = [] ( Vector3f* out, const Vector3f* in, size_t count ) noexcept {
+        normalizeArray(out, in, count);
+    };
+    table.distanceArrays3f = [] ( float* out, const Vector3f* a, const Vector3f* b, size_t count ) noexcept {
+        distanceArrays(out, a, b, count);
+    };
+    table.normalizeArrayFast3f = [] ( Vector3f* out, const Vector3f* in, size_t count ) noexcept {
+        normalizeArrayFast(out, in, count);
+    };
+    table.distanceArraysFast3f = [] ( float* out, const Vector3f* a, const Vector3f* b, size_t count ) noexcept {
+        distanceArraysFast(out, a, b, count);
+    };
+    table.transformArray2f = [] ( Vector2f* out, const Vector2f* in, const Vector2f& scale, const Vector2f& offset, size_t count ) noexcept {
+        transformArray(out, in, scale, offset, count);
+    };
+    table.normalizeArray2f = [] ( Vector2f* out, const Vector2f* in, size_t count ) noexcept {
+        normalizeArray(out, in, count);
+    };
+
+    table.unpackARGBArray = [] ( Color4f* out, const uint32_t* in, size_t count ) noexcept {
+        unpackARGBArray(out, in, count);
+    };
+    table.packARGBArray = [] ( uint32_t* out, const Color4f* in, size_t count ) noexcept {
+        packARGBArray(out, in, count);
+    };
+    table.unpackRGBAArray = [] ( Color4f* out, const uint32_t* in, size_t count ) noexcept {
+        unpackRGBAArray(out, in, count);
+    };
+    table.packRGBAArray = [] ( uint32_t* out, const Color4f* in, size_t count ) noexcept {
+        packRGBAArray(out, in, count);
+    };
+    table.unpackSrgbARGBArray = [] ( Color4f* out, const uint32_t* in, size_t count ) noexcept {
+        unpackSrgbARGBArray(out, in, count);
+    };
+    table.packSrgbARGBArray = [] ( uint32_t* out, const Color4f* in, size_t count ) noexcept {
+        packSrgbARGBArray(out, in, count);
+    };
+    table.unpackSrgbARGBArrayPremultiplied = [] ( Color4f* out, const uint32_t* in, size_t count ) noexcept {
+        unpackSrgbARGBArrayPremultiplied(out, in, count);
+    };
+    table.packSrgbARGBArrayPremultiplied = [] ( uint32_t* out, const Color4f* in, size_t count ) noexcept {
+        packSrgbARGBArrayPremultiplied(out, in, count);
+    };
+    table.srgbToLinearArray = [] ( Color4f* out, const Color4f* in, size_t count ) noexcept {
+        srgbToLinearArray(out, in, count);
+    };
+    table.linearToSrgbArray = [] ( Color4f* out, const Color4f* in, size_t count ) noexcept {
+        linearToSrgbArray(out, in, count);
+    };
+    table.premultiplyAlphaArray = [] ( Color4f* out, const Color4f* in, size_t count ) noexcept {
+        premultiplyAlphaArray(out, in, count);
+    };
+    table.unpremultiplyAlphaArray = [] ( Color4f* out, const Color4f* in, size_t count ) noexcept {
+        unpremultiplyAlphaArray(out, in, count);
+    };
+
+    table.encodeHalfPositions = [] ( Half4* out, const Vector3f* in, size_t count, const PositionQuantization& quant ) noexcept {
+        encodeHalfPositions(out, in, count, quant);
+    };
+    table.decodeHalfPositions = [] ( Vector3f* out, const Half4* in, size_t count, const PositionQuantization& quant ) noexcept {
+        decodeHalfPositions(out, in, count, quant);
+    };
+    table.encodeSnormPositions = [] ( Snorm16x4* out, const Vector3f* in, size_t count, const PositionQuantization& quant ) noexcept {
+        encodeSnormPositions(out, in, count, quant);
+    };
+    table.decodeSnormPositions = [] ( Vector3f* out, const Snorm16x4* in, size_t count, const PositionQuantization& quant ) noexcept {
+        decodeSnormPositions(out, in, count, quant);
+    };
+    table.encodeOctNormals = [] ( Snorm16x2* out, const Vector3f* in, size_t count ) noexcept {
+        encodeOctNormals(out, in, count);
+    };
+    table.decodeOctNormals = [] ( Vector3f* out, const Snorm16x2* in, size_t count ) noexcept {
+        decodeOctNormals(out, in, count);
+    };
+    table.encodeVertexColors = [] ( uint32_t* out, const Color4f* in, size_t count ) noexcept {
+        encodeVertexColors(out, in, count);
+    };
+
+    table.encodeMorton3Array = [] ( uint64_t* out, const Vector3i* in, size_t count ) noexcept {
+        encodeMorton3Array(out, in, count);
+    };
+    table.decodeMorton3Array = [] ( Vector3i* out, const uint64_t* in, size_t count ) noexcept {
+        decodeMorton3Array(out, in, count);
+    };
+
+    return table;
+}
@@ -0,0 +1,44 @@
+#include "Kernels.h"
+#include "util/math/VectorArrays.h"
+#include "util/colors/ColorArrays.h"
+#include "util/math/VertexArrays.h"
+#include "util/math/Morton.h"
+#include "KernelTable.h"
+
+#if SIMD_AVX
+    #define BASELINE_KERNELS_NAME "avx"
+#elif SIMD_SSE2
+    #define BASELINE_KERNELS_NAME "sse2"
+#elif SIMD_NEON
+    #define BASELINE_KERNELS_NAME "neon"
+#else
+    #define BASELINE_KERNELS_NAME "scalar"
+#endif
+
+static constexpr Kernels baselineKernels = makeKernelTable(BASELINE_KERNELS_NAME);
+
+Kernels kernels = baselineKernels;
+
+const Kernels& getBaselineKernels ( ) {
+    return baselineKernels;
+}
+
+const char* initKernels ( const CpuFeatures& features ) {
+
+    const Kernels* avx2 = getAVX2Kernels();
+
+    if ( avx2 != nullptr && features.avx2 && features.fma ) {
+        kernels = *avx2;
+
+        // the AVX2 table's Morton kernels are built on pdep, which AMD CPUs before Zen 3 run as
+        // slow microcode, the baseline shifts and masks beat it there.
+        if ( !features.fastPdep ) {
+            kernels.encodeMorton3Array = baselineKernels.encodeMorton3Array;
+            kernels.decodeMorton3Array = baselineKernels.decodeMorton3Array;
+        }
+    } else {
+        kernels = baselineKernels;
+    }
+
+    return kernels.name;
+}
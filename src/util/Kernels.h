@@ -0,0 +1,69 @@
+#pragma once
+
+// Hot bulk kernels, resolved once against the running CPU. The baseline table is built with the
+// compile flags, extra tables are compiled for wider instruction sets and picked by initKernels().
+// Call through the global table, e.g. kernels.normalizeArray3f(out, in, count).
+
+#include <stddef.h>
+#include <stdint.h>
+#include "util/math/Vector2f.h"
+#include "util/math/Vector3f.h"
+#include "util/math/Vector3i.h"
+#include "util/colors/Color4f.h"
+#include "util/math/VertexFormats.h"
+#include "util/detect/detect_cpu.h"
+
+struct Kernels
+{
+    const char* name;
+
+    // util/math/VectorArrays.h
+    void (*transformArray3f) ( Vector3f* out, const Vector3f* in, const Vector3f& scale, const Vector3f& offset, size_t count ) noexcept;
+    void (*lerpArrays3f) ( Vector3f* out, const Vector3f* a, const Vector3f* b, float delta, size_t count ) noexcept;
+    void (*dotArrays3f) ( float* out, const Vector3f* a, const Vector3f* b, size_t count ) noexcept;
+    void (*normalizeArray3f) ( Vector3f* out, const Vector3f* in, size_t count ) noexcept;
+    void (*distanceArrays3f) ( float* out, const Vector3f* a, const Vector3f* b, size_t count ) noexcept;
+    void (*normalizeArrayFast3f) ( Vector3f* out, const Vector3f* in, size_t count ) noexcept;
+    void (*distanceArraysFast3f) ( float* out, const Vector3f* a, const Vector3f* b, size_t count ) noexcept;
+    void (*transformArray2f) ( Vector2f* out, const Vector2f* in, const Vector2f& scale, const Vector2f& offset, size_t count ) noexcept;
+    void (*normalizeArray2f) ( Vector2f* out, const Vector2f* in, size_t count ) noexcept;
+
+    // util/colors/ColorArrays.h
+    void (*unpackARGBArray) ( Color4f* out, const uint32_t* in, size_t count ) noexcept;
+    void (*packARGBArray) ( uint32_t* out, const Color4f* in, size_t count ) noexcept;
+    void (*unpackRGBAArray) ( Color4f* out, const uint32_t* in, size_t count ) noexcept;
+    void (*packRGBAArray) ( uint32_t* out, const Color4f* in, size_t count ) noexcept;
+    void (*unpackSrgbARGBArray) ( Color4f* out, const uint32_t* in, size_t count ) noexcept;
+    void (*packSrgbARGBArray) ( uint32_t* out, const Color4f* in, size_t count ) noexcept;
+    void (*unpackSrgbARGBArrayPremultiplied) ( Color4f* out, const uint32_t* in, size_t count ) noexcept;
+    void (*packSrgbARGBArrayPremultiplied) ( uint32_t* out, const Color4f* in, size_t count ) noexcept;
+    void (*srgbToLinearArray) ( Color4f* out, const Color4f* in, size_t count ) noexcept;
+    void (*linearToSrgbArray) ( Color4f* out, const Color4f* in, size_t count ) noexcept;
+    void (*premultiplyAlphaArray) ( Color4f* out, const Color4f* in, size_t count ) noexcept;
+    void (*unpremultiplyAlphaArray) ( Color4f* out, const Color4f* in, size_t count ) noexcept;
+
+    // util/math/VertexArrays.h
+    void (*encodeHalfPositions) ( Half4* out, const Vector3f* in, size_t count, const PositionQuantization& quant ) noexcept;
+    void (*decodeHalfPositions) ( Vector3f* out, const Half4* in, size_t count, const PositionQuantization& quant ) noexcept;
+    void (*encodeSnormPositions) ( Snorm16x4* out, const Vector3f* in, size_t count, const PositionQuantization& quant ) noexcept;
+    void (*decodeSnormPositions) ( Vector3f* out, const Snorm16x4* in, size_t count, const PositionQuantization& quant ) noexcept;
+    void (*encodeOctNormals) ( Snorm16x2* out, const Vector3f* in, size_t count ) noexcept;
+    void (*decodeOctNormals) ( Vector3f* out, const Snorm16x2* in, size_t count ) noexcept;
+    void (*encodeVertexColors) ( uint32_t* out, const Color4f* in, size_t count ) noexcept;
+
+    // util/math/Morton.h
+    void (*encodeMorton3Array) ( uint64_t* out, const Vector3i* in, size_t count ) noexcept;
+    void (*decodeMorton3Array) ( Vector3i* out, const uint64_t* in, size_t count ) noexcept;
+};
+
+// Holds the baseline table until initKernels() runs.
+extern Kernels kernels;
+
+const Kernels& getBaselineKernels ( );
+
+// nullptr when the compiler can not target AVX2.
+const Kernels* getAVX2Kernels ( );
+
+// Installs the best table the features allow and returns its name.
+// Must be called before any other thread uses kernels.
+const char* initKernels ( const CpuFeatures& features = getCpuFeatures() );
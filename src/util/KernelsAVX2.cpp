@@ -0,0 +1,59 @@
+// AVX2 + FMA build of the kernel table, used only when the CPU reports both. It also targets
+// BMI2 for the Morton kernels, which initKernels() swaps for the baseline ones without fast pdep.
+// Everything with external linkage is included before the target pragma so it keeps the
+// baseline instruction set, the kernels themselves are compiled inside namespace avx2 so
+// none of their inline symbols can be merged with the baseline build by the linker.
+
+#include "Kernels.h"
+#include "util/detect.h"
+
+#if (DETECT_ARCH_X86 || DETECT_ARCH_X86_64) && DETECT_ARCH_SSE
+
+#include <stddef.h>
+#include <stdint.h>
+#include <float.h>
+#include <string.h>
+#include <emmintrin.h>
+#include <immintrin.h>
+#include "util/intrinsics.h"
+#include "util/Constants.h"
+#include "util/colors/ColorRGBa.h"
+
+#define SIMD_TARGET_AVX2
+#define MORTON_TARGET_BMI2
+
+#if defined(__clang__)
+    #pragma clang attribute push (__attribute__((target("avx2,fma,bmi2"))), apply_to = function)
+#elif defined(__GNUC__)
+    #pragma GCC push_options
+    #pragma GCC target("avx2,fma,bmi2")
+#endif
+
+namespace avx2 {
+    #include "util/simd.h"
+    #include "util/math/VectorArrays.h"
+    #include "util/colors/ColorArrays.h"
+    #include "util/math/VertexArrays.h"
+    #include "util/math/Morton.h"
+    #include "KernelTable.h"
+}
+
+#if defined(__clang__)
+    #pragma clang attribute pop
+#elif defined(__GNUC__)
+    #pragma GCC pop_options
+#endif
+
+static constexpr Kernels avx2Kernels = avx2::makeKernelTable("avx2");
+
+const Kernels* getAVX2Kernels ( ) {
+    return &avx2Kernels;
+}
+
+#else
+
+const Kernels* getAVX2Kernels ( ) {
+    return nullptr;
+}
+
+#endif
@@ -0,0 +1,58 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+// 64 bit key with a 32 bit payload, usually an index into the array the keys describe.
+struct RadixSortItem {
+    uint64_t key;
+    uint32_t value;
+};
+
+// Stable LSD radix sort on the key, 8 bits per pass. All 8 histograms are built in one read
+// and passes where every key has the same digit are skipped, so keys that only differ in a
+// few bytes cost a few passes. Returns whichever of items or scratch holds the result,
+// both must hold count entries.
+inline RadixSortItem* radixSort ( RadixSortItem* items, RadixSortItem* scratch, size_t count ) noexcept {
+
+    constexpr int PASSES = 8;
+    size_t histograms[PASSES][256];
+    memset(histograms, 0, sizeof(histograms));
+
+    for ( size_t i = 0; i < count; ++i ) {
+        uint64_t key = items[i].key;
+        for ( int pass = 0; pass < PASSES; ++pass ) {
+            histograms[pass][(key >> (pass * 8)) & 0xFF]++;
+        }
+    }
+
+    RadixSortItem* src = items;
+    RadixSortItem* dst = scratch;
+
+    for ( int pass = 0; pass < PASSES; ++pass ) {
+        size_t* histogram = histograms[pass];
+
+        if ( count == 0 || histogram[(src[0].key >> (pass * 8)) & 0xFF] == count ) {
+            continue;
+        }
+
+        size_t offset = 0;
+        for ( int digit = 0; digit < 256; ++digit ) {
+            size_t digitCount = histogram[digit];
+            histogram[digit] = offset;
+            offset += digitCount;
+        }
+
+        for ( size_t i = 0; i < count; ++i ) {
+            dst[histogram[(src[i].key >> (pass * 8)) & 0xFF]++] = src[i];
+        }
+
+        RadixSortItem* swap = src;
+        src = dst;
+        dst = swap;
+    }
+
+    return src;
+
+}
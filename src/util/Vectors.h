@@ -3,4 +3,5 @@
 
 #include "math/Vector2i.h"
 #include "math/Vector3f.h"
+#include "math/Vector3i.h"
 #include "math/Vector2f.h"
@@ -4,6 +4,7 @@
 #ifdef __cplusplus
 #include "stdint.h"
 #include <algorithm>
+#include <cmath>
 #include "util/Constants.h"
 #endif
 
@@ -50,5 +51,27 @@ struct Color4f
         return (getUAlpha() << 24) | (getURed() << 16) | (getUGreen() << 8) | getUBlue();
     }
 
+    // sRGB transfer function on red, green and blue, clamped to [0, 1]. Alpha is always linear.
+    // Exact reference for the polynomial versions in ColorArrays.h.
+    inline Color4f toLinear ( ) const noexcept {
+        auto decode = []( float c ) -> float {
+            c = std::clamp(c, 0.0F, 1.0F);
+            return c <= 0.04045F ? c * (1.0F / 12.92F) : std::pow((c + 0.055F) * (1.0F / 1.055F), 2.4F);
+        };
+        return Color4f(decode(this->red), decode(this->green), decode(this->blue), this->alpha);
+    }
+
+    inline Color4f toSrgb ( ) const noexcept {
+        auto encode = []( float c ) -> float {
+            c = std::clamp(c, 0.0F, 1.0F);
+            return c <= 0.0031308F ? c * 12.92F : 1.055F * std::pow(c, 1.0F / 2.4F) - 0.055F;
+        };
+        return Color4f(encode(this->red), encode(this->green), encode(this->blue), this->alpha);
+    }
+
+    constexpr inline Color4f premultiplied ( ) const noexcept {
+        return Color4f(this->red * this->alpha, this->green * this->alpha, this->blue * this->alpha, this->alpha);
+    }
+
 #endif // cplusplus
 };
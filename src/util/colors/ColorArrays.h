@@ -0,0 +1,267 @@
+#pragma once
+
+// Bulk conversions between packed 8 bit pixels and Color4f. The plain unpack / pack give the
+// same result as Color4f(argb) / Color4f::toARGB() per element. The sRGB variants decode to
+// linear Color4f and encode back with a polynomial fit of the transfer function, within 1e-5
+// of Color4f::toLinear() / toSrgb(), and round to nearest when packing.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "util/simd.h"
+#include "util/Constants.h"
+#include "ColorRGBa.h"
+#include "Color4f.h"
+
+static_assert(sizeof(Color4f) == 4 * sizeof(float), "Color4f arrays are read as packed floats");
+static_assert(sizeof(ColorRGB) == sizeof(uint32_t), "ColorRGB arrays are read as packed pixels");
+
+// Bit offset of each channel in a packed pixel.
+template<int RShift, int GShift, int BShift, int AShift>
+struct PixelLayout {
+    static constexpr int R = RShift, G = GShift, B = BShift, A = AShift;
+};
+
+typedef PixelLayout<16, 8, 0, 24> PixelARGB;
+typedef PixelLayout<24, 16, 8, 0> PixelRGBA;
+typedef PixelLayout<0, 8, 16, 24> PixelABGR; // red, green, blue, alpha bytes read little endian, GL's RGBA8
+typedef PixelLayout<8, 16, 24, 0> PixelColorRGB; // alpha, red, green, blue bytes read little endian
+
+// sRGB -> linear, [0, 1] after clamping. Degree 6 fit of ((c + 0.055) / 1.055)^2.4 above the linear toe.
+inline simd4f srgbToLinear4 ( simd4f c ) noexcept {
+    c = simd_min(simd_max(c, simd4f_set1(0.0F)), simd4f_set1(1.0F));
+
+    simd4f curve = simd_madd(simd4f_set1(-0.04716058F), c, simd4f_set1(0.20313660F));
+    curve = simd_madd(curve, c, simd4f_set1(-0.40627095F));
+    curve = simd_madd(curve, c, simd4f_set1(0.70087075F));
+    curve = simd_madd(curve, c, simd4f_set1(0.51585769F));
+    curve = simd_madd(curve, c, simd4f_set1(0.03263253F));
+    curve = simd_madd(curve, c, simd4f_set1(0.00093115F));
+
+    return simd_select(simd_cmple(c, simd4f_set1(0.04045F)), simd_mul(c, simd4f_set1(1.0F / 12.92F)), curve);
+}
+
+// linear -> sRGB. c^(1/2.4) is steep near 0, so the degree 5 fit runs on c^(1/4) instead.
+inline simd4f linearToSrgb4 ( simd4f c ) noexcept {
+    c = simd_min(simd_max(c, simd4f_set1(0.0F)), simd4f_set1(1.0F));
+    simd4f x = simd_sqrt(simd_sqrt(c));
+
+    simd4f curve = simd_madd(simd4f_set1(-0.06275899F), x, simd4f_set1(0.27275224F));
+    curve = simd_madd(curve, x, simd4f_set1(-0.55755565F));
+    curve = simd_madd(curve, x, simd4f_set1(1.24421400F));
+    curve = simd_madd(curve, x, simd4f_set1(0.16497400F));
+    curve = simd_madd(curve, x, simd4f_set1(-0.06162971F));
+
+    return simd_select(simd_cmple(c, simd4f_set1(0.0031308F)), simd_mul(c, simd4f_set1(12.92F)), curve);
+}
+
+// 4 pixels -> 4 colors. Linearize decodes sRGB, Premultiply then scales red, green and blue by alpha.
+template<typename Layout, bool Linearize, bool Premultiply>
+inline void unpackPixels4 ( Color4f* out, const uint32_t* in ) noexcept {
+
+    simd4i mask = simd4i_set1(0xFF);
+    simd4f scale = simd4f_set1(ONE_255);
+    simd4i pixels = simd4i_load(reinterpret_cast<const int32_t*>(in));
+
+    simd4f r = simd_mul(simd_toFloat(simd_and(simd_shr<Layout::R>(pixels), mask)), scale);
+    simd4f g = simd_mul(simd_toFloat(simd_and(simd_shr<Layout::G>(pixels), mask)), scale);
+    simd4f b = simd_mul(simd_toFloat(simd_and(simd_shr<Layout::B>(pixels), mask)), scale);
+    simd4f a = simd_mul(simd_toFloat(simd_and(simd_shr<Layout::A>(pixels), mask)), scale);
+
+    if constexpr ( Linearize ) {
+        r = srgbToLinear4(r); g = srgbToLinear4(g); b = srgbToLinear4(b);
+    }
+
+    if constexpr ( Premultiply ) {
+        r = simd_mul(r, a); g = simd_mul(g, a); b = simd_mul(b, a);
+    }
+
+    simd_storeXYZW(&out->red, r, g, b, a);
+
+}
+
+// 4 colors -> 4 pixels. Premultiply scales by alpha first, Encode then applies sRGB and rounds,
+// otherwise channels truncate like Color4f::toARGB().
+template<typename Layout, bool Encode, bool Premultiply>
+inline void packPixels4 ( uint32_t* out, const Color4f* in ) noexcept {
+
+    simd4f zero = simd4f_set1(0.0F), max = simd4f_set1(255.0F);
+    simd4f bias = simd4f_set1(Encode ? 0.5F : 0.0F);
+    simd4f r, g, b, a;
+
+    simd_loadXYZW(&in->red, r, g, b, a);
+
+    if constexpr ( Premultiply ) {
+        simd4f clampedA = simd_min(simd_max(a, zero), simd4f_set1(1.0F));
+        r = simd_mul(r, clampedA); g = simd_mul(g, clampedA); b = simd_mul(b, clampedA);
+    }
+
+    if constexpr ( Encode ) {
+        r = linearToSrgb4(r); g = linearToSrgb4(g); b = linearToSrgb4(b);
+    }
+
+    simd4i ri = simd_toInt(simd_min(simd_max(simd_madd(r, max, bias), zero), max));
+    simd4i gi = simd_toInt(simd_min(simd_max(simd_madd(g, max, bias), zero), max));
+    simd4i bi = simd_toInt(simd_min(simd_max(simd_madd(b, max, bias), zero), max));
+    simd4i ai = simd_toInt(simd_min(simd_max(simd_madd(a, max, bias), zero), max));
+
+    simd_store(reinterpret_cast<int32_t*>(out),
+        simd_or(simd_or(simd_shl<Layout::A>(ai), simd_shl<Layout::R>(ri)), simd_or(simd_shl<Layout::G>(gi), simd_shl<Layout::B>(bi))));
+
+}
+
+// The tails go through a zero padded copy so every element takes the same path.
+template<typename Layout, bool Linearize = false, bool Premultiply = false>
+inline void unpackPixelArray ( Color4f* out, const uint32_t* in, size_t count ) noexcept {
+
+    size_t i = 0, simdCount = count - count % 4;
+
+    for ( ; i < simdCount; i += 4 ) {
+        unpackPixels4<Layout, Linearize, Premultiply>(out + i, in + i);
+    }
+
+    if ( i < count ) {
+        uint32_t tailIn[4] = { };
+        Color4f tailOut[4];
+        memcpy(tailIn, in + i, (count - i) * sizeof(uint32_t));
+        unpackPixels4<Layout, Linearize, Premultiply>(tailOut, tailIn);
+        memcpy(out + i, tailOut, (count - i) * sizeof(Color4f));
+    }
+
+}
+
+template<typename Layout, bool Encode = false, bool Premultiply = false>
+inline void packPixelArray ( uint32_t* out, const Color4f* in, size_t count ) noexcept {
+
+    size_t i = 0, simdCount = count - count % 4;
+
+    for ( ; i < simdCount; i += 4 ) {
+        packPixels4<Layout, Encode, Premultiply>(out + i, in + i);
+    }
+
+    if ( i < count ) {
+        Color4f tailIn[4];
+        uint32_t tailOut[4];
+        memcpy(tailIn, in + i, (count - i) * sizeof(Color4f));
+        packPixels4<Layout, Encode, Premultiply>(tailOut, tailIn);
+        memcpy(out + i, tailOut, (count - i) * sizeof(uint32_t));
+    }
+
+}
+
+inline void unpackARGBArray ( Color4f* out, const uint32_t* in, size_t count ) noexcept {
+    unpackPixelArray<PixelARGB>(out, in, count);
+}
+
+inline void packARGBArray ( uint32_t* out, const Color4f* in, size_t count ) noexcept {
+    packPixelArray<PixelARGB>(out, in, count);
+}
+
+inline void unpackRGBAArray ( Color4f* out, const uint32_t* in, size_t count ) noexcept {
+    unpackPixelArray<PixelRGBA>(out, in, count);
+}
+
+inline void packRGBAArray ( uint32_t* out, const Color4f* in, size_t count ) noexcept {
+    packPixelArray<PixelRGBA>(out, in, count);
+}
+
+inline void unpackColorRGBArray ( Color4f* out, const ColorRGB* in, size_t count ) noexcept {
+    unpackPixelArray<PixelColorRGB>(out, reinterpret_cast<const uint32_t*>(in), count);
+}
+
+inline void packColorRGBArray ( ColorRGB* out, const Color4f* in, size_t count ) noexcept {
+    packPixelArray<PixelColorRGB>(reinterpret_cast<uint32_t*>(out), in, count);
+}
+
+// sRGB encoded ARGB <-> linear Color4f, e.g. texture import.
+inline void unpackSrgbARGBArray ( Color4f* out, const uint32_t* in, size_t count ) noexcept {
+    unpackPixelArray<PixelARGB, true>(out, in, count);
+}
+
+inline void packSrgbARGBArray ( uint32_t* out, const Color4f* in, size_t count ) noexcept {
+    packPixelArray<PixelARGB, true>(out, in, count);
+}
+
+// As above with alpha premultiplied in linear space, what blending with (ONE, ONE_MINUS_SRC_ALPHA) wants.
+inline void unpackSrgbARGBArrayPremultiplied ( Color4f* out, const uint32_t* in, size_t count ) noexcept {
+    unpackPixelArray<PixelARGB, true, true>(out, in, count);
+}
+
+inline void packSrgbARGBArrayPremultiplied ( uint32_t* out, const Color4f* in, size_t count ) noexcept {
+    packPixelArray<PixelARGB, true, true>(out, in, count);
+}
+
+// Color4f -> Color4f transforms below leave alpha untouched and may run in place.
+
+inline void srgbToLinearArray ( Color4f* out, const Color4f* in, size_t count ) noexcept {
+
+    simd4f r, g, b, a;
+    size_t i = 0, simdCount = count - count % 4;
+
+    for ( ; i < simdCount; i += 4 ) {
+        simd_loadXYZW(&in[i].red, r, g, b, a);
+        simd_storeXYZW(&out[i].red, srgbToLinear4(r), srgbToLinear4(g), srgbToLinear4(b), a);
+    }
+
+    for ( ; i < count; ++i ) {
+        alignas(16) float rgba[4];
+        simd_store(rgba, srgbToLinear4(simd_load<simd4f>(&in[i].red)));
+        out[i] = Color4f(rgba[0], rgba[1], rgba[2], in[i].alpha);
+    }
+
+}
+
+inline void linearToSrgbArray ( Color4f* out, const Color4f* in, size_t count ) noexcept {
+
+    simd4f r, g, b, a;
+    size_t i = 0, simdCount = count - count % 4;
+
+    for ( ; i < simdCount; i += 4 ) {
+        simd_loadXYZW(&in[i].red, r, g, b, a);
+        simd_storeXYZW(&out[i].red, linearToSrgb4(r), linearToSrgb4(g), linearToSrgb4(b), a);
+    }
+
+    for ( ; i < count; ++i ) {
+        alignas(16) float rgba[4];
+        simd_store(rgba, linearToSrgb4(simd_load<simd4f>(&in[i].red)));
+        out[i] = Color4f(rgba[0], rgba[1], rgba[2], in[i].alpha);
+    }
+
+}
+
+inline void premultiplyAlphaArray ( Color4f* out, const Color4f* in, size_t count ) noexcept {
+
+    simd4f r, g, b, a;
+    size_t i = 0, simdCount = count - count % 4;
+
+    for ( ; i < simdCount; i += 4 ) {
+        simd_loadXYZW(&in[i].red, r, g, b, a);
+        simd_storeXYZW(&out[i].red, simd_mul(r, a), simd_mul(g, a), simd_mul(b, a), a);
+    }
+
+    for ( ; i < count; ++i ) {
+        out[i] = in[i].premultiplied();
+    }
+
+}
+
+// Colors with zero alpha come out black.
+inline void unpremultiplyAlphaArray ( Color4f* out, const Color4f* in, size_t count ) noexcept {
+
+    simd4f zero = simd4f_set1(0.0F), one = simd4f_set1(1.0F);
+    simd4f r, g, b, a;
+    size_t i = 0, simdCount = count - count % 4;
+
+    for ( ; i < simdCount; i += 4 ) {
+        simd_loadXYZW(&in[i].red, r, g, b, a);
+        simd4f hasAlpha = simd_cmpgt(a, zero);
+        simd4f invA = simd_select(hasAlpha, simd_div(one, simd_select(hasAlpha, a, one)), zero);
+        simd_storeXYZW(&out[i].red, simd_mul(r, invA), simd_mul(g, invA), simd_mul(b, invA), a);
+    }
+
+    for ( ; i < count; ++i ) {
+        float invA = in[i].alpha > 0 ? 1.0F / in[i].alpha : 0.0F;
+        out[i] = Color4f(in[i].red * invA, in[i].green * invA, in[i].blue * invA, in[i].alpha);
+    }
+
+}
@@ -12,7 +12,7 @@ typedef struct alignas(4) ColorRGB
     uint8_t alpha, red, green, blue;
 
 #ifdef __cplusplus
-    constexpr inline ColorRGB ( ) noexcept: red(0), green(0), blue(0), alpha(255) { }
+    constexpr inline ColorRGB ( ) noexcept: alpha(255), red(0), green(0), blue(0) { }
 
     // Takes ARGB as input and not RGBa
     constexpr inline ColorRGB ( uint32_t argb ) noexcept: 
@@ -23,11 +23,11 @@ typedef struct alignas(4) ColorRGB
     { } 
     
     constexpr inline uint32_t toRGBA ( ) const noexcept {
-        return (this->red << 24) | (this->blue << 16) | (this->green << 8) | this->alpha;
+        return (this->red << 24) | (this->green << 16) | (this->blue << 8) | this->alpha;
     }
 
     constexpr inline uint32_t toARGB ( ) const noexcept {
-        return (this->alpha << 24) | (this->red << 16) | (this->blue << 8) | this->green;
+        return (this->alpha << 24) | (this->red << 16) | (this->green << 8) | this->blue;
     }
 
 #endif
@@ -0,0 +1,125 @@
+#include "detect_cpu.h"
+#include "util/detect.h"
+#include <stdint.h>
+
+#if DETECT_ARCH_X86 || DETECT_ARCH_X86_64
+    #if defined(_MSC_VER) && !defined(__clang__)
+        #include <intrin.h>
+        #include <immintrin.h>
+    #else
+        #include <cpuid.h>
+    #endif
+#endif
+
+#if DETECT_ARCH_X86 || DETECT_ARCH_X86_64
+
+static void cpuid ( uint32_t leaf, uint32_t subLeaf, uint32_t regs[4] ) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    int out[4];
+    __cpuidex(out, static_cast<int>(leaf), static_cast<int>(subLeaf));
+    for ( int i = 0; i < 4; ++i ) { regs[i] = static_cast<uint32_t>(out[i]); }
+#else
+    __cpuid_count(leaf, subLeaf, regs[0], regs[1], regs[2], regs[3]);
+#endif
+}
+
+// XCR0, which register states the OS saves on a context switch.
+static uint64_t readXcr0 ( ) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    return _xgetbv(0);
+#else
+    uint32_t eax, edx;
+    __asm__ volatile ( "xgetbv" : "=a"(eax), "=d"(edx) : "c"(0) );
+    return (static_cast<uint64_t>(edx) << 32) | eax;
+#endif
+}
+
+static CpuFeatures queryCpuFeatures ( ) {
+
+    CpuFeatures features{};
+    uint32_t regs[4]; // eax, ebx, ecx, edx
+
+    cpuid(0, 0, regs);
+    uint32_t maxLeaf = regs[0];
+    bool isAmd = regs[1] == 0x68747541 && regs[3] == 0x69746E65 && regs[2] == 0x444D4163; // "AuthenticAMD"
+
+    if ( maxLeaf < 1 ) {
+        return features;
+    }
+
+    cpuid(1, 0, regs);
+    uint32_t baseFamily = (regs[0] >> 8) & 0xF;
+    uint32_t family = baseFamily == 0xF ? baseFamily + ((regs[0] >> 20) & 0xFF) : baseFamily;
+    features.sse2   = regs[3] & (1u << 26);
+    features.sse3   = regs[2] & (1u << 0);
+    features.ssse3  = regs[2] & (1u << 9);
+    features.sse41  = regs[2] & (1u << 19);
+    features.sse42  = regs[2] & (1u << 20);
+    features.popcnt = regs[2] & (1u << 23);
+
+    bool osxsave = regs[2] & (1u << 27);
+    bool cpuAvx = regs[2] & (1u << 28);
+    bool cpuFma = regs[2] & (1u << 12);
+    bool cpuF16c = regs[2] & (1u << 29);
+
+    // The AVX registers are only usable if the OS saves them, XCR0 bits 1 and 2 (xmm, ymm).
+    uint64_t xcr0 = osxsave ? readXcr0() : 0;
+    bool osAvx = (xcr0 & 0x6) == 0x6;
+    bool osAvx512 = (xcr0 & 0xE6) == 0xE6; // + opmask, zmm hi256, hi16 zmm
+
+    features.avx  = cpuAvx && osAvx;
+    features.fma  = cpuFma && features.avx;
+    features.f16c = cpuF16c && features.avx;
+
+    if ( maxLeaf >= 7 ) {
+        cpuid(7, 0, regs);
+        features.bmi1     = regs[1] & (1u << 3);
+        features.avx2     = (regs[1] & (1u << 5)) && features.avx;
+        features.bmi2     = regs[1] & (1u << 8);
+        features.avx512f  = (regs[1] & (1u << 16)) && osAvx512;
+        features.avx512bw = (regs[1] & (1u << 30)) && features.avx512f;
+        features.avx512vl = (regs[1] & (1u << 31)) && features.avx512f;
+    }
+
+    features.fastPdep = features.bmi2 && (!isAmd || family >= 0x19);
+
+    return features;
+}
+
+#else
+
+static CpuFeatures queryCpuFeatures ( ) {
+    CpuFeatures features{};
+    // NEON is mandatory on aarch64, on 32 bit arm trust the compile flags.
+#if DETECT_ARCH_AARCH64 || defined(__ARM_NEON)
+    features.neon = true;
+#endif
+    return features;
+}
+
+#endif
+
+const CpuFeatures& getCpuFeatures ( ) {
+    static const CpuFeatures features = queryCpuFeatures();
+    return features;
+}
+
+std::string describeCpuFeatures ( const CpuFeatures& features ) {
+
+    std::string out;
+
+    auto add = [&out]( bool supported, const char* name ) {
+        if ( supported ) {
+            out += out.empty() ? name : std::string(" ") + name;
+        }
+    };
+
+    add(features.sse2, "sse2"); add(features.sse3, "sse3"); add(features.ssse3, "ssse3");
+    add(features.sse41, "sse4.1"); add(features.sse42, "sse4.2"); add(features.popcnt, "popcnt");
+    add(features.avx, "avx"); add(features.avx2, "avx2"); add(features.fma, "fma");
+    add(features.f16c, "f16c"); add(features.bmi1, "bmi1"); add(features.bmi2, "bmi2");
+    add(features.avx512f, "avx512f"); add(features.avx512bw, "avx512bw"); add(features.avx512vl, "avx512vl");
+    add(features.neon, "neon");
+
+    return out.empty() ? "none" : out;
+}
@@ -0,0 +1,21 @@
+#pragma once
+
+// Runtime counterpart of detect_arch.h, describes what the running CPU and OS support
+// rather than what the binary was compiled for.
+
+#include <string>
+
+typedef struct CpuFeatures
+{
+    bool sse2, sse3, ssse3, sse41, sse42, popcnt;
+    bool avx, avx2, fma, f16c, bmi1, bmi2;
+    bool avx512f, avx512bw, avx512vl;
+    bool fastPdep; // bmi2 pdep / pext in hardware, AMD before Zen 3 runs them in microcode
+    bool neon;
+} CpuFeatures;
+
+// Queried once on first use, safe to call from any thread.
+const CpuFeatures& getCpuFeatures ( );
+
+// Space separated list of the supported features, for logging.
+std::string describeCpuFeatures ( const CpuFeatures& features );
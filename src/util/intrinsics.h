@@ -2,6 +2,9 @@
 #pragma once
 
 #ifdef __cplusplus
+#include <cmath> // the libm declarations must come before the overrides below.
+#include <cfloat>
+
 extern "C" {
 #endif
 
@@ -24,3 +27,34 @@ extern "C" {
 #ifdef __cplusplus
 }
 #endif
+
+#ifdef __cplusplus
+
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    #include <xmmintrin.h>
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    #include <arm_neon.h>
+#endif
+
+// Approximate 1 / sqrtf(x) from the hardware estimate refined by Newton-Raphson, relative error
+// is below 4e-7 (about 3 ulp) for normal x > 0. 0 and denormals give NaN or inf, guard them.
+inline float fastRsqrt ( float x ) noexcept {
+#if defined(__SSE__) || defined(_M_X64) || defined(_M_AMD64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 1)
+    float est = _mm_cvtss_f32(_mm_rsqrt_ss(_mm_set_ss(x))); // 12 bits
+    return est * (1.5F - 0.5F * x * est * est);
+#elif defined(__aarch64__) || defined(_M_ARM64)
+    float est = vrsqrtes_f32(x); // 8 bits, needs two steps
+    est *= vrsqrtss_f32(x * est, est);
+    return est * vrsqrtss_f32(x * est, est);
+#else
+    return 1.0F / sqrtf(x);
+#endif
+}
+
+// sqrtf(x) as x * fastRsqrt(x), same error bound. Below FLT_MIN the estimate overflows, so
+// 0 and denormals take the exact sqrtf.
+inline float fastSqrt ( float x ) noexcept {
+    return x >= FLT_MIN ? x * fastRsqrt(x) : sqrtf(x);
+}
+
+#endif // cplusplus
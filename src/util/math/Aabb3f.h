@@ -0,0 +1,79 @@
+#pragma once
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include "Vector3f.h"
+#endif
+
+// Axis aligned box. The default box is empty (Min > Max), growing it by anything yields that thing.
+typedef struct Aabb3f
+{
+    Vector3f Min, Max;
+
+#ifdef __cplusplus
+    constexpr inline Aabb3f ( ) noexcept : Min(INFINITY, INFINITY, INFINITY), Max(-INFINITY, -INFINITY, -INFINITY) { }
+    constexpr inline Aabb3f ( const Vector3f& min, const Vector3f& max ) noexcept : Min(min), Max(max) { }
+
+    constexpr inline bool IsEmpty ( ) const noexcept {
+        return this->Min.X > this->Max.X || this->Min.Y > this->Max.Y || this->Min.Z > this->Max.Z;
+    }
+
+    constexpr inline void Grow ( const Vector3f& point ) noexcept {
+        this->Min = Vector3f(std::min(this->Min.X, point.X), std::min(this->Min.Y, point.Y), std::min(this->Min.Z, point.Z));
+        this->Max = Vector3f(std::max(this->Max.X, point.X), std::max(this->Max.Y, point.Y), std::max(this->Max.Z, point.Z));
+    }
+
+    constexpr inline void Grow ( const Aabb3f& other ) noexcept {
+        this->Min = Vector3f(std::min(this->Min.X, other.Min.X), std::min(this->Min.Y, other.Min.Y), std::min(this->Min.Z, other.Min.Z));
+        this->Max = Vector3f(std::max(this->Max.X, other.Max.X), std::max(this->Max.Y, other.Max.Y), std::max(this->Max.Z, other.Max.Z));
+    }
+
+    constexpr inline Vector3f GetCenter ( ) const noexcept {
+        return (this->Min + this->Max) * 0.5F;
+    }
+
+    constexpr inline Vector3f GetSize ( ) const noexcept {
+        return this->Max - this->Min;
+    }
+
+    // 0 for empty boxes, so they never win a SAH comparison.
+    constexpr inline float GetSurfaceArea ( ) const noexcept {
+        if ( this->IsEmpty() ) {
+            return 0;
+        }
+
+        Vector3f size = this->GetSize();
+        return 2 * (size.X * size.Y + size.Y * size.Z + size.Z * size.X);
+    }
+
+    constexpr inline bool Contains ( const Vector3f& point ) const noexcept {
+        return point.X >= this->Min.X && point.Y >= this->Min.Y && point.Z >= this->Min.Z
+            && point.X <= this->Max.X && point.Y <= this->Max.Y && point.Z <= this->Max.Z;
+    }
+
+    constexpr inline bool Overlaps ( const Aabb3f& other ) const noexcept {
+        return this->Min.X <= other.Max.X && this->Min.Y <= other.Max.Y && this->Min.Z <= other.Max.Z
+            && other.Min.X <= this->Max.X && other.Min.Y <= this->Max.Y && other.Min.Z <= this->Max.Z;
+    }
+
+    inline std::string toString ( ) const noexcept {
+        return "[Min: " + this->Min.toString() + ", Max: " + this->Max.toString() + "]";
+    }
+#endif
+} Aabb3f;
+
+#ifdef __cplusplus
+
+constexpr inline Aabb3f operator+ ( const Aabb3f& valA, const Aabb3f& valB ) noexcept {
+    Aabb3f out = valA;
+    out.Grow(valB);
+    return out;
+}
+
+inline std::ostream& operator<<(std::ostream& os, const Aabb3f& val) {
+    return os << val.toString();
+}
+
+#endif // cplusplus
@@ -0,0 +1,103 @@
+#pragma once
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <limits.h>
+#include <stdint.h>
+#include <string>
+#include "Aabb3f.h"
+#include "Vector3i.h"
+#endif
+
+// Integer box over grid cells, Min inclusive and Max exclusive so sizes and volumes need no +1.
+// The default box is empty (Min >= Max), growing it by anything yields that thing.
+typedef struct Aabb3i
+{
+    Vector3i Min, Max;
+
+#ifdef __cplusplus
+    constexpr inline Aabb3i ( ) noexcept : Min(INT_MAX, INT_MAX, INT_MAX), Max(INT_MIN, INT_MIN, INT_MIN) { }
+    constexpr inline Aabb3i ( const Vector3i& min, const Vector3i& max ) noexcept : Min(min), Max(max) { }
+
+    // Every cell the box touches, a face lying exactly on a cell border takes that cell too.
+    static inline Aabb3i FromAabb3f ( const Aabb3f& box ) noexcept {
+        if ( box.IsEmpty() ) {
+            return Aabb3i();
+        }
+
+        return Aabb3i(Vector3i::Floor(box.Min), Vector3i::Floor(box.Max) + Vector3i(1, 1, 1));
+    }
+
+    constexpr inline bool IsEmpty ( ) const noexcept {
+        return this->Min.X >= this->Max.X || this->Min.Y >= this->Max.Y || this->Min.Z >= this->Max.Z;
+    }
+
+    constexpr inline void Grow ( const Vector3i& cell ) noexcept {
+        this->Min = this->Min.Min(cell);
+        this->Max = this->Max.Max(cell + Vector3i(1, 1, 1));
+    }
+
+    constexpr inline void Grow ( const Aabb3i& other ) noexcept {
+        if ( !other.IsEmpty() ) {
+            this->Min = this->Min.Min(other.Min);
+            this->Max = this->Max.Max(other.Max);
+        }
+    }
+
+    constexpr inline Vector3i GetSize ( ) const noexcept {
+        return this->IsEmpty() ? Vector3i() : this->Max - this->Min;
+    }
+
+    constexpr inline int64_t GetVolume ( ) const noexcept {
+        Vector3i size = this->GetSize();
+        return static_cast<int64_t>(size.X) * size.Y * size.Z;
+    }
+
+    constexpr inline bool Contains ( const Vector3i& cell ) const noexcept {
+        return cell.X >= this->Min.X && cell.Y >= this->Min.Y && cell.Z >= this->Min.Z
+            && cell.X < this->Max.X && cell.Y < this->Max.Y && cell.Z < this->Max.Z;
+    }
+
+    constexpr inline bool Overlaps ( const Aabb3i& other ) const noexcept {
+        return this->Min.X < other.Max.X && this->Min.Y < other.Max.Y && this->Min.Z < other.Max.Z
+            && other.Min.X < this->Max.X && other.Min.Y < this->Max.Y && other.Min.Z < this->Max.Z;
+    }
+
+    // Empty when the boxes don't overlap.
+    constexpr inline Aabb3i GetIntersection ( const Aabb3i& other ) const noexcept {
+        Aabb3i out(this->Min.Max(other.Min), this->Max.Min(other.Max));
+        return out.IsEmpty() ? Aabb3i() : out;
+    }
+
+    // Grows every face by cells, a negative count shrinks the box.
+    constexpr inline Aabb3i Expanded ( int cells ) const noexcept {
+        if ( this->IsEmpty() ) {
+            return *this;
+        }
+
+        return Aabb3i(this->Min - Vector3i(cells, cells, cells), this->Max + Vector3i(cells, cells, cells));
+    }
+
+    inline Aabb3f ToAabb3f ( ) const noexcept {
+        return Aabb3f(this->Min.ToVector3f(), this->Max.ToVector3f());
+    }
+
+    inline std::string toString ( ) const noexcept {
+        return "[Min: " + this->Min.toString() + ", Max: " + this->Max.toString() + "]";
+    }
+#endif
+} Aabb3i;
+
+#ifdef __cplusplus
+
+constexpr inline Aabb3i operator+ ( const Aabb3i& valA, const Aabb3i& valB ) noexcept {
+    Aabb3i out = valA;
+    out.Grow(valB);
+    return out;
+}
+
+inline std::ostream& operator<<(std::ostream& os, const Aabb3i& val) {
+    return os << val.toString();
+}
+
+#endif // cplusplus
@@ -0,0 +1,85 @@
+#pragma once
+
+#ifdef __cplusplus
+#include <cmath>
+#include "Aabb3f.h"
+#include "Matrix4f.h"
+#include "Vector3f.h"
+#endif
+
+static constexpr int FRUSTUM_PLANES = 6;
+
+// Six inward facing planes, a point p is inside plane i when Normals[i].Dot(p) + Offsets[i] >= 0.
+// Ordered left, right, bottom, top, near, far. Normals are unit length, so plane distances are
+// in world units and sphere radii can be compared against them directly.
+typedef struct Frustum
+{
+    Vector3f Normals[FRUSTUM_PLANES];
+    float Offsets[FRUSTUM_PLANES];
+
+#ifdef __cplusplus
+    constexpr inline Frustum ( ) noexcept : Normals{}, Offsets{} { }
+
+    // Extracts the planes from the rows of a view-projection matrix (Gribb & Hartmann),
+    // which puts them in the space the matrix transforms from.
+    static inline Frustum FromMatrix ( const Matrix4f& mat ) noexcept {
+        Frustum frustum;
+
+        for ( int i = 0; i < FRUSTUM_PLANES; ++i ) {
+            int row = i / 2;
+            float sign = (i % 2) ? -1.0F : 1.0F;
+
+            Vector3f normal(mat.Get(3, 0) + sign * mat.Get(row, 0), mat.Get(3, 1) + sign * mat.Get(row, 1),
+                mat.Get(3, 2) + sign * mat.Get(row, 2));
+            float offset = mat.Get(3, 3) + sign * mat.Get(row, 3);
+            float invLength = 1 / normal.Magnitude();
+
+            frustum.Normals[i] = normal * invLength;
+            frustum.Offsets[i] = offset * invLength;
+        }
+
+        return frustum;
+    }
+
+    constexpr inline float GetDistance ( int plane, const Vector3f& point ) const noexcept {
+        return this->Normals[plane].Dot(point) + this->Offsets[plane];
+    }
+
+    constexpr inline bool Contains ( const Vector3f& point ) const noexcept {
+        for ( int i = 0; i < FRUSTUM_PLANES; ++i ) {
+            if ( this->GetDistance(i, point) < 0 ) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Conservative, spheres near a frustum corner can pass while being outside.
+    constexpr inline bool IntersectsSphere ( const Vector3f& center, float radius ) const noexcept {
+        for ( int i = 0; i < FRUSTUM_PLANES; ++i ) {
+            if ( this->GetDistance(i, center) < -radius ) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+
+    // Conservative like IntersectsSphere, tests the box corner furthest along each normal.
+    inline bool IntersectsBox ( const Aabb3f& box ) const noexcept {
+        Vector3f center = box.GetCenter(), extent = box.GetSize() * 0.5F;
+
+        for ( int i = 0; i < FRUSTUM_PLANES; ++i ) {
+            const Vector3f& n = this->Normals[i];
+            float radius = std::fabs(n.X) * extent.X + std::fabs(n.Y) * extent.Y + std::fabs(n.Z) * extent.Z;
+
+            if ( this->GetDistance(i, center) < -radius ) {
+                return false;
+            }
+        }
+
+        return true;
+    }
+#endif
+} Frustum;
@@ -0,0 +1,257 @@
+#pragma once
+
+#ifdef __cplusplus
+#include "util/simd.h"
+#include "Quaternion.h"
+#include "Vector3f.h"
+#include <cmath>
+#include <string>
+#endif
+
+// Column major 4x4 matrix, the layout glUniformMatrix4fv expects without transposing.
+// M[column * 4 + row], each column is loaded as one simd4f.
+typedef struct alignas(16) Matrix4f
+{
+    float M[16];
+
+#ifdef __cplusplus
+    constexpr inline Matrix4f ( ) noexcept : M{ 1, 0, 0, 0,  0, 1, 0, 0,  0, 0, 1, 0,  0, 0, 0, 1 } { }
+
+    static constexpr inline Matrix4f Identity ( ) noexcept {
+        return Matrix4f();
+    }
+
+    static constexpr inline Matrix4f Translation ( const Vector3f& offset ) noexcept {
+        Matrix4f mat;
+        mat.M[12] = offset.X; mat.M[13] = offset.Y; mat.M[14] = offset.Z;
+        return mat;
+    }
+
+    static constexpr inline Matrix4f Scale ( const Vector3f& scale ) noexcept {
+        Matrix4f mat;
+        mat.M[0] = scale.X; mat.M[5] = scale.Y; mat.M[10] = scale.Z;
+        return mat;
+    }
+
+    // rotation must be normalized.
+    static constexpr inline Matrix4f Rotation ( const Quaternion& rot ) noexcept {
+        float xx = rot.X * rot.X, yy = rot.Y * rot.Y, zz = rot.Z * rot.Z;
+        float xy = rot.X * rot.Y, xz = rot.X * rot.Z, yz = rot.Y * rot.Z;
+        float wx = rot.W * rot.X, wy = rot.W * rot.Y, wz = rot.W * rot.Z;
+
+        Matrix4f mat;
+        mat.M[0] = 1 - 2 * (yy + zz); mat.M[1] = 2 * (xy + wz);     mat.M[2] = 2 * (xz - wy);
+        mat.M[4] = 2 * (xy - wz);     mat.M[5] = 1 - 2 * (xx + zz); mat.M[6] = 2 * (yz + wx);
+        mat.M[8] = 2 * (xz + wy);     mat.M[9] = 2 * (yz - wx);     mat.M[10] = 1 - 2 * (xx + yy);
+        return mat;
+    }
+
+    // Scale, then rotate, then translate.
+    static constexpr inline Matrix4f TRS ( const Vector3f& pos, const Quaternion& rot, const Vector3f& scale ) noexcept {
+        Matrix4f mat = Rotation(rot);
+
+        for ( int row = 0; row < 3; ++row ) {
+            mat.M[row] *= scale.X; mat.M[4 + row] *= scale.Y; mat.M[8 + row] *= scale.Z;
+        }
+
+        mat.M[12] = pos.X; mat.M[13] = pos.Y; mat.M[14] = pos.Z;
+        return mat;
+    }
+
+    // Right handed, maps depth to [-1, 1] like gluPerspective. fovY is in radians.
+    static inline Matrix4f Perspective ( float fovY, float aspect, float zNear, float zFar ) noexcept {
+        float f = 1 / std::tan(fovY * 0.5F);
+        float invDepth = 1 / (zNear - zFar);
+
+        Matrix4f mat;
+        mat.M[0] = f / aspect;
+        mat.M[5] = f;
+        mat.M[10] = (zFar + zNear) * invDepth;
+        mat.M[11] = -1;
+        mat.M[14] = 2 * zFar * zNear * invDepth;
+        mat.M[15] = 0;
+        return mat;
+    }
+
+    // Right handed view matrix, like gluLookAt.
+    static inline Matrix4f LookAt ( const Vector3f& eye, const Vector3f& target, const Vector3f& up ) noexcept {
+        Vector3f forward = (target - eye).Normalized();
+        Vector3f side = forward.Cross(up).Normalized();
+        Vector3f camUp = side.Cross(forward);
+
+        Matrix4f mat;
+        mat.M[0] = side.X; mat.M[4] = side.Y; mat.M[8] = side.Z;
+        mat.M[1] = camUp.X; mat.M[5] = camUp.Y; mat.M[9] = camUp.Z;
+        mat.M[2] = -forward.X; mat.M[6] = -forward.Y; mat.M[10] = -forward.Z;
+        mat.M[12] = -side.Dot(eye); mat.M[13] = -camUp.Dot(eye); mat.M[14] = forward.Dot(eye);
+        return mat;
+    }
+
+    constexpr inline float Get ( int row, int column ) const noexcept {
+        return this->M[column * 4 + row];
+    }
+
+    constexpr inline void Set ( int row, int column, float val ) noexcept {
+        this->M[column * 4 + row] = val;
+    }
+
+    inline simd4f GetColumn ( int column ) const noexcept {
+        return simd4f_load(&this->M[column * 4]);
+    }
+
+    inline void SetColumn ( int column, simd4f val ) noexcept {
+        simd_store(&this->M[column * 4], val);
+    }
+
+    // (x, y, z, w) * columns, 4 lane wide.
+    inline simd4f Transform ( simd4f vec ) const noexcept {
+        return simd_madd(this->GetColumn(3), simd_splat<3>(vec),
+            simd_madd(this->GetColumn(2), simd_splat<2>(vec),
+            simd_madd(this->GetColumn(1), simd_splat<1>(vec), simd_mul(this->GetColumn(0), simd_splat<0>(vec)))));
+    }
+
+    // w = 1, no perspective divide.
+    inline Vector3f TransformPoint ( const Vector3f& point ) const noexcept {
+        alignas(16) float r[4];
+        simd_store(r, simd_madd(this->GetColumn(2), simd4f_set1(point.Z),
+            simd_madd(this->GetColumn(1), simd4f_set1(point.Y),
+            simd_madd(this->GetColumn(0), simd4f_set1(point.X), this->GetColumn(3)))));
+        return Vector3f(r[0], r[1], r[2]);
+    }
+
+    // w = 0, ignores translation.
+    inline Vector3f TransformDirection ( const Vector3f& dir ) const noexcept {
+        alignas(16) float r[4];
+        simd_store(r, simd_madd(this->GetColumn(2), simd4f_set1(dir.Z),
+            simd_madd(this->GetColumn(1), simd4f_set1(dir.Y), simd_mul(this->GetColumn(0), simd4f_set1(dir.X)))));
+        return Vector3f(r[0], r[1], r[2]);
+    }
+
+    constexpr inline Matrix4f Transposed ( ) const noexcept {
+        Matrix4f mat;
+        for ( int column = 0; column < 4; ++column ) {
+            for ( int row = 0; row < 4; ++row ) {
+                mat.M[row * 4 + column] = this->M[column * 4 + row];
+            }
+        }
+        return mat;
+    }
+
+    // General inverse through the adjugate, returns the identity if the matrix is singular.
+    inline Matrix4f Inverse ( ) const noexcept;
+
+    // Only valid when the last row is (0, 0, 0, 1), which holds for TRS and LookAt matrices.
+    // Inverts the 3x3 part through cross products and the translation with one transform.
+    inline Matrix4f InverseAffine ( ) const noexcept;
+
+    inline std::string toString ( ) const noexcept {
+        std::string str = "[";
+        for ( int row = 0; row < 4; ++row ) {
+            str += row ? ", (" : "(";
+            for ( int column = 0; column < 4; ++column ) {
+                str += (column ? ", " : "") + std::to_string(this->Get(row, column));
+            }
+            str += ")";
+        }
+        return str + "]";
+    }
+
+#endif // cplusplus
+} Matrix4f;
+
+#ifdef __cplusplus
+
+inline Matrix4f operator* ( const Matrix4f& valA, const Matrix4f& valB ) noexcept {
+    Matrix4f mat;
+
+    for ( int column = 0; column < 4; ++column ) {
+        mat.SetColumn(column, valA.Transform(valB.GetColumn(column)));
+    }
+
+    return mat;
+}
+
+inline Matrix4f operator*= ( Matrix4f& valA, const Matrix4f& valB ) noexcept {
+    return valA = valA * valB;
+}
+
+constexpr inline bool operator== ( const Matrix4f& valA, const Matrix4f& valB ) noexcept {
+    for ( int i = 0; i < 16; ++i ) {
+        if ( valA.M[i] != valB.M[i] ) { return false; }
+    }
+    return true;
+}
+
+constexpr inline bool operator!= ( const Matrix4f& valA, const Matrix4f& valB ) noexcept {
+    return !(valA == valB);
+}
+
+inline Matrix4f Matrix4f::Inverse ( ) const noexcept {
+
+    const float* m = this->M;
+    float inv[16];
+
+    inv[0]  =  m[5] * m[10] * m[15] - m[5] * m[11] * m[14] - m[9] * m[6] * m[15] + m[9] * m[7] * m[14] + m[13] * m[6] * m[11] - m[13] * m[7] * m[10];
+    inv[4]  = -m[4] * m[10] * m[15] + m[4] * m[11] * m[14] + m[8] * m[6] * m[15] - m[8] * m[7] * m[14] - m[12] * m[6] * m[11] + m[12] * m[7] * m[10];
+    inv[8]  =  m[4] * m[9]  * m[15] - m[4] * m[11] * m[13] - m[8] * m[5] * m[15] + m[8] * m[7] * m[13] + m[12] * m[5] * m[11] - m[12] * m[7] * m[9];
+    inv[12] = -m[4] * m[9]  * m[14] + m[4] * m[10] * m[13] + m[8] * m[5] * m[14] - m[8] * m[6] * m[13] - m[12] * m[5] * m[10] + m[12] * m[6] * m[9];
+    inv[1]  = -m[1] * m[10] * m[15] + m[1] * m[11] * m[14] + m[9] * m[2] * m[15] - m[9] * m[3] * m[14] - m[13] * m[2] * m[11] + m[13] * m[3] * m[10];
+    inv[5]  =  m[0] * m[10] * m[15] - m[0] * m[11] * m[14] - m[8] * m[2] * m[15] + m[8] * m[3] * m[14] + m[12] * m[2] * m[11] - m[12] * m[3] * m[10];
+    inv[9]  = -m[0] * m[9]  * m[15] + m[0] * m[11] * m[13] + m[8] * m[1] * m[15] - m[8] * m[3] * m[13] - m[12] * m[1] * m[11] + m[12] * m[3] * m[9];
+    inv[13] =  m[0] * m[9]  * m[14] - m[0] * m[10] * m[13] - m[8] * m[1] * m[14] + m[8] * m[2] * m[13] + m[12] * m[1] * m[10] - m[12] * m[2] * m[9];
+    inv[2]  =  m[1] * m[6]  * m[15] - m[1] * m[7]  * m[14] - m[5] * m[2] * m[15] + m[5] * m[3] * m[14] + m[13] * m[2] * m[7]  - m[13] * m[3] * m[6];
+    inv[6]  = -m[0] * m[6]  * m[15] + m[0] * m[7]  * m[14] + m[4] * m[2] * m[15] - m[4] * m[3] * m[14] - m[12] * m[2] * m[7]  + m[12] * m[3] * m[6];
+    inv[10] =  m[0] * m[5]  * m[15] - m[0] * m[7]  * m[13] - m[4] * m[1] * m[15] + m[4] * m[3] * m[13] + m[12] * m[1] * m[7]  - m[12] * m[3] * m[5];
+    inv[14] = -m[0] * m[5]  * m[14] + m[0] * m[6]  * m[13] + m[4] * m[1] * m[14] - m[4] * m[2] * m[13] - m[12] * m[1] * m[6]  + m[12] * m[2] * m[5];
+    inv[3]  = -m[1] * m[6]  * m[11] + m[1] * m[7]  * m[10] + m[5] * m[2] * m[11] - m[5] * m[3] * m[10] - m[9]  * m[2] * m[7]  + m[9]  * m[3] * m[6];
+    inv[7]  =  m[0] * m[6]  * m[11] - m[0] * m[7]  * m[10] - m[4] * m[2] * m[11] + m[4] * m[3] * m[10] + m[8]  * m[2] * m[7]  - m[8]  * m[3] * m[6];
+    inv[11] = -m[0] * m[5]  * m[11] + m[0] * m[7]  * m[9]  + m[4] * m[1] * m[11] - m[4] * m[3] * m[9]  - m[8]  * m[1] * m[7]  + m[8]  * m[3] * m[5];
+    inv[15] =  m[0] * m[5]  * m[10] - m[0] * m[6]  * m[9]  - m[4] * m[1] * m[10] + m[4] * m[2] * m[9]  + m[8]  * m[1] * m[6]  - m[8]  * m[2] * m[5];
+
+    float det = m[0] * inv[0] + m[1] * inv[4] + m[2] * inv[8] + m[3] * inv[12];
+
+    if ( det == 0 ) {
+        return Matrix4f();
+    }
+
+    Matrix4f mat;
+    simd4f invDet = simd4f_set1(1 / det);
+
+    for ( int column = 0; column < 4; ++column ) {
+        mat.SetColumn(column, simd_mul(simd4f_load(inv + column * 4), invDet));
+    }
+
+    return mat;
+}
+
+inline Matrix4f Matrix4f::InverseAffine ( ) const noexcept {
+
+    Vector3f c0(this->M[0], this->M[1], this->M[2]);
+    Vector3f c1(this->M[4], this->M[5], this->M[6]);
+    Vector3f c2(this->M[8], this->M[9], this->M[10]);
+
+    // rows of the inverse 3x3 are the cross products of the columns over the determinant.
+    Vector3f r0 = c1.Cross(c2), r1 = c2.Cross(c0), r2 = c0.Cross(c1);
+    float det = c0.Dot(r0);
+
+    if ( det == 0 ) {
+        return Matrix4f();
+    }
+
+    float invDet = 1 / det;
+    r0 *= invDet; r1 *= invDet; r2 *= invDet;
+
+    Vector3f pos(this->M[12], this->M[13], this->M[14]);
+
+    Matrix4f mat;
+    mat.M[0] = r0.X; mat.M[4] = r0.Y; mat.M[8]  = r0.Z; mat.M[12] = -r0.Dot(pos);
+    mat.M[1] = r1.X; mat.M[5] = r1.Y; mat.M[9]  = r1.Z; mat.M[13] = -r1.Dot(pos);
+    mat.M[2] = r2.X; mat.M[6] = r2.Y; mat.M[10] = r2.Z; mat.M[14] = -r2.Dot(pos);
+    return mat;
+}
+
+inline std::ostream& operator<<(std::ostream& os, const Matrix4f& val) {
+    return os << val.toString();
+}
+
+#endif // cplusplus
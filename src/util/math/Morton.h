@@ -0,0 +1,130 @@
+#pragma once
+
+// Morton (Z-order) codes, coordinates bit interleaved so cells close in space stay close in
+// memory. 3D codes take the low 21 bits of each axis, X in bit 0, Y in bit 1, Z in bit 2.
+// 2D codes take 32 bits per axis. Negative coordinates wrap, offset them into range first.
+//
+// BMI2 pdep / pext do the interleave in one instruction each. They are used when the compile
+// flags enable BMI2 or the including translation unit targets it and defines MORTON_TARGET_BMI2
+// first (gcc does not update the feature macros for target pragmas, see util/simd.h).
+// The bit twiddling fallback is portable and constexpr.
+
+#ifdef __cplusplus
+
+#include <stddef.h>
+#include <stdint.h>
+#include "util/detect.h"
+#include "Vector3i.h"
+#include "Vector2i.h"
+
+#if DETECT_ARCH_X86_64 && (defined(__BMI2__) || defined(MORTON_TARGET_BMI2))
+    #define MORTON_BMI2 1
+    #include <immintrin.h>
+#else
+    #define MORTON_BMI2 0
+#endif
+
+static constexpr uint64_t MORTON3_MASK_X = 0x1249249249249249ULL;
+static constexpr uint64_t MORTON3_MASK_Y = MORTON3_MASK_X << 1;
+static constexpr uint64_t MORTON3_MASK_Z = MORTON3_MASK_X << 2;
+static constexpr uint64_t MORTON2_MASK_X = 0x5555555555555555ULL;
+static constexpr uint64_t MORTON2_MASK_Y = MORTON2_MASK_X << 1;
+
+// Spreads the low 21 bits 3 apart.
+constexpr inline uint64_t mortonSpread3 ( uint32_t val ) noexcept {
+    uint64_t x = val & 0x1FFFFF;
+    x = (x | x << 32) & 0x001F00000000FFFFULL;
+    x = (x | x << 16) & 0x001F0000FF0000FFULL;
+    x = (x | x << 8)  & 0x100F00F00F00F00FULL;
+    x = (x | x << 4)  & 0x10C30C30C30C30C3ULL;
+    return (x | x << 2) & MORTON3_MASK_X;
+}
+
+constexpr inline uint32_t mortonCompact3 ( uint64_t x ) noexcept {
+    x &= MORTON3_MASK_X;
+    x = (x ^ (x >> 2))  & 0x10C30C30C30C30C3ULL;
+    x = (x ^ (x >> 4))  & 0x100F00F00F00F00FULL;
+    x = (x ^ (x >> 8))  & 0x001F0000FF0000FFULL;
+    x = (x ^ (x >> 16)) & 0x001F00000000FFFFULL;
+    return static_cast<uint32_t>((x ^ (x >> 32)) & 0x1FFFFF);
+}
+
+constexpr inline uint64_t mortonSpread2 ( uint32_t val ) noexcept {
+    uint64_t x = val;
+    x = (x | x << 16) & 0x0000FFFF0000FFFFULL;
+    x = (x | x << 8)  & 0x00FF00FF00FF00FFULL;
+    x = (x | x << 4)  & 0x0F0F0F0F0F0F0F0FULL;
+    x = (x | x << 2)  & 0x3333333333333333ULL;
+    return (x | x << 1) & MORTON2_MASK_X;
+}
+
+constexpr inline uint32_t mortonCompact2 ( uint64_t x ) noexcept {
+    x &= MORTON2_MASK_X;
+    x = (x ^ (x >> 1))  & 0x3333333333333333ULL;
+    x = (x ^ (x >> 2))  & 0x0F0F0F0F0F0F0F0FULL;
+    x = (x ^ (x >> 4))  & 0x00FF00FF00FF00FFULL;
+    x = (x ^ (x >> 8))  & 0x0000FFFF0000FFFFULL;
+    return static_cast<uint32_t>((x ^ (x >> 16)) & 0xFFFFFFFFULL);
+}
+
+inline uint64_t encodeMorton3 ( const Vector3i& cell ) noexcept {
+#if MORTON_BMI2
+    return _pdep_u64(static_cast<uint32_t>(cell.X), MORTON3_MASK_X) | _pdep_u64(static_cast<uint32_t>(cell.Y), MORTON3_MASK_Y)
+        | _pdep_u64(static_cast<uint32_t>(cell.Z), MORTON3_MASK_Z);
+#else
+    return mortonSpread3(static_cast<uint32_t>(cell.X)) | (mortonSpread3(static_cast<uint32_t>(cell.Y)) << 1)
+        | (mortonSpread3(static_cast<uint32_t>(cell.Z)) << 2);
+#endif
+}
+
+// Coordinates come back in [0, 2^21).
+inline Vector3i decodeMorton3 ( uint64_t code ) noexcept {
+#if MORTON_BMI2
+    return Vector3i(static_cast<int>(_pext_u64(code, MORTON3_MASK_X)), static_cast<int>(_pext_u64(code, MORTON3_MASK_Y)),
+        static_cast<int>(_pext_u64(code, MORTON3_MASK_Z)));
+#else
+    return Vector3i(static_cast<int>(mortonCompact3(code)), static_cast<int>(mortonCompact3(code >> 1)),
+        static_cast<int>(mortonCompact3(code >> 2)));
+#endif
+}
+
+inline uint64_t encodeMorton2 ( const Vector2i& cell ) noexcept {
+#if MORTON_BMI2
+    return _pdep_u64(static_cast<uint32_t>(cell.X), MORTON2_MASK_X) | _pdep_u64(static_cast<uint32_t>(cell.Y), MORTON2_MASK_Y);
+#else
+    return mortonSpread2(static_cast<uint32_t>(cell.X)) | (mortonSpread2(static_cast<uint32_t>(cell.Y)) << 1);
+#endif
+}
+
+inline Vector2i decodeMorton2 ( uint64_t code ) noexcept {
+#if MORTON_BMI2
+    return Vector2i(static_cast<int>(_pext_u64(code, MORTON2_MASK_X)), static_cast<int>(_pext_u64(code, MORTON2_MASK_Y)));
+#else
+    return Vector2i(static_cast<int>(mortonCompact2(code)), static_cast<int>(mortonCompact2(code >> 1)));
+#endif
+}
+
+// Adds two codes axis by axis without decoding them. Filling the other axes' bits with ones
+// carries each axis through them, so this is a plain add per axis that wraps at 2^21.
+// A negative step is just the encoded two's complement, e.g. encodeMorton3(Vector3i(-1, 0, 0)).
+constexpr inline uint64_t mortonAdd3 ( uint64_t a, uint64_t b ) noexcept {
+    uint64_t x = ((a | ~MORTON3_MASK_X) + (b & MORTON3_MASK_X)) & MORTON3_MASK_X;
+    uint64_t y = ((a | ~MORTON3_MASK_Y) + (b & MORTON3_MASK_Y)) & MORTON3_MASK_Y;
+    uint64_t z = ((a | ~MORTON3_MASK_Z) + (b & MORTON3_MASK_Z)) & MORTON3_MASK_Z;
+    return x | y | z;
+}
+
+// Bulk forms, the Kernels table picks the pdep build at runtime where it is fast.
+inline void encodeMorton3Array ( uint64_t* out, const Vector3i* in, size_t count ) noexcept {
+    for ( size_t i = 0; i < count; ++i ) {
+        out[i] = encodeMorton3(in[i]);
+    }
+}
+
+inline void decodeMorton3Array ( Vector3i* out, const uint64_t* in, size_t count ) noexcept {
+    for ( size_t i = 0; i < count; ++i ) {
+        out[i] = decodeMorton3(in[i]);
+    }
+}
+
+#endif // cplusplus
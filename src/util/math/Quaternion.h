@@ -0,0 +1,124 @@
+#pragma once
+
+#ifdef __cplusplus
+#include "util/intrinsics.h"
+#include "Vector3f.h"
+#include <cmath>
+#include <string>
+#endif
+
+// Unit quaternion rotation, W is the scalar part.
+typedef struct Quaternion
+{
+    float X, Y, Z, W;
+
+#ifdef __cplusplus
+    constexpr inline Quaternion ( ) noexcept : X(0), Y(0), Z(0), W(1) { }
+    constexpr inline Quaternion ( float x, float y, float z, float w ) noexcept : X(x), Y(y), Z(z), W(w) { }
+
+    // axis must be normalized, angle is in radians.
+    static inline Quaternion FromAxisAngle ( const Vector3f& axis, float angle ) noexcept {
+        float halfSin = std::sin(angle * 0.5F);
+        return Quaternion(axis.X * halfSin, axis.Y * halfSin, axis.Z * halfSin, std::cos(angle * 0.5F));
+    }
+
+    // Applies yaw (Y), then pitch (X), then roll (Z), in radians.
+    static inline Quaternion FromEuler ( float pitch, float yaw, float roll ) noexcept;
+
+    constexpr inline float Dot ( const Quaternion& other ) const noexcept {
+        return this->X * other.X + this->Y * other.Y + this->Z * other.Z + this->W * other.W;
+    }
+
+    constexpr inline Quaternion Conjugate ( ) const noexcept {
+        return Quaternion(-this->X, -this->Y, -this->Z, this->W);
+    }
+
+    constexpr inline Quaternion Inverse ( ) const noexcept {
+        float invSqrMag = 1 / this->Dot(*this);
+        return Quaternion(-this->X * invSqrMag, -this->Y * invSqrMag, -this->Z * invSqrMag, this->W * invSqrMag);
+    }
+
+    inline Quaternion Normalized ( ) const noexcept {
+        float invMag = 1 / sqrtf(this->Dot(*this));
+        return Quaternion(this->X * invMag, this->Y * invMag, this->Z * invMag, this->W * invMag);
+    }
+
+    // Rotates vec by this quaternion, which must be normalized.
+    constexpr inline Vector3f Rotate ( const Vector3f& vec ) const noexcept {
+        Vector3f axis(this->X, this->Y, this->Z);
+        Vector3f t = axis.Cross(vec) * 2.0F;
+        return vec + t * this->W + axis.Cross(t);
+    }
+
+    inline Quaternion Slerp ( const Quaternion& other, float delta ) const noexcept;
+
+    inline std::string toString ( ) const noexcept {
+        return "( " +
+            std::to_string(this->X) + ", " +
+            std::to_string(this->Y) + ", " +
+            std::to_string(this->Z) + ", " +
+            std::to_string(this->W) + " )";
+    }
+
+#endif // cplusplus
+} Quaternion;
+
+#ifdef __cplusplus
+
+// Hamilton product, (valA * valB) rotates by valB first, then valA.
+constexpr inline Quaternion operator* ( const Quaternion& valA, const Quaternion& valB ) noexcept {
+    return Quaternion(
+        valA.W * valB.X + valA.X * valB.W + valA.Y * valB.Z - valA.Z * valB.Y,
+        valA.W * valB.Y - valA.X * valB.Z + valA.Y * valB.W + valA.Z * valB.X,
+        valA.W * valB.Z + valA.X * valB.Y - valA.Y * valB.X + valA.Z * valB.W,
+        valA.W * valB.W - valA.X * valB.X - valA.Y * valB.Y - valA.Z * valB.Z
+    );
+}
+
+constexpr inline bool operator== ( const Quaternion& valA, const Quaternion& valB ) noexcept {
+    return valA.X == valB.X && valA.Y == valB.Y && valA.Z == valB.Z && valA.W == valB.W;
+}
+
+constexpr inline bool operator!= ( const Quaternion& valA, const Quaternion& valB ) noexcept {
+    return !(valA == valB);
+}
+
+inline Quaternion Quaternion::FromEuler ( float pitch, float yaw, float roll ) noexcept {
+    return FromAxisAngle(Vector3f(0, 1, 0), yaw) * FromAxisAngle(Vector3f(1, 0, 0), pitch)
+        * FromAxisAngle(Vector3f(0, 0, 1), roll);
+}
+
+inline Quaternion Quaternion::Slerp ( const Quaternion& other, float delta ) const noexcept {
+
+    Quaternion target = other;
+    float cosTheta = this->Dot(other);
+
+    if ( cosTheta < 0 ) { // take the short way around
+        target = Quaternion(-other.X, -other.Y, -other.Z, -other.W);
+        cosTheta = -cosTheta;
+    }
+
+    float scaleA = 1 - delta, scaleB = delta;
+
+    // nearly parallel, sin(theta) would divide by ~0.
+    if ( cosTheta < 0.9995F ) {
+        float theta = std::acos(cosTheta);
+        float invSin = 1 / std::sin(theta);
+
+        scaleA = std::sin((1 - delta) * theta) * invSin;
+        scaleB = std::sin(delta * theta) * invSin;
+    }
+
+    return Quaternion(
+        this->X * scaleA + target.X * scaleB,
+        this->Y * scaleA + target.Y * scaleB,
+        this->Z * scaleA + target.Z * scaleB,
+        this->W * scaleA + target.W * scaleB
+    ).Normalized();
+}
+
+inline std::ostream& operator<<(std::ostream& os, const Quaternion& val) {
+    return os << val.toString();
+}
+
+#endif // cplusplus
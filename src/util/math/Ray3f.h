@@ -0,0 +1,37 @@
+#pragma once
+
+#ifdef __cplusplus
+#include "Vector3f.h"
+#include <cmath>
+#endif
+
+typedef struct Ray3f
+{
+    Vector3f Origin, Direction;
+
+#ifdef __cplusplus
+    constexpr inline Ray3f ( ) noexcept : Origin(), Direction(0, 0, 1) { }
+    constexpr inline Ray3f ( const Vector3f& origin, const Vector3f& direction ) noexcept :
+        Origin(origin), Direction(direction) { }
+
+    constexpr inline Vector3f GetPoint ( float t ) const noexcept {
+        return this->Origin + this->Direction * t;
+    }
+#endif
+} Ray3f;
+
+// Nearest hit along a ray, T is in units of the ray direction. The hit point is
+// VecA * (1 - U - V) + VecB * U + VecC * V of triangle Index, which is -1 on a miss.
+typedef struct RayHit
+{
+    float T, U, V;
+    int Index;
+
+#ifdef __cplusplus
+    constexpr inline RayHit ( ) noexcept : T(INFINITY), U(0), V(0), Index(-1) { }
+
+    constexpr inline bool IsHit ( ) const noexcept {
+        return this->Index >= 0;
+    }
+#endif
+} RayHit;
@@ -2,6 +2,7 @@
 #pragma once
 
 #include "Vector3f.h"
+#include "Ray3f.h"
 #include "util/Constants.h"
 
 typedef struct Triangle3d
@@ -29,5 +30,28 @@ typedef struct Triangle3d
         return (this->VecB - this->VecA).Cross(this->VecC - this->VecA).Magnitude() * ONE_HALF;
     }
 
+    // Möller–Trumbore, hits from both sides. On a hit with tMin < t < tMax writes the distance
+    // along the ray and the barycentrics of VecB (u) and VecC (v). Packet form in TrianglePacket.h.
+    constexpr inline bool Intersect ( const Ray3f& ray, float tMin, float tMax, float& t, float& u, float& v ) const noexcept {
+
+        Vector3f edgeAB = this->VecB - this->VecA, edgeAC = this->VecC - this->VecA;
+        Vector3f p = ray.Direction.Cross(edgeAC);
+        float det = edgeAB.Dot(p);
+
+        if ( det == 0 ) { // parallel or degenerate
+            return false;
+        }
+
+        float invDet = 1 / det;
+        Vector3f s = ray.Origin - this->VecA;
+        Vector3f q = s.Cross(edgeAB);
+
+        u = s.Dot(p) * invDet;
+        v = ray.Direction.Dot(q) * invDet;
+        t = edgeAC.Dot(q) * invDet;
+
+        return u >= 0 && v >= 0 && u + v <= 1 && t > tMin && t < tMax;
+    }
+
 #endif
 } Triangle3d;
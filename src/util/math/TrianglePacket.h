@@ -0,0 +1,98 @@
+#pragma once
+
+// Möller–Trumbore in structure of arrays form. A TrianglePacket holds Lanes triangles
+// precomputed as a vertex and two edges, a RayPacket holds Lanes rays. Either side can be
+// broadcast, so the same kernel tests one ray against Lanes triangles or Lanes rays against one.
+
+#include "Vector3fPacket.h"
+#include "Triangle3d.h"
+#include "Ray3f.h"
+
+template<typename T>
+struct RayPacket
+{
+    Vector3fPacket<T> Origin, Direction;
+
+    static constexpr int Lanes = Vector3fPacket<T>::Lanes;
+
+    inline RayPacket ( ) noexcept { }
+
+    // Broadcasts one ray to every lane.
+    inline RayPacket ( const Ray3f& ray ) noexcept : Origin(ray.Origin), Direction(ray.Direction) { }
+
+    // Reads Lanes rays.
+    static inline RayPacket Load ( const Ray3f* rays ) noexcept {
+        float buf[6][Lanes];
+
+        for ( int i = 0; i < Lanes; ++i ) {
+            buf[0][i] = rays[i].Origin.X; buf[1][i] = rays[i].Origin.Y; buf[2][i] = rays[i].Origin.Z;
+            buf[3][i] = rays[i].Direction.X; buf[4][i] = rays[i].Direction.Y; buf[5][i] = rays[i].Direction.Z;
+        }
+
+        RayPacket packet;
+        packet.Origin = Vector3fPacket<T>::Load(buf[0], buf[1], buf[2]);
+        packet.Direction = Vector3fPacket<T>::Load(buf[3], buf[4], buf[5]);
+        return packet;
+    }
+};
+
+template<typename T>
+struct TrianglePacket
+{
+    Vector3fPacket<T> VecA, EdgeAB, EdgeAC;
+
+    static constexpr int Lanes = Vector3fPacket<T>::Lanes;
+
+    inline TrianglePacket ( ) noexcept { }
+    inline TrianglePacket ( const Vector3fPacket<T>& vecA, const Vector3fPacket<T>& edgeAB, const Vector3fPacket<T>& edgeAC ) noexcept :
+        VecA(vecA), EdgeAB(edgeAB), EdgeAC(edgeAC) { }
+
+    // Broadcasts one triangle to every lane.
+    inline TrianglePacket ( const Triangle3d& tri ) noexcept :
+        VecA(tri.VecA), EdgeAB(tri.VecB - tri.VecA), EdgeAC(tri.VecC - tri.VecA) { }
+
+    // Per lane Triangle3d::GetArea.
+    inline T GetArea ( ) const noexcept {
+        return simd_mul(this->EdgeAB.Cross(this->EdgeAC).Magnitude(), simd_set1<T>(ONE_HALF));
+    }
+
+    // Tests the lanes pairwise against rays. Returns the mask of lanes hit with tMin < t < tMax,
+    // t, u and v are only meaningful in those lanes, see Triangle3d::Intersect.
+    inline T Intersect ( const RayPacket<T>& rays, T tMin, T tMax, T& t, T& u, T& v ) const noexcept {
+
+        T zero = simd_set1<T>(0.0F), one = simd_set1<T>(1.0F);
+
+        Vector3fPacket<T> p = rays.Direction.Cross(this->EdgeAC);
+        T det = this->EdgeAB.Dot(p);
+        T invDet = simd_div(one, det);
+
+        Vector3fPacket<T> s = rays.Origin - this->VecA;
+        Vector3fPacket<T> q = s.Cross(this->EdgeAB);
+
+        u = simd_mul(s.Dot(p), invDet);
+        v = simd_mul(rays.Direction.Dot(q), invDet);
+        t = simd_mul(this->EdgeAC.Dot(q), invDet);
+
+        // det == 0 gives inf/NaN above, which every compare below rejects except the explicit check.
+        T mask = simd_or(simd_cmplt(det, zero), simd_cmpgt(det, zero));
+        mask = simd_and(mask, simd_and(simd_cmpge(u, zero), simd_cmpge(v, zero)));
+        mask = simd_and(mask, simd_cmple(simd_add(u, v), one));
+        return simd_and(mask, simd_and(simd_cmpgt(t, tMin), simd_cmplt(t, tMax)));
+    }
+};
+
+#if (COMPILER == COMPILER_GCC) && !defined(__clang__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wignored-attributes"
+#endif
+
+typedef RayPacket<simd4f> RayPacketx4;
+typedef RayPacket<simd8f> RayPacketx8;
+typedef RayPacket<simdf> RayPacketxN;
+typedef TrianglePacket<simd4f> TrianglePacketx4;
+typedef TrianglePacket<simd8f> TrianglePacketx8;
+typedef TrianglePacket<simdf> TrianglePacketxN;
+
+#if (COMPILER == COMPILER_GCC) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+#endif
@@ -0,0 +1,152 @@
+#pragma once
+
+// Triangles precomputed for ray casts, stored as three Vector3fStreams (vertex A and the two
+// edges). Padding lanes are degenerate triangles, which never report a hit.
+
+#include <stddef.h>
+#include "Vector3fStream.h"
+#include "TrianglePacket.h"
+
+class TriangleStream
+{
+    private:
+        Vector3fStream vecA, edgeAB, edgeAC;
+
+        // Writes the lanes of hitMask that beat hit.T into hit, returns whether any did.
+        template<typename T>
+        static inline bool updateNearest ( RayHit& hit, size_t base, int hitMask, T t, T u, T v ) noexcept {
+            static constexpr int Lanes = sizeof(T) / sizeof(float);
+            float tBuf[Lanes], uBuf[Lanes], vBuf[Lanes];
+            bool updated = false;
+
+            simd_store(tBuf, t); simd_store(uBuf, u); simd_store(vBuf, v);
+
+            for ( int lane = 0; lane < Lanes; ++lane ) {
+                if ( (hitMask & (1 << lane)) && tBuf[lane] < hit.T ) {
+                    hit.T = tBuf[lane]; hit.U = uBuf[lane]; hit.V = vBuf[lane];
+                    hit.Index = static_cast<int>(base + lane);
+                    updated = true;
+                }
+            }
+
+            return updated;
+        }
+
+    public:
+        inline TriangleStream ( ) noexcept { }
+        inline TriangleStream ( const Triangle3d* tris, size_t count ) { this->load(tris, count); }
+
+        inline size_t size ( ) const noexcept {
+            return this->vecA.size();
+        }
+
+        inline void load ( const Triangle3d* tris, size_t count ) {
+            this->vecA.resize(count); this->edgeAB.resize(count); this->edgeAC.resize(count);
+
+            for ( size_t i = 0; i < count; ++i ) {
+                this->vecA.set(i, tris[i].VecA);
+                this->edgeAB.set(i, tris[i].VecB - tris[i].VecA);
+                this->edgeAC.set(i, tris[i].VecC - tris[i].VecA);
+            }
+        }
+
+        template<typename T = simdf>
+        inline TrianglePacket<T> loadPacket ( size_t index ) const noexcept {
+            return TrianglePacket<T>(this->vecA.loadPacket<T>(index), this->edgeAB.loadPacket<T>(index),
+                this->edgeAC.loadPacket<T>(index));
+        }
+
+        // One ray against every triangle, SIMD_LANES triangles per step. Returns whether
+        // anything between tMin and tMax was hit, hit holds the nearest.
+        inline bool intersect ( const Ray3f& ray, RayHit& hit, float tMin = 0, float tMax = INFINITY ) const noexcept {
+
+            RayPacketxN rays(ray);
+            simdf t, u, v, minT = simdf_set1(tMin), maxT = simdf_set1(tMax);
+
+            hit = RayHit();
+            hit.T = tMax;
+
+            for ( size_t i = 0; i < this->vecA.paddedSize(); i += SIMD_LANES ) {
+                int hitMask = simd_mask(this->loadPacket(i).Intersect(rays, minT, maxT, t, u, v));
+
+                if ( hitMask != 0 && updateNearest(hit, i, hitMask, t, u, v) ) {
+                    maxT = simdf_set1(hit.T); // later packets only need to beat the nearest so far.
+                }
+            }
+
+            return hit.IsHit();
+        }
+
+        // Stops at the first hit, for shadow and visibility rays.
+        inline bool intersectAny ( const Ray3f& ray, float tMin = 0, float tMax = INFINITY ) const noexcept {
+
+            RayPacketxN rays(ray);
+            simdf t, u, v, minT = simdf_set1(tMin), maxT = simdf_set1(tMax);
+
+            for ( size_t i = 0; i < this->vecA.paddedSize(); i += SIMD_LANES ) {
+                if ( simd_mask(this->loadPacket(i).Intersect(rays, minT, maxT, t, u, v)) != 0 ) {
+                    return true;
+                }
+            }
+
+            return false;
+        }
+
+        // SIMD_LANES rays at a time against each triangle, for coherent batches such as picking
+        // a screen region. hits must hold rayCount entries.
+        inline void intersect ( const Ray3f* rays, RayHit* hits, size_t rayCount,
+            float tMin = 0, float tMax = INFINITY ) const noexcept {
+
+            simdf t, u, v, minT = simdf_set1(tMin);
+            size_t i = 0, simdCount = rayCount - rayCount % SIMD_LANES;
+
+            for ( ; i < simdCount; i += SIMD_LANES ) {
+
+                RayPacketxN packet = RayPacketxN::Load(rays + i);
+                simdf nearT = simdf_set1(tMax), nearU = simdf_set1(0), nearV = simdf_set1(0);
+                int nearIndex[SIMD_LANES];
+
+                for ( int lane = 0; lane < SIMD_LANES; ++lane ) {
+                    nearIndex[lane] = -1;
+                }
+
+                for ( size_t tri = 0; tri < this->size(); ++tri ) {
+                    TrianglePacketxN tris(Vector3fxN(this->vecA.get(tri)),
+                        Vector3fxN(this->edgeAB.get(tri)), Vector3fxN(this->edgeAC.get(tri)));
+
+                    simdf mask = tris.Intersect(packet, minT, nearT, t, u, v);
+                    int hitMask = simd_mask(mask);
+
+                    if ( hitMask == 0 ) {
+                        continue;
+                    }
+
+                    nearT = simd_select(mask, t, nearT);
+                    nearU = simd_select(mask, u, nearU);
+                    nearV = simd_select(mask, v, nearV);
+
+                    for ( int lane = 0; lane < SIMD_LANES; ++lane ) {
+                        if ( hitMask & (1 << lane) ) { nearIndex[lane] = static_cast<int>(tri); }
+                    }
+                }
+
+                float tBuf[SIMD_LANES], uBuf[SIMD_LANES], vBuf[SIMD_LANES];
+                simd_store(tBuf, nearT); simd_store(uBuf, nearU); simd_store(vBuf, nearV);
+
+                for ( int lane = 0; lane < SIMD_LANES; ++lane ) {
+                    RayHit& hit = hits[i + lane];
+                    hit = RayHit();
+
+                    if ( nearIndex[lane] >= 0 ) {
+                        hit.T = tBuf[lane]; hit.U = uBuf[lane]; hit.V = vBuf[lane];
+                        hit.Index = nearIndex[lane];
+                    }
+                }
+            }
+
+            for ( ; i < rayCount; ++i ) {
+                this->intersect(rays[i], hits[i], tMin, tMax);
+            }
+        }
+
+};
@@ -73,6 +73,29 @@ typedef struct Vector2f
         return this->Normalized();
     }
 
+    // Fast variants built on fastRsqrt, see Vector3f.
+
+    inline float RsqrtMagnitude ( ) const noexcept {
+        return fastRsqrt(this->SqrMagnitude());
+    }
+
+    inline Vector2f NormalizedFast ( ) const noexcept {
+        float invMag = this->RsqrtMagnitude();
+        return Vector2f( this->X * invMag, this->Y * invMag );
+    }
+
+    inline float RsqrtDistance ( const Vector2f& other ) const noexcept {
+        float dx = this->X - other.X; float dy = this->Y - other.Y;
+        float sqrDist = dx * dx + dy * dy;
+        return sqrDist >= FLT_MIN ? fastRsqrt(sqrDist) : 1.0F / sqrtf(sqrDist);
+    }
+
+    inline float DistanceFast ( const Vector2f& other ) const noexcept {
+        float dx = this->X - other.X; float dy = this->Y - other.Y;
+        float sqrDist = dx * dx + dy * dy;
+        return fastSqrt(sqrDist);
+    }
+
     inline std::string toString ( ) const noexcept {
         return "( " + 
             std::to_string(this->X) + ", " + 
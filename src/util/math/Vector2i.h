@@ -62,6 +62,19 @@ typedef struct Vector2i
         return this->Normalized();
     }
 
+    // Fast variants built on fastRsqrt, see Vector3f.
+
+    inline Vector2f NormalizedFast ( ) const noexcept {
+        float invMag = fastRsqrt(this->SqrMagnitude());
+        return Vector2f( this->X * invMag, this->Y * invMag );
+    }
+
+    inline float DistanceFast ( const Vector2i& other ) const noexcept {
+        float dx = this->X - other.X; float dy = this->Y - other.Y;
+        float sqrDist = dx * dx + dy * dy;
+        return fastSqrt(sqrDist);
+    }
+
     inline std::string toString ( ) const noexcept {
         return "(" + std::to_string(this->X) + ", " + std::to_string(this->Y) + ")";
     }
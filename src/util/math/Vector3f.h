@@ -84,6 +84,37 @@ typedef struct Vector3f
         return this->Normalized();
     }
 
+    // Fast variants built on fastRsqrt, relative error below 4e-7. Normalizing a zero vector
+    // gives NaN like Normalized(). Distances below sqrt(FLT_MIN) are exact, 0 for equal points.
+
+    inline float RsqrtMagnitude ( ) const noexcept {
+        return fastRsqrt(this->SqrMagnitude());
+    }
+
+    inline Vector3f NormalizedFast ( ) const noexcept {
+        float invMag = this->RsqrtMagnitude();
+        return Vector3f( this->X * invMag, this->Y * invMag, this->Z * invMag );
+    }
+
+    // 1 / Distance(other), inf for equal points.
+    inline float RsqrtDistance ( const Vector3f& other ) const noexcept {
+        float dx = this->X - other.X;
+        float dy = this->Y - other.Y;
+        float dz = this->Z - other.Z;
+        float sqrDist = dx * dx + dy * dy + dz * dz;
+
+        return sqrDist >= FLT_MIN ? fastRsqrt(sqrDist) : 1.0F / sqrtf(sqrDist);
+    }
+
+    inline float DistanceFast ( const Vector3f& other ) const noexcept {
+        float dx = this->X - other.X;
+        float dy = this->Y - other.Y;
+        float dz = this->Z - other.Z;
+        float sqrDist = dx * dx + dy * dy + dz * dz;
+
+        return fastSqrt(sqrDist);
+    }
+
     inline std::string toString ( ) const noexcept {
         return "( " + 
             std::to_string(this->X) + ", " + 
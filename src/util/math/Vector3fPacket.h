@@ -0,0 +1,136 @@
+#pragma once
+
+// Structure of arrays Vector3f, one lane per vector. Vector3fx4 holds 4 vectors and
+// Vector3fx8 holds 8, Vector3fx8 is two simd4f wide on targets without AVX.
+
+#include "util/simd.h"
+#include "Vector3f.h"
+
+template<typename T>
+struct Vector3fPacket
+{
+    T X, Y, Z;
+
+    static constexpr int Lanes = sizeof(T) / sizeof(float);
+
+    inline Vector3fPacket ( ) noexcept : X(simd_set1<T>(0)), Y(simd_set1<T>(0)), Z(simd_set1<T>(0)) { }
+    inline Vector3fPacket ( T x, T y, T z ) noexcept : X(x), Y(y), Z(z) { }
+
+    // Broadcasts one vector to every lane.
+    inline Vector3fPacket ( const Vector3f& vec ) noexcept :
+        X(simd_set1<T>(vec.X)), Y(simd_set1<T>(vec.Y)), Z(simd_set1<T>(vec.Z)) { }
+
+    // Reads Lanes consecutive vectors from an AoS array.
+    static inline Vector3fPacket Load ( const Vector3f* src ) noexcept {
+        Vector3fPacket packet;
+        simd_loadXYZ(&src->X, packet.X, packet.Y, packet.Z);
+        return packet;
+    }
+
+    // Reads Lanes vectors from SoA component arrays.
+    static inline Vector3fPacket Load ( const float* x, const float* y, const float* z ) noexcept {
+        return Vector3fPacket(simd_load<T>(x), simd_load<T>(y), simd_load<T>(z));
+    }
+
+    // Writes Lanes consecutive vectors to an AoS array.
+    inline void Store ( Vector3f* dst ) const noexcept {
+        simd_storeXYZ(&dst->X, this->X, this->Y, this->Z);
+    }
+
+    inline void Store ( float* x, float* y, float* z ) const noexcept {
+        simd_store(x, this->X);
+        simd_store(y, this->Y);
+        simd_store(z, this->Z);
+    }
+
+    inline T Dot ( const Vector3fPacket& other ) const noexcept {
+        return simd_madd(this->Z, other.Z, simd_madd(this->Y, other.Y, simd_mul(this->X, other.X)));
+    }
+
+    inline Vector3fPacket Cross ( const Vector3fPacket& other ) const noexcept {
+        return Vector3fPacket(
+            simd_sub(simd_mul(this->Y, other.Z), simd_mul(this->Z, other.Y)),
+            simd_sub(simd_mul(this->Z, other.X), simd_mul(this->X, other.Z)),
+            simd_sub(simd_mul(this->X, other.Y), simd_mul(this->Y, other.X))
+        );
+    }
+
+    inline Vector3fPacket Lerp ( const Vector3fPacket& other, float delta ) const noexcept {
+        T d = simd_set1<T>(delta);
+
+        return Vector3fPacket(
+            simd_madd(simd_sub(other.X, this->X), d, this->X),
+            simd_madd(simd_sub(other.Y, this->Y), d, this->Y),
+            simd_madd(simd_sub(other.Z, this->Z), d, this->Z)
+        );
+    }
+
+    inline T SqrMagnitude ( ) const noexcept {
+        return this->Dot(*this);
+    }
+
+    inline T Magnitude ( ) const noexcept {
+        return simd_sqrt(this->SqrMagnitude());
+    }
+
+    inline T Distance ( const Vector3fPacket& other ) const noexcept {
+        Vector3fPacket delta(simd_sub(this->X, other.X), simd_sub(this->Y, other.Y), simd_sub(this->Z, other.Z));
+        return delta.Magnitude();
+    }
+
+    inline Vector3fPacket Normalized ( ) const noexcept {
+        T invMag = simd_div(simd_set1<T>(1.0F), this->Magnitude());
+        return Vector3fPacket(simd_mul(this->X, invMag), simd_mul(this->Y, invMag), simd_mul(this->Z, invMag));
+    }
+
+    // Fast variants, see Vector3f::NormalizedFast.
+
+    inline T RsqrtMagnitude ( ) const noexcept {
+        return simd_rsqrt(this->SqrMagnitude());
+    }
+
+    inline Vector3fPacket NormalizedFast ( ) const noexcept {
+        T invMag = this->RsqrtMagnitude();
+        return Vector3fPacket(simd_mul(this->X, invMag), simd_mul(this->Y, invMag), simd_mul(this->Z, invMag));
+    }
+
+    inline T DistanceFast ( const Vector3fPacket& other ) const noexcept {
+        Vector3fPacket delta(simd_sub(this->X, other.X), simd_sub(this->Y, other.Y), simd_sub(this->Z, other.Z));
+        return simd_fastSqrt(delta.SqrMagnitude());
+    }
+
+};
+
+#if (COMPILER == COMPILER_GCC) && !defined(__clang__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wignored-attributes"
+#endif
+
+typedef Vector3fPacket<simd4f> Vector3fx4;
+typedef Vector3fPacket<simd8f> Vector3fx8;
+typedef Vector3fPacket<simdf> Vector3fxN; // the native width, use it over Vector3fPacket<simdf>
+
+#if (COMPILER == COMPILER_GCC) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+#endif
+
+template<typename T>
+inline Vector3fPacket<T> operator+ ( const Vector3fPacket<T>& valA, const Vector3fPacket<T>& valB ) noexcept {
+    return Vector3fPacket<T>(simd_add(valA.X, valB.X), simd_add(valA.Y, valB.Y), simd_add(valA.Z, valB.Z));
+}
+
+template<typename T>
+inline Vector3fPacket<T> operator- ( const Vector3fPacket<T>& valA, const Vector3fPacket<T>& valB ) noexcept {
+    return Vector3fPacket<T>(simd_sub(valA.X, valB.X), simd_sub(valA.Y, valB.Y), simd_sub(valA.Z, valB.Z));
+}
+
+// per lane scale
+template<typename T>
+inline Vector3fPacket<T> operator* ( const Vector3fPacket<T>& val, T scale ) noexcept {
+    return Vector3fPacket<T>(simd_mul(val.X, scale), simd_mul(val.Y, scale), simd_mul(val.Z, scale));
+}
+
+template<typename T>
+inline Vector3fPacket<T> operator* ( const Vector3fPacket<T>& val, float scale ) noexcept {
+    return val * simd_set1<T>(scale);
+}
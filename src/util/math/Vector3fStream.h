@@ -0,0 +1,180 @@
+#pragma once
+
+// Structure of arrays container for Vector3f. Components are padded to a multiple of
+// STREAM_PADDING so the batched kernels below never need a scalar tail, padding lanes hold 0.
+
+#include <stddef.h>
+#include <vector>
+#include "Vector3fPacket.h"
+#include "Vector3f.h"
+
+static constexpr size_t STREAM_PADDING = 8;
+
+class Vector3fStream
+{
+    private:
+        size_t count = 0;
+
+    public:
+        std::vector<float> X, Y, Z;
+
+        inline Vector3fStream ( ) noexcept { }
+        inline explicit Vector3fStream ( size_t count ) { this->resize(count); }
+        inline Vector3fStream ( const Vector3f* src, size_t count ) { this->loadAoS(src, count); }
+
+        inline size_t size ( ) const noexcept {
+            return this->count;
+        }
+
+        // Number of elements including padding, a multiple of STREAM_PADDING.
+        inline size_t paddedSize ( ) const noexcept {
+            return this->X.size();
+        }
+
+        inline void resize ( size_t newCount ) {
+            size_t padded = (newCount + STREAM_PADDING - 1) / STREAM_PADDING * STREAM_PADDING;
+
+            this->X.resize(padded); this->Y.resize(padded); this->Z.resize(padded);
+            this->count = newCount;
+            this->clearPadding();
+        }
+
+        inline void clearPadding ( ) noexcept {
+            for ( size_t i = this->count; i < this->X.size(); ++i ) {
+                this->X[i] = this->Y[i] = this->Z[i] = 0;
+            }
+        }
+
+        inline Vector3f get ( size_t index ) const noexcept {
+            return Vector3f(this->X[index], this->Y[index], this->Z[index]);
+        }
+
+        inline void set ( size_t index, const Vector3f& vec ) noexcept {
+            this->X[index] = vec.X; this->Y[index] = vec.Y; this->Z[index] = vec.Z;
+        }
+
+        inline void append ( const Vector3f& vec ) {
+            this->resize(this->count + 1);
+            this->set(this->count - 1, vec);
+        }
+
+        template<typename T = simdf>
+        inline Vector3fPacket<T> loadPacket ( size_t index ) const noexcept {
+            return Vector3fPacket<T>::Load(&this->X[index], &this->Y[index], &this->Z[index]);
+        }
+
+        template<typename T>
+        inline void storePacket ( size_t index, const Vector3fPacket<T>& packet ) noexcept {
+            packet.Store(&this->X[index], &this->Y[index], &this->Z[index]);
+        }
+
+        // AoS -> SoA
+        inline void loadAoS ( const Vector3f* src, size_t srcCount ) {
+            this->resize(srcCount);
+
+            size_t i = 0, simdCount = srcCount - srcCount % 4;
+
+            for ( ; i < simdCount; i += 4 ) {
+                this->storePacket(i, Vector3fx4::Load(src + i));
+            }
+
+            for ( ; i < srcCount; ++i ) {
+                this->set(i, src[i]);
+            }
+        }
+
+        // SoA -> AoS, dst must hold size() vectors.
+        inline void storeAoS ( Vector3f* dst ) const noexcept {
+            size_t i = 0, simdCount = this->count - this->count % 4;
+
+            for ( ; i < simdCount; i += 4 ) {
+                this->loadPacket<simd4f>(i).Store(dst + i);
+            }
+
+            for ( ; i < this->count; ++i ) {
+                dst[i] = this->get(i);
+            }
+        }
+
+};
+
+// Batched kernels, inputs must have the same size. out is resized to match and may alias them.
+
+inline void addArrays ( Vector3fStream& out, const Vector3fStream& a, const Vector3fStream& b ) {
+    out.resize(a.size());
+
+    for ( size_t i = 0; i < a.paddedSize(); i += SIMD_LANES ) {
+        out.storePacket(i, a.loadPacket(i) + b.loadPacket(i));
+    }
+}
+
+inline void subArrays ( Vector3fStream& out, const Vector3fStream& a, const Vector3fStream& b ) {
+    out.resize(a.size());
+
+    for ( size_t i = 0; i < a.paddedSize(); i += SIMD_LANES ) {
+        out.storePacket(i, a.loadPacket(i) - b.loadPacket(i));
+    }
+}
+
+inline void scaleArray ( Vector3fStream& out, const Vector3fStream& in, float scale ) {
+    out.resize(in.size());
+    simdf s = simdf_set1(scale);
+
+    for ( size_t i = 0; i < in.paddedSize(); i += SIMD_LANES ) {
+        out.storePacket(i, in.loadPacket(i) * s);
+    }
+}
+
+// Component-wise multiply.
+inline void mulArrays ( Vector3fStream& out, const Vector3fStream& a, const Vector3fStream& b ) {
+    out.resize(a.size());
+
+    for ( size_t i = 0; i < a.paddedSize(); i += SIMD_LANES ) {
+        Vector3fxN pa = a.loadPacket(i), pb = b.loadPacket(i);
+        out.storePacket(i, Vector3fxN(simd_mul(pa.X, pb.X), simd_mul(pa.Y, pb.Y), simd_mul(pa.Z, pb.Z)));
+    }
+}
+
+// out must hold a.paddedSize() floats.
+inline void dotArrays ( float* out, const Vector3fStream& a, const Vector3fStream& b ) noexcept {
+    for ( size_t i = 0; i < a.paddedSize(); i += SIMD_LANES ) {
+        simd_store(out + i, a.loadPacket(i).Dot(b.loadPacket(i)));
+    }
+}
+
+inline void crossArrays ( Vector3fStream& out, const Vector3fStream& a, const Vector3fStream& b ) {
+    out.resize(a.size());
+
+    for ( size_t i = 0; i < a.paddedSize(); i += SIMD_LANES ) {
+        out.storePacket(i, a.loadPacket(i).Cross(b.loadPacket(i)));
+    }
+}
+
+inline void lerpArrays ( Vector3fStream& out, const Vector3fStream& a, const Vector3fStream& b, float delta ) {
+    out.resize(a.size());
+
+    for ( size_t i = 0; i < a.paddedSize(); i += SIMD_LANES ) {
+        out.storePacket(i, a.loadPacket(i).Lerp(b.loadPacket(i), delta));
+    }
+}
+
+inline void normalizeArray ( Vector3fStream& out, const Vector3fStream& in ) {
+    out.resize(in.size());
+
+    for ( size_t i = 0; i < in.paddedSize(); i += SIMD_LANES ) {
+        out.storePacket(i, in.loadPacket(i).Normalized());
+    }
+
+    out.clearPadding(); // zero-length padding lanes turn into NaN.
+}
+
+// normalizeArray with Vector3fPacket::NormalizedFast.
+inline void normalizeArrayFast ( Vector3fStream& out, const Vector3fStream& in ) {
+    out.resize(in.size());
+
+    for ( size_t i = 0; i < in.paddedSize(); i += SIMD_LANES ) {
+        out.storePacket(i, in.loadPacket(i).NormalizedFast());
+    }
+
+    out.clearPadding();
+}
@@ -0,0 +1,113 @@
+#pragma once
+
+#ifdef __cplusplus
+#include "util/intrinsics.h"
+#include "Vector3f.h"
+#include <iostream>
+#include <string>
+#endif
+
+// Integer coordinates, chunk and voxel addresses.
+typedef struct Vector3i
+{
+    int X, Y, Z;
+
+#ifdef __cplusplus
+    constexpr inline Vector3i ( ) noexcept : X(0), Y(0), Z(0) { }
+    constexpr inline Vector3i ( int x, int y, int z ) noexcept : X(x), Y(y), Z(z) { }
+
+    // The cell a position falls in, rounding toward -infinity unlike a cast.
+    static inline Vector3i Floor ( const Vector3f& val ) noexcept {
+        return Vector3i(static_cast<int>(floorf(val.X)), static_cast<int>(floorf(val.Y)), static_cast<int>(floorf(val.Z)));
+    }
+
+    constexpr inline int Dot ( const Vector3i& other ) const noexcept {
+        return this->X * other.X + this->Y * other.Y + this->Z * other.Z;
+    }
+
+    constexpr inline Vector3i Cross ( const Vector3i& other ) const noexcept {
+        return Vector3i(
+            this->Y * other.Z - this->Z * other.Y,
+            this->Z * other.X - this->X * other.Z,
+            this->X * other.Y - this->Y * other.X
+        );
+    }
+
+    constexpr inline Vector3i Min ( const Vector3i& other ) const noexcept {
+        return Vector3i(this->X < other.X ? this->X : other.X, this->Y < other.Y ? this->Y : other.Y, this->Z < other.Z ? this->Z : other.Z);
+    }
+
+    constexpr inline Vector3i Max ( const Vector3i& other ) const noexcept {
+        return Vector3i(this->X > other.X ? this->X : other.X, this->Y > other.Y ? this->Y : other.Y, this->Z > other.Z ? this->Z : other.Z);
+    }
+
+    constexpr inline int SqrMagnitude ( ) const noexcept {
+        return this->X * this->X + this->Y * this->Y + this->Z * this->Z;
+    }
+
+    inline float Magnitude ( ) const noexcept {
+        return sqrtf(this->SqrMagnitude());
+    }
+
+    inline float Distance ( const Vector3i& other ) const noexcept {
+        float dx = this->X - other.X; float dy = this->Y - other.Y; float dz = this->Z - other.Z;
+        return sqrtf(dx * dx + dy * dy + dz * dz);
+    }
+
+    // Steps along the grid, what a neighborhood scan walks.
+    constexpr inline int ManhattanDistance ( const Vector3i& other ) const noexcept {
+        int dx = this->X - other.X; int dy = this->Y - other.Y; int dz = this->Z - other.Z;
+        return (dx < 0 ? -dx : dx) + (dy < 0 ? -dy : dy) + (dz < 0 ? -dz : dz);
+    }
+
+    constexpr inline Vector3f ToVector3f ( ) const noexcept {
+        return Vector3f(static_cast<float>(this->X), static_cast<float>(this->Y), static_cast<float>(this->Z));
+    }
+
+    inline std::string toString ( ) const noexcept {
+        return "(" + std::to_string(this->X) + ", " + std::to_string(this->Y) + ", " + std::to_string(this->Z) + ")";
+    }
+
+#endif // cplusplus
+} Vector3i;
+
+#ifdef __cplusplus
+constexpr inline Vector3i operator- ( const Vector3i& val ) noexcept {
+    return Vector3i(-val.X, -val.Y, -val.Z);
+}
+
+constexpr inline Vector3i operator+ ( const Vector3i& valA, const Vector3i& valB ) noexcept {
+    return Vector3i(valA.X + valB.X, valA.Y + valB.Y, valA.Z + valB.Z);
+}
+
+constexpr inline Vector3i operator- ( const Vector3i& valA, const Vector3i& valB ) noexcept {
+    return Vector3i(valA.X - valB.X, valA.Y - valB.Y, valA.Z - valB.Z);
+}
+
+constexpr inline Vector3i operator* ( const Vector3i& val, int scale ) noexcept {
+    return Vector3i(val.X * scale, val.Y * scale, val.Z * scale);
+}
+
+constexpr inline Vector3i operator+= ( Vector3i& valA, const Vector3i& valB ) noexcept {
+    valA.X += valB.X; valA.Y += valB.Y; valA.Z += valB.Z;
+    return valA;
+}
+
+constexpr inline Vector3i operator-= ( Vector3i& valA, const Vector3i& valB ) noexcept {
+    valA.X -= valB.X; valA.Y -= valB.Y; valA.Z -= valB.Z;
+    return valA;
+}
+
+constexpr inline bool operator== ( const Vector3i& valA, const Vector3i& valB ) noexcept {
+    return valA.X == valB.X && valA.Y == valB.Y && valA.Z == valB.Z;
+}
+
+constexpr inline bool operator!= ( const Vector3i& valA, const Vector3i& valB ) noexcept {
+    return !(valA == valB);
+}
+
+inline std::ostream& operator<<(std::ostream& os, const Vector3i& val) {
+    return os << val.toString();
+}
+
+#endif // cplusplus
@@ -0,0 +1,380 @@
+#pragma once
+
+// Bulk operations over packed (array of structs) Vector2f/Vector3f arrays, out may alias the
+// inputs. Without SIMD_FMA each function gives the same results as calling the matching method
+// per element. With it (the AVX2 kernel table, -mfma builds) transform, lerp, dot, normalize
+// and distance round each multiply-add once instead of twice, so they differ by up to half an
+// ulp of each product: normalize and distance stay within 4 ulp, while dot, lerp and transform
+// results that cancel to near zero can differ in every bit.
+// The *Fast variants match the Fast methods within their error bound.
+
+#include <stddef.h>
+#include "util/simd.h"
+#include "Vector2f.h"
+#include "Vector3f.h"
+
+static_assert(sizeof(Vector3f) == 3 * sizeof(float), "Vector3f arrays are read as packed floats");
+static_assert(sizeof(Vector2f) == 2 * sizeof(float), "Vector2f arrays are read as packed floats");
+
+// Component-wise over flat float arrays, shared by both vector types.
+inline void addFloats ( float* out, const float* a, const float* b, size_t count ) noexcept {
+
+    size_t i = 0, simdCount = count - count % SIMD_LANES;
+
+    for ( ; i < simdCount; i += SIMD_LANES ) {
+        simd_store(out + i, simd_add(simdf_load(a + i), simdf_load(b + i)));
+    }
+
+    for ( ; i < count; ++i ) {
+        out[i] = a[i] + b[i];
+    }
+
+}
+
+inline void subFloats ( float* out, const float* a, const float* b, size_t count ) noexcept {
+
+    size_t i = 0, simdCount = count - count % SIMD_LANES;
+
+    for ( ; i < simdCount; i += SIMD_LANES ) {
+        simd_store(out + i, simd_sub(simdf_load(a + i), simdf_load(b + i)));
+    }
+
+    for ( ; i < count; ++i ) {
+        out[i] = a[i] - b[i];
+    }
+
+}
+
+inline void lerpFloats ( float* out, const float* a, const float* b, float delta, size_t count ) noexcept {
+
+    simdf d = simdf_set1(delta);
+    size_t i = 0, simdCount = count - count % SIMD_LANES;
+
+    for ( ; i < simdCount; i += SIMD_LANES ) {
+        simdf va = simdf_load(a + i);
+        simd_store(out + i, simd_madd(simd_sub(simdf_load(b + i), va), d, va));
+    }
+
+    for ( ; i < count; ++i ) {
+        out[i] = a[i] + (b[i] - a[i]) * delta;
+    }
+
+}
+
+// out[i] = in[i] * scale + offset, component-wise.
+inline void transformArray ( Vector3f* out, const Vector3f* in, const Vector3f& scale,
+    const Vector3f& offset, size_t count ) noexcept {
+
+    // xyz repeats every 3 registers, build the repeating pattern once.
+    float scaleBuf[3 * SIMD_LANES], offsetBuf[3 * SIMD_LANES];
+
+    for ( int i = 0; i < SIMD_LANES; ++i ) {
+        scaleBuf[i * 3] = scale.X; scaleBuf[i * 3 + 1] = scale.Y; scaleBuf[i * 3 + 2] = scale.Z;
+        offsetBuf[i * 3] = offset.X; offsetBuf[i * 3 + 1] = offset.Y; offsetBuf[i * 3 + 2] = offset.Z;
+    }
+
+    simdf s0 = simdf_load(scaleBuf), s1 = simdf_load(scaleBuf + SIMD_LANES), s2 = simdf_load(scaleBuf + 2 * SIMD_LANES);
+    simdf o0 = simdf_load(offsetBuf), o1 = simdf_load(offsetBuf + SIMD_LANES), o2 = simdf_load(offsetBuf + 2 * SIMD_LANES);
+
+    const float* src = reinterpret_cast<const float*>(in);
+    float* dst = reinterpret_cast<float*>(out);
+    size_t i = 0, simdCount = count - count % SIMD_LANES;
+
+    for ( ; i < simdCount; i += SIMD_LANES ) {
+        const float* s = src + i * 3;
+        float* d = dst + i * 3;
+
+        simd_store(d, simd_madd(simdf_load(s), s0, o0));
+        simd_store(d + SIMD_LANES, simd_madd(simdf_load(s + SIMD_LANES), s1, o1));
+        simd_store(d + 2 * SIMD_LANES, simd_madd(simdf_load(s + 2 * SIMD_LANES), s2, o2));
+    }
+
+    for ( ; i < count; ++i ) {
+        out[i] = Vector3f(in[i].X * scale.X + offset.X, in[i].Y * scale.Y + offset.Y, in[i].Z * scale.Z + offset.Z);
+    }
+
+}
+
+inline void translateArray ( Vector3f* out, const Vector3f* in, const Vector3f& offset, size_t count ) noexcept {
+    transformArray(out, in, Vector3f(1, 1, 1), offset, count);
+}
+
+inline void scaleArray ( Vector3f* out, const Vector3f* in, float scale, size_t count ) noexcept {
+    transformArray(out, in, Vector3f(scale, scale, scale), Vector3f(), count);
+}
+
+inline void addArrays ( Vector3f* out, const Vector3f* a, const Vector3f* b, size_t count ) noexcept {
+    addFloats(&out->X, &a->X, &b->X, count * 3);
+}
+
+inline void subArrays ( Vector3f* out, const Vector3f* a, const Vector3f* b, size_t count ) noexcept {
+    subFloats(&out->X, &a->X, &b->X, count * 3);
+}
+
+inline void lerpArrays ( Vector3f* out, const Vector3f* a, const Vector3f* b, float delta, size_t count ) noexcept {
+    lerpFloats(&out->X, &a->X, &b->X, delta, count * 3);
+}
+
+inline void dotArrays ( float* out, const Vector3f* a, const Vector3f* b, size_t count ) noexcept {
+
+    simd4f ax, ay, az, bx, by, bz;
+    size_t i = 0, simdCount = count - count % 4;
+
+    for ( ; i < simdCount; i += 4 ) {
+        simd_loadXYZ(&a[i].X, ax, ay, az);
+        simd_loadXYZ(&b[i].X, bx, by, bz);
+        simd_store(out + i, simd_madd(az, bz, simd_madd(ay, by, simd_mul(ax, bx))));
+    }
+
+    for ( ; i < count; ++i ) {
+        out[i] = a[i].Dot(b[i]);
+    }
+
+}
+
+inline void crossArrays ( Vector3f* out, const Vector3f* a, const Vector3f* b, size_t count ) noexcept {
+
+    simd4f ax, ay, az, bx, by, bz;
+    size_t i = 0, simdCount = count - count % 4;
+
+    for ( ; i < simdCount; i += 4 ) {
+        simd_loadXYZ(&a[i].X, ax, ay, az);
+        simd_loadXYZ(&b[i].X, bx, by, bz);
+
+        simd_storeXYZ(&out[i].X,
+            simd_sub(simd_mul(ay, bz), simd_mul(az, by)),
+            simd_sub(simd_mul(az, bx), simd_mul(ax, bz)),
+            simd_sub(simd_mul(ax, by), simd_mul(ay, bx))
+        );
+    }
+
+    for ( ; i < count; ++i ) {
+        out[i] = a[i].Cross(b[i]);
+    }
+
+}
+
+inline void normalizeArray ( Vector3f* out, const Vector3f* in, size_t count ) noexcept {
+
+    simd4f one = simd4f_set1(1.0F);
+    simd4f x, y, z, invMag;
+    size_t i = 0, simdCount = count - count % 4;
+
+    for ( ; i < simdCount; i += 4 ) {
+        simd_loadXYZ(&in[i].X, x, y, z);
+        invMag = simd_div(one, simd_sqrt(simd_madd(z, z, simd_madd(y, y, simd_mul(x, x)))));
+        simd_storeXYZ(&out[i].X, simd_mul(x, invMag), simd_mul(y, invMag), simd_mul(z, invMag));
+    }
+
+    for ( ; i < count; ++i ) {
+        out[i] = in[i].Normalized();
+    }
+
+}
+
+inline void normalizeArrayFast ( Vector3f* out, const Vector3f* in, size_t count ) noexcept {
+
+    simd4f x, y, z, invMag;
+    size_t i = 0, simdCount = count - count % 4;
+
+    for ( ; i < simdCount; i += 4 ) {
+        simd_loadXYZ(&in[i].X, x, y, z);
+        invMag = simd_rsqrt(simd_madd(z, z, simd_madd(y, y, simd_mul(x, x))));
+        simd_storeXYZ(&out[i].X, simd_mul(x, invMag), simd_mul(y, invMag), simd_mul(z, invMag));
+    }
+
+    for ( ; i < count; ++i ) {
+        out[i] = in[i].NormalizedFast();
+    }
+
+}
+
+inline void distanceArrays ( float* out, const Vector3f* a, const Vector3f* b, size_t count ) noexcept {
+
+    simd4f ax, ay, az, bx, by, bz;
+    size_t i = 0, simdCount = count - count % 4;
+
+    for ( ; i < simdCount; i += 4 ) {
+        simd_loadXYZ(&a[i].X, ax, ay, az);
+        simd_loadXYZ(&b[i].X, bx, by, bz);
+
+        ax = simd_sub(ax, bx); ay = simd_sub(ay, by); az = simd_sub(az, bz);
+        simd_store(out + i, simd_sqrt(simd_madd(az, az, simd_madd(ay, ay, simd_mul(ax, ax)))));
+    }
+
+    for ( ; i < count; ++i ) {
+        out[i] = a[i].Distance(b[i]);
+    }
+
+}
+
+inline void distanceArraysFast ( float* out, const Vector3f* a, const Vector3f* b, size_t count ) noexcept {
+
+    simd4f ax, ay, az, bx, by, bz, sqrDist;
+    size_t i = 0, simdCount = count - count % 4;
+
+    for ( ; i < simdCount; i += 4 ) {
+        simd_loadXYZ(&a[i].X, ax, ay, az);
+        simd_loadXYZ(&b[i].X, bx, by, bz);
+
+        ax = simd_sub(ax, bx); ay = simd_sub(ay, by); az = simd_sub(az, bz);
+        sqrDist = simd_madd(az, az, simd_madd(ay, ay, simd_mul(ax, ax)));
+        simd_store(out + i, simd_fastSqrt(sqrDist));
+    }
+
+    for ( ; i < count; ++i ) {
+        out[i] = a[i].DistanceFast(b[i]);
+    }
+
+}
+
+// Vector2f
+
+inline void transformArray ( Vector2f* out, const Vector2f* in, const Vector2f& scale,
+    const Vector2f& offset, size_t count ) noexcept {
+
+    // SIMD_LANES is even, so xy lines up with every register.
+    float scaleBuf[SIMD_LANES], offsetBuf[SIMD_LANES];
+
+    for ( int i = 0; i < SIMD_LANES; i += 2 ) {
+        scaleBuf[i] = scale.X; scaleBuf[i + 1] = scale.Y;
+        offsetBuf[i] = offset.X; offsetBuf[i + 1] = offset.Y;
+    }
+
+    simdf s = simdf_load(scaleBuf), o = simdf_load(offsetBuf);
+    const float* src = reinterpret_cast<const float*>(in);
+    float* dst = reinterpret_cast<float*>(out);
+
+    size_t floatCount = count * 2, i = 0, simdCount = floatCount - floatCount % SIMD_LANES;
+
+    for ( ; i < simdCount; i += SIMD_LANES ) {
+        simd_store(dst + i, simd_madd(simdf_load(src + i), s, o));
+    }
+
+    for ( ; i < floatCount; i += 2 ) {
+        dst[i] = src[i] * scale.X + offset.X;
+        dst[i + 1] = src[i + 1] * scale.Y + offset.Y;
+    }
+
+}
+
+inline void addArrays ( Vector2f* out, const Vector2f* a, const Vector2f* b, size_t count ) noexcept {
+    addFloats(&out->X, &a->X, &b->X, count * 2);
+}
+
+inline void subArrays ( Vector2f* out, const Vector2f* a, const Vector2f* b, size_t count ) noexcept {
+    subFloats(&out->X, &a->X, &b->X, count * 2);
+}
+
+inline void lerpArrays ( Vector2f* out, const Vector2f* a, const Vector2f* b, float delta, size_t count ) noexcept {
+    lerpFloats(&out->X, &a->X, &b->X, delta, count * 2);
+}
+
+inline void dotArrays ( float* out, const Vector2f* a, const Vector2f* b, size_t count ) noexcept {
+
+    simd4f ax, ay, bx, by;
+    size_t i = 0, simdCount = count - count % 4;
+
+    for ( ; i < simdCount; i += 4 ) {
+        simd_loadXY(&a[i].X, ax, ay);
+        simd_loadXY(&b[i].X, bx, by);
+        simd_store(out + i, simd_madd(ay, by, simd_mul(ax, bx)));
+    }
+
+    for ( ; i < count; ++i ) {
+        out[i] = a[i].Dot(b[i]);
+    }
+
+}
+
+inline void crossArrays ( float* out, const Vector2f* a, const Vector2f* b, size_t count ) noexcept {
+
+    simd4f ax, ay, bx, by;
+    size_t i = 0, simdCount = count - count % 4;
+
+    for ( ; i < simdCount; i += 4 ) {
+        simd_loadXY(&a[i].X, ax, ay);
+        simd_loadXY(&b[i].X, bx, by);
+        simd_store(out + i, simd_sub(simd_mul(ax, by), simd_mul(ay, bx)));
+    }
+
+    for ( ; i < count; ++i ) {
+        out[i] = a[i].Cross(b[i]);
+    }
+
+}
+
+inline void normalizeArray ( Vector2f* out, const Vector2f* in, size_t count ) noexcept {
+
+    simd4f one = simd4f_set1(1.0F);
+    simd4f x, y, invMag;
+    size_t i = 0, simdCount = count - count % 4;
+
+    for ( ; i < simdCount; i += 4 ) {
+        simd_loadXY(&in[i].X, x, y);
+        invMag = simd_div(one, simd_sqrt(simd_madd(y, y, simd_mul(x, x))));
+        simd_storeXY(&out[i].X, simd_mul(x, invMag), simd_mul(y, invMag));
+    }
+
+    for ( ; i < count; ++i ) {
+        out[i] = in[i].Normalized();
+    }
+
+}
+
+inline void normalizeArrayFast ( Vector2f* out, const Vector2f* in, size_t count ) noexcept {
+
+    simd4f x, y, invMag;
+    size_t i = 0, simdCount = count - count % 4;
+
+    for ( ; i < simdCount; i += 4 ) {
+        simd_loadXY(&in[i].X, x, y);
+        invMag = simd_rsqrt(simd_madd(y, y, simd_mul(x, x)));
+        simd_storeXY(&out[i].X, simd_mul(x, invMag), simd_mul(y, invMag));
+    }
+
+    for ( ; i < count; ++i ) {
+        out[i] = in[i].NormalizedFast();
+    }
+
+}
+
+inline void distanceArrays ( float* out, const Vector2f* a, const Vector2f* b, size_t count ) noexcept {
+
+    simd4f ax, ay, bx, by;
+    size_t i = 0, simdCount = count - count % 4;
+
+    for ( ; i < simdCount; i += 4 ) {
+        simd_loadXY(&a[i].X, ax, ay);
+        simd_loadXY(&b[i].X, bx, by);
+
+        ax = simd_sub(ax, bx); ay = simd_sub(ay, by);
+        simd_store(out + i, simd_sqrt(simd_madd(ay, ay, simd_mul(ax, ax))));
+    }
+
+    for ( ; i < count; ++i ) {
+        out[i] = a[i].Distance(b[i]);
+    }
+
+}
+
+inline void distanceArraysFast ( float* out, const Vector2f* a, const Vector2f* b, size_t count ) noexcept {
+
+    simd4f ax, ay, bx, by, sqrDist;
+    size_t i = 0, simdCount = count - count % 4;
+
+    for ( ; i < simdCount; i += 4 ) {
+        simd_loadXY(&a[i].X, ax, ay);
+        simd_loadXY(&b[i].X, bx, by);
+
+        ax = simd_sub(ax, bx); ay = simd_sub(ay, by);
+        sqrDist = simd_madd(ay, ay, simd_mul(ax, ax));
+        simd_store(out + i, simd_fastSqrt(sqrDist));
+    }
+
+    for ( ; i < count; ++i ) {
+        out[i] = a[i].DistanceFast(b[i]);
+    }
+
+}
+
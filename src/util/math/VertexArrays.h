@@ -0,0 +1,226 @@
+#pragma once
+
+// Bulk encoders / decoders for the formats in VertexFormats.h, 4 vertices per step. Encoders
+// give the same bits as the scalar encode* functions, decoders match within float rounding.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "util/simd.h"
+#include "util/colors/ColorArrays.h"
+#include "VertexFormats.h"
+#include "Vector3f.h"
+
+// SIMD floatToHalf, both paths are computed and the lane picks one.
+inline simd4i floatToHalf4 ( simd4f val ) noexcept {
+
+    constexpr int32_t F32_INFINITY = 255 << 23, F16_OVERFLOW = (127 + 16) << 23;
+    constexpr int32_t DENORM_MAGIC = ((127 - 15) + (23 - 10) + 1) << 23;
+
+    simd4i bits = simd_asInt(val);
+    simd4i sign = simd_and(bits, simd4i_set1(INT32_MIN));
+    bits = simd_xor(bits, sign); // signed compares below are fine without the sign bit
+
+    simd4i denormal = simd_sub(simd_asInt(simd_add(simd_asFloat(bits), simd_asFloat(simd4i_set1(DENORM_MAGIC)))),
+        simd4i_set1(DENORM_MAGIC));
+
+    simd4i mantissaOdd = simd_and(simd_shr<13>(bits), simd4i_set1(1));
+    simd4i normal = simd_shr<13>(simd_add(simd_add(bits, simd4i_set1(static_cast<int32_t>((15U - 127U) << 23) + 0xFFF)), mantissaOdd));
+
+    simd4i out = simd_select(simd_cmpgt(simd4i_set1(113 << 23), bits), denormal, normal);
+    simd4i overflow = simd_select(simd_cmpgt(bits, simd4i_set1(F32_INFINITY)), simd4i_set1(0x7E00), simd4i_set1(0x7C00));
+    out = simd_select(simd_cmpgt(bits, simd4i_set1(F16_OVERFLOW - 1)), overflow, out);
+
+    return simd_or(out, simd_shr<16>(sign));
+
+}
+
+// SIMD halfToFloat, takes halves zero extended to 32 bits.
+inline simd4f halfToFloat4 ( simd4i half ) noexcept {
+
+    constexpr int32_t SHIFTED_EXP = 0x7C00 << 13;
+
+    simd4i bits = simd_shl<13>(simd_and(half, simd4i_set1(0x7FFF)));
+    simd4i exp = simd_and(bits, simd4i_set1(SHIFTED_EXP));
+    bits = simd_add(bits, simd4i_set1((127 - 15) << 23));
+
+    simd4i infNan = simd_add(bits, simd4i_set1((128 - 16) << 23));
+    simd4i denormal = simd_asInt(simd_sub(simd_asFloat(simd_add(bits, simd4i_set1(1 << 23))), simd_asFloat(simd4i_set1(113 << 23))));
+
+    bits = simd_select(simd_cmpeq(exp, simd4i_set1(SHIFTED_EXP)), infNan, bits);
+    bits = simd_select(simd_cmpeq(exp, simd4i_set1(0)), denormal, bits);
+
+    return simd_asFloat(simd_or(bits, simd_shl<16>(simd_and(half, simd4i_set1(0x8000)))));
+
+}
+
+inline simd4i floatToSnorm16x4 ( simd4f val ) noexcept {
+    simd4f clamped = simd_min(simd_max(val, simd4f_set1(-1.0F)), simd4f_set1(1.0F));
+    return simd_toIntRound(simd_mul(clamped, simd4f_set1(SNORM16_MAX)));
+}
+
+inline simd4f snorm16ToFloat4 ( simd4i val ) noexcept {
+    return simd_max(simd_mul(simd_toFloat(val), simd4f_set1(1.0F / SNORM16_MAX)), simd4f_set1(-1.0F));
+}
+
+// Runs block(out, in) on groups of 4, the tail goes through zero padded copies.
+template<typename Out, typename In, typename Block>
+inline void forVertexBlocks ( Out* out, const In* in, size_t count, Block block ) noexcept {
+
+    size_t i = 0, simdCount = count - count % 4;
+
+    for ( ; i < simdCount; i += 4 ) {
+        block(out + i, in + i);
+    }
+
+    if ( i < count ) {
+        In tailIn[4] = { };
+        Out tailOut[4];
+        memcpy(tailIn, in + i, (count - i) * sizeof(In));
+        block(tailOut, tailIn);
+        memcpy(out + i, tailOut, (count - i) * sizeof(Out));
+    }
+
+}
+
+// Broadcast PositionQuantization.
+struct PositionQuantization4 {
+    simd4f offsetX, offsetY, offsetZ, scaleX, scaleY, scaleZ;
+
+    inline PositionQuantization4 ( const PositionQuantization& quant ) noexcept :
+        offsetX(simd4f_set1(quant.Offset.X)), offsetY(simd4f_set1(quant.Offset.Y)), offsetZ(simd4f_set1(quant.Offset.Z)),
+        scaleX(simd4f_set1(quant.Scale.X)), scaleY(simd4f_set1(quant.Scale.Y)), scaleZ(simd4f_set1(quant.Scale.Z)) { }
+
+    inline void normalize ( const Vector3f* in, simd4f& x, simd4f& y, simd4f& z ) const noexcept {
+        simd_loadXYZ(&in->X, x, y, z);
+        x = simd_div(simd_sub(x, this->offsetX), this->scaleX);
+        y = simd_div(simd_sub(y, this->offsetY), this->scaleY);
+        z = simd_div(simd_sub(z, this->offsetZ), this->scaleZ);
+    }
+
+    inline void denormalize ( Vector3f* out, simd4f x, simd4f y, simd4f z ) const noexcept {
+        simd_storeXYZ(&out->X, simd_madd(x, this->scaleX, this->offsetX), simd_madd(y, this->scaleY, this->offsetY),
+            simd_madd(z, this->scaleZ, this->offsetZ));
+    }
+};
+
+inline void encodeHalfPositions ( Half4* out, const Vector3f* in, size_t count, const PositionQuantization& quant ) noexcept {
+    PositionQuantization4 q(quant);
+
+    forVertexBlocks(out, in, count, [&]( Half4* dst, const Vector3f* src ) {
+        alignas(16) int32_t x[4], y[4], z[4];
+        simd4f px, py, pz;
+        q.normalize(src, px, py, pz);
+        simd_store(x, floatToHalf4(px)); simd_store(y, floatToHalf4(py)); simd_store(z, floatToHalf4(pz));
+
+        for ( int j = 0; j < 4; ++j ) {
+            dst[j] = Half4{ static_cast<uint16_t>(x[j]), static_cast<uint16_t>(y[j]), static_cast<uint16_t>(z[j]), HALF_ONE };
+        }
+    });
+}
+
+inline void decodeHalfPositions ( Vector3f* out, const Half4* in, size_t count, const PositionQuantization& quant ) noexcept {
+    PositionQuantization4 q(quant);
+
+    forVertexBlocks(out, in, count, [&]( Vector3f* dst, const Half4* src ) {
+        simd4i x = simd4i_set(src[0].X, src[1].X, src[2].X, src[3].X);
+        simd4i y = simd4i_set(src[0].Y, src[1].Y, src[2].Y, src[3].Y);
+        simd4i z = simd4i_set(src[0].Z, src[1].Z, src[2].Z, src[3].Z);
+
+        q.denormalize(dst, halfToFloat4(x), halfToFloat4(y), halfToFloat4(z));
+    });
+}
+
+// Positions outside the quantization box are clamped to it.
+inline void encodeSnormPositions ( Snorm16x4* out, const Vector3f* in, size_t count, const PositionQuantization& quant ) noexcept {
+    PositionQuantization4 q(quant);
+
+    forVertexBlocks(out, in, count, [&]( Snorm16x4* dst, const Vector3f* src ) {
+        alignas(16) int32_t x[4], y[4], z[4];
+        simd4f px, py, pz;
+        q.normalize(src, px, py, pz);
+        simd_store(x, floatToSnorm16x4(px)); simd_store(y, floatToSnorm16x4(py)); simd_store(z, floatToSnorm16x4(pz));
+
+        for ( int j = 0; j < 4; ++j ) {
+            dst[j] = Snorm16x4{ static_cast<int16_t>(x[j]), static_cast<int16_t>(y[j]), static_cast<int16_t>(z[j]),
+                static_cast<int16_t>(SNORM16_MAX) };
+        }
+    });
+}
+
+inline void decodeSnormPositions ( Vector3f* out, const Snorm16x4* in, size_t count, const PositionQuantization& quant ) noexcept {
+    PositionQuantization4 q(quant);
+
+    forVertexBlocks(out, in, count, [&]( Vector3f* dst, const Snorm16x4* src ) {
+        simd4i x = simd4i_set(src[0].X, src[1].X, src[2].X, src[3].X);
+        simd4i y = simd4i_set(src[0].Y, src[1].Y, src[2].Y, src[3].Y);
+        simd4i z = simd4i_set(src[0].Z, src[1].Z, src[2].Z, src[3].Z);
+
+        q.denormalize(dst, snorm16ToFloat4(x), snorm16ToFloat4(y), snorm16ToFloat4(z));
+    });
+}
+
+inline void encodeOctNormals ( Snorm16x2* out, const Vector3f* in, size_t count ) noexcept {
+
+    simd4i absMask = simd4i_set1(INT32_MAX);
+    simd4f zero = simd4f_set1(0.0F), one = simd4f_set1(1.0F), minusOne = simd4f_set1(-1.0F);
+
+    forVertexBlocks(out, in, count, [&]( Snorm16x2* dst, const Vector3f* src ) {
+        alignas(16) int32_t packedU[4], packedV[4];
+        simd4f x, y, z;
+        simd_loadXYZ(&src->X, x, y, z);
+
+        simd4f absX = simd_asFloat(simd_and(simd_asInt(x), absMask));
+        simd4f absY = simd_asFloat(simd_and(simd_asInt(y), absMask));
+        simd4f absZ = simd_asFloat(simd_and(simd_asInt(z), absMask));
+        simd4f sum = simd_max(simd_add(simd_add(absX, absY), absZ), simd4f_set1(FLT_MIN));
+
+        simd4f u = simd_div(x, sum), v = simd_div(y, sum);
+        simd4f absU = simd_asFloat(simd_and(simd_asInt(u), absMask));
+        simd4f absV = simd_asFloat(simd_and(simd_asInt(v), absMask));
+
+        // lower hemisphere folds over the diagonals.
+        simd4f foldedU = simd_mul(simd_sub(one, absV), simd_select(simd_cmpge(u, zero), one, minusOne));
+        simd4f foldedV = simd_mul(simd_sub(one, absU), simd_select(simd_cmpge(v, zero), one, minusOne));
+        simd4f lower = simd_cmplt(z, zero);
+
+        simd_store(packedU, floatToSnorm16x4(simd_select(lower, foldedU, u)));
+        simd_store(packedV, floatToSnorm16x4(simd_select(lower, foldedV, v)));
+
+        for ( int j = 0; j < 4; ++j ) {
+            dst[j] = Snorm16x2{ static_cast<int16_t>(packedU[j]), static_cast<int16_t>(packedV[j]) };
+        }
+    });
+
+}
+
+inline void decodeOctNormals ( Vector3f* out, const Snorm16x2* in, size_t count ) noexcept {
+
+    simd4i absMask = simd4i_set1(INT32_MAX);
+    simd4f zero = simd4f_set1(0.0F), one = simd4f_set1(1.0F);
+
+    forVertexBlocks(out, in, count, [&]( Vector3f* dst, const Snorm16x2* src ) {
+        simd4f u = snorm16ToFloat4(simd4i_set(src[0].X, src[1].X, src[2].X, src[3].X));
+        simd4f v = snorm16ToFloat4(simd4i_set(src[0].Y, src[1].Y, src[2].Y, src[3].Y));
+        simd4f absU = simd_asFloat(simd_and(simd_asInt(u), absMask));
+        simd4f absV = simd_asFloat(simd_and(simd_asInt(v), absMask));
+        simd4f z = simd_sub(simd_sub(one, absU), absV);
+        simd4f fold = simd_max(simd_sub(zero, z), zero);
+
+        u = simd_select(simd_cmpge(u, zero), simd_sub(u, fold), simd_add(u, fold));
+        v = simd_select(simd_cmpge(v, zero), simd_sub(v, fold), simd_add(v, fold));
+
+        simd4f invLength = simd_div(one, simd_sqrt(simd_madd(z, z, simd_madd(v, v, simd_mul(u, u)))));
+        simd_storeXYZ(&dst->X, simd_mul(u, invLength), simd_mul(v, invLength), simd_mul(z, invLength));
+    });
+
+}
+
+// RGBA8 in R, G, B, A byte order, see encodeVertexColor.
+inline void encodeVertexColors ( uint32_t* out, const Color4f* in, size_t count ) noexcept {
+    packPixelArray<PixelABGR>(out, in, count);
+}
+
+inline void decodeVertexColors ( Color4f* out, const uint32_t* in, size_t count ) noexcept {
+    unpackPixelArray<PixelABGR>(out, in, count);
+}
@@ -0,0 +1,227 @@
+#pragma once
+
+// Compact vertex attribute formats and their scalar encoders. Bulk SIMD versions are in
+// VertexArrays.h and encode to the same bits, VertexPackingReport measures what a format costs.
+//
+//   position  Vector3f (12 bytes) -> Half4 or Snorm16x4 (8 bytes), W holds 1 so it reads as a vec4
+//   normal    Vector3f (12 bytes) -> octahedral Snorm16x2 (4 bytes)
+//   color     Color4f  (16 bytes) -> RGBA8 (4 bytes), bytes R, G, B, A in memory
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <string>
+#include <float.h>
+#include <bit>
+#include <cmath>
+#include "util/colors/Color4f.h"
+#include "Aabb3f.h"
+#include "Vector3f.h"
+#endif
+
+#include <stdint.h>
+
+static constexpr float SNORM16_MAX = 32767.0F;
+static constexpr uint16_t HALF_ONE = 0x3C00;
+
+typedef struct Half4 { uint16_t X, Y, Z, W; } Half4;
+typedef struct Snorm16x4 { int16_t X, Y, Z, W; } Snorm16x4;
+typedef struct Snorm16x2 { int16_t X, Y; } Snorm16x2;
+
+#ifdef __cplusplus
+
+static_assert(sizeof(Half4) == 8 && sizeof(Snorm16x4) == 8 && sizeof(Snorm16x2) == 4, "vertex formats must be tightly packed");
+
+// Round to nearest even, overflow goes to infinity and NaN stays NaN (F. Giesen, "half_from_float_fast3").
+constexpr inline uint16_t floatToHalf ( float val ) noexcept {
+    constexpr uint32_t F32_INFINITY = 255U << 23, F16_OVERFLOW = (127U + 16) << 23;
+    constexpr uint32_t DENORM_MAGIC = ((127U - 15) + (23 - 10) + 1) << 23;
+
+    uint32_t bits = std::bit_cast<uint32_t>(val);
+    uint32_t sign = bits & 0x80000000U, out;
+    bits ^= sign;
+
+    if ( bits >= F16_OVERFLOW ) {
+        out = bits > F32_INFINITY ? 0x7E00 : 0x7C00;
+    } else if ( bits < (113U << 23) ) {
+        out = std::bit_cast<uint32_t>(std::bit_cast<float>(bits) + std::bit_cast<float>(DENORM_MAGIC)) - DENORM_MAGIC;
+    } else {
+        uint32_t mantissaOdd = (bits >> 13) & 1;
+        out = (bits + (static_cast<uint32_t>(15 - 127) << 23) + 0xFFF + mantissaOdd) >> 13;
+    }
+
+    return static_cast<uint16_t>(out | (sign >> 16));
+}
+
+// Exact, every half is representable as a float.
+constexpr inline float halfToFloat ( uint16_t half ) noexcept {
+    constexpr uint32_t SHIFTED_EXP = 0x7C00U << 13;
+
+    uint32_t bits = (half & 0x7FFFU) << 13;
+    uint32_t exp = bits & SHIFTED_EXP;
+    bits += (127U - 15) << 23;
+
+    if ( exp == SHIFTED_EXP ) {
+        bits += (128U - 16) << 23; // Inf / NaN
+    } else if ( exp == 0 ) {
+        bits = std::bit_cast<uint32_t>(std::bit_cast<float>(bits + (1U << 23)) - std::bit_cast<float>(113U << 23));
+    }
+
+    return std::bit_cast<float>(bits | ((half & 0x8000U) << 16));
+}
+
+inline int16_t floatToSnorm16 ( float val ) noexcept {
+    return static_cast<int16_t>(std::lrint(std::clamp(val, -1.0F, 1.0F) * SNORM16_MAX));
+}
+
+constexpr inline float snorm16ToFloat ( int16_t val ) noexcept {
+    return std::max(val * (1.0F / SNORM16_MAX), -1.0F);
+}
+
+// Maps positions into [-1, 1] over a box: packed = (pos - Offset) / Scale.
+typedef struct PositionQuantization
+{
+    Vector3f Offset, Scale;
+
+    constexpr inline PositionQuantization ( ) noexcept : Offset(0, 0, 0), Scale(1, 1, 1) { }
+    constexpr inline PositionQuantization ( const Vector3f& offset, const Vector3f& scale ) noexcept : Offset(offset), Scale(scale) { }
+
+    // Flat axes get a scale of 1 so they don't divide by 0.
+    static constexpr inline PositionQuantization FromBounds ( const Aabb3f& bounds ) noexcept {
+        if ( bounds.IsEmpty() ) {
+            return PositionQuantization();
+        }
+
+        Vector3f extent = bounds.GetSize() * 0.5F;
+        return PositionQuantization(bounds.GetCenter(), Vector3f(extent.X > 0 ? extent.X : 1,
+            extent.Y > 0 ? extent.Y : 1, extent.Z > 0 ? extent.Z : 1));
+    }
+
+    constexpr inline Vector3f Normalize ( const Vector3f& pos ) const noexcept {
+        return Vector3f((pos.X - this->Offset.X) / this->Scale.X, (pos.Y - this->Offset.Y) / this->Scale.Y,
+            (pos.Z - this->Offset.Z) / this->Scale.Z);
+    }
+
+    constexpr inline Vector3f Denormalize ( const Vector3f& pos ) const noexcept {
+        return Vector3f(pos.X * this->Scale.X + this->Offset.X, pos.Y * this->Scale.Y + this->Offset.Y,
+            pos.Z * this->Scale.Z + this->Offset.Z);
+    }
+} PositionQuantization;
+
+inline Half4 encodeHalfPosition ( const Vector3f& pos, const PositionQuantization& quant ) noexcept {
+    Vector3f n = quant.Normalize(pos);
+    return Half4{ floatToHalf(n.X), floatToHalf(n.Y), floatToHalf(n.Z), HALF_ONE };
+}
+
+inline Vector3f decodeHalfPosition ( const Half4& packed, const PositionQuantization& quant ) noexcept {
+    return quant.Denormalize(Vector3f(halfToFloat(packed.X), halfToFloat(packed.Y), halfToFloat(packed.Z)));
+}
+
+// Positions outside the quantization box are clamped to it.
+inline Snorm16x4 encodeSnormPosition ( const Vector3f& pos, const PositionQuantization& quant ) noexcept {
+    Vector3f n = quant.Normalize(pos);
+    return Snorm16x4{ floatToSnorm16(n.X), floatToSnorm16(n.Y), floatToSnorm16(n.Z), static_cast<int16_t>(SNORM16_MAX) };
+}
+
+inline Vector3f decodeSnormPosition ( const Snorm16x4& packed, const PositionQuantization& quant ) noexcept {
+    return quant.Denormalize(Vector3f(snorm16ToFloat(packed.X), snorm16ToFloat(packed.Y), snorm16ToFloat(packed.Z)));
+}
+
+// Octahedral normal (Cigolle et al. 2014), the unit sphere folded onto a square. The zero vector maps to +Z.
+inline Snorm16x2 encodeOctNormal ( const Vector3f& normal ) noexcept {
+    float sum = std::max(std::fabs(normal.X) + std::fabs(normal.Y) + std::fabs(normal.Z), FLT_MIN);
+    float u = normal.X / sum, v = normal.Y / sum;
+
+    if ( normal.Z < 0 ) {
+        float foldedU = (1 - std::fabs(v)) * (u >= 0 ? 1.0F : -1.0F);
+        v = (1 - std::fabs(u)) * (v >= 0 ? 1.0F : -1.0F);
+        u = foldedU;
+    }
+
+    return Snorm16x2{ floatToSnorm16(u), floatToSnorm16(v) };
+}
+
+inline Vector3f decodeOctNormal ( const Snorm16x2& packed ) noexcept {
+    float u = snorm16ToFloat(packed.X), v = snorm16ToFloat(packed.Y);
+    float z = 1 - std::fabs(u) - std::fabs(v);
+    float fold = std::max(-z, 0.0F);
+
+    u += u >= 0 ? -fold : fold;
+    v += v >= 0 ? -fold : fold;
+
+    return Vector3f(u, v, z).Normalized();
+}
+
+// RGBA8 keeps Color4f::toRGBA()'s truncation, only the byte order differs.
+inline uint32_t encodeVertexColor ( const Color4f& color ) noexcept {
+    return static_cast<uint32_t>(color.getURed()) | (color.getUGreen() << 8) | (color.getUBlue() << 16)
+        | (static_cast<uint32_t>(color.getUAlpha()) << 24);
+}
+
+inline Color4f decodeVertexColor ( uint32_t packed ) noexcept {
+    return Color4f((packed & 0xFF) * ONE_255, ((packed >> 8) & 0xFF) * ONE_255, ((packed >> 16) & 0xFF) * ONE_255,
+        (packed >> 24) * ONE_255);
+}
+
+// Size and worst case error of packed attributes against their source, fed one attribute
+// stream at a time. Normal error is the angle in degrees, color error is per channel in [0, 1].
+struct VertexPackingReport {
+    size_t vertexCount = 0;
+    size_t sourceBytes = 0;
+    size_t packedBytes = 0;
+
+    float maxPositionError = 0;
+    float maxNormalError = 0;
+    float maxColorError = 0;
+
+    inline void addPositions ( const Vector3f* src, const Half4* packed, size_t count, const PositionQuantization& quant ) noexcept {
+        this->addStream(count, sizeof(Vector3f), sizeof(Half4));
+
+        for ( size_t i = 0; i < count; ++i ) {
+            this->maxPositionError = std::max(this->maxPositionError, src[i].Distance(decodeHalfPosition(packed[i], quant)));
+        }
+    }
+
+    inline void addPositions ( const Vector3f* src, const Snorm16x4* packed, size_t count, const PositionQuantization& quant ) noexcept {
+        this->addStream(count, sizeof(Vector3f), sizeof(Snorm16x4));
+
+        for ( size_t i = 0; i < count; ++i ) {
+            this->maxPositionError = std::max(this->maxPositionError, src[i].Distance(decodeSnormPosition(packed[i], quant)));
+        }
+    }
+
+    // src must be unit length.
+    inline void addNormals ( const Vector3f* src, const Snorm16x2* packed, size_t count ) noexcept {
+        this->addStream(count, sizeof(Vector3f), sizeof(Snorm16x2));
+
+        for ( size_t i = 0; i < count; ++i ) {
+            float cosAngle = std::clamp(src[i].Dot(decodeOctNormal(packed[i])), -1.0F, 1.0F);
+            this->maxNormalError = std::max(this->maxNormalError, std::acos(cosAngle) * (180.0F / 3.14159265F));
+        }
+    }
+
+    inline void addColors ( const Color4f* src, const uint32_t* packed, size_t count ) noexcept {
+        this->addStream(count, sizeof(Color4f), sizeof(uint32_t));
+
+        for ( size_t i = 0; i < count; ++i ) {
+            Color4f decoded = decodeVertexColor(packed[i]);
+            this->maxColorError = std::max({ this->maxColorError,
+                std::fabs(std::clamp(src[i].red, 0.0F, 1.0F) - decoded.red), std::fabs(std::clamp(src[i].green, 0.0F, 1.0F) - decoded.green),
+                std::fabs(std::clamp(src[i].blue, 0.0F, 1.0F) - decoded.blue), std::fabs(std::clamp(src[i].alpha, 0.0F, 1.0F) - decoded.alpha) });
+        }
+    }
+
+    inline std::string toString ( ) const noexcept {
+        return std::to_string(this->packedBytes) + " bytes/vertex (" + std::to_string(this->sourceBytes) + " unpacked), max error: position "
+            + std::to_string(this->maxPositionError) + ", normal " + std::to_string(this->maxNormalError) + " deg, color "
+            + std::to_string(this->maxColorError);
+    }
+
+    // Per vertex sizes add up, the vertex count is the longest stream.
+    inline void addStream ( size_t count, size_t srcSize, size_t packedSize ) noexcept {
+        this->vertexCount = std::max(this->vertexCount, count);
+        this->sourceBytes += srcSize;
+        this->packedBytes += packedSize;
+    }
+};
+
+#endif // cplusplus
@@ -0,0 +1,614 @@
+#pragma once
+
+// Thin wrapper over the SIMD instruction set picked from detect_arch.h.
+// simd4f is always 4 lanes wide, simdf is the widest type the target supports (SIMD_LANES).
+// A translation unit compiled for AVX2 through a target pragma defines SIMD_TARGET_AVX2 first,
+// gcc does not update the feature macros for those, see util/Kernels.h.
+
+#include "util/detect.h"
+#include "util/intrinsics.h"
+#include <stdint.h>
+#include <string.h>
+#include <float.h>
+
+#if DETECT_ARCH_SSE && (DETECT_ARCH_X86_64 || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2))
+    #define SIMD_SSE2 1
+    #include <emmintrin.h>
+
+    #if defined(__AVX__) || defined(SIMD_TARGET_AVX2)
+        #define SIMD_AVX 1
+        #include <immintrin.h>
+    #endif
+
+    #if defined(__FMA__) || defined(SIMD_TARGET_AVX2)
+        #define SIMD_FMA 1
+    #endif
+#elif DETECT_ARCH_AARCH64 || (DETECT_ARCH_ARM && defined(__ARM_NEON))
+    #define SIMD_NEON 1
+    #include <arm_neon.h>
+#endif
+
+#ifndef SIMD_SSE2
+    #define SIMD_SSE2 0
+#endif
+
+#ifndef SIMD_AVX
+    #define SIMD_AVX 0
+#endif
+
+#ifndef SIMD_FMA
+    #define SIMD_FMA 0
+#endif
+
+#ifndef SIMD_NEON
+    #define SIMD_NEON 0
+#endif
+
+#define SIMD_SCALAR (!SIMD_SSE2 && !SIMD_NEON)
+
+#if SIMD_SCALAR && defined(__cplusplus)
+    #include <cmath> // std::nearbyint
+#endif
+
+#if SIMD_AVX
+    #define SIMD_LANES 8
+#else
+    #define SIMD_LANES 4
+#endif
+
+#if (COMPILER == COMPILER_GCC) || (COMPILER == COMPILER_CLANG)
+    #define SIMD_ALWAYS_INLINE inline __attribute__((always_inline))
+#else
+    #define SIMD_ALWAYS_INLINE inline
+#endif
+
+#ifdef __cplusplus
+
+// __m128/__m256 carry may_alias, which gcc reports as dropped whenever they are template arguments.
+// Scoped to this header, files instantiating templates on them push and pop it themselves.
+#if (COMPILER == COMPILER_GCC) && !defined(__clang__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wignored-attributes"
+#endif
+
+// simd4f
+
+#if SIMD_SSE2
+    typedef __m128 simd4f;
+
+    SIMD_ALWAYS_INLINE simd4f simd4f_load ( const float* ptr ) { return _mm_loadu_ps(ptr); }
+    SIMD_ALWAYS_INLINE void simd_store ( float* ptr, simd4f val ) { _mm_storeu_ps(ptr, val); }
+    SIMD_ALWAYS_INLINE simd4f simd4f_set1 ( float val ) { return _mm_set1_ps(val); }
+    SIMD_ALWAYS_INLINE simd4f simd4f_set ( float a, float b, float c, float d ) { return _mm_setr_ps(a, b, c, d); }
+
+    SIMD_ALWAYS_INLINE simd4f simd_add ( simd4f a, simd4f b ) { return _mm_add_ps(a, b); }
+    SIMD_ALWAYS_INLINE simd4f simd_sub ( simd4f a, simd4f b ) { return _mm_sub_ps(a, b); }
+    SIMD_ALWAYS_INLINE simd4f simd_mul ( simd4f a, simd4f b ) { return _mm_mul_ps(a, b); }
+    SIMD_ALWAYS_INLINE simd4f simd_div ( simd4f a, simd4f b ) { return _mm_div_ps(a, b); }
+    SIMD_ALWAYS_INLINE simd4f simd_min ( simd4f a, simd4f b ) { return _mm_min_ps(a, b); }
+    SIMD_ALWAYS_INLINE simd4f simd_max ( simd4f a, simd4f b ) { return _mm_max_ps(a, b); }
+    SIMD_ALWAYS_INLINE simd4f simd_sqrt ( simd4f a ) { return _mm_sqrt_ps(a); }
+
+    // fastRsqrt per lane, 12 bit estimate and one Newton step.
+    SIMD_ALWAYS_INLINE simd4f simd_rsqrt ( simd4f a ) {
+        simd4f est = _mm_rsqrt_ps(a);
+        simd4f halfA = _mm_mul_ps(_mm_set1_ps(0.5F), a);
+        return _mm_mul_ps(est, _mm_sub_ps(_mm_set1_ps(1.5F), _mm_mul_ps(halfA, _mm_mul_ps(est, est))));
+    }
+
+    // a * b + c
+    #if SIMD_FMA
+        SIMD_ALWAYS_INLINE simd4f simd_madd ( simd4f a, simd4f b, simd4f c ) { return _mm_fmadd_ps(a, b, c); }
+    #else
+        SIMD_ALWAYS_INLINE simd4f simd_madd ( simd4f a, simd4f b, simd4f c ) { return _mm_add_ps(_mm_mul_ps(a, b), c); }
+    #endif
+
+#elif SIMD_NEON
+    typedef float32x4_t simd4f;
+
+    SIMD_ALWAYS_INLINE simd4f simd4f_load ( const float* ptr ) { return vld1q_f32(ptr); }
+    SIMD_ALWAYS_INLINE void simd_store ( float* ptr, simd4f val ) { vst1q_f32(ptr, val); }
+    SIMD_ALWAYS_INLINE simd4f simd4f_set1 ( float val ) { return vdupq_n_f32(val); }
+    SIMD_ALWAYS_INLINE simd4f simd4f_set ( float a, float b, float c, float d ) {
+        float vals[4] = { a, b, c, d };
+        return vld1q_f32(vals);
+    }
+
+    SIMD_ALWAYS_INLINE simd4f simd_add ( simd4f a, simd4f b ) { return vaddq_f32(a, b); }
+    SIMD_ALWAYS_INLINE simd4f simd_sub ( simd4f a, simd4f b ) { return vsubq_f32(a, b); }
+    SIMD_ALWAYS_INLINE simd4f simd_mul ( simd4f a, simd4f b ) { return vmulq_f32(a, b); }
+    SIMD_ALWAYS_INLINE simd4f simd_min ( simd4f a, simd4f b ) { return vminq_f32(a, b); }
+    SIMD_ALWAYS_INLINE simd4f simd_max ( simd4f a, simd4f b ) { return vmaxq_f32(a, b); }
+    SIMD_ALWAYS_INLINE simd4f simd_madd ( simd4f a, simd4f b, simd4f c ) { return vmlaq_f32(c, a, b); }
+
+    // fastRsqrt per lane, 8 bit estimate and two Newton steps.
+    SIMD_ALWAYS_INLINE simd4f simd_rsqrt ( simd4f a ) {
+        simd4f est = vrsqrteq_f32(a);
+        est = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, est), est), est);
+        return vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, est), est), est);
+    }
+
+    #if DETECT_ARCH_AARCH64
+        SIMD_ALWAYS_INLINE simd4f simd_div ( simd4f a, simd4f b ) { return vdivq_f32(a, b); }
+        SIMD_ALWAYS_INLINE simd4f simd_sqrt ( simd4f a ) { return vsqrtq_f32(a); }
+    #else
+        // ARMv7 has neither, two Newton steps are within an ulp or two.
+        SIMD_ALWAYS_INLINE simd4f simd_div ( simd4f a, simd4f b ) {
+            simd4f inv = vrecpeq_f32(b);
+            inv = vmulq_f32(vrecpsq_f32(b, inv), inv);
+            inv = vmulq_f32(vrecpsq_f32(b, inv), inv);
+            return vmulq_f32(a, inv);
+        }
+
+        SIMD_ALWAYS_INLINE simd4f simd_sqrt ( simd4f a ) {
+            simd4f inv = vrsqrteq_f32(a);
+            inv = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, inv), inv), inv);
+            inv = vmulq_f32(vrsqrtsq_f32(vmulq_f32(a, inv), inv), inv);
+            return vbslq_f32(vceqq_f32(a, vdupq_n_f32(0)), a, vmulq_f32(a, inv));
+        }
+    #endif
+
+#else
+    struct simd4f { float v[4]; };
+
+    #define SIMD_SCALAR_OP(expr) simd4f r; for ( int i = 0; i < 4; ++i ) { r.v[i] = (expr); } return r;
+
+    inline simd4f simd4f_load ( const float* ptr ) { SIMD_SCALAR_OP(ptr[i]) }
+    inline void simd_store ( float* ptr, simd4f val ) { for ( int i = 0; i < 4; ++i ) { ptr[i] = val.v[i]; } }
+    inline simd4f simd4f_set1 ( float val ) { SIMD_SCALAR_OP(val) }
+    inline simd4f simd4f_set ( float a, float b, float c, float d ) { return simd4f{ { a, b, c, d } }; }
+
+    inline simd4f simd_add ( simd4f a, simd4f b ) { SIMD_SCALAR_OP(a.v[i] + b.v[i]) }
+    inline simd4f simd_sub ( simd4f a, simd4f b ) { SIMD_SCALAR_OP(a.v[i] - b.v[i]) }
+    inline simd4f simd_mul ( simd4f a, simd4f b ) { SIMD_SCALAR_OP(a.v[i] * b.v[i]) }
+    inline simd4f simd_div ( simd4f a, simd4f b ) { SIMD_SCALAR_OP(a.v[i] / b.v[i]) }
+    inline simd4f simd_min ( simd4f a, simd4f b ) { SIMD_SCALAR_OP(a.v[i] < b.v[i] ? a.v[i] : b.v[i]) }
+    inline simd4f simd_max ( simd4f a, simd4f b ) { SIMD_SCALAR_OP(a.v[i] > b.v[i] ? a.v[i] : b.v[i]) }
+    inline simd4f simd_sqrt ( simd4f a ) { SIMD_SCALAR_OP(sqrtf(a.v[i])) }
+    inline simd4f simd_rsqrt ( simd4f a ) { SIMD_SCALAR_OP(fastRsqrt(a.v[i])) }
+    inline simd4f simd_madd ( simd4f a, simd4f b, simd4f c ) { SIMD_SCALAR_OP(a.v[i] * b.v[i] + c.v[i]) }
+
+    #undef SIMD_SCALAR_OP
+#endif
+
+// simd4i, 4 x int32. Shifts are logical, simd_toInt truncates toward zero and simd_toIntRound
+// rounds to nearest even (ARMv7 NEON rounds ties away from zero). Integer comparisons are
+// signed and, like the float ones, return all bits set in lanes where they hold.
+
+#if SIMD_SSE2
+    typedef __m128i simd4i;
+
+    SIMD_ALWAYS_INLINE simd4i simd4i_load ( const int32_t* ptr ) { return _mm_loadu_si128(reinterpret_cast<const __m128i*>(ptr)); }
+    SIMD_ALWAYS_INLINE void simd_store ( int32_t* ptr, simd4i val ) { _mm_storeu_si128(reinterpret_cast<__m128i*>(ptr), val); }
+    SIMD_ALWAYS_INLINE simd4i simd4i_set1 ( int32_t val ) { return _mm_set1_epi32(val); }
+    SIMD_ALWAYS_INLINE simd4i simd4i_set ( int32_t a, int32_t b, int32_t c, int32_t d ) { return _mm_setr_epi32(a, b, c, d); }
+
+    SIMD_ALWAYS_INLINE simd4i simd_and ( simd4i a, simd4i b ) { return _mm_and_si128(a, b); }
+    SIMD_ALWAYS_INLINE simd4i simd_or ( simd4i a, simd4i b ) { return _mm_or_si128(a, b); }
+    template<int Bits> SIMD_ALWAYS_INLINE simd4i simd_shl ( simd4i a ) { return _mm_slli_epi32(a, Bits); }
+    template<int Bits> SIMD_ALWAYS_INLINE simd4i simd_shr ( simd4i a ) { return _mm_srli_epi32(a, Bits); }
+
+    SIMD_ALWAYS_INLINE simd4f simd_toFloat ( simd4i a ) { return _mm_cvtepi32_ps(a); }
+    SIMD_ALWAYS_INLINE simd4i simd_toInt ( simd4f a ) { return _mm_cvttps_epi32(a); }
+    SIMD_ALWAYS_INLINE simd4i simd_toIntRound ( simd4f a ) { return _mm_cvtps_epi32(a); }
+
+    SIMD_ALWAYS_INLINE simd4i simd_add ( simd4i a, simd4i b ) { return _mm_add_epi32(a, b); }
+    SIMD_ALWAYS_INLINE simd4i simd_sub ( simd4i a, simd4i b ) { return _mm_sub_epi32(a, b); }
+    SIMD_ALWAYS_INLINE simd4i simd_xor ( simd4i a, simd4i b ) { return _mm_xor_si128(a, b); }
+    SIMD_ALWAYS_INLINE simd4i simd_cmpeq ( simd4i a, simd4i b ) { return _mm_cmpeq_epi32(a, b); }
+    SIMD_ALWAYS_INLINE simd4i simd_cmpgt ( simd4i a, simd4i b ) { return _mm_cmpgt_epi32(a, b); }
+    SIMD_ALWAYS_INLINE simd4i simd_select ( simd4i mask, simd4i a, simd4i b ) {
+        return _mm_or_si128(_mm_and_si128(mask, a), _mm_andnot_si128(mask, b));
+    }
+
+    // Bit casts.
+    SIMD_ALWAYS_INLINE simd4f simd_asFloat ( simd4i a ) { return _mm_castsi128_ps(a); }
+    SIMD_ALWAYS_INLINE simd4i simd_asInt ( simd4f a ) { return _mm_castps_si128(a); }
+
+#elif SIMD_NEON
+    typedef int32x4_t simd4i;
+
+    SIMD_ALWAYS_INLINE simd4i simd4i_load ( const int32_t* ptr ) { return vld1q_s32(ptr); }
+    SIMD_ALWAYS_INLINE void simd_store ( int32_t* ptr, simd4i val ) { vst1q_s32(ptr, val); }
+    SIMD_ALWAYS_INLINE simd4i simd4i_set1 ( int32_t val ) { return vdupq_n_s32(val); }
+    SIMD_ALWAYS_INLINE simd4i simd4i_set ( int32_t a, int32_t b, int32_t c, int32_t d ) {
+        int32_t lanes[4] = { a, b, c, d };
+        return vld1q_s32(lanes);
+    }
+
+    SIMD_ALWAYS_INLINE simd4i simd_and ( simd4i a, simd4i b ) { return vandq_s32(a, b); }
+    SIMD_ALWAYS_INLINE simd4i simd_or ( simd4i a, simd4i b ) { return vorrq_s32(a, b); }
+    template<int Bits> SIMD_ALWAYS_INLINE simd4i simd_shl ( simd4i a ) { return vshlq_n_s32(a, Bits); }
+    template<int Bits> SIMD_ALWAYS_INLINE simd4i simd_shr ( simd4i a ) {
+        if constexpr ( Bits == 0 ) { return a; } // vshrq_n takes 1 to 32
+        else { return vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(a), Bits)); }
+    }
+
+    SIMD_ALWAYS_INLINE simd4f simd_toFloat ( simd4i a ) { return vcvtq_f32_s32(a); }
+    SIMD_ALWAYS_INLINE simd4i simd_toInt ( simd4f a ) { return vcvtq_s32_f32(a); }
+    SIMD_ALWAYS_INLINE simd4i simd_toIntRound ( simd4f a ) {
+    #if DETECT_ARCH_AARCH64
+        return vcvtnq_s32_f32(a);
+    #else
+        return vcvtq_s32_f32(vaddq_f32(a, vbslq_f32(vcltq_f32(a, vdupq_n_f32(0)), vdupq_n_f32(-0.5F), vdupq_n_f32(0.5F))));
+    #endif
+    }
+
+    SIMD_ALWAYS_INLINE simd4i simd_add ( simd4i a, simd4i b ) { return vaddq_s32(a, b); }
+    SIMD_ALWAYS_INLINE simd4i simd_sub ( simd4i a, simd4i b ) { return vsubq_s32(a, b); }
+    SIMD_ALWAYS_INLINE simd4i simd_xor ( simd4i a, simd4i b ) { return veorq_s32(a, b); }
+    SIMD_ALWAYS_INLINE simd4i simd_cmpeq ( simd4i a, simd4i b ) { return vreinterpretq_s32_u32(vceqq_s32(a, b)); }
+    SIMD_ALWAYS_INLINE simd4i simd_cmpgt ( simd4i a, simd4i b ) { return vreinterpretq_s32_u32(vcgtq_s32(a, b)); }
+    SIMD_ALWAYS_INLINE simd4i simd_select ( simd4i mask, simd4i a, simd4i b ) {
+        return vbslq_s32(vreinterpretq_u32_s32(mask), a, b);
+    }
+
+    SIMD_ALWAYS_INLINE simd4f simd_asFloat ( simd4i a ) { return vreinterpretq_f32_s32(a); }
+    SIMD_ALWAYS_INLINE simd4i simd_asInt ( simd4f a ) { return vreinterpretq_s32_f32(a); }
+
+#else
+    struct simd4i { int32_t v[4]; };
+
+    #define SIMD_SCALAR_OP(type, expr) type r; for ( int i = 0; i < 4; ++i ) { r.v[i] = (expr); } return r;
+
+    inline simd4i simd4i_load ( const int32_t* ptr ) { SIMD_SCALAR_OP(simd4i, ptr[i]) }
+    inline void simd_store ( int32_t* ptr, simd4i val ) { for ( int i = 0; i < 4; ++i ) { ptr[i] = val.v[i]; } }
+    inline simd4i simd4i_set1 ( int32_t val ) { SIMD_SCALAR_OP(simd4i, val) }
+    inline simd4i simd4i_set ( int32_t a, int32_t b, int32_t c, int32_t d ) { return simd4i{ { a, b, c, d } }; }
+
+    inline simd4i simd_and ( simd4i a, simd4i b ) { SIMD_SCALAR_OP(simd4i, a.v[i] & b.v[i]) }
+    inline simd4i simd_or ( simd4i a, simd4i b ) { SIMD_SCALAR_OP(simd4i, a.v[i] | b.v[i]) }
+    template<int Bits> inline simd4i simd_shl ( simd4i a ) {
+        SIMD_SCALAR_OP(simd4i, static_cast<int32_t>(static_cast<uint32_t>(a.v[i]) << Bits))
+    }
+    template<int Bits> inline simd4i simd_shr ( simd4i a ) {
+        SIMD_SCALAR_OP(simd4i, static_cast<int32_t>(static_cast<uint32_t>(a.v[i]) >> Bits))
+    }
+
+    inline simd4f simd_toFloat ( simd4i a ) { SIMD_SCALAR_OP(simd4f, static_cast<float>(a.v[i])) }
+    inline simd4i simd_toInt ( simd4f a ) { SIMD_SCALAR_OP(simd4i, static_cast<int32_t>(a.v[i])) }
+    inline simd4i simd_toIntRound ( simd4f a ) { SIMD_SCALAR_OP(simd4i, static_cast<int32_t>(std::nearbyint(a.v[i]))) }
+
+    // wrapping like the vector units, signed overflow would be UB here.
+    inline simd4i simd_add ( simd4i a, simd4i b ) {
+        SIMD_SCALAR_OP(simd4i, static_cast<int32_t>(static_cast<uint32_t>(a.v[i]) + static_cast<uint32_t>(b.v[i])))
+    }
+    inline simd4i simd_sub ( simd4i a, simd4i b ) {
+        SIMD_SCALAR_OP(simd4i, static_cast<int32_t>(static_cast<uint32_t>(a.v[i]) - static_cast<uint32_t>(b.v[i])))
+    }
+    inline simd4i simd_xor ( simd4i a, simd4i b ) { SIMD_SCALAR_OP(simd4i, a.v[i] ^ b.v[i]) }
+    inline simd4i simd_cmpeq ( simd4i a, simd4i b ) { SIMD_SCALAR_OP(simd4i, a.v[i] == b.v[i] ? -1 : 0) }
+    inline simd4i simd_cmpgt ( simd4i a, simd4i b ) { SIMD_SCALAR_OP(simd4i, a.v[i] > b.v[i] ? -1 : 0) }
+    inline simd4i simd_select ( simd4i mask, simd4i a, simd4i b ) { SIMD_SCALAR_OP(simd4i, (mask.v[i] & a.v[i]) | (~mask.v[i] & b.v[i])) }
+
+    inline simd4f simd_asFloat ( simd4i a ) { simd4f r; memcpy(r.v, a.v, sizeof(r.v)); return r; }
+    inline simd4i simd_asInt ( simd4f a ) { simd4i r; memcpy(r.v, a.v, sizeof(r.v)); return r; }
+
+    #undef SIMD_SCALAR_OP
+#endif
+
+// Comparisons return a mask in the same type, all bits set in lanes where they hold.
+// simd_mask packs the lane signs into the low bits of an int, lane 0 first.
+
+#if SIMD_SSE2
+    SIMD_ALWAYS_INLINE simd4f simd_cmplt ( simd4f a, simd4f b ) { return _mm_cmplt_ps(a, b); }
+    SIMD_ALWAYS_INLINE simd4f simd_cmple ( simd4f a, simd4f b ) { return _mm_cmple_ps(a, b); }
+    SIMD_ALWAYS_INLINE simd4f simd_cmpgt ( simd4f a, simd4f b ) { return _mm_cmpgt_ps(a, b); }
+    SIMD_ALWAYS_INLINE simd4f simd_cmpge ( simd4f a, simd4f b ) { return _mm_cmpge_ps(a, b); }
+
+    SIMD_ALWAYS_INLINE simd4f simd_and ( simd4f a, simd4f b ) { return _mm_and_ps(a, b); }
+    SIMD_ALWAYS_INLINE simd4f simd_or ( simd4f a, simd4f b ) { return _mm_or_ps(a, b); }
+
+    // mask ? a : b per lane.
+    SIMD_ALWAYS_INLINE simd4f simd_select ( simd4f mask, simd4f a, simd4f b ) {
+        return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b));
+    }
+
+    SIMD_ALWAYS_INLINE int simd_mask ( simd4f mask ) { return _mm_movemask_ps(mask); }
+
+#elif SIMD_NEON
+    SIMD_ALWAYS_INLINE simd4f simd_cmplt ( simd4f a, simd4f b ) { return vreinterpretq_f32_u32(vcltq_f32(a, b)); }
+    SIMD_ALWAYS_INLINE simd4f simd_cmple ( simd4f a, simd4f b ) { return vreinterpretq_f32_u32(vcleq_f32(a, b)); }
+    SIMD_ALWAYS_INLINE simd4f simd_cmpgt ( simd4f a, simd4f b ) { return vreinterpretq_f32_u32(vcgtq_f32(a, b)); }
+    SIMD_ALWAYS_INLINE simd4f simd_cmpge ( simd4f a, simd4f b ) { return vreinterpretq_f32_u32(vcgeq_f32(a, b)); }
+
+    SIMD_ALWAYS_INLINE simd4f simd_and ( simd4f a, simd4f b ) {
+        return vreinterpretq_f32_u32(vandq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+    }
+    SIMD_ALWAYS_INLINE simd4f simd_or ( simd4f a, simd4f b ) {
+        return vreinterpretq_f32_u32(vorrq_u32(vreinterpretq_u32_f32(a), vreinterpretq_u32_f32(b)));
+    }
+
+    SIMD_ALWAYS_INLINE simd4f simd_select ( simd4f mask, simd4f a, simd4f b ) {
+        return vbslq_f32(vreinterpretq_u32_f32(mask), a, b);
+    }
+
+    SIMD_ALWAYS_INLINE int simd_mask ( simd4f mask ) {
+        static const int32_t shifts[4] = { 0, 1, 2, 3 };
+        uint32x4_t bits = vshlq_u32(vshrq_n_u32(vreinterpretq_u32_f32(mask), 31), vld1q_s32(shifts));
+    #if DETECT_ARCH_AARCH64
+        return static_cast<int>(vaddvq_u32(bits));
+    #else
+        uint32x2_t sum = vpadd_u32(vget_low_u32(bits), vget_high_u32(bits));
+        return static_cast<int>(vget_lane_u32(vpadd_u32(sum, sum), 0));
+    #endif
+    }
+
+#else
+    // Scalar masks hold the all-ones bit pattern (a NaN) or 0.
+    inline float simd_maskLane ( bool set ) {
+        uint32_t bits = set ? 0xFFFFFFFFu : 0;
+        float lane;
+        memcpy(&lane, &bits, sizeof(lane));
+        return lane;
+    }
+
+    inline uint32_t simd_laneBits ( float lane ) {
+        uint32_t bits;
+        memcpy(&bits, &lane, sizeof(bits));
+        return bits;
+    }
+
+    #define SIMD_SCALAR_OP(expr) simd4f r; for ( int i = 0; i < 4; ++i ) { r.v[i] = (expr); } return r;
+
+    inline simd4f simd_cmplt ( simd4f a, simd4f b ) { SIMD_SCALAR_OP(simd_maskLane(a.v[i] < b.v[i])) }
+    inline simd4f simd_cmple ( simd4f a, simd4f b ) { SIMD_SCALAR_OP(simd_maskLane(a.v[i] <= b.v[i])) }
+    inline simd4f simd_cmpgt ( simd4f a, simd4f b ) { SIMD_SCALAR_OP(simd_maskLane(a.v[i] > b.v[i])) }
+    inline simd4f simd_cmpge ( simd4f a, simd4f b ) { SIMD_SCALAR_OP(simd_maskLane(a.v[i] >= b.v[i])) }
+
+    inline simd4f simd_and ( simd4f a, simd4f b ) {
+        SIMD_SCALAR_OP(simd_maskLane(simd_laneBits(a.v[i]) != 0 && simd_laneBits(b.v[i]) != 0))
+    }
+    inline simd4f simd_or ( simd4f a, simd4f b ) {
+        SIMD_SCALAR_OP(simd_maskLane(simd_laneBits(a.v[i]) != 0 || simd_laneBits(b.v[i]) != 0))
+    }
+
+    inline simd4f simd_select ( simd4f mask, simd4f a, simd4f b ) {
+        SIMD_SCALAR_OP(simd_laneBits(mask.v[i]) != 0 ? a.v[i] : b.v[i])
+    }
+
+    inline int simd_mask ( simd4f mask ) {
+        int bits = 0;
+        for ( int i = 0; i < 4; ++i ) { bits |= static_cast<int>(simd_laneBits(mask.v[i]) >> 31) << i; }
+        return bits;
+    }
+
+    #undef SIMD_SCALAR_OP
+#endif
+
+// simd8f, native with AVX and a pair of simd4f otherwise. simdf is the native width.
+
+#if SIMD_AVX
+    typedef __m256 simd8f;
+
+    SIMD_ALWAYS_INLINE simd8f simd8f_load ( const float* ptr ) { return _mm256_loadu_ps(ptr); }
+    SIMD_ALWAYS_INLINE void simd_store ( float* ptr, simd8f val ) { _mm256_storeu_ps(ptr, val); }
+    SIMD_ALWAYS_INLINE simd8f simd8f_set1 ( float val ) { return _mm256_set1_ps(val); }
+
+    SIMD_ALWAYS_INLINE simd8f simd8f_combine ( simd4f lo, simd4f hi ) {
+        return _mm256_insertf128_ps(_mm256_castps128_ps256(lo), hi, 1);
+    }
+
+    SIMD_ALWAYS_INLINE simd4f simd_lo ( simd8f val ) { return _mm256_castps256_ps128(val); }
+    SIMD_ALWAYS_INLINE simd4f simd_hi ( simd8f val ) { return _mm256_extractf128_ps(val, 1); }
+
+    SIMD_ALWAYS_INLINE simd8f simd_add ( simd8f a, simd8f b ) { return _mm256_add_ps(a, b); }
+    SIMD_ALWAYS_INLINE simd8f simd_sub ( simd8f a, simd8f b ) { return _mm256_sub_ps(a, b); }
+    SIMD_ALWAYS_INLINE simd8f simd_mul ( simd8f a, simd8f b ) { return _mm256_mul_ps(a, b); }
+    SIMD_ALWAYS_INLINE simd8f simd_div ( simd8f a, simd8f b ) { return _mm256_div_ps(a, b); }
+    SIMD_ALWAYS_INLINE simd8f simd_min ( simd8f a, simd8f b ) { return _mm256_min_ps(a, b); }
+    SIMD_ALWAYS_INLINE simd8f simd_max ( simd8f a, simd8f b ) { return _mm256_max_ps(a, b); }
+    SIMD_ALWAYS_INLINE simd8f simd_sqrt ( simd8f a ) { return _mm256_sqrt_ps(a); }
+
+    SIMD_ALWAYS_INLINE simd8f simd_rsqrt ( simd8f a ) {
+        simd8f est = _mm256_rsqrt_ps(a);
+        simd8f halfA = _mm256_mul_ps(_mm256_set1_ps(0.5F), a);
+        return _mm256_mul_ps(est, _mm256_sub_ps(_mm256_set1_ps(1.5F), _mm256_mul_ps(halfA, _mm256_mul_ps(est, est))));
+    }
+
+    SIMD_ALWAYS_INLINE simd8f simd_cmplt ( simd8f a, simd8f b ) { return _mm256_cmp_ps(a, b, _CMP_LT_OQ); }
+    SIMD_ALWAYS_INLINE simd8f simd_cmple ( simd8f a, simd8f b ) { return _mm256_cmp_ps(a, b, _CMP_LE_OQ); }
+    SIMD_ALWAYS_INLINE simd8f simd_cmpgt ( simd8f a, simd8f b ) { return _mm256_cmp_ps(a, b, _CMP_GT_OQ); }
+    SIMD_ALWAYS_INLINE simd8f simd_cmpge ( simd8f a, simd8f b ) { return _mm256_cmp_ps(a, b, _CMP_GE_OQ); }
+    SIMD_ALWAYS_INLINE simd8f simd_and ( simd8f a, simd8f b ) { return _mm256_and_ps(a, b); }
+    SIMD_ALWAYS_INLINE simd8f simd_or ( simd8f a, simd8f b ) { return _mm256_or_ps(a, b); }
+    SIMD_ALWAYS_INLINE simd8f simd_select ( simd8f mask, simd8f a, simd8f b ) { return _mm256_blendv_ps(b, a, mask); }
+    SIMD_ALWAYS_INLINE int simd_mask ( simd8f mask ) { return _mm256_movemask_ps(mask); }
+
+    #if SIMD_FMA
+        SIMD_ALWAYS_INLINE simd8f simd_madd ( simd8f a, simd8f b, simd8f c ) { return _mm256_fmadd_ps(a, b, c); }
+    #else
+        SIMD_ALWAYS_INLINE simd8f simd_madd ( simd8f a, simd8f b, simd8f c ) { return _mm256_add_ps(_mm256_mul_ps(a, b), c); }
+    #endif
+
+    typedef simd8f simdf;
+    SIMD_ALWAYS_INLINE simdf simdf_load ( const float* ptr ) { return simd8f_load(ptr); }
+    SIMD_ALWAYS_INLINE simdf simdf_set1 ( float val ) { return simd8f_set1(val); }
+#else
+    struct simd8f { simd4f lo, hi; };
+
+    SIMD_ALWAYS_INLINE simd8f simd8f_load ( const float* ptr ) { return { simd4f_load(ptr), simd4f_load(ptr + 4) }; }
+    SIMD_ALWAYS_INLINE void simd_store ( float* ptr, simd8f val ) { simd_store(ptr, val.lo); simd_store(ptr + 4, val.hi); }
+    SIMD_ALWAYS_INLINE simd8f simd8f_set1 ( float val ) { return { simd4f_set1(val), simd4f_set1(val) }; }
+    SIMD_ALWAYS_INLINE simd8f simd8f_combine ( simd4f lo, simd4f hi ) { return { lo, hi }; }
+    SIMD_ALWAYS_INLINE simd4f simd_lo ( simd8f val ) { return val.lo; }
+    SIMD_ALWAYS_INLINE simd4f simd_hi ( simd8f val ) { return val.hi; }
+
+    SIMD_ALWAYS_INLINE simd8f simd_add ( simd8f a, simd8f b ) { return { simd_add(a.lo, b.lo), simd_add(a.hi, b.hi) }; }
+    SIMD_ALWAYS_INLINE simd8f simd_sub ( simd8f a, simd8f b ) { return { simd_sub(a.lo, b.lo), simd_sub(a.hi, b.hi) }; }
+    SIMD_ALWAYS_INLINE simd8f simd_mul ( simd8f a, simd8f b ) { return { simd_mul(a.lo, b.lo), simd_mul(a.hi, b.hi) }; }
+    SIMD_ALWAYS_INLINE simd8f simd_div ( simd8f a, simd8f b ) { return { simd_div(a.lo, b.lo), simd_div(a.hi, b.hi) }; }
+    SIMD_ALWAYS_INLINE simd8f simd_min ( simd8f a, simd8f b ) { return { simd_min(a.lo, b.lo), simd_min(a.hi, b.hi) }; }
+    SIMD_ALWAYS_INLINE simd8f simd_max ( simd8f a, simd8f b ) { return { simd_max(a.lo, b.lo), simd_max(a.hi, b.hi) }; }
+    SIMD_ALWAYS_INLINE simd8f simd_sqrt ( simd8f a ) { return { simd_sqrt(a.lo), simd_sqrt(a.hi) }; }
+    SIMD_ALWAYS_INLINE simd8f simd_rsqrt ( simd8f a ) { return { simd_rsqrt(a.lo), simd_rsqrt(a.hi) }; }
+
+    SIMD_ALWAYS_INLINE simd8f simd_cmplt ( simd8f a, simd8f b ) { return { simd_cmplt(a.lo, b.lo), simd_cmplt(a.hi, b.hi) }; }
+    SIMD_ALWAYS_INLINE simd8f simd_cmple ( simd8f a, simd8f b ) { return { simd_cmple(a.lo, b.lo), simd_cmple(a.hi, b.hi) }; }
+    SIMD_ALWAYS_INLINE simd8f simd_cmpgt ( simd8f a, simd8f b ) { return { simd_cmpgt(a.lo, b.lo), simd_cmpgt(a.hi, b.hi) }; }
+    SIMD_ALWAYS_INLINE simd8f simd_cmpge ( simd8f a, simd8f b ) { return { simd_cmpge(a.lo, b.lo), simd_cmpge(a.hi, b.hi) }; }
+    SIMD_ALWAYS_INLINE simd8f simd_and ( simd8f a, simd8f b ) { return { simd_and(a.lo, b.lo), simd_and(a.hi, b.hi) }; }
+    SIMD_ALWAYS_INLINE simd8f simd_or ( simd8f a, simd8f b ) { return { simd_or(a.lo, b.lo), simd_or(a.hi, b.hi) }; }
+    SIMD_ALWAYS_INLINE simd8f simd_select ( simd8f mask, simd8f a, simd8f b ) {
+        return { simd_select(mask.lo, a.lo, b.lo), simd_select(mask.hi, a.hi, b.hi) };
+    }
+    SIMD_ALWAYS_INLINE int simd_mask ( simd8f mask ) { return simd_mask(mask.lo) | (simd_mask(mask.hi) << 4); }
+    SIMD_ALWAYS_INLINE simd8f simd_madd ( simd8f a, simd8f b, simd8f c ) {
+        return { simd_madd(a.lo, b.lo, c.lo), simd_madd(a.hi, b.hi, c.hi) };
+    }
+
+    typedef simd4f simdf;
+    SIMD_ALWAYS_INLINE simdf simdf_load ( const float* ptr ) { return simd4f_load(ptr); }
+    SIMD_ALWAYS_INLINE simdf simdf_set1 ( float val ) { return simd4f_set1(val); }
+#endif
+
+// Broadcasts one lane to every lane.
+template<int Lane>
+SIMD_ALWAYS_INLINE simd4f simd_splat ( simd4f val ) {
+#if SIMD_SSE2
+    return _mm_shuffle_ps(val, val, _MM_SHUFFLE(Lane, Lane, Lane, Lane));
+#elif SIMD_NEON && DETECT_ARCH_AARCH64
+    return vdupq_laneq_f32(val, Lane);
+#elif SIMD_NEON
+    return vdupq_n_f32(vgetq_lane_f32(val, Lane));
+#else
+    return simd4f_set1(val.v[Lane]);
+#endif
+}
+
+// Deinterleaves 4 packed xyz triplets (12 floats) into one register per component.
+SIMD_ALWAYS_INLINE void simd_loadXYZ ( const float* ptr, simd4f& x, simd4f& y, simd4f& z ) {
+#if SIMD_SSE2
+    simd4f a0 = _mm_loadu_ps(ptr), a1 = _mm_loadu_ps(ptr + 4), a2 = _mm_loadu_ps(ptr + 8);
+
+    x = _mm_shuffle_ps(a0, _mm_shuffle_ps(a1, a2, _MM_SHUFFLE(1, 1, 2, 2)), _MM_SHUFFLE(2, 0, 3, 0));
+    y = _mm_shuffle_ps(_mm_shuffle_ps(a0, a1, _MM_SHUFFLE(0, 0, 1, 1)),
+            _mm_shuffle_ps(a1, a2, _MM_SHUFFLE(2, 2, 3, 3)), _MM_SHUFFLE(2, 0, 2, 0));
+    z = _mm_shuffle_ps(_mm_shuffle_ps(a0, a1, _MM_SHUFFLE(1, 1, 2, 2)), a2, _MM_SHUFFLE(3, 0, 2, 0));
+#elif SIMD_NEON
+    float32x4x3_t v = vld3q_f32(ptr);
+    x = v.val[0]; y = v.val[1]; z = v.val[2];
+#else
+    x = simd4f_set(ptr[0], ptr[3], ptr[6], ptr[9]);
+    y = simd4f_set(ptr[1], ptr[4], ptr[7], ptr[10]);
+    z = simd4f_set(ptr[2], ptr[5], ptr[8], ptr[11]);
+#endif
+}
+
+// Inverse of simd_loadXYZ.
+SIMD_ALWAYS_INLINE void simd_storeXYZ ( float* ptr, simd4f x, simd4f y, simd4f z ) {
+#if SIMD_SSE2
+    simd4f xyLo = _mm_unpacklo_ps(x, y), xyHi = _mm_unpackhi_ps(x, y);
+    simd4f t;
+
+    _mm_storeu_ps(ptr, _mm_shuffle_ps(xyLo, _mm_shuffle_ps(z, x, _MM_SHUFFLE(1, 1, 0, 0)), _MM_SHUFFLE(2, 0, 1, 0)));
+    _mm_storeu_ps(ptr + 4, _mm_shuffle_ps(_mm_shuffle_ps(y, z, _MM_SHUFFLE(1, 1, 1, 1)), xyHi, _MM_SHUFFLE(1, 0, 2, 0)));
+
+    t = _mm_shuffle_ps(z, xyHi, _MM_SHUFFLE(3, 2, 3, 2));
+    _mm_storeu_ps(ptr + 8, _mm_shuffle_ps(t, t, _MM_SHUFFLE(1, 3, 2, 0)));
+#elif SIMD_NEON
+    float32x4x3_t v = { { x, y, z } };
+    vst3q_f32(ptr, v);
+#else
+    for ( int i = 0; i < 4; ++i ) {
+        ptr[i * 3] = x.v[i]; ptr[i * 3 + 1] = y.v[i]; ptr[i * 3 + 2] = z.v[i];
+    }
+#endif
+}
+
+// Deinterleaves 4 packed xy pairs (8 floats).
+SIMD_ALWAYS_INLINE void simd_loadXY ( const float* ptr, simd4f& x, simd4f& y ) {
+#if SIMD_SSE2
+    simd4f a0 = _mm_loadu_ps(ptr), a1 = _mm_loadu_ps(ptr + 4);
+    x = _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(2, 0, 2, 0));
+    y = _mm_shuffle_ps(a0, a1, _MM_SHUFFLE(3, 1, 3, 1));
+#elif SIMD_NEON
+    float32x4x2_t v = vld2q_f32(ptr);
+    x = v.val[0]; y = v.val[1];
+#else
+    x = simd4f_set(ptr[0], ptr[2], ptr[4], ptr[6]);
+    y = simd4f_set(ptr[1], ptr[3], ptr[5], ptr[7]);
+#endif
+}
+
+// Inverse of simd_loadXY.
+SIMD_ALWAYS_INLINE void simd_storeXY ( float* ptr, simd4f x, simd4f y ) {
+#if SIMD_SSE2
+    _mm_storeu_ps(ptr, _mm_unpacklo_ps(x, y));
+    _mm_storeu_ps(ptr + 4, _mm_unpackhi_ps(x, y));
+#elif SIMD_NEON
+    float32x4x2_t v = { { x, y } };
+    vst2q_f32(ptr, v);
+#else
+    for ( int i = 0; i < 4; ++i ) {
+        ptr[i * 2] = x.v[i]; ptr[i * 2 + 1] = y.v[i];
+    }
+#endif
+}
+
+// Transposes 4 packed xyzw quads (16 floats) into one register per component.
+SIMD_ALWAYS_INLINE void simd_loadXYZW ( const float* ptr, simd4f& x, simd4f& y, simd4f& z, simd4f& w ) {
+#if SIMD_SSE2
+    x = _mm_loadu_ps(ptr); y = _mm_loadu_ps(ptr + 4); z = _mm_loadu_ps(ptr + 8); w = _mm_loadu_ps(ptr + 12);
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+#elif SIMD_NEON
+    float32x4x4_t v = vld4q_f32(ptr);
+    x = v.val[0]; y = v.val[1]; z = v.val[2]; w = v.val[3];
+#else
+    x = simd4f_set(ptr[0], ptr[4], ptr[8], ptr[12]);
+    y = simd4f_set(ptr[1], ptr[5], ptr[9], ptr[13]);
+    z = simd4f_set(ptr[2], ptr[6], ptr[10], ptr[14]);
+    w = simd4f_set(ptr[3], ptr[7], ptr[11], ptr[15]);
+#endif
+}
+
+// Inverse of simd_loadXYZW.
+SIMD_ALWAYS_INLINE void simd_storeXYZW ( float* ptr, simd4f x, simd4f y, simd4f z, simd4f w ) {
+#if SIMD_SSE2
+    _MM_TRANSPOSE4_PS(x, y, z, w);
+    _mm_storeu_ps(ptr, x); _mm_storeu_ps(ptr + 4, y); _mm_storeu_ps(ptr + 8, z); _mm_storeu_ps(ptr + 12, w);
+#elif SIMD_NEON
+    float32x4x4_t v = { { x, y, z, w } };
+    vst4q_f32(ptr, v);
+#else
+    for ( int i = 0; i < 4; ++i ) {
+        ptr[i * 4] = x.v[i]; ptr[i * 4 + 1] = y.v[i]; ptr[i * 4 + 2] = z.v[i]; ptr[i * 4 + 3] = w.v[i];
+    }
+#endif
+}
+
+// Width-generic helpers, so packet types can be written once for simd4f and simd8f.
+
+template<typename T> T simd_load ( const float* ptr );
+template<> SIMD_ALWAYS_INLINE simd4f simd_load<simd4f> ( const float* ptr ) { return simd4f_load(ptr); }
+template<> SIMD_ALWAYS_INLINE simd8f simd_load<simd8f> ( const float* ptr ) { return simd8f_load(ptr); }
+
+template<typename T> T simd_set1 ( float val );
+template<> SIMD_ALWAYS_INLINE simd4f simd_set1<simd4f> ( float val ) { return simd4f_set1(val); }
+template<> SIMD_ALWAYS_INLINE simd8f simd_set1<simd8f> ( float val ) { return simd8f_set1(val); }
+
+// fastSqrt per lane, lanes below FLT_MIN take the exact sqrt.
+template<typename T>
+SIMD_ALWAYS_INLINE T simd_fastSqrt ( T x ) {
+    T minNormal = simd_set1<T>(FLT_MIN);
+    return simd_select(simd_cmplt(x, minNormal), simd_sqrt(x), simd_mul(x, simd_rsqrt(simd_max(x, minNormal))));
+}
+
+SIMD_ALWAYS_INLINE void simd_loadXYZ ( const float* ptr, simd8f& x, simd8f& y, simd8f& z ) {
+    simd4f xLo, yLo, zLo, xHi, yHi, zHi;
+    simd_loadXYZ(ptr, xLo, yLo, zLo);
+    simd_loadXYZ(ptr + 12, xHi, yHi, zHi);
+
+    x = simd8f_combine(xLo, xHi); y = simd8f_combine(yLo, yHi); z = simd8f_combine(zLo, zHi);
+}
+
+SIMD_ALWAYS_INLINE void simd_storeXYZ ( float* ptr, simd8f x, simd8f y, simd8f z ) {
+    simd_storeXYZ(ptr, simd_lo(x), simd_lo(y), simd_lo(z));
+    simd_storeXYZ(ptr + 12, simd_hi(x), simd_hi(y), simd_hi(z));
+}
+
+#if (COMPILER == COMPILER_GCC) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+#endif
+
+#endif // cplusplus
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "util/math/Aabb3i.h"
+#include "util/math/Morton.h"
+
+// Cubic chunk of 2^SizeLog2 cells per axis stored in Morton order, so a cell's neighbors are
+// mostly in the same or the next cache line instead of a row or a slice away. Cells are addressed
+// by local coordinates or directly by their Morton index, which steps to neighbors with mortonAdd3
+// and no decode.
+template<typename T, int SizeLog2>
+class MortonChunk {
+
+    static_assert(SizeLog2 > 0 && SizeLog2 <= 10, "chunks are at most 1024 cells per axis");
+
+    private:
+        std::vector<T> cells{};
+
+    public:
+        static constexpr int SIZE = 1 << SizeLog2;
+        static constexpr size_t VOLUME = static_cast<size_t>(1) << (3 * SizeLog2);
+
+        MortonChunk ( ) : cells(VOLUME) { }
+        MortonChunk ( const T& fill ) : cells(VOLUME, fill) { }
+
+        static inline uint64_t getIndex ( const Vector3i& local ) noexcept {
+            return encodeMorton3(local);
+        }
+
+        static inline Vector3i getLocal ( uint64_t index ) noexcept {
+            return decodeMorton3(index);
+        }
+
+        static inline bool isInside ( const Vector3i& local ) noexcept {
+            return static_cast<uint32_t>(local.X) < SIZE && static_cast<uint32_t>(local.Y) < SIZE && static_cast<uint32_t>(local.Z) < SIZE;
+        }
+
+        // Index of the cell offset from index by step, an encodeMorton3 of the offset. Offsets
+        // leaving the chunk on any side wrap past VOLUME, which the caller can test for.
+        static inline uint64_t getNeighborIndex ( uint64_t index, uint64_t step ) noexcept {
+            return mortonAdd3(index, step);
+        }
+
+        // Indices of the 3x3x3 block around local, X fastest, Z slowest. Each axis is stepped in
+        // its own dilated bits once, the 27 indices are then just ORs. Cells past the chunk on
+        // any side land past VOLUME.
+        static inline void getNeighborhood ( const Vector3i& local, uint64_t out[27] ) noexcept {
+            uint64_t corner = getIndex(local - Vector3i(1, 1, 1));
+            uint64_t xs[3], ys[3], zs[3];
+            xs[0] = corner & MORTON3_MASK_X; ys[0] = corner & MORTON3_MASK_Y; zs[0] = corner & MORTON3_MASK_Z;
+
+            for ( int i = 1; i < 3; ++i ) {
+                xs[i] = ((xs[i - 1] | ~MORTON3_MASK_X) + 1) & MORTON3_MASK_X;
+                ys[i] = ((ys[i - 1] | ~MORTON3_MASK_Y) + 2) & MORTON3_MASK_Y;
+                zs[i] = ((zs[i - 1] | ~MORTON3_MASK_Z) + 4) & MORTON3_MASK_Z;
+            }
+
+            for ( int z = 0; z < 3; ++z ) {
+                for ( int y = 0; y < 3; ++y ) {
+                    uint64_t yz = ys[y] | zs[z];
+                    out[z * 9 + y * 3 + 0] = xs[0] | yz;
+                    out[z * 9 + y * 3 + 1] = xs[1] | yz;
+                    out[z * 9 + y * 3 + 2] = xs[2] | yz;
+                }
+            }
+        }
+
+        static constexpr Aabb3i getBounds ( ) noexcept {
+            return Aabb3i(Vector3i(0, 0, 0), Vector3i(SIZE, SIZE, SIZE));
+        }
+
+        inline T& operator[] ( uint64_t index ) noexcept {
+            return this->cells[index];
+        }
+
+        inline const T& operator[] ( uint64_t index ) const noexcept {
+            return this->cells[index];
+        }
+
+        inline T& at ( const Vector3i& local ) noexcept {
+            return this->cells[getIndex(local)];
+        }
+
+        inline const T& at ( const Vector3i& local ) const noexcept {
+            return this->cells[getIndex(local)];
+        }
+
+        inline T* data ( ) noexcept {
+            return this->cells.data();
+        }
+
+        inline const T* data ( ) const noexcept {
+            return this->cells.data();
+        }
+
+        // Calls visit(local, cell) over box clipped to the chunk, in storage order when the box
+        // covers the whole chunk and row by row otherwise.
+        template<typename Visit>
+        void forEach ( const Aabb3i& box, Visit visit ) {
+            Aabb3i clipped = box.GetIntersection(getBounds());
+
+            if ( clipped.GetVolume() == static_cast<int64_t>(VOLUME) ) {
+                for ( uint64_t i = 0; i < VOLUME; ++i ) {
+                    visit(getLocal(i), this->cells[i]);
+                }
+                return;
+            }
+
+            for ( int z = clipped.Min.Z; z < clipped.Max.Z; ++z ) {
+                for ( int y = clipped.Min.Y; y < clipped.Max.Y; ++y ) {
+                    for ( int x = clipped.Min.X; x < clipped.Max.X; ++x ) {
+                        Vector3i local(x, y, z);
+                        visit(local, this->cells[getIndex(local)]);
+                    }
+                }
+            }
+        }
+
+};
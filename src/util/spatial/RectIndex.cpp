@@ -0,0 +1,430 @@
+#include <algorithm>
+#include <limits.h>
+#include <bit>
+#include "util/simd.h"
+#include "RectIndex.h"
+
+static constexpr uint32_t NODE_SIZE = 16;
+static constexpr size_t MIN_PENDING_REBUILD = 64;   // pending inserts scanned before the tree is rebuilt
+static constexpr int MAX_TREE_DEPTH = 16;           // 16^8 rects already fit in 8 levels
+
+static inline uint32_t interleaveBits ( uint32_t x ) {
+    x = (x | (x << 8)) & 0x00FF00FF;
+    x = (x | (x << 4)) & 0x0F0F0F0F;
+    x = (x | (x << 2)) & 0x33333333;
+    return (x | (x << 1)) & 0x55555555;
+}
+
+// Distance along a Hilbert curve through a 65536 x 65536 grid, without a branch per level
+// (the prefix scan form from rawrunprojects' "Fast Hilbert curve generation", as Flatbush uses).
+static uint32_t getHilbertIndex ( uint32_t x, uint32_t y ) {
+    uint32_t a = x ^ y, b = 0xFFFF ^ a, c = 0xFFFF ^ (x | y), d = x & (y ^ 0xFFFF);
+    uint32_t A = a | (b >> 1), B = (a >> 1) ^ a;
+    uint32_t C = ((c >> 1) ^ (b & (d >> 1))) ^ c, D = ((a & (c >> 1)) ^ (d >> 1)) ^ d;
+
+    a = A; b = B; c = C; d = D;
+    A = (a & (a >> 2)) ^ (b & (b >> 2));
+    B = (a & (b >> 2)) ^ (b & ((a ^ b) >> 2));
+    C ^= (a & (c >> 2)) ^ (b & (d >> 2));
+    D ^= (b & (c >> 2)) ^ ((a ^ b) & (d >> 2));
+
+    a = A; b = B; c = C; d = D;
+    A = (a & (a >> 4)) ^ (b & (b >> 4));
+    B = (a & (b >> 4)) ^ (b & ((a ^ b) >> 4));
+    C ^= (a & (c >> 4)) ^ (b & (d >> 4));
+    D ^= (b & (c >> 4)) ^ ((a ^ b) & (d >> 4));
+
+    a = A; b = B; c = C; d = D;
+    C ^= (a & (c >> 8)) ^ (b & (d >> 8));
+    D ^= (b & (c >> 8)) ^ ((a ^ b) & (d >> 8));
+
+    a = C ^ (C >> 1);
+    b = D ^ (D >> 1);
+
+    uint32_t i0 = x ^ y, i1 = b | (0xFFFF ^ (i0 | a));
+    return (interleaveBits(i1) << 1) | interleaveBits(i0);
+}
+
+// Child lanes overlapping [minX, maxX) x [minY, maxY) as a 16 bit mask.
+template<typename Node>
+static inline int getOverlapMask ( const Node& node, simd4i minX, simd4i minY, simd4i maxX, simd4i maxY ) noexcept {
+    int mask = 0;
+
+    for ( uint32_t i = 0; i < NODE_SIZE; i += 4 ) {
+        simd4i overlapX = simd_and(simd_cmpgt(simd4i_load(&node.maxX[i]), minX), simd_cmpgt(maxX, simd4i_load(&node.minX[i])));
+        simd4i overlapY = simd_and(simd_cmpgt(simd4i_load(&node.maxY[i]), minY), simd_cmpgt(maxY, simd4i_load(&node.minY[i])));
+        mask |= simd_mask(simd_asFloat(simd_and(overlapX, overlapY))) << i;
+    }
+
+    return mask;
+}
+
+template<typename Node>
+static inline int64_t getLaneIntersectionArea ( const Node& node, int lane, const Rect2d& rect ) noexcept {
+    int64_t width = static_cast<int64_t>(std::min(node.maxX[lane], rect.xPos + rect.width)) - std::max(node.minX[lane], rect.xPos);
+    int64_t height = static_cast<int64_t>(std::min(node.maxY[lane], rect.yPos + rect.height)) - std::max(node.minY[lane], rect.yPos);
+    return width * height;
+}
+
+void RectIndex::build ( const Rect2d* rects, size_t count ) {
+    this->rects.assign(rects, rects + count);
+    this->slotStates.assign(count, SLOT_TREE);
+    this->pendingIndices.assign(count, 0);
+    this->pendingIds.clear();
+    this->freeIds.clear();
+    this->rebuild();
+}
+
+void RectIndex::rebuild ( ) {
+
+    // pending rects join the tree, hidden entries are dropped.
+    std::vector<uint32_t> ids;
+    ids.reserve(this->rects.size());
+
+    int64_t minX = INT_MAX, minY = INT_MAX, maxX = INT_MIN, maxY = INT_MIN;
+
+    for ( uint32_t id = 0; id < this->rects.size(); ++id ) {
+        if ( this->slotStates[id] == SLOT_FREE ) {
+            continue;
+        }
+
+        const Rect2d& rect = this->rects[id];
+        this->slotStates[id] = SLOT_TREE;
+        ids.push_back(id);
+
+        // centers doubled to stay integral.
+        int64_t cx = 2LL * rect.xPos + rect.width, cy = 2LL * rect.yPos + rect.height;
+        minX = std::min(minX, cx); minY = std::min(minY, cy);
+        maxX = std::max(maxX, cx); maxY = std::max(maxY, cy);
+    }
+
+    this->pendingIds.clear();
+    this->hiddenCount = 0;
+    this->treeCount = ids.size();
+    this->nodes.clear();
+    this->leafNodeCount = 0;
+
+    if ( ids.empty() ) {
+        return;
+    }
+
+    // Hilbert index in the high half and id in the low half, so one sort orders by both.
+    std::vector<uint64_t> keys(ids.size());
+    int64_t rangeX = std::max<int64_t>(maxX - minX, 1), rangeY = std::max<int64_t>(maxY - minY, 1);
+
+    for ( size_t i = 0; i < ids.size(); ++i ) {
+        const Rect2d& rect = this->rects[ids[i]];
+        int64_t cx = 2LL * rect.xPos + rect.width, cy = 2LL * rect.yPos + rect.height;
+        uint32_t hilbert = getHilbertIndex(static_cast<uint32_t>((cx - minX) * 65535 / rangeX), static_cast<uint32_t>((cy - minY) * 65535 / rangeY));
+        keys[i] = (static_cast<uint64_t>(hilbert) << 32) | ids[i];
+    }
+
+    std::sort(keys.begin(), keys.end());
+
+    for ( size_t i = 0; i < ids.size(); ++i ) {
+        ids[i] = static_cast<uint32_t>(keys[i]);
+    }
+
+    Node empty;
+    std::fill(std::begin(empty.minX), std::end(empty.minX), INT_MAX);
+    std::fill(std::begin(empty.minY), std::end(empty.minY), INT_MAX);
+    std::fill(std::begin(empty.maxX), std::end(empty.maxX), INT_MIN);
+    std::fill(std::begin(empty.maxY), std::end(empty.maxY), INT_MIN);
+    std::fill(std::begin(empty.child), std::end(empty.child), INVALID_RECT_ID);
+
+    // leaves.
+    for ( size_t i = 0; i < ids.size(); i += NODE_SIZE ) {
+        Node& node = this->nodes.emplace_back(empty);
+
+        for ( size_t lane = 0; lane < NODE_SIZE && i + lane < ids.size(); ++lane ) {
+            const Rect2d& rect = this->rects[ids[i + lane]];
+            node.child[lane] = ids[i + lane];
+
+            // rects without area keep the inverted box, so they neither match nor grow their parents.
+            if ( rect.width <= 0 || rect.height <= 0 ) {
+                continue;
+            }
+
+            node.minX[lane] = rect.xPos;
+            node.minY[lane] = rect.yPos;
+            node.maxX[lane] = rect.xPos + rect.width;
+            node.maxY[lane] = rect.yPos + rect.height;
+        }
+    }
+
+    this->leafNodeCount = this->nodes.size();
+
+    // each level groups 16 consecutive nodes of the one below until a single root is left.
+    for ( size_t levelStart = 0, levelEnd = this->nodes.size(); levelEnd - levelStart > 1; ) {
+
+        for ( size_t i = levelStart; i < levelEnd; i += NODE_SIZE ) {
+            Node parent = empty;
+
+            for ( size_t lane = 0; lane < NODE_SIZE && i + lane < levelEnd; ++lane ) {
+                const Node& child = this->nodes[i + lane];
+                parent.minX[lane] = *std::min_element(std::begin(child.minX), std::end(child.minX));
+                parent.minY[lane] = *std::min_element(std::begin(child.minY), std::end(child.minY));
+                parent.maxX[lane] = *std::max_element(std::begin(child.maxX), std::end(child.maxX));
+                parent.maxY[lane] = *std::max_element(std::begin(child.maxY), std::end(child.maxY));
+                parent.child[lane] = static_cast<uint32_t>(i + lane);
+            }
+
+            this->nodes.push_back(parent);
+        }
+
+        levelStart = levelEnd;
+        levelEnd = this->nodes.size();
+    }
+
+}
+
+void RectIndex::clear ( ) {
+    this->nodes.clear();
+    this->leafNodeCount = 0;
+    this->treeCount = 0;
+    this->rects.clear();
+    this->slotStates.clear();
+    this->pendingIndices.clear();
+    this->pendingIds.clear();
+    this->freeIds.clear();
+    this->hiddenCount = 0;
+}
+
+// Amortized: pending inserts cost a linear scan per query and hidden entries dead lanes, so
+// rebuild once either grows past a fraction of the tree.
+void RectIndex::rebuildIfNeeded ( ) {
+    if ( this->pendingIds.size() > std::max(MIN_PENDING_REBUILD, this->treeCount / 8) || this->hiddenCount > this->treeCount / 4 + MIN_PENDING_REBUILD ) {
+        this->rebuild();
+    }
+}
+
+void RectIndex::removePending ( uint32_t id ) {
+    uint32_t index = this->pendingIndices[id];
+    uint32_t last = this->pendingIds.back();
+
+    this->pendingIds[index] = last;
+    this->pendingIndices[last] = index;
+    this->pendingIds.pop_back();
+}
+
+uint32_t RectIndex::insert ( const Rect2d& rect ) {
+
+    uint32_t id;
+
+    if ( this->freeIds.empty() ) {
+        id = static_cast<uint32_t>(this->rects.size());
+        this->rects.push_back(rect);
+        this->slotStates.push_back(SLOT_PENDING);
+        this->pendingIndices.push_back(0);
+    } else {
+        id = this->freeIds.back();
+        this->freeIds.pop_back();
+        this->rects[id] = rect;
+        this->slotStates[id] = SLOT_PENDING;
+    }
+
+    this->pendingIndices[id] = static_cast<uint32_t>(this->pendingIds.size());
+    this->pendingIds.push_back(id);
+    this->rebuildIfNeeded();
+
+    return id;
+
+}
+
+bool RectIndex::remove ( uint32_t id ) {
+
+    if ( !this->contains(id) ) {
+        return false;
+    }
+
+    if ( this->slotStates[id] == SLOT_TREE ) {
+        --this->treeCount;
+        ++this->hiddenCount;
+    } else {
+        this->removePending(id);
+    }
+
+    this->slotStates[id] = SLOT_FREE;
+    this->freeIds.push_back(id);
+    this->rebuildIfNeeded();
+
+    return true;
+
+}
+
+// The tree entry keeps the old box, so a moved rect is hidden there and pending until the next rebuild.
+bool RectIndex::update ( uint32_t id, const Rect2d& rect ) {
+
+    if ( !this->contains(id) ) {
+        return false;
+    }
+
+    this->rects[id] = rect;
+
+    if ( this->slotStates[id] == SLOT_TREE ) {
+        --this->treeCount;
+        ++this->hiddenCount;
+        this->slotStates[id] = SLOT_PENDING;
+        this->pendingIndices[id] = static_cast<uint32_t>(this->pendingIds.size());
+        this->pendingIds.push_back(id);
+        this->rebuildIfNeeded();
+    }
+
+    return true;
+
+}
+
+template<typename Visit>
+void RectIndex::visitOverlaps ( int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, Visit visit ) const {
+
+    if ( minX >= maxX || minY >= maxY ) {
+        return;
+    }
+
+    for ( uint32_t id : this->pendingIds ) {
+        const Rect2d& rect = this->rects[id];
+        if ( rect.xPos < maxX && minX < rect.xPos + rect.width && rect.yPos < maxY && minY < rect.yPos + rect.height
+            && rect.width > 0 && rect.height > 0 ) {
+            visit(id);
+        }
+    }
+
+    if ( this->nodes.empty() ) {
+        return;
+    }
+
+    simd4i qMinX = simd4i_set1(minX), qMinY = simd4i_set1(minY), qMaxX = simd4i_set1(maxX), qMaxY = simd4i_set1(maxY);
+    uint32_t stack[MAX_TREE_DEPTH * NODE_SIZE];
+    int stackSize = 0;
+    stack[stackSize++] = static_cast<uint32_t>(this->nodes.size() - 1);
+
+    while ( stackSize > 0 ) {
+        uint32_t nodeIndex = stack[--stackSize];
+        const Node& node = this->nodes[nodeIndex];
+        int mask = getOverlapMask(node, qMinX, qMinY, qMaxX, qMaxY);
+
+        if ( nodeIndex < this->leafNodeCount ) {
+            for ( ; mask; mask &= mask - 1 ) {
+                uint32_t id = node.child[std::countr_zero(static_cast<unsigned>(mask))];
+                if ( this->slotStates[id] == SLOT_TREE ) {
+                    visit(id);
+                }
+            }
+        } else {
+            for ( ; mask; mask &= mask - 1 ) {
+                stack[stackSize++] = node.child[std::countr_zero(static_cast<unsigned>(mask))];
+            }
+        }
+    }
+
+}
+
+void RectIndex::queryPoint ( const Vector2i& point, std::vector<uint32_t>& out ) const {
+    this->visitOverlaps(point.X, point.Y, point.X + 1, point.Y + 1, [&out]( uint32_t id ) { out.push_back(id); });
+}
+
+void RectIndex::queryOverlap ( const Rect2d& rect, std::vector<uint32_t>& out ) const {
+    this->visitOverlaps(rect.xPos, rect.yPos, rect.xPos + rect.width, rect.yPos + rect.height,
+        [&out]( uint32_t id ) { out.push_back(id); });
+}
+
+// Best first would need a heap, depth first with the child boxes' own overlap as a bound already
+// skips every subtree that can't beat the best so far.
+uint32_t RectIndex::findLargestIntersection ( const Rect2d& rect, int64_t* area ) const {
+
+    uint32_t best = INVALID_RECT_ID;
+    int64_t bestArea = 0;
+
+    auto consider = [&]( uint32_t id, int64_t overlap ) {
+        if ( overlap > bestArea || (overlap == bestArea && overlap > 0 && id < best) ) {
+            best = id;
+            bestArea = overlap;
+        }
+    };
+
+    for ( uint32_t id : this->pendingIds ) {
+        consider(id, getRectIntersectionArea(this->rects[id], rect));
+    }
+
+    if ( !this->nodes.empty() && rect.width > 0 && rect.height > 0 ) {
+
+        simd4i qMinX = simd4i_set1(rect.xPos), qMinY = simd4i_set1(rect.yPos);
+        simd4i qMaxX = simd4i_set1(rect.xPos + rect.width), qMaxY = simd4i_set1(rect.yPos + rect.height);
+        uint32_t stack[MAX_TREE_DEPTH * NODE_SIZE];
+        int stackSize = 0;
+        stack[stackSize++] = static_cast<uint32_t>(this->nodes.size() - 1);
+
+        while ( stackSize > 0 ) {
+            uint32_t nodeIndex = stack[--stackSize];
+            const Node& node = this->nodes[nodeIndex];
+            bool isLeaf = nodeIndex < this->leafNodeCount;
+
+            for ( int mask = getOverlapMask(node, qMinX, qMinY, qMaxX, qMaxY); mask; mask &= mask - 1 ) {
+                int lane = std::countr_zero(static_cast<unsigned>(mask));
+                int64_t overlap = getLaneIntersectionArea(node, lane, rect);
+
+                if ( overlap < bestArea ) {
+                    continue;
+                }
+
+                if ( !isLeaf ) {
+                    stack[stackSize++] = node.child[lane];
+                } else if ( this->slotStates[node.child[lane]] == SLOT_TREE ) {
+                    consider(node.child[lane], overlap);
+                }
+            }
+        }
+
+    }
+
+    if ( area ) {
+        *area = bestArea;
+    }
+
+    return best;
+
+}
+
+void RectIndex::queryPoints ( const Vector2i* points, size_t count, std::vector<uint32_t>& out, std::vector<uint32_t>& offsets ) const {
+    offsets.resize(count + 1);
+
+    for ( size_t i = 0; i < count; ++i ) {
+        offsets[i] = static_cast<uint32_t>(out.size());
+        this->queryPoint(points[i], out);
+    }
+
+    offsets[count] = static_cast<uint32_t>(out.size());
+}
+
+void RectIndex::queryOverlaps ( const Rect2d* rects, size_t count, std::vector<uint32_t>& out, std::vector<uint32_t>& offsets ) const {
+    offsets.resize(count + 1);
+
+    for ( size_t i = 0; i < count; ++i ) {
+        offsets[i] = static_cast<uint32_t>(out.size());
+        this->queryOverlap(rects[i], out);
+    }
+
+    offsets[count] = static_cast<uint32_t>(out.size());
+}
+
+void RectIndex::findLargestIntersections ( const Rect2d* rects, size_t count, uint32_t* out ) const {
+    for ( size_t i = 0; i < count; ++i ) {
+        out[i] = this->findLargestIntersection(rects[i]);
+    }
+}
+
+bool RectIndex::contains ( uint32_t id ) const {
+    return id < this->slotStates.size() && this->slotStates[id] != SLOT_FREE;
+}
+
+const Rect2d& RectIndex::getRect ( uint32_t id ) const {
+    return this->rects[id];
+}
+
+size_t RectIndex::size ( ) const {
+    return this->rects.size() - this->freeIds.size();
+}
+
+size_t RectIndex::getPendingCount ( ) const {
+    return this->pendingIds.size();
+}
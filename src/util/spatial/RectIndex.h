@@ -0,0 +1,105 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "util/math/Rect2d.h"
+#include "util/math/Vector2i.h"
+
+static constexpr uint32_t INVALID_RECT_ID = UINT32_MAX;
+
+// Rects are half open like Rect2d::getIntersection, a point is inside when
+// xPos <= X < xPos + width, and rects without area never match anything.
+inline int64_t getRectIntersectionArea ( const Rect2d& a, const Rect2d& b ) noexcept {
+    int64_t width = static_cast<int64_t>(std::min(a.xPos + a.width, b.xPos + b.width)) - std::max(a.xPos, b.xPos);
+    int64_t height = static_cast<int64_t>(std::min(a.yPos + a.height, b.yPos + b.height)) - std::max(a.yPos, b.yPos);
+    return width > 0 && height > 0 ? width * height : 0;
+}
+
+// Linear scan for a handful of rects, ties go to the lowest index. Returns INVALID_RECT_ID when
+// nothing overlaps rect.
+inline uint32_t findLargestIntersection ( const Rect2d* rects, size_t count, const Rect2d& rect, int64_t* area = nullptr ) noexcept {
+    uint32_t best = INVALID_RECT_ID;
+    int64_t bestArea = 0;
+
+    for ( size_t i = 0; i < count; ++i ) {
+        int64_t overlap = getRectIntersectionArea(rects[i], rect);
+
+        if ( overlap > bestArea ) {
+            best = static_cast<uint32_t>(i);
+            bestArea = overlap;
+        }
+    }
+
+    if ( area ) {
+        *area = bestArea;
+    }
+
+    return best;
+}
+
+// Packed Hilbert R-tree over Rect2d. Rects are sorted along a Hilbert curve through their centers
+// and grouped 16 to a node, bottom up, and a node's child boxes are tested 4 at a time.
+// The tree itself is immutable: inserts go to a pending list that queries scan linearly and
+// removes only hide their entry, both until enough pile up to rebuild the tree.
+// Ids are stable until removed, removed ids are handed out again by insert.
+class RectIndex {
+
+    private:
+        // Child boxes in SoA form with exclusive max, unused lanes hold an inverted box.
+        // child is a node index in inner nodes and a rect id in leaves.
+        struct alignas(16) Node {
+            int32_t minX[16], minY[16], maxX[16], maxY[16];
+            uint32_t child[16];
+        };
+
+        enum : uint8_t { SLOT_FREE, SLOT_TREE, SLOT_PENDING };
+
+        std::vector<Node> nodes{};
+        size_t leafNodeCount = 0;               // nodes below this index hold rect ids, the root is last
+        size_t treeCount = 0;                   // live rects in the tree
+
+        std::vector<Rect2d> rects{};            // by id
+        std::vector<uint8_t> slotStates{};      // by id
+        std::vector<uint32_t> pendingIndices{}; // by id, position in pendingIds
+        std::vector<uint32_t> pendingIds{};
+        std::vector<uint32_t> freeIds{};
+        size_t hiddenCount = 0;                 // removed or moved rects the tree still holds
+
+        void rebuildIfNeeded ( );
+        void removePending ( uint32_t id );
+
+        // Calls visit(id) for every live rect overlapping [minX, maxX) x [minY, maxY).
+        template<typename Visit>
+        void visitOverlaps ( int32_t minX, int32_t minY, int32_t maxX, int32_t maxY, Visit visit ) const;
+
+    public:
+        RectIndex ( ) { }
+
+        // Replaces the contents, rects[i] gets id i.
+        void build ( const Rect2d* rects, size_t count );
+        void rebuild ( );
+        void clear ( );
+
+        uint32_t insert ( const Rect2d& rect );
+        bool remove ( uint32_t id );
+        bool update ( uint32_t id, const Rect2d& rect );
+
+        // Ids are appended to out, in no particular order.
+        void queryPoint ( const Vector2i& point, std::vector<uint32_t>& out ) const;
+        void queryOverlap ( const Rect2d& rect, std::vector<uint32_t>& out ) const;
+
+        // Largest intersection area, ties go to the lowest id. INVALID_RECT_ID when nothing overlaps.
+        uint32_t findLargestIntersection ( const Rect2d& rect, int64_t* area = nullptr ) const;
+
+        // Batched forms, hits for query i are out[offsets[i]] to out[offsets[i + 1]].
+        void queryPoints ( const Vector2i* points, size_t count, std::vector<uint32_t>& out, std::vector<uint32_t>& offsets ) const;
+        void queryOverlaps ( const Rect2d* rects, size_t count, std::vector<uint32_t>& out, std::vector<uint32_t>& offsets ) const;
+        void findLargestIntersections ( const Rect2d* rects, size_t count, uint32_t* out ) const;
+
+        bool contains ( uint32_t id ) const;
+        const Rect2d& getRect ( uint32_t id ) const;
+        size_t size ( ) const;
+        size_t getPendingCount ( ) const;
+
+};
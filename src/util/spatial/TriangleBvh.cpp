@@ -0,0 +1,552 @@
+#include <type_traits>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include "util/JobPool.h"
+#include "TriangleBvh.h"
+
+using highResClock = std::chrono::high_resolution_clock;
+
+static constexpr int BIN_COUNT = 16;
+static constexpr uint32_t MAX_LEAF_SIZE = 4;            // one TrianglePacketx4
+static constexpr int MAX_SAH_DEPTH = 48;                // deeper nodes split at the median, which always halves
+static constexpr uint32_t PARALLEL_THRESHOLD = 16384;   // smaller subtrees stay on the current thread
+
+#if (COMPILER == COMPILER_GCC) && !defined(__clang__)
+    #pragma GCC diagnostic push
+    #pragma GCC diagnostic ignored "-Wignored-attributes"
+#endif
+
+template<int Width>
+using NodeLanes = std::conditional_t<Width == 4, simd4f, simd8f>;
+
+#if (COMPILER == COMPILER_GCC) && !defined(__clang__)
+    #pragma GCC diagnostic pop
+#endif
+
+// Binary tree built first, collapsed into wide nodes afterwards.
+struct BuildNode {
+    Aabb3f bounds{};
+    uint32_t begin = 0, count = 0;
+    uint32_t left = 0; // right is left + 1, 0 marks a leaf as the root is never a child.
+};
+
+struct BvhBuilder {
+    std::vector<Aabb3f> primBounds{};
+    std::vector<Vector3f> centroids{};
+    std::vector<uint32_t> refs{};
+    std::vector<BuildNode> nodes{};
+    std::atomic<uint32_t> nodeCount = 1;
+    std::atomic<int> freeThreads = 0;
+    std::atomic<int> maxDepth = 0;
+
+    void buildNode ( uint32_t index, uint32_t begin, uint32_t end, int depth );
+    uint32_t splitMedian ( uint32_t begin, uint32_t end, const Aabb3f& centroidBounds );
+    uint32_t splitSah ( uint32_t begin, uint32_t end, const Aabb3f& centroidBounds );
+};
+
+// Leaf packets are tested 4 triangles at a time, so cost counts packets rather than triangles.
+static inline float packetCost ( uint32_t count ) {
+    return static_cast<float>((count + MAX_LEAF_SIZE - 1) / MAX_LEAF_SIZE);
+}
+
+static inline float getAxis ( const Vector3f& vec, int axis ) {
+    return axis == 0 ? vec.X : (axis == 1 ? vec.Y : vec.Z);
+}
+
+uint32_t BvhBuilder::splitMedian ( uint32_t begin, uint32_t end, const Aabb3f& centroidBounds ) {
+
+    Vector3f size = centroidBounds.GetSize();
+    int axis = size.X > size.Y ? (size.X > size.Z ? 0 : 2) : (size.Y > size.Z ? 1 : 2);
+    uint32_t mid = begin + (end - begin) / 2;
+
+    std::nth_element(this->refs.begin() + begin, this->refs.begin() + mid, this->refs.begin() + end,
+        [this, axis]( uint32_t a, uint32_t b ) {
+            return getAxis(this->centroids[a], axis) < getAxis(this->centroids[b], axis);
+        });
+
+    return mid;
+}
+
+// Returns the partition point of the cheapest binned plane.
+uint32_t BvhBuilder::splitSah ( uint32_t begin, uint32_t end, const Aabb3f& centroidBounds ) {
+
+    struct Bin { Aabb3f bounds{}; uint32_t count = 0; };
+
+    Bin bins[3][BIN_COUNT];
+    float scale[3];
+
+    for ( int axis = 0; axis < 3; ++axis ) {
+        float extent = getAxis(centroidBounds.Max, axis) - getAxis(centroidBounds.Min, axis);
+        scale[axis] = extent > 0 ? BIN_COUNT * 0.9999F / extent : 0;
+    }
+
+    for ( uint32_t i = begin; i < end; ++i ) {
+        uint32_t ref = this->refs[i];
+
+        for ( int axis = 0; axis < 3; ++axis ) {
+            int bin = static_cast<int>((getAxis(this->centroids[ref], axis) - getAxis(centroidBounds.Min, axis)) * scale[axis]);
+            bins[axis][bin].bounds.Grow(this->primBounds[ref]);
+            bins[axis][bin].count++;
+        }
+    }
+
+    float bestCost = INFINITY;
+    int bestAxis = -1, bestSplit = 0;
+
+    for ( int axis = 0; axis < 3; ++axis ) {
+
+        if ( scale[axis] == 0 ) {
+            continue;
+        }
+
+        // right side areas and counts for every plane, then sweep from the left.
+        float rightCost[BIN_COUNT];
+        Aabb3f accum{};
+        uint32_t count = 0;
+
+        for ( int i = BIN_COUNT - 1; i > 0; --i ) {
+            accum.Grow(bins[axis][i].bounds);
+            count += bins[axis][i].count;
+            rightCost[i] = accum.GetSurfaceArea() * packetCost(count);
+        }
+
+        accum = Aabb3f();
+        count = 0;
+
+        for ( int i = 1; i < BIN_COUNT; ++i ) {
+            accum.Grow(bins[axis][i - 1].bounds);
+            count += bins[axis][i - 1].count;
+
+            float cost = accum.GetSurfaceArea() * packetCost(count) + rightCost[i];
+
+            if ( cost < bestCost ) {
+                bestCost = cost;
+                bestAxis = axis;
+                bestSplit = i;
+            }
+        }
+    }
+
+    if ( bestAxis < 0 ) {
+        return this->splitMedian(begin, end, centroidBounds);
+    }
+
+    float minCentroid = getAxis(centroidBounds.Min, bestAxis), axisScale = scale[bestAxis];
+
+    uint32_t* mid = std::partition(this->refs.data() + begin, this->refs.data() + end,
+        [&]( uint32_t ref ) {
+            return static_cast<int>((getAxis(this->centroids[ref], bestAxis) - minCentroid) * axisScale) < bestSplit;
+        });
+
+    uint32_t split = static_cast<uint32_t>(mid - this->refs.data());
+
+    if ( split == begin || split == end ) { // binning rounding put everything on one side
+        return this->splitMedian(begin, end, centroidBounds);
+    }
+
+    return split;
+}
+
+void BvhBuilder::buildNode ( uint32_t index, uint32_t begin, uint32_t end, int depth ) {
+
+    Aabb3f bounds{}, centroidBounds{};
+
+    for ( uint32_t i = begin; i < end; ++i ) {
+        bounds.Grow(this->primBounds[this->refs[i]]);
+        centroidBounds.Grow(this->centroids[this->refs[i]]);
+    }
+
+    BuildNode& node = this->nodes[index];
+    node.bounds = bounds;
+    node.begin = begin;
+    node.count = end - begin;
+
+    int prevDepth = this->maxDepth.load();
+    while ( depth > prevDepth && !this->maxDepth.compare_exchange_weak(prevDepth, depth) ) { }
+
+    // a leaf is one packet test whatever its size, splitting it can only add traversal cost.
+    if ( node.count <= MAX_LEAF_SIZE ) {
+        return;
+    }
+
+    uint32_t mid = depth < MAX_SAH_DEPTH
+        ? this->splitSah(begin, end, centroidBounds)
+        : this->splitMedian(begin, end, centroidBounds);
+
+    uint32_t left = this->nodeCount.fetch_add(2);
+    node.left = left;
+
+    if ( node.count >= PARALLEL_THRESHOLD && this->freeThreads.fetch_sub(1) > 0 ) {
+        getJobPool().run(2, [&]( size_t side ) {
+            this->buildNode(left + side, side ? mid : begin, side ? end : mid, depth + 1);
+        });
+    } else {
+        this->buildNode(left, begin, mid, depth + 1);
+        this->buildNode(left + 1, mid, end, depth + 1);
+    }
+
+    if ( node.count >= PARALLEL_THRESHOLD ) {
+        this->freeThreads.fetch_add(1); // undo the fetch_sub either way
+    }
+}
+
+// Slab test of one ray against every child box, tNear holds the entry distances.
+template<typename T>
+static inline T intersectBoxes ( const float* minX, const float* minY, const float* minZ,
+    const float* maxX, const float* maxY, const float* maxZ,
+    const Vector3fPacket<T>& origin, const Vector3fPacket<T>& invDir, T tMin, T tMax, T& tNear ) {
+
+    T t0x = simd_mul(simd_sub(simd_load<T>(minX), origin.X), invDir.X);
+    T t1x = simd_mul(simd_sub(simd_load<T>(maxX), origin.X), invDir.X);
+    T t0y = simd_mul(simd_sub(simd_load<T>(minY), origin.Y), invDir.Y);
+    T t1y = simd_mul(simd_sub(simd_load<T>(maxY), origin.Y), invDir.Y);
+    T t0z = simd_mul(simd_sub(simd_load<T>(minZ), origin.Z), invDir.Z);
+    T t1z = simd_mul(simd_sub(simd_load<T>(maxZ), origin.Z), invDir.Z);
+
+    tNear = simd_max(simd_max(simd_min(t0x, t1x), simd_min(t0y, t1y)), simd_max(simd_min(t0z, t1z), tMin));
+    T tFar = simd_min(simd_min(simd_max(t0x, t1x), simd_max(t0y, t1y)), simd_min(simd_max(t0z, t1z), tMax));
+
+    return simd_cmple(tNear, tFar);
+}
+
+template<int Width>
+void TriangleBvh<Width>::setLane ( Node& node, int lane, const Aabb3f& box, int32_t child ) {
+    node.minX[lane] = box.Min.X; node.minY[lane] = box.Min.Y; node.minZ[lane] = box.Min.Z;
+    node.maxX[lane] = box.Max.X; node.maxY[lane] = box.Max.Y; node.maxZ[lane] = box.Max.Z;
+    node.child[lane] = child;
+}
+
+template<int Width>
+Aabb3f TriangleBvh<Width>::getNodeBounds ( uint32_t nodeIndex ) const {
+    const Node& node = this->nodes[nodeIndex];
+    Aabb3f box{};
+
+    for ( uint32_t lane = 0; lane < node.childCount; ++lane ) {
+        box.Grow(Aabb3f(Vector3f(node.minX[lane], node.minY[lane], node.minZ[lane]),
+            Vector3f(node.maxX[lane], node.maxY[lane], node.maxZ[lane])));
+    }
+
+    return box;
+}
+
+template<int Width>
+void TriangleBvh<Width>::loadSlots ( const Triangle3d* tris ) {
+    std::vector<Triangle3d> slotTris;
+    slotTris.reserve(this->slotToTriangle.size());
+
+    for ( int32_t index : this->slotToTriangle ) {
+        slotTris.push_back(index >= 0 ? tris[index] : Triangle3d(Vector3f(), Vector3f(), Vector3f(), Vector3f()));
+    }
+
+    this->triangles.load(slotTris.data(), slotTris.size());
+}
+
+template<int Width>
+void TriangleBvh<Width>::build ( const Triangle3d* tris, size_t count, unsigned int threadCount ) {
+
+    highResClock::time_point start = highResClock::now();
+
+    if ( threadCount == 0 ) {
+        threadCount = static_cast<unsigned int>(getJobPool().getThreadCount());
+    }
+
+    this->nodes.clear();
+    this->slotToTriangle.clear();
+    this->triangleCount = count;
+    this->bounds = Aabb3f();
+    this->stats = BvhBuildStats();
+
+    if ( count == 0 ) {
+        this->triangles.load(tris, 0);
+        return;
+    }
+
+    BvhBuilder builder;
+    builder.primBounds.resize(count);
+    builder.centroids.resize(count);
+    builder.refs.resize(count);
+    builder.nodes.resize(2 * count - 1);
+    builder.freeThreads = static_cast<int>(threadCount) - 1;
+
+    // per triangle boxes, in parallel chunks.
+    size_t chunk = (count + threadCount - 1) / threadCount;
+
+    getJobPool().run((count + chunk - 1) / chunk, [&]( size_t t ) {
+        for ( size_t i = t * chunk; i < std::min(count, (t + 1) * chunk); ++i ) {
+            Aabb3f box{};
+            box.Grow(tris[i].VecA); box.Grow(tris[i].VecB); box.Grow(tris[i].VecC);
+
+            builder.primBounds[i] = box;
+            builder.centroids[i] = box.GetCenter();
+            builder.refs[i] = static_cast<uint32_t>(i);
+        }
+    });
+
+    builder.buildNode(0, 0, static_cast<uint32_t>(count), 0);
+
+    // Collapse: each wide node takes its binary children, then keeps opening the largest inner
+    // child until Width lanes are filled. Nodes are emitted parent first, refit relies on that.
+    auto collapse = [this, &builder]( auto& self, uint32_t buildIndex ) -> uint32_t {
+
+        uint32_t lanes[Width];
+        uint32_t laneCount = 0;
+        const BuildNode& root = builder.nodes[buildIndex];
+
+        if ( root.left == 0 ) {
+            lanes[laneCount++] = buildIndex;
+        } else {
+            lanes[laneCount++] = root.left;
+            lanes[laneCount++] = root.left + 1;
+        }
+
+        while ( laneCount < Width ) {
+            int best = -1;
+            float bestArea = -1;
+
+            for ( uint32_t i = 0; i < laneCount; ++i ) {
+                const BuildNode& node = builder.nodes[lanes[i]];
+
+                if ( node.left != 0 && node.bounds.GetSurfaceArea() > bestArea ) {
+                    best = static_cast<int>(i);
+                    bestArea = node.bounds.GetSurfaceArea();
+                }
+            }
+
+            if ( best < 0 ) {
+                break;
+            }
+
+            uint32_t opened = builder.nodes[lanes[best]].left;
+            lanes[best] = opened;
+            lanes[laneCount++] = opened + 1;
+        }
+
+        uint32_t nodeIndex = static_cast<uint32_t>(this->nodes.size());
+        this->nodes.push_back(Node());
+        this->nodes[nodeIndex].childCount = laneCount;
+
+        for ( int lane = 0; lane < Width; ++lane ) {
+            this->setLane(this->nodes[nodeIndex], lane, Aabb3f(), 0);
+        }
+
+        for ( uint32_t lane = 0; lane < laneCount; ++lane ) {
+            const BuildNode& child = builder.nodes[lanes[lane]];
+            int32_t childRef;
+
+            if ( child.left == 0 ) {
+                int32_t packet = static_cast<int32_t>(this->slotToTriangle.size() / MAX_LEAF_SIZE);
+
+                for ( uint32_t i = 0; i < MAX_LEAF_SIZE; ++i ) {
+                    this->slotToTriangle.push_back(i < child.count ? static_cast<int32_t>(builder.refs[child.begin + i]) : -1);
+                }
+
+                childRef = ~packet;
+                this->stats.leafCount++;
+            } else {
+                childRef = static_cast<int32_t>(self(self, lanes[lane]));
+            }
+
+            this->setLane(this->nodes[nodeIndex], lane, child.bounds, childRef);
+        }
+
+        return nodeIndex;
+    };
+
+    collapse(collapse, 0);
+    this->loadSlots(tris);
+
+    this->bounds = builder.nodes[0].bounds;
+    this->stats.nodeCount = this->nodes.size();
+    this->stats.maxDepth = builder.maxDepth;
+    this->stats.buildSeconds = std::chrono::duration<double>(highResClock::now() - start).count();
+}
+
+template<int Width>
+void TriangleBvh<Width>::refit ( const Triangle3d* tris ) {
+
+    this->loadSlots(tris);
+
+    // children always come after their parent, so walking backwards sees them first.
+    for ( size_t nodeIndex = this->nodes.size(); nodeIndex-- > 0; ) {
+        Node& node = this->nodes[nodeIndex];
+
+        for ( uint32_t lane = 0; lane < node.childCount; ++lane ) {
+            int32_t child = node.child[lane];
+            Aabb3f box{};
+
+            if ( child >= 0 ) {
+                box = this->getNodeBounds(static_cast<uint32_t>(child));
+            } else {
+                for ( uint32_t i = 0; i < MAX_LEAF_SIZE; ++i ) {
+                    int32_t index = this->slotToTriangle[(~child) * MAX_LEAF_SIZE + i];
+
+                    if ( index >= 0 ) {
+                        box.Grow(tris[index].VecA); box.Grow(tris[index].VecB); box.Grow(tris[index].VecC);
+                    }
+                }
+            }
+
+            this->setLane(node, static_cast<int>(lane), box, child);
+        }
+    }
+
+    this->bounds = this->nodes.empty() ? Aabb3f() : this->getNodeBounds(0);
+}
+
+template<int Width>
+bool TriangleBvh<Width>::intersect ( const Ray3f& ray, RayHit& hit, float tMin, float tMax ) const {
+
+    typedef NodeLanes<Width> T;
+    struct StackEntry { int32_t child; float tNear; };
+
+    hit = RayHit();
+    hit.T = tMax;
+
+    if ( this->nodes.empty() ) {
+        return false;
+    }
+
+    Vector3fPacket<T> origin(ray.Origin);
+    Vector3fPacket<T> invDir(Vector3f(1 / ray.Direction.X, 1 / ray.Direction.Y, 1 / ray.Direction.Z));
+    T boxMin = simd_set1<T>(tMin);
+
+    RayPacketx4 leafRay(ray);
+    simd4f leafMin = simd4f_set1(tMin);
+
+    // binary depth is bounded by MAX_SAH_DEPTH plus the median splits, wide nodes are never deeper.
+    StackEntry stack[96 * Width];
+    int stackSize = 0;
+    stack[stackSize++] = { 0, tMin };
+
+    while ( stackSize > 0 ) {
+
+        StackEntry entry = stack[--stackSize];
+
+        if ( entry.tNear > hit.T ) {
+            continue;
+        }
+
+        if ( entry.child < 0 ) {
+            uint32_t slot = static_cast<uint32_t>(~entry.child) * MAX_LEAF_SIZE;
+            simd4f t, u, v;
+            int hitMask = simd_mask(this->triangles.template loadPacket<simd4f>(slot).Intersect(
+                leafRay, leafMin, simd4f_set1(hit.T), t, u, v));
+
+            if ( hitMask != 0 ) {
+                float tBuf[4], uBuf[4], vBuf[4];
+                simd_store(tBuf, t); simd_store(uBuf, u); simd_store(vBuf, v);
+
+                for ( int lane = 0; lane < 4; ++lane ) {
+                    if ( (hitMask & (1 << lane)) && tBuf[lane] < hit.T ) {
+                        hit.T = tBuf[lane]; hit.U = uBuf[lane]; hit.V = vBuf[lane];
+                        hit.Index = this->slotToTriangle[slot + lane];
+                    }
+                }
+            }
+
+            continue;
+        }
+
+        const Node& node = this->nodes[entry.child];
+        T tNear;
+        T mask = intersectBoxes<T>(node.minX, node.minY, node.minZ, node.maxX, node.maxY, node.maxZ,
+            origin, invDir, boxMin, simd_set1<T>(hit.T), tNear);
+
+        int hitMask = simd_mask(mask) & ((1 << node.childCount) - 1);
+
+        if ( hitMask == 0 ) {
+            continue;
+        }
+
+        float nearBuf[Width];
+        simd_store(nearBuf, tNear);
+
+        // pushed far to near, so the nearest child is popped first.
+        int base = stackSize;
+
+        for ( int lane = 0; lane < Width; ++lane ) {
+            if ( hitMask & (1 << lane) ) {
+                StackEntry next = { node.child[lane], nearBuf[lane] };
+                int pos = stackSize++;
+
+                while ( pos > base && stack[pos - 1].tNear < next.tNear ) {
+                    stack[pos] = stack[pos - 1];
+                    --pos;
+                }
+
+                stack[pos] = next;
+            }
+        }
+    }
+
+    return hit.IsHit();
+}
+
+template<int Width>
+bool TriangleBvh<Width>::intersectAny ( const Ray3f& ray, float tMin, float tMax ) const {
+
+    typedef NodeLanes<Width> T;
+
+    if ( this->nodes.empty() ) {
+        return false;
+    }
+
+    Vector3fPacket<T> origin(ray.Origin);
+    Vector3fPacket<T> invDir(Vector3f(1 / ray.Direction.X, 1 / ray.Direction.Y, 1 / ray.Direction.Z));
+    T boxMin = simd_set1<T>(tMin), boxMax = simd_set1<T>(tMax);
+
+    RayPacketx4 leafRay(ray);
+    simd4f leafMin = simd4f_set1(tMin), leafMax = simd4f_set1(tMax);
+
+    int32_t stack[96 * Width];
+    int stackSize = 0;
+    stack[stackSize++] = 0;
+
+    while ( stackSize > 0 ) {
+
+        int32_t child = stack[--stackSize];
+
+        if ( child < 0 ) {
+            simd4f t, u, v;
+            uint32_t slot = static_cast<uint32_t>(~child) * MAX_LEAF_SIZE;
+
+            if ( simd_mask(this->triangles.template loadPacket<simd4f>(slot).Intersect(leafRay, leafMin, leafMax, t, u, v)) != 0 ) {
+                return true;
+            }
+
+            continue;
+        }
+
+        const Node& node = this->nodes[child];
+        T tNear;
+        int hitMask = simd_mask(intersectBoxes<T>(node.minX, node.minY, node.minZ, node.maxX, node.maxY, node.maxZ,
+            origin, invDir, boxMin, boxMax, tNear)) & ((1 << node.childCount) - 1);
+
+        for ( int lane = 0; lane < Width; ++lane ) {
+            if ( hitMask & (1 << lane) ) {
+                stack[stackSize++] = node.child[lane];
+            }
+        }
+    }
+
+    return false;
+}
+
+template<int Width>
+size_t TriangleBvh<Width>::getTriangleCount ( ) const {
+    return this->triangleCount;
+}
+
+template<int Width>
+const Aabb3f& TriangleBvh<Width>::getBounds ( ) const {
+    return this->bounds;
+}
+
+template<int Width>
+const BvhBuildStats& TriangleBvh<Width>::getBuildStats ( ) const {
+    return this->stats;
+}
+
+template class TriangleBvh<4>;
+template class TriangleBvh<8>;
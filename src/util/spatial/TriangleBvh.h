@@ -0,0 +1,67 @@
+#pragma once
+
+#include <stdint.h>
+#include <stddef.h>
+#include <vector>
+#include "util/math/Aabb3f.h"
+#include "util/math/Triangle3d.h"
+#include "util/math/TriangleStream.h"
+
+struct BvhBuildStats {
+    size_t nodeCount = 0;
+    size_t leafCount = 0;
+    int maxDepth = 0;
+    double buildSeconds = 0;
+};
+
+// Bounding volume hierarchy over a triangle soup. Built top down with binned SAH, subtrees are
+// split across the shared JobPool, then the binary tree is collapsed into Width wide nodes (4 or 8) whose
+// child boxes are tested against a ray in one SIMD pass. Leaves hold up to 4 triangles stored
+// as one TrianglePacketx4.
+template<int Width>
+class TriangleBvh {
+
+    static_assert(Width == 4 || Width == 8, "BVH nodes are 4 or 8 wide");
+
+    private:
+        // Child boxes in SoA form. child >= 0 is an inner node, otherwise ~child is the triangle
+        // packet of a leaf. Lanes past childCount are unused.
+        struct alignas(32) Node {
+            float minX[Width], minY[Width], minZ[Width];
+            float maxX[Width], maxY[Width], maxZ[Width];
+            int32_t child[Width];
+            uint32_t childCount;
+        };
+
+        std::vector<Node> nodes{};
+        TriangleStream triangles{};             // leaf packets, padded with degenerate triangles
+        std::vector<int32_t> slotToTriangle{};  // packet slot -> caller index, -1 for padding
+        Aabb3f bounds{};
+        size_t triangleCount = 0;
+        BvhBuildStats stats{};
+
+        void loadSlots ( const Triangle3d* tris );
+        Aabb3f getNodeBounds ( uint32_t nodeIndex ) const;
+        void setLane ( Node& node, int lane, const Aabb3f& box, int32_t child );
+
+    public:
+        TriangleBvh ( ) { }
+
+        // threadCount 0 uses every thread of the job pool.
+        void build ( const Triangle3d* tris, size_t count, unsigned int threadCount = 0 );
+
+        // Updates the boxes for moved vertices, tris must match the build in count and order.
+        // The tree keeps its topology, so quality drops as the mesh deforms away from it.
+        void refit ( const Triangle3d* tris );
+
+        bool intersect ( const Ray3f& ray, RayHit& hit, float tMin = 0, float tMax = INFINITY ) const;
+        bool intersectAny ( const Ray3f& ray, float tMin = 0, float tMax = INFINITY ) const;
+
+        size_t getTriangleCount ( ) const;
+        const Aabb3f& getBounds ( ) const;
+        const BvhBuildStats& getBuildStats ( ) const;
+
+};
+
+typedef TriangleBvh<4> TriangleBvh4;
+typedef TriangleBvh<8> TriangleBvh8;